@@ -22,8 +22,11 @@
 #include <core/string_utils/string_utils.h>
 #include <core/uuid/uuid.hpp>
 
+#include <runtime/animation/animation_compression.h>
+#include <runtime/animation/animation_sampler.h>
 #include <runtime/ecs/constructs/prefab.h>
 #include <runtime/ecs/constructs/scene.h>
+#include <runtime/ecs/constructs/snapshots.h>
 #include <runtime/meta/animation/animation.hpp>
 #include <runtime/meta/audio/sound.hpp>
 #include <runtime/meta/rendering/material.hpp>
@@ -34,6 +37,9 @@
 
 namespace asset_compiler
 {
+/// Sounds at least this long are not decoded up front.
+static const audio::sound_info::duration_t stream_min_duration = std::chrono::seconds(10);
+
 static std::string escape_str(const std::string& str)
 {
 	return "\"" + str + "\"";
@@ -98,25 +104,18 @@ static bool run_compile_process(const std::string& process, const std::vector<st
 	}
 }
 
-template <>
-void compile<gfx::shader>(const fs::path& absolute_meta_key, const fs::path& output)
+fs::path get_source_path(const fs::path& absolute_meta_key)
 {
-	fs::error_code err;
 	fs::path absolute_key = fs::convert_to_protocol(absolute_meta_key);
 	absolute_key = fs::resolve_protocol(fs::replace(absolute_key, ":/meta", ":/data"));
 	absolute_key.replace_extension();
-	std::string str_input = absolute_key.string();
-	std::string file = absolute_key.stem().string();
-	fs::path dir = absolute_key.parent_path();
-
-	fs::path temp = fs::temp_directory_path(err);
-	temp /= uuids::random_uuid(str_input).to_string() + ".buildtemp";
+	return absolute_key;
+}
 
-	std::string str_output = temp.string();
-	fs::path include = fs::resolve_protocol("shader_include:/");
-	std::string str_include = include.string();
-	fs::path varying = dir / (file + ".io");
-	std::string str_varying = varying.string();
+template <>
+std::vector<std::string> get_tool_args<gfx::shader>(const fs::path& absolute_meta_key)
+{
+	std::string file = get_source_path(absolute_meta_key).stem().string();
 
 	std::string str_platform;
 	std::string str_profile;
@@ -162,10 +161,42 @@ void compile<gfx::shader>(const fs::path& absolute_meta_key, const fs::path& out
 	else
 		str_type = "unknown";
 
-	const std::vector<std::string> args_array = {
-		"-f",		  str_input,	"-o", str_output,  "-i",	 str_include, "--varyingdef", str_varying,
-		"--platform", str_platform, "-p", str_profile, "--type", str_type,	"-O",			  "3",
+	return {
+		"--platform", str_platform, "-p", str_profile, "--type", str_type, "-O", "3",
 	};
+}
+
+template <>
+std::vector<std::string> get_tool_args<gfx::texture>(const fs::path& /*absolute_meta_key*/)
+{
+	return {
+		"--as", "ktx", "-m", "-t", "BGRA8",
+	};
+}
+
+template <>
+bool compile<gfx::shader>(const fs::path& absolute_meta_key, const fs::path& output)
+{
+	fs::error_code err;
+	fs::path absolute_key = get_source_path(absolute_meta_key);
+	std::string str_input = absolute_key.string();
+	std::string file = absolute_key.stem().string();
+	fs::path dir = absolute_key.parent_path();
+
+	fs::path temp = fs::temp_directory_path(err);
+	temp /= uuids::random_uuid(str_input).to_string() + ".buildtemp";
+
+	std::string str_output = temp.string();
+	fs::path include = fs::resolve_protocol("shader_include:/");
+	std::string str_include = include.string();
+	fs::path varying = dir / (file + ".io");
+	std::string str_varying = varying.string();
+
+	std::vector<std::string> args_array = {
+		"-f", str_input, "-o", str_output, "-i", str_include, "--varyingdef", str_varying,
+	};
+	const auto tool_args = get_tool_args<gfx::shader>(absolute_meta_key);
+	args_array.insert(std::end(args_array), std::begin(tool_args), std::end(tool_args));
 
 	std::string error;
 
@@ -174,25 +205,25 @@ void compile<gfx::shader>(const fs::path& absolute_meta_key, const fs::path& out
 		(void)output_file;
 	}
 
-	if(!run_compile_process("shaderc", args_array, error))
+	bool result = run_compile_process("shaderc", args_array, error);
+	if(!result)
 	{
 		APPLOG_ERROR("Failed compilation of {0} with error: {1}", str_input, error);
 	}
 	else
 	{
 		APPLOG_INFO("Successful compilation of {0}", str_input);
-		fs::copy_file(temp, output, fs::copy_options::overwrite_existing, err);
+		result = fs::copy_file(temp, output, fs::copy_options::overwrite_existing, err);
 	}
 	fs::remove(temp, err);
+	return result;
 }
 
 template <>
-void compile<gfx::texture>(const fs::path& absolute_meta_key, const fs::path& output)
+bool compile<gfx::texture>(const fs::path& absolute_meta_key, const fs::path& output)
 {
 	fs::error_code err;
-	fs::path absolute_key = fs::convert_to_protocol(absolute_meta_key);
-	absolute_key = fs::resolve_protocol(fs::replace(absolute_key, ":/meta", ":/data"));
-	absolute_key.replace_extension();
+	fs::path absolute_key = get_source_path(absolute_meta_key);
 	std::string str_input = absolute_key.string();
 
 	fs::path temp = fs::temp_directory_path(err);
@@ -200,9 +231,11 @@ void compile<gfx::texture>(const fs::path& absolute_meta_key, const fs::path& ou
 
 	std::string str_output = temp.string();
 
-	const std::vector<std::string> args_array = {
-		"-f", str_input, "-o", str_output, "--as", "ktx", "-m", "-t", "BGRA8",
+	std::vector<std::string> args_array = {
+		"-f", str_input, "-o", str_output,
 	};
+	const auto tool_args = get_tool_args<gfx::texture>(absolute_meta_key);
+	args_array.insert(std::end(args_array), std::begin(tool_args), std::end(tool_args));
 
 	std::string error;
 
@@ -211,25 +244,25 @@ void compile<gfx::texture>(const fs::path& absolute_meta_key, const fs::path& ou
 		(void)output_file;
 	}
 
-	if(!run_compile_process("texturec", args_array, error))
+	bool result = run_compile_process("texturec", args_array, error);
+	if(!result)
 	{
 		APPLOG_ERROR("Failed compilation of {0} with error: {1}", str_input, error);
 	}
 	else
 	{
 		APPLOG_INFO("Successful compilation of {0}", str_input);
-		fs::copy_file(temp, output, fs::copy_options::overwrite_existing, err);
+		result = fs::copy_file(temp, output, fs::copy_options::overwrite_existing, err);
 	}
 	fs::remove(temp, err);
+	return result;
 }
 
 template <>
-void compile<mesh>(const fs::path& absolute_meta_key, const fs::path& output)
+bool compile<mesh>(const fs::path& absolute_meta_key, const fs::path& output)
 {
 	fs::error_code err;
-	fs::path absolute_key = fs::convert_to_protocol(absolute_meta_key);
-	absolute_key = fs::resolve_protocol(fs::replace(absolute_key, ":/meta", ":/data"));
-	absolute_key.replace_extension();
+	fs::path absolute_key = get_source_path(absolute_meta_key);
 	std::string str_input = absolute_key.string();
 
 	fs::path temp = fs::temp_directory_path(err);
@@ -240,7 +273,7 @@ void compile<mesh>(const fs::path& absolute_meta_key, const fs::path& output)
 	if(!importer::load_mesh_data_from_file(str_input, data, animations))
 	{
 		APPLOG_ERROR("Failed compilation of {0}", str_input);
-		return;
+		return false;
 	}
 
 	if(!data.vertex_data.empty())
@@ -250,8 +283,13 @@ void compile<mesh>(const fs::path& absolute_meta_key, const fs::path& output)
 			cereal::oarchive_binary_t ar(soutput);
 			try_save(ar, cereal::make_nvp("mesh", data));
 		}
-		fs::copy_file(temp, output, fs::copy_options::overwrite_existing, err);
+		const bool copied = fs::copy_file(temp, output, fs::copy_options::overwrite_existing, err);
 		fs::remove(temp, err);
+		if(!copied)
+		{
+			APPLOG_ERROR("Failed compilation of {0}", str_input);
+			return false;
+		}
 
 		APPLOG_INFO("Successful compilation of {0}", str_input);
 	}
@@ -276,18 +314,18 @@ void compile<mesh>(const fs::path& absolute_meta_key, const fs::path& output)
 			APPLOG_INFO("Successful compilation of animation {0}", animation.name);
 		}
 	}
+	return true;
 }
 
 template <>
-void compile<runtime::animation>(const fs::path& absolute_meta_key, const fs::path& output)
+bool compile<runtime::animation>(const fs::path& absolute_meta_key, const fs::path& output)
 {
 	fs::error_code err;
-	fs::path absolute_key = fs::convert_to_protocol(absolute_meta_key);
-	absolute_key = fs::resolve_protocol(fs::replace(absolute_key, ":/meta", ":/data"));
-	absolute_key.replace_extension();
+	fs::path absolute_key = get_source_path(absolute_meta_key);
 	std::string str_input = absolute_key.string();
 
 	bool has_loaded = false;
+	bool has_saved = false;
 	runtime::animation anim;
 	{
 		std::ifstream stream(absolute_key.string());
@@ -303,6 +341,11 @@ void compile<runtime::animation>(const fs::path& absolute_meta_key, const fs::pa
 
 	if(has_loaded)
 	{
+		// drop the keys interpolation reproduces and pack the rest
+		const auto source_keys = runtime::get_key_count(anim);
+		const auto source_bytes = runtime::get_key_memory(anim);
+		runtime::compress(anim, runtime::animation_compression_settings{});
+
 		std::ofstream stream(output.string(), std::ios::binary);
 		if(stream.good())
 		{
@@ -310,18 +353,20 @@ void compile<runtime::animation>(const fs::path& absolute_meta_key, const fs::pa
 
 			try_save(ar, cereal::make_nvp("animation", anim));
 
-			APPLOG_INFO("Successful compilation of {0}", str_input);
+			APPLOG_INFO("Successful compilation of {0} ({1} of {2} keys, {3} of {4} bytes)", str_input,
+						runtime::get_key_count(anim), source_keys, runtime::get_key_memory(anim),
+						source_bytes);
+			has_saved = true;
 		}
 	}
+	return has_saved;
 }
 
 template <>
-void compile<audio::sound>(const fs::path& absolute_meta_key, const fs::path& output)
+bool compile<audio::sound>(const fs::path& absolute_meta_key, const fs::path& output)
 {
 	fs::error_code err;
-	fs::path absolute_key = fs::convert_to_protocol(absolute_meta_key);
-	absolute_key = fs::resolve_protocol(fs::replace(absolute_key, ":/meta", ":/data"));
-	absolute_key.replace_extension();
+	fs::path absolute_key = get_source_path(absolute_meta_key);
 
 	std::string str_input = absolute_key.string();
 
@@ -333,7 +378,7 @@ void compile<audio::sound>(const fs::path& absolute_meta_key, const fs::path& ou
 	if(!f.is_open())
 	{
 		APPLOG_ERROR("Cant open file {0}", str_input);
-		return;
+		return false;
 	}
 
 	auto file_data = fs::read_stream(f);
@@ -344,10 +389,18 @@ void compile<audio::sound>(const fs::path& absolute_meta_key, const fs::path& ou
 	if(ext == ".ogg")
 	{
 		std::string load_err;
-		if(!audio::load_ogg_from_memory(file_data.data(), file_data.size(), data, load_err))
+		if(!audio::load_ogg_stream_from_memory(file_data.data(), file_data.size(), data, load_err))
 		{
 			APPLOG_ERROR("Failed compilation of {0} with error : {1}", str_input, load_err);
-			return;
+			return false;
+		}
+
+		// long sounds stay compressed and are decoded while playing
+		if(data.info.duration < stream_min_duration &&
+		   !audio::load_ogg_from_memory(file_data.data(), file_data.size(), data, load_err))
+		{
+			APPLOG_ERROR("Failed compilation of {0} with error : {1}", str_input, load_err);
+			return false;
 		}
 	}
 	else if(ext == ".wav")
@@ -356,13 +409,13 @@ void compile<audio::sound>(const fs::path& absolute_meta_key, const fs::path& ou
 		if(!audio::load_wav_from_memory(file_data.data(), file_data.size(), data, load_err))
 		{
 			APPLOG_ERROR("Failed compilation of {0} with error : {1}", str_input, load_err);
-			return;
+			return false;
 		}
 	}
 	else
 	{
 		APPLOG_ERROR("Failed compilation of {0} with error : Unsupported", str_input);
-		return;
+		return false;
 	}
 
 	{
@@ -370,19 +423,23 @@ void compile<audio::sound>(const fs::path& absolute_meta_key, const fs::path& ou
 		cereal::oarchive_binary_t ar(soutput);
 		try_save(ar, cereal::make_nvp("sound", data));
 	}
-	fs::copy_file(temp, output, fs::copy_options::overwrite_existing, err);
+	const bool copied = fs::copy_file(temp, output, fs::copy_options::overwrite_existing, err);
 	fs::remove(temp, err);
+	if(!copied)
+	{
+		APPLOG_ERROR("Failed compilation of {0}", str_input);
+		return false;
+	}
 
 	APPLOG_INFO("Successful compilation of {0}", str_input);
+	return true;
 }
 
 template <>
-void compile<material>(const fs::path& absolute_meta_key, const fs::path& output)
+bool compile<material>(const fs::path& absolute_meta_key, const fs::path& output)
 {
 	fs::error_code err;
-	fs::path absolute_key = fs::convert_to_protocol(absolute_meta_key);
-	absolute_key = fs::resolve_protocol(fs::replace(absolute_key, ":/meta", ":/data"));
-	absolute_key.replace_extension();
+	fs::path absolute_key = get_source_path(absolute_meta_key);
 	std::string str_input = absolute_key.string();
 
 	std::shared_ptr<::material> material;
@@ -406,29 +463,51 @@ void compile<material>(const fs::path& absolute_meta_key, const fs::path& output
 			try_save(ar, cereal::make_nvp("material", material));
 
 			APPLOG_INFO("Successful compilation of {0}", str_input);
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool compile_snapshot(const fs::path& absolute_meta_key, const fs::path& output)
+{
+	fs::path absolute_key = get_source_path(absolute_meta_key);
+	std::string str_input = absolute_key.string();
+
+	// the source stays json for editing, the compiled asset is binary
+	Registry registry;
+	std::vector<EntityType> entities;
+	{
+		std::ifstream stream(str_input, std::ios::binary);
+		if(!stream.good() || !ecs::deserialize(stream, registry, entities))
+		{
+			APPLOG_ERROR("Failed compilation of {0}", str_input);
+			return false;
 		}
 	}
+
+	{
+		std::ofstream stream(output.string(), std::ios::binary | std::ios::trunc);
+		if(!stream.good() || !ecs::serialize(stream, registry, entities, ecs::snapshot_format::binary))
+		{
+			APPLOG_ERROR("Failed compilation of {0}", str_input);
+			return false;
+		}
+	}
+
+	APPLOG_INFO("Successful compilation of {0}", str_input);
+	return true;
 }
 
 template <>
-void compile<prefab>(const fs::path& absolute_meta_key, const fs::path& output)
+bool compile<prefab>(const fs::path& absolute_meta_key, const fs::path& output)
 {
-	fs::error_code err;
-	fs::path absolute_key = fs::convert_to_protocol(absolute_meta_key);
-	absolute_key = fs::resolve_protocol(fs::replace(absolute_key, ":/meta", ":/data"));
-	absolute_key.replace_extension();
-	fs::copy_file(absolute_key, output, fs::copy_options::overwrite_existing, err);
-	APPLOG_INFO("Successful compilation of {0}", absolute_key.string());
+	return compile_snapshot(absolute_meta_key, output);
 }
 
 template <>
-void compile<scene>(const fs::path& absolute_meta_key, const fs::path& output)
+bool compile<scene>(const fs::path& absolute_meta_key, const fs::path& output)
 {
-	fs::error_code err;
-	fs::path absolute_key = fs::convert_to_protocol(absolute_meta_key);
-	absolute_key = fs::resolve_protocol(fs::replace(absolute_key, ":/meta", ":/data"));
-	absolute_key.replace_extension();
-	fs::copy_file(absolute_key, output, fs::copy_options::overwrite_existing, err);
-	APPLOG_INFO("Successful compilation of {0}", absolute_key.string());
+	return compile_snapshot(absolute_meta_key, output);
 }
 }
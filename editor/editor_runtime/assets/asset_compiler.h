@@ -1,9 +1,89 @@
 #pragma once
+#include "asset_extensions.h"
+#include "build_cache.h"
+
 #include <core/filesystem/filesystem.h>
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
 namespace asset_compiler
 {
+/// Bump whenever a compiler starts writing different outputs for the same
+/// inputs, this invalidates everything in the build caches.
+constexpr std::uint32_t version = 3;
+
+//-----------------------------------------------------------------------------
+//  Name : get_source_path ()
+/// <summary>
+/// Returns the absolute path of the source file a .meta file describes.
+/// </summary>
+//-----------------------------------------------------------------------------
+fs::path get_source_path(const fs::path& absolute_meta_key);
+
+//-----------------------------------------------------------------------------
+//  Name : get_tool_args ()
+/// <summary>
+/// Returns the options the external tool compiles the source with, without
+/// the file paths. They are part of the build cache key so changing them
+/// rebuilds the affected assets.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <typename T>
+std::vector<std::string> get_tool_args(const fs::path& /*absolute_meta_key*/)
+{
+	return {};
+}
+
+template <>
+std::vector<std::string> get_tool_args<gfx::shader>(const fs::path& absolute_meta_key);
 
+template <>
+std::vector<std::string> get_tool_args<gfx::texture>(const fs::path& absolute_meta_key);
+
+//-----------------------------------------------------------------------------
+//  Name : compile ()
+/// <summary>
+/// Compiles the source of the .meta file into the output. Returns false when
+/// the compilation failed.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <typename T>
+extern bool compile(const fs::path& absolute_meta_key, const fs::path& output);
+
+//-----------------------------------------------------------------------------
+//  Name : build ()
+/// <summary>
+/// Brings the output up to date through the build cache. Unchanged inputs are
+/// skipped, an output built from the same inputs elsewhere is copied and
+/// anything else is compiled. is_initial_listing lets outputs from before the
+/// cache existed be adopted instead of rebuilt.
+/// </summary>
+//-----------------------------------------------------------------------------
 template <typename T>
-extern void compile(const fs::path& absolute_meta_key, const fs::path& output);
+bool build(build_cache& cache, const fs::path& absolute_meta_key, const fs::path& output,
+		   bool is_initial_listing)
+{
+	const auto source = get_source_path(absolute_meta_key);
+	const auto tool_args = get_tool_args<T>(absolute_meta_key);
+	const auto entry = cache.make_entry(output, source, absolute_meta_key, tool_args);
+	if(cache.is_up_to_date(output, entry, is_initial_listing))
+	{
+		return true;
+	}
+
+	if(cache.reuse(output, entry))
+	{
+		return true;
+	}
+
+	if(!compile<T>(absolute_meta_key, output))
+	{
+		return false;
+	}
+
+	cache.record(output, entry);
+	return true;
+}
 };
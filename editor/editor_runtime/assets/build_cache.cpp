@@ -0,0 +1,262 @@
+#include "build_cache.h"
+#include "asset_compiler.h"
+#include "../meta/assets/build_cache.hpp"
+
+#include <core/common/hash.hpp>
+#include <core/logging/logging.h>
+#include <core/serialization/binary_archive.h>
+#include <core/serialization/types/string.hpp>
+#include <core/serialization/types/unordered_map.hpp>
+
+#include <array>
+#include <fstream>
+
+namespace asset_compiler
+{
+namespace
+{
+std::uint64_t hash_combine(std::uint64_t hash, std::uint64_t value)
+{
+	return utils::fnv1a(&value, sizeof(value), hash);
+}
+
+build_cache::file_stamp get_stamp(const fs::path& file, const build_cache::file_stamp* recorded)
+{
+	build_cache::file_stamp stamp;
+	fs::error_code err;
+	stamp.size = fs::file_size(file, err);
+	if(err)
+	{
+		return {};
+	}
+	stamp.time = fs::last_write_time(file, err).time_since_epoch().count();
+
+	if(recorded != nullptr && recorded->size == stamp.size && recorded->time == stamp.time)
+	{
+		stamp.hash = recorded->hash;
+		return stamp;
+	}
+
+	std::ifstream stream(file.string(), std::ios::in | std::ios::binary);
+	std::array<char, 64 * 1024> buffer;
+	stamp.hash = utils::fnv1a_offset;
+	while(stream.read(buffer.data(), std::streamsize(buffer.size())) || stream.gcount() > 0)
+	{
+		stamp.hash = utils::fnv1a(buffer.data(), std::size_t(stream.gcount()), stamp.hash);
+	}
+	return stamp;
+}
+}
+
+void build_cache::load(const fs::path& db_path)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	db_path_ = db_path;
+	entries_.clear();
+	outputs_.clear();
+	dirty_ = false;
+
+	std::ifstream stream(db_path_.string(), std::ios::in | std::ios::binary);
+	if(!stream.good())
+	{
+		return;
+	}
+
+	cereal::iarchive_binary_t ar(stream);
+	if(!try_load(ar, cereal::make_nvp("entries", entries_)))
+	{
+		APPLOG_WARNING("Discarding unreadable build cache {0}", db_path_.string());
+		entries_.clear();
+	}
+
+	for(const auto& kvp : entries_)
+	{
+		outputs_[kvp.second.key] = kvp.first;
+	}
+}
+
+void build_cache::save()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	if(!dirty_ || db_path_.empty())
+	{
+		return;
+	}
+
+	std::ofstream stream(db_path_.string(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if(!stream.good())
+	{
+		APPLOG_ERROR("Cant write build cache {0}", db_path_.string());
+		return;
+	}
+
+	cereal::oarchive_binary_t ar(stream);
+	try_save(ar, cereal::make_nvp("entries", entries_));
+	dirty_ = false;
+}
+
+build_cache::entry build_cache::make_entry(const fs::path& output, const fs::path& source,
+										   const fs::path& meta,
+										   const std::vector<std::string>& tool_args) const
+{
+	entry recorded;
+	bool has_recorded = false;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = entries_.find(get_output_key(output));
+		if(it != entries_.end())
+		{
+			recorded = it->second;
+			has_recorded = true;
+		}
+	}
+
+	// reading the files happens outside the lock, builds hash in parallel
+	entry e;
+	e.source = get_stamp(source, has_recorded ? &recorded.source : nullptr);
+	e.meta = get_stamp(meta, has_recorded ? &recorded.meta : nullptr);
+
+	e.key = hash_combine(utils::fnv1a_offset, version);
+	e.key = hash_combine(e.key, e.source.hash);
+	e.key = hash_combine(e.key, e.meta.hash);
+	for(const auto& arg : tool_args)
+	{
+		e.key = utils::fnv1a(arg.data(), arg.size() + 1, e.key);
+	}
+	return e;
+}
+
+bool build_cache::is_up_to_date(const fs::path& output, const entry& e, bool adopt_unknown)
+{
+	fs::error_code err;
+	if(!fs::exists(output, err))
+	{
+		return false;
+	}
+
+	const auto output_key = get_output_key(output);
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto it = entries_.find(output_key);
+	if(it != entries_.end())
+	{
+		if(it->second.key != e.key)
+		{
+			return false;
+		}
+		// keep the stamps of a touched but unchanged source so it isn't hashed again
+		if(it->second.source.time != e.source.time || it->second.meta.time != e.meta.time)
+		{
+			set_entry(output_key, e);
+		}
+		return true;
+	}
+
+	if(!adopt_unknown)
+	{
+		return false;
+	}
+
+	const auto output_time = fs::last_write_time(output, err).time_since_epoch().count();
+	if(err || output_time < e.source.time)
+	{
+		return false;
+	}
+
+	set_entry(output_key, e);
+	return true;
+}
+
+bool build_cache::reuse(const fs::path& output, const entry& e)
+{
+	const auto output_key = get_output_key(output);
+	std::string built_key;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = outputs_.find(e.key);
+		if(it == outputs_.end() || it->second == output_key)
+		{
+			return false;
+		}
+		built_key = it->second;
+	}
+
+	fs::error_code err;
+	const auto built = fs::resolve_protocol(built_key);
+	if(!fs::exists(built, err) || !fs::copy_file(built, output, fs::copy_options::overwrite_existing, err))
+	{
+		return false;
+	}
+
+	record(output, e);
+	APPLOG_INFO("Reused {0} for {1}", built_key, output_key);
+	return true;
+}
+
+void build_cache::record(const fs::path& output, const entry& e)
+{
+	const auto output_key = get_output_key(output);
+	std::lock_guard<std::mutex> lock(mutex_);
+	set_entry(output_key, e);
+}
+
+void build_cache::remove(const fs::path& output)
+{
+	const auto output_key = get_output_key(output);
+	std::lock_guard<std::mutex> lock(mutex_);
+	erase_entry(output_key);
+}
+
+void build_cache::rename(const fs::path& old_output, const fs::path& new_output)
+{
+	const auto old_key = get_output_key(old_output);
+	const auto new_key = get_output_key(new_output);
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto it = entries_.find(old_key);
+	if(it == entries_.end())
+	{
+		return;
+	}
+
+	const auto e = it->second;
+	erase_entry(old_key);
+	set_entry(new_key, e);
+}
+
+std::string build_cache::get_output_key(const fs::path& output) const
+{
+	return fs::convert_to_protocol(output).generic_string();
+}
+
+void build_cache::set_entry(const std::string& output_key, const entry& e)
+{
+	auto& recorded = entries_[output_key];
+	if(recorded.key != e.key)
+	{
+		auto it = outputs_.find(recorded.key);
+		if(it != outputs_.end() && it->second == output_key)
+		{
+			outputs_.erase(it);
+		}
+	}
+	recorded = e;
+	outputs_[e.key] = output_key;
+	dirty_ = true;
+}
+
+void build_cache::erase_entry(const std::string& output_key)
+{
+	auto it = entries_.find(output_key);
+	if(it == entries_.end())
+	{
+		return;
+	}
+
+	auto output = outputs_.find(it->second.key);
+	if(output != outputs_.end() && output->second == output_key)
+	{
+		outputs_.erase(output);
+	}
+	entries_.erase(it);
+	dirty_ = true;
+}
+}
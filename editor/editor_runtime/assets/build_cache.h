@@ -0,0 +1,146 @@
+#pragma once
+#include <core/filesystem/filesystem.h>
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace asset_compiler
+{
+//-----------------------------------------------------------------------------
+// Main Class Declarations
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//  Name : build_cache (Class)
+/// <summary>
+/// Persistent record of what every compiled asset was built from. Each output
+/// is stored with a key made of the content hashes of its source and .meta
+/// files, the compiler version and the tool arguments. An output whose key
+/// still matches is up to date no matter how often its source was touched,
+/// and an output for a key that was already built elsewhere (a renamed or
+/// copied source) is reused instead of compiled again.
+/// </summary>
+//-----------------------------------------------------------------------------
+class build_cache
+{
+public:
+	struct file_stamp
+	{
+		/// Size and write time the hash was taken at.
+		std::uint64_t size = 0;
+		std::int64_t time = 0;
+		/// Content hash of the file.
+		std::uint64_t hash = 0;
+	};
+
+	struct entry
+	{
+		/// Combined hash of everything the output is built from.
+		std::uint64_t key = 0;
+		file_stamp source;
+		file_stamp meta;
+	};
+
+	using entries_t = std::unordered_map<std::string, entry>;
+
+	//-----------------------------------------------------------------------------
+	//  Name : load ()
+	/// <summary>
+	/// Loads the database stored at the path, which is also where save writes
+	/// to. A missing or unreadable database leaves the cache empty.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void load(const fs::path& db_path);
+
+	//-----------------------------------------------------------------------------
+	//  Name : save ()
+	/// <summary>
+	/// Writes the database back if it changed since it was loaded.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void save();
+
+	//-----------------------------------------------------------------------------
+	//  Name : make_entry ()
+	/// <summary>
+	/// Hashes the inputs of an output. Files whose size and write time match
+	/// the recorded stamps keep their recorded hash and are not read again.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	entry make_entry(const fs::path& output, const fs::path& source, const fs::path& meta,
+					 const std::vector<std::string>& tool_args) const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : is_up_to_date ()
+	/// <summary>
+	/// Checks whether the output exists and was built from the inputs of the
+	/// entry. An output the database does not know yet is adopted when
+	/// adopt_unknown is set and it is newer than its source, so an existing
+	/// cache isn't rebuilt from scratch the first time.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool is_up_to_date(const fs::path& output, const entry& e, bool adopt_unknown);
+
+	//-----------------------------------------------------------------------------
+	//  Name : reuse ()
+	/// <summary>
+	/// Copies a still existing output built with the same key over the output
+	/// and records it. Returns false when there is none.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool reuse(const fs::path& output, const entry& e);
+
+	//-----------------------------------------------------------------------------
+	//  Name : record ()
+	/// <summary>
+	/// Records a successful build of the output.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void record(const fs::path& output, const entry& e);
+
+	//-----------------------------------------------------------------------------
+	//  Name : remove ()
+	/// <summary>
+	/// Forgets the output.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void remove(const fs::path& output);
+
+	//-----------------------------------------------------------------------------
+	//  Name : rename ()
+	/// <summary>
+	/// Moves the record of an output along with the output itself.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void rename(const fs::path& old_output, const fs::path& new_output);
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_entries ()
+	/// <summary>
+	/// Recorded outputs by their protocol path.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	const entries_t& get_entries() const
+	{
+		return entries_;
+	}
+
+private:
+	std::string get_output_key(const fs::path& output) const;
+	void set_entry(const std::string& output_key, const entry& e);
+	void erase_entry(const std::string& output_key);
+
+	/// Where the database is stored.
+	fs::path db_path_;
+	/// Recorded outputs by their protocol path.
+	entries_t entries_;
+	/// Outputs by the key they were built with.
+	std::unordered_map<std::uint64_t, std::string> outputs_;
+	/// Whether the entries changed since the last load or save.
+	bool dirty_ = false;
+	/// Builds run on worker threads.
+	mutable std::mutex mutex_;
+};
+}
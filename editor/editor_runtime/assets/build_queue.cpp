@@ -0,0 +1,182 @@
+#include "build_queue.h"
+
+#include <core/logging/logging.h>
+
+#include <algorithm>
+
+namespace asset_compiler
+{
+build_queue::build_queue(core::task_system& ts)
+	: ts_(ts)
+	, max_running_(std::max<std::size_t>(1, ts.get_threads_count() / 2))
+{
+}
+
+build_queue::~build_queue()
+{
+	clear();
+}
+
+void build_queue::push(const std::string& key, job_t job)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto it = pending_.find(key);
+	if(it != pending_.end())
+	{
+		it->second.job = std::move(job);
+		return;
+	}
+
+	if(pending_.empty() && running_.empty())
+	{
+		started_ = std::chrono::steady_clock::now();
+		completed_ = 0;
+	}
+
+	const bool requested = requested_.erase(key) > 0;
+	const rank_t rank = {!requested, pushed_++};
+	pending_.emplace(key, entry{std::move(job), rank});
+	order_.emplace(rank, key);
+
+	dispatch();
+}
+
+void build_queue::prioritize(const std::string& key)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto it = pending_.find(key);
+	if(it == pending_.end())
+	{
+		// only remembered while there is work, loads in between builds find their assets
+		if(!running_.empty())
+		{
+			requested_.insert(key);
+		}
+		return;
+	}
+
+	auto& rank = it->second.rank;
+	if(rank.first)
+	{
+		order_.erase(rank);
+		rank.first = false;
+		order_.emplace(rank, key);
+	}
+}
+
+void build_queue::set_max_running(std::size_t count)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	max_running_ = std::max<std::size_t>(1, count);
+	dispatch();
+}
+
+std::size_t build_queue::get_max_running() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return max_running_;
+}
+
+void build_queue::clear()
+{
+	clear("");
+}
+
+void build_queue::clear(const std::string& group)
+{
+	const auto in_group = [&group](const std::string& key) {
+		return key.compare(0, group.size(), group) == 0;
+	};
+
+	std::unique_lock<std::mutex> lock(mutex_);
+	for(auto it = order_.begin(); it != order_.end();)
+	{
+		if(in_group(it->second))
+		{
+			pending_.erase(it->second);
+			it = order_.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	idle_.wait(lock, [this, &in_group]() {
+		return std::none_of(std::begin(running_), std::end(running_), in_group);
+	});
+}
+
+void build_queue::wait()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	idle_.wait(lock, [this]() { return pending_.empty() && running_.empty(); });
+}
+
+build_queue::info build_queue::get_info() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	info result;
+	result.pending = pending_.size();
+	result.running = running_.size();
+	result.completed = completed_;
+	if(result.pending + result.running == 0)
+	{
+		return result;
+	}
+
+	const auto elapsed = seconds_t(std::chrono::steady_clock::now() - started_).count();
+	if(completed_ > 0 && elapsed > 0.0f)
+	{
+		result.throughput = float(completed_) / elapsed;
+		result.eta = seconds_t(float(result.pending + result.running) / result.throughput);
+	}
+	return result;
+}
+
+void build_queue::dispatch()
+{
+	auto it = order_.begin();
+	while(running_.size() < max_running_ && it != order_.end())
+	{
+		// a source is never built twice at once, a newer build waits for the running one
+		const auto key = it->second;
+		if(running_.count(key) > 0)
+		{
+			++it;
+			continue;
+		}
+
+		auto pending = pending_.find(key);
+		auto job = std::move(pending->second.job);
+		pending_.erase(pending);
+		it = order_.erase(it);
+		running_.insert(key);
+
+		ts_.push_on_worker_thread([this, key, job = std::move(job)]() { run(key, job); });
+	}
+}
+
+void build_queue::run(const std::string& key, const job_t& job)
+{
+	try
+	{
+		job();
+	}
+	catch(const std::exception& e)
+	{
+		APPLOG_ERROR("Failed build of {0} with error : {1}", key, e.what());
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	running_.erase(key);
+	++completed_;
+	dispatch();
+
+	if(running_.empty())
+	{
+		requested_.clear();
+	}
+	idle_.notify_all();
+}
+}
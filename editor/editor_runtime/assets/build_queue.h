@@ -0,0 +1,156 @@
+#pragma once
+
+#include <core/tasks/task_system.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace asset_compiler
+{
+//-----------------------------------------------------------------------------
+// Main Class Declarations
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//  Name : build_queue (Class)
+/// <summary>
+/// Schedules asset builds on the worker threads. Only a limited number of
+/// builds run at once, so the external compilers they start don't crowd out
+/// the other tasks. Builds are keyed by their source, a build pushed again
+/// while it waits replaces the waiting one, and sources the asset manager
+/// was asked for go ahead of the rest.
+/// </summary>
+//-----------------------------------------------------------------------------
+class build_queue
+{
+public:
+	using job_t = std::function<void()>;
+	using seconds_t = std::chrono::duration<float>;
+
+	struct info
+	{
+		/// Builds waiting for a free slot.
+		std::size_t pending = 0;
+		/// Builds in progress.
+		std::size_t running = 0;
+		/// Builds finished since the queue last ran dry.
+		std::size_t completed = 0;
+		/// Finished builds per second since the queue last ran dry.
+		float throughput = 0.0f;
+		/// Estimated time until the queue runs dry.
+		seconds_t eta = seconds_t(0);
+	};
+
+	build_queue(core::task_system& ts);
+	~build_queue();
+
+	//-----------------------------------------------------------------------------
+	//  Name : push ()
+	/// <summary>
+	/// Queues the build of a source, keyed by its protocol path. A build of
+	/// the same source already waiting is replaced, one already running is
+	/// followed by this one.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void push(const std::string& key, job_t job);
+
+	//-----------------------------------------------------------------------------
+	//  Name : prioritize ()
+	/// <summary>
+	/// Moves the build of the source ahead of the others. A source that isn't
+	/// queued yet is remembered and prioritized once it is.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void prioritize(const std::string& key);
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_max_running ()
+	/// <summary>
+	/// Sets how many builds may run at once, at least one.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_max_running(std::size_t count);
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_max_running ()
+	/// <summary>
+	/// How many builds may run at once.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::size_t get_max_running() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : clear ()
+	/// <summary>
+	/// Drops the waiting builds and blocks until the running ones are done.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void clear();
+
+	//-----------------------------------------------------------------------------
+	//  Name : clear ()
+	/// <summary>
+	/// Drops the waiting builds of the sources in the group, a protocol like
+	/// "app:/", and blocks until its running ones are done.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void clear(const std::string& group);
+
+	//-----------------------------------------------------------------------------
+	//  Name : wait ()
+	/// <summary>
+	/// Blocks until every queued build is done.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void wait();
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_info ()
+	/// <summary>
+	/// Queue depth and progress, for display.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	info get_info() const;
+
+private:
+	/// Requested sources first, then in the order they were pushed.
+	using rank_t = std::pair<bool, std::uint64_t>;
+
+	struct entry
+	{
+		job_t job;
+		/// Whether the source wasn't requested, and when it was pushed.
+		rank_t rank;
+	};
+
+	/// Starts waiting builds while there are free slots, expects the lock held.
+	void dispatch();
+	void run(const std::string& key, const job_t& job);
+
+	/// Where the builds run.
+	core::task_system& ts_;
+	mutable std::mutex mutex_;
+	std::condition_variable idle_;
+	/// Waiting builds by source.
+	std::unordered_map<std::string, entry> pending_;
+	/// Waiting sources in the order they start in.
+	std::map<rank_t, std::string> order_;
+	/// Sources being built.
+	std::unordered_set<std::string> running_;
+	/// Requested sources without a waiting build, forgotten when the queue
+	/// runs dry.
+	std::unordered_set<std::string> requested_;
+	std::uint64_t pushed_ = 0;
+	std::size_t max_running_ = 1;
+
+	/// Progress since the queue last ran dry.
+	std::chrono::steady_clock::time_point started_;
+	std::size_t completed_ = 0;
+};
+}
@@ -246,7 +246,8 @@ void process_animation(const aiAnimation* assimp_anim, runtime::animation& anim)
 
 	auto ticks = assimp_anim->mDuration;
 
-	anim.duration = decltype(anim.duration)(ticks * ticks_per_second);
+	// assimp keys are in ticks, the runtime works in seconds
+	anim.duration = decltype(anim.duration)(ticks / ticks_per_second);
 
 	if(assimp_anim->mNumChannels > 0)
 	{
@@ -268,7 +269,7 @@ void process_animation(const aiAnimation* assimp_anim, runtime::animation& anim)
 		{
 			const auto& anim_key = assimp_node_anim->mPositionKeys[idx];
 			auto& key = node_anim.position_keys[idx];
-			key.time = decltype(key.time)(anim_key.mTime);
+			key.time = decltype(key.time)(anim_key.mTime / ticks_per_second);
 			key.value.x = anim_key.mValue.x;
 			key.value.y = anim_key.mValue.y;
 			key.value.z = anim_key.mValue.z;
@@ -283,7 +284,7 @@ void process_animation(const aiAnimation* assimp_anim, runtime::animation& anim)
 		{
 			const auto& anim_key = assimp_node_anim->mRotationKeys[idx];
 			auto& key = node_anim.rotation_keys[idx];
-			key.time = decltype(key.time)(anim_key.mTime);
+			key.time = decltype(key.time)(anim_key.mTime / ticks_per_second);
 			key.value.x = anim_key.mValue.x;
 			key.value.y = anim_key.mValue.y;
 			key.value.z = anim_key.mValue.z;
@@ -299,7 +300,7 @@ void process_animation(const aiAnimation* assimp_anim, runtime::animation& anim)
 		{
 			const auto& anim_key = assimp_node_anim->mScalingKeys[idx];
 			auto& key = node_anim.scaling_keys[idx];
-			key.time = decltype(key.time)(anim_key.mTime);
+			key.time = decltype(key.time)(anim_key.mTime / ticks_per_second);
 			key.value.x = anim_key.mValue.x;
 			key.value.y = anim_key.mValue.y;
 			key.value.z = anim_key.mValue.z;
@@ -98,7 +98,8 @@ static context_action check_context_menu(EntityType entity)
 			if(gui::MenuItem("CREATE CHILD"))
 			{
 				auto object = factory.create();
-				// object.assign<transform_component>().lock()->set_parent(entity);
+				ecs.assign<transform_component>(object);
+				core::get_subsystem<runtime::scene_graph>().set_parent(object, entity);
 			}
 
 			if(gui::MenuItem("RENAME", "F2"))
@@ -109,12 +110,6 @@ static context_action check_context_menu(EntityType entity)
 			if(gui::MenuItem("DUPLICATE", "CTRL + D"))
 			{
 				EntityType object = ecs::utils::clone_entity(entity);
-				// auto obj_trans_comp = object.get_component<transform_component>().lock();
-				// auto ent_trans_comp = entity.get_component<transform_component>().lock();
-				// if(obj_trans_comp && ent_trans_comp)
-				// {
-				// 	obj_trans_comp->set_parent(ent_trans_comp->get_parent(), false, true);
-				// }
 				es.select_ent(object);
 			}
 
@@ -333,10 +328,10 @@ static void process_drag_drop_target(EntityType entity)
 					// auto dropped_entity = ecs.get(eid);
 					// if(dropped_entity)
 					// {
-					if(ecs.has<transform_component>(dropped_entity))
+					if(ecs.has<Relation>(dropped_entity))
 					{
-						auto& trans_comp = ecs.get<transform_component>(dropped_entity);
-						// trans_comp.set_parent(entity);
+						// dropping on the empty area makes a root, loops are refused
+						core::get_subsystem<runtime::scene_graph>().set_parent(dropped_entity, entity);
 					}
 					// }
 				}
@@ -363,12 +358,14 @@ static void process_drag_drop_target(EntityType entity)
 				if(entry)
 				{
 					auto object = entry->instantiate();
-					auto& trans_comp = ecs.get<transform_component>(object);
-					// if(trans_comp)
-					// {
-					// 	trans_comp->set_parent(entity);
-					// }
-					es.select_ent(object);
+					if(ecs.valid(object))
+					{
+						if(entity != entt::null)
+						{
+							core::get_subsystem<runtime::scene_graph>().set_parent(object, entity);
+						}
+						es.select_ent(object);
+					}
 				}
 			}
 		}
@@ -471,12 +468,8 @@ void hierarchy_dock::draw_entity(EntityType entity)
 			}
 		}
 	}
-	auto& trans_comp = ecs.get<transform_component>(entity);
-	bool no_children = true;
-	// if(trans_comp)
-	// {
-		// no_children = trans_comp->get_children().empty();
-	// }
+	auto& sg = core::get_subsystem<runtime::scene_graph>();
+	bool no_children = !sg.has_children(entity);
 
 	if(no_children)
 	{
@@ -565,14 +558,7 @@ void hierarchy_dock::draw_entity(EntityType entity)
 	{
 		if(!no_children)
 		{
-			// const auto& children = trans_comp->get_children();
-			// for(auto& child : children)
-			// {
-			// 	if(child.valid())
-			// 	{
-			// 		draw_entity(child);
-			// 	}
-			// }
+			sg.for_each_child(entity, [this](EntityType child) { draw_entity(child); });
 		}
 
 		gui::TreePop();
@@ -589,7 +575,6 @@ void hierarchy_dock::render(const ImVec2& /*unused*/)
 	auto& sg = core::get_subsystem<runtime::scene_graph>();
 	auto& input = core::get_subsystem<runtime::input>();
 
-	auto& roots = sg.get_roots();
 	auto& editor_camera = es.camera;
 	// auto& selected = es.selection_data.object;
 	bool selected = es.selection_data.is_ent_selected();
@@ -627,12 +612,6 @@ void hierarchy_dock::render(const ImVec2& /*unused*/)
 					if(selected_id != editor_camera)
 					{
 						auto clone = ecs::utils::clone_entity(selected_id);
-						auto clone_trans_comp = ecs.get<transform_component>(clone);
-						auto sel_trans_comp = ecs.get<transform_component>(selected_id);
-						// if(clone_trans_comp && sel_trans_comp)
-						// {
-						// 	clone_trans_comp->set_parent(sel_trans_comp->get_parent(), false, true);
-						// }
 						es.select_ent(clone);
 					}
 				}
@@ -661,8 +640,7 @@ void hierarchy_dock::render(const ImVec2& /*unused*/)
 			gui::Separator();
 		}
 
-		for(auto& root : roots)
-		{
+		sg.for_each_root([&](EntityType root) {
 			if(ecs.valid(root))
 			{
 				if(root != editor_camera)
@@ -670,10 +648,10 @@ void hierarchy_dock::render(const ImVec2& /*unused*/)
 					draw_entity(root);
 				}
 			}
-		}
+		});
 	}
 	gui::EndChild();
-	process_drag_drop_target({});
+	process_drag_drop_target(entt::null);
 }
 
 hierarchy_dock::hierarchy_dock(const std::string& dtitle, bool close_button, const ImVec2& min_size)
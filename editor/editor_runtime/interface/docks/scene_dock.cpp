@@ -16,6 +16,8 @@
 #include <runtime/ecs/components/relation.h>
 #include <runtime/ecs/constructs/prefab.h>
 #include <runtime/ecs/constructs/utils.h>
+#include <runtime/ecs/systems/audio_system.h>
+#include <runtime/ecs/systems/deferred_rendering.h>
 #include <runtime/input/input.h>
 #include <runtime/rendering/camera.h>
 #include <runtime/rendering/mesh/mesh.h>
@@ -115,6 +117,20 @@ void scene_dock::show_statistics(const ImVec2& area, unsigned int fps, bool& sho
 				gui::Text("Texture mem: %s / %s", tmp3, tmp0);
 			}
 
+			const auto& rendering = core::get_subsystem<runtime::deferred_rendering>();
+			const auto& graph_report = rendering.get_memory_report();
+			const auto pool_stats = rendering.get_transient_pool_stats();
+			char requested[64];
+			bx::prettify(requested, 64, uint64_t(graph_report.requested_bytes));
+			char allocated[64];
+			bx::prettify(allocated, 64, uint64_t(graph_report.allocated_bytes));
+			char pooled[64];
+			bx::prettify(pooled, 64, uint64_t(pool_stats.texture_bytes));
+			gui::Text("Transient targets: %s aliased to %s", requested, allocated);
+			gui::Text("Transient pool: %u targets, %s", unsigned(pool_stats.texture_count), pooled);
+			gui::Text("Frame graph passes: %u (%u culled)", unsigned(graph_report.pass_count),
+					  unsigned(graph_report.culled_pass_count));
+
 			gui::Separator();
 
 			const auto& gui_sys = core::get_subsystem<gui_system>();
@@ -128,6 +144,19 @@ void scene_dock::show_statistics(const ImVec2& area, unsigned int fps, bool& sho
 			gui::Text("Scene Draw Calls: %u", math::abs<std::uint32_t>(stats->numDraw - ui_draw_calls));
 			gui::PopFont();
 		}
+		if(gui::CollapsingHeader(ICON_FA_VOLUME_UP "\tAudio"))
+		{
+			gui::PushFont("default");
+
+			auto& audio = core::get_subsystem<runtime::audio_system>();
+			const auto& voices = audio.get_voice_stats();
+			gui::Text("Voices: %u (%u playing)", unsigned(voices.voices), unsigned(voices.playing));
+			gui::Text("Real: %u / %u, Virtual: %u", unsigned(voices.real),
+					  unsigned(audio.get_voice_manager().get_max_voices()), unsigned(voices.virtual_voices));
+			gui::Text("Steals: %u (%llu total)", unsigned(voices.steals),
+					  static_cast<unsigned long long>(voices.total_steals));
+			gui::PopFont();
+		}
 		if(gui::CollapsingHeader(ICON_FA_PUZZLE_PIECE "\tResources"))
 		{
 			const auto caps = gfx::get_caps();
@@ -619,7 +648,7 @@ static void process_drag_drop_target(camera_component& camera_comp){
 				if(entry)
 				{
 					auto object = entry->instantiate();
-					if(ecs.has<transform_component>(object))
+					if(ecs.valid(object) && ecs.has<transform_component>(object))
 					{
 						auto& trans_comp = ecs.get<transform_component>(object);
 						math::vec3 projected_pos;
@@ -728,6 +757,7 @@ void scene_dock::render(const ImVec2& area)
 
 		const auto& camera = camera_comp.get_camera();
 		auto& render_view = camera_comp.get_render_view();
+		render_view.set_retain_g_buffer(show_gbuffer);
 		const auto& viewport_size = camera.get_viewport_size();
 		const auto surface = render_view.get_output_fbo(viewport_size);
 		auto tex = surface->get_attachment(0).texture;
@@ -0,0 +1,38 @@
+#include "build_cache.hpp"
+
+#include <core/serialization/binary_archive.h>
+
+namespace asset_compiler
+{
+SAVE(build_cache::file_stamp)
+{
+	try_save(ar, cereal::make_nvp("size", obj.size));
+	try_save(ar, cereal::make_nvp("time", obj.time));
+	try_save(ar, cereal::make_nvp("hash", obj.hash));
+}
+SAVE_INSTANTIATE(build_cache::file_stamp, cereal::oarchive_binary_t);
+
+LOAD(build_cache::file_stamp)
+{
+	try_load(ar, cereal::make_nvp("size", obj.size));
+	try_load(ar, cereal::make_nvp("time", obj.time));
+	try_load(ar, cereal::make_nvp("hash", obj.hash));
+}
+LOAD_INSTANTIATE(build_cache::file_stamp, cereal::iarchive_binary_t);
+
+SAVE(build_cache::entry)
+{
+	try_save(ar, cereal::make_nvp("key", obj.key));
+	try_save(ar, cereal::make_nvp("source", obj.source));
+	try_save(ar, cereal::make_nvp("meta", obj.meta));
+}
+SAVE_INSTANTIATE(build_cache::entry, cereal::oarchive_binary_t);
+
+LOAD(build_cache::entry)
+{
+	try_load(ar, cereal::make_nvp("key", obj.key));
+	try_load(ar, cereal::make_nvp("source", obj.source));
+	try_load(ar, cereal::make_nvp("meta", obj.meta));
+}
+LOAD_INSTANTIATE(build_cache::entry, cereal::iarchive_binary_t);
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "../../assets/build_cache.h"
+
+#include <core/serialization/serialization.h>
+
+namespace asset_compiler
+{
+SAVE_EXTERN(build_cache::file_stamp);
+LOAD_EXTERN(build_cache::file_stamp);
+SAVE_EXTERN(build_cache::entry);
+LOAD_EXTERN(build_cache::entry);
+}
@@ -9,12 +9,14 @@ namespace editor
 SAVE(project_manager::options)
 {
 	try_save(ar, cereal::make_nvp("recent_projects", obj.recent_project_paths));
+	try_save(ar, cereal::make_nvp("build_jobs", obj.build_jobs));
 }
 SAVE_INSTANTIATE(project_manager::options, cereal::oarchive_associative_t);
 
 LOAD(project_manager::options)
 {
 	try_load(ar, cereal::make_nvp("recent_projects", obj.recent_project_paths));
+	try_load(ar, cereal::make_nvp("build_jobs", obj.build_jobs));
 }
 LOAD_INSTANTIATE(project_manager::options, cereal::iarchive_associative_t);
 }
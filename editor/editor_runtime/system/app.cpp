@@ -16,6 +16,7 @@
 
 #include <core/filesystem/filesystem.h>
 #include <core/logging/logging.h>
+#include <core/profiling/profiler.h>
 
 #include <runtime/assets/asset_manager.h>
 #include <runtime/ecs/components/camera_component.h>
@@ -30,6 +31,7 @@
 #include <runtime/input/input.h>
 #include <runtime/rendering/renderer.h>
 #include <runtime/system/events.h>
+#include <runtime/system/system_scheduler.h>
 
 #include <editor_core/nativefd/filedialog.h>
 
@@ -61,15 +63,14 @@ std::vector<EntityType> gather_scene_data()
 	auto& ecs = core::get_subsystem<SpatialSystem>();
 	auto& es = core::get_subsystem<editor::editing_system>();
 	auto& sg = core::get_subsystem<runtime::scene_graph>();
-	const auto& roots = sg.get_roots();
 	auto editor_camera = es.camera;
 	std::vector<EntityType> entities;
-	for(auto root : roots)
-	{
+	sg.for_each_root([&](EntityType root) {
 		if (ecs.valid(root) && root != editor_camera) {
 			entities.push_back(root);
+			sg.for_each_descendant(root, [&entities](EntityType child) { entities.push_back(child); });
 		}
-	}
+	});
 
 	return entities;
 }
@@ -508,6 +509,34 @@ void app::register_console_commands()
 	std::function<void()> log_version = []() { APPLOG_INFO("Version 1.0"); };
 	console_log_->register_command("version", "Returns the current version of the Editor.", {}, {},
 								   log_version);
+
+	std::function<void()> log_schedule = []() {
+		APPLOG_INFO(core::get_subsystem<runtime::system_scheduler>().get_schedule_dump());
+	};
+	console_log_->register_command("schedule", "Logs the system schedule and timings of the last frame.",
+								   {}, {}, log_schedule);
+
+	std::function<void(int)> enable_profiler = [](int enabled) {
+		profiling::set_enabled(enabled != 0);
+		APPLOG_INFO("Profiler {0}", enabled != 0 ? "enabled" : "disabled");
+	};
+	console_log_->register_command("profiler", "Starts or stops recording the frame profile.", {"enabled"},
+								   {"1"}, enable_profiler);
+
+	std::function<void(std::string)> save_profile = [](const std::string& path) {
+		std::string err;
+		if(profiling::save_chrome_trace(path, err))
+		{
+			APPLOG_INFO("Saved the last {0} frames to {1}", profiling::get_frames().size(), path);
+		}
+		else
+		{
+			APPLOG_ERROR("Could not save the profile : {0}", err);
+		}
+	};
+	console_log_->register_command("profile",
+								   "Saves the last frames the profiler recorded as a chrome://tracing file.",
+								   {"path"}, {"profile.json"}, save_profile);
 }
 
 void app::stop()
@@ -586,6 +615,8 @@ void app::draw_footer(render_window&, imguidock::dockspace& dockspace)
 	auto& ts = core::get_subsystem<core::task_system>();
 	const auto tasks_info = ts.get_info();
 	const auto items = console_log_->get_items();
+	auto& pm = core::get_subsystem<editor::project_manager>();
+	const auto build_info = pm.get_build_queue().get_info();
 
 	const auto total_width = gui::GetContentRegionAvailWidth();
 	gui::BeginColumns("footer", 2, ImGuiColumnsFlags_NoBorder | ImGuiColumnsFlags_NoResize);
@@ -607,6 +638,30 @@ void app::draw_footer(render_window&, imguidock::dockspace& dockspace)
 		gui::PopStyleColor();
 	}
 	gui::NextColumn();
+	const auto builds = build_info.pending + build_info.running;
+	if(builds > 0)
+	{
+		gui::PushFont("icons");
+		gui::AlignTextToFramePadding();
+		gui::Text(ICON_FA_COGS " Compiling assets : (%u)", unsigned(builds));
+		auto& g = *gui::GetCurrentContext();
+		if(!g.DragDropActive && gui::IsItemHovered())
+		{
+			gui::BeginTooltip();
+			gui::AlignTextToFramePadding();
+			gui::Text("RUNNING : %u", unsigned(build_info.running));
+			gui::Text("WAITING : %u", unsigned(build_info.pending));
+			gui::Text("DONE : %u (%.1f/s)", unsigned(build_info.completed), double(build_info.throughput));
+			if(build_info.throughput > 0.0f)
+			{
+				gui::Text("ETA : %.0fs", double(build_info.eta.count()));
+			}
+			gui::EndTooltip();
+		}
+
+		gui::PopFont();
+		gui::SameLine();
+	}
 	if(tasks_info.pending_tasks > 0)
 	{
 		gui::PushFont("icons");
@@ -85,22 +85,24 @@ static std::uint64_t watch_assets(const fs::path& dir, const std::string& wildca
 		});
 }
 
+static std::string get_source_key(const fs::path& ref_path)
+{
+	return fs::convert_to_protocol(asset_compiler::get_source_path(ref_path)).generic_string();
+}
+
 template <typename T>
-static void add_to_syncer(std::vector<uint64_t>& watchers, fs::syncer& syncer, const fs::path& dir,
-						  const fs::syncer::on_entry_removed_t& on_removed,
+static void add_to_syncer(std::vector<uint64_t>& watchers, fs::syncer& syncer,
+						  asset_compiler::build_queue& queue, asset_compiler::build_cache& cache,
+						  const fs::path& dir, const fs::syncer::on_entry_removed_t& on_removed,
 						  const fs::syncer::on_entry_renamed_t& on_renamed)
 {
-	auto& ts = core::get_subsystem<core::task_system>();
-	auto on_modified = [&ts](const auto& ref_path, const auto& synced_paths, bool is_initial_listing) {
-		auto task = ts.push_on_worker_thread(
-			[ref_path, synced_paths = remove_meta_tag(synced_paths), is_initial_listing]() {
+	auto on_modified = [&queue, &cache](const auto& ref_path, const auto& synced_paths,
+										bool is_initial_listing) {
+		queue.push(
+			get_source_key(ref_path),
+			[ref_path, synced_paths = remove_meta_tag(synced_paths), is_initial_listing, &cache]() {
 				fs::path output = synced_paths.front();
-				fs::error_code err;
-				if(is_initial_listing && fs::exists(output, err))
-				{
-					return;
-				}
-				asset_compiler::compile<T>(ref_path, output);
+				asset_compiler::build<T>(cache, ref_path, output, is_initial_listing);
 			});
 	};
 
@@ -113,15 +115,16 @@ static void add_to_syncer(std::vector<uint64_t>& watchers, fs::syncer& syncer, c
 }
 
 template <>
-void add_to_syncer<gfx::shader>(std::vector<uint64_t>& watchers, fs::syncer& syncer, const fs::path& dir,
-								const fs::syncer::on_entry_removed_t& on_removed,
+void add_to_syncer<gfx::shader>(std::vector<uint64_t>& watchers, fs::syncer& syncer,
+								asset_compiler::build_queue& queue, asset_compiler::build_cache& cache,
+								const fs::path& dir, const fs::syncer::on_entry_removed_t& on_removed,
 								const fs::syncer::on_entry_renamed_t& on_renamed)
 {
-	auto& ts = core::get_subsystem<core::task_system>();
-
-	auto on_modified = [&ts](const auto& ref_path, const auto& synced_paths, bool is_initial_listing) {
-		auto task = ts.push_on_worker_thread(
-			[ref_path, synced_paths = remove_meta_tag(synced_paths), is_initial_listing]() {
+	auto on_modified = [&queue, &cache](const auto& ref_path, const auto& synced_paths,
+										bool is_initial_listing) {
+		queue.push(
+			get_source_key(ref_path),
+			[ref_path, synced_paths = remove_meta_tag(synced_paths), is_initial_listing, &cache]() {
 				const auto& renderer_extension = gfx::get_renderer_filename_extension();
 				auto it = std::find_if(std::begin(synced_paths), std::end(synced_paths),
 									   [&renderer_extension](const auto& key) {
@@ -134,14 +137,7 @@ void add_to_syncer<gfx::shader>(std::vector<uint64_t>& watchers, fs::syncer& syn
 				}
 
 				fs::path output = *it;
-
-				fs::error_code err;
-				if(is_initial_listing && fs::exists(output, err))
-				{
-					return;
-				}
-
-				asset_compiler::compile<gfx::shader>(ref_path, output);
+				asset_compiler::build<gfx::shader>(cache, ref_path, output, is_initial_listing);
 			});
 	};
 
@@ -166,6 +162,8 @@ void project_manager::close_project()
 	unwatch(app_watchers_);
 	app_meta_syncer_.unsync();
 	app_cache_syncer_.unsync();
+	build_queue_.clear("app:/");
+	app_build_cache_.save();
 	load_config();
 }
 
@@ -187,7 +185,7 @@ bool project_manager::open_project(const fs::path& project_path)
 	save_config();
 
 	setup_meta_syncer(app_meta_syncer_, fs::resolve_protocol("app:/data"), fs::resolve_protocol("app:/meta"));
-	setup_cache_syncer(app_watchers_, app_cache_syncer_, fs::resolve_protocol("app:/meta"),
+	setup_cache_syncer(app_watchers_, app_cache_syncer_, app_build_cache_, fs::resolve_protocol("app:/meta"),
 					   fs::resolve_protocol("app:/cache"));
 
 	auto& es = core::get_subsystem<editing_system>();
@@ -222,6 +220,11 @@ void project_manager::load_config()
 
 		try_load(ar, cereal::make_nvp("options", options_));
 
+		if(options_.build_jobs > 0)
+		{
+			build_queue_.set_max_running(options_.build_jobs);
+		}
+
 		auto& items = options_.recent_project_paths;
 		auto iter = std::begin(items);
 		while(iter != items.end())
@@ -314,37 +317,43 @@ void project_manager::setup_meta_syncer(fs::syncer& syncer, const fs::path& data
 }
 
 void project_manager::setup_cache_syncer(std::vector<uint64_t>& watchers, fs::syncer& syncer,
-										 const fs::path& meta_dir, const fs::path& cache_dir)
+										 asset_compiler::build_cache& cache, const fs::path& meta_dir,
+										 const fs::path& cache_dir)
 {
 	setup_directory(syncer);
 
-	auto on_removed = [](const auto& /*ref_path*/, const auto& synced_paths) {
+	cache.load(cache_dir / "build_cache.db");
+
+	auto on_removed = [&cache](const auto& /*ref_path*/, const auto& synced_paths) {
 		for(const auto& synced_path : synced_paths)
 		{
 			auto synced_asset = fs::replace(synced_path, ".meta", "");
 			fs::error_code err;
 			fs::remove_all(synced_asset, err);
+			cache.remove(synced_asset);
 		}
 	};
 
-	auto on_renamed = [](const auto& /*ref_path*/, const auto& synced_paths) {
+	auto on_renamed = [&cache](const auto& /*ref_path*/, const auto& synced_paths) {
 		for(const auto& synced_path : synced_paths)
 		{
 			auto synced_old_asset = fs::replace(synced_path.first, ".meta", "");
 			auto synced_new_asset = fs::replace(synced_path.second, ".meta", "");
 			fs::error_code err;
 			fs::rename(synced_old_asset, synced_new_asset, err);
+			cache.rename(synced_old_asset, synced_new_asset);
 		}
 	};
 
-	add_to_syncer<gfx::texture>(watchers, syncer, cache_dir, on_removed, on_renamed);
-	add_to_syncer<gfx::shader>(watchers, syncer, cache_dir, on_removed, on_renamed);
-	add_to_syncer<mesh>(watchers, syncer, cache_dir, on_removed, on_renamed);
-	add_to_syncer<audio::sound>(watchers, syncer, cache_dir, on_removed, on_renamed);
-	add_to_syncer<material>(watchers, syncer, cache_dir, on_removed, on_renamed);
-	add_to_syncer<runtime::animation>(watchers, syncer, cache_dir, on_removed, on_renamed);
-	add_to_syncer<prefab>(watchers, syncer, cache_dir, on_removed, on_renamed);
-	add_to_syncer<scene>(watchers, syncer, cache_dir, on_removed, on_renamed);
+	auto& queue = build_queue_;
+	add_to_syncer<gfx::texture>(watchers, syncer, queue, cache, cache_dir, on_removed, on_renamed);
+	add_to_syncer<gfx::shader>(watchers, syncer, queue, cache, cache_dir, on_removed, on_renamed);
+	add_to_syncer<mesh>(watchers, syncer, queue, cache, cache_dir, on_removed, on_renamed);
+	add_to_syncer<audio::sound>(watchers, syncer, queue, cache, cache_dir, on_removed, on_renamed);
+	add_to_syncer<material>(watchers, syncer, queue, cache, cache_dir, on_removed, on_renamed);
+	add_to_syncer<runtime::animation>(watchers, syncer, queue, cache, cache_dir, on_removed, on_renamed);
+	add_to_syncer<prefab>(watchers, syncer, queue, cache, cache_dir, on_removed, on_renamed);
+	add_to_syncer<scene>(watchers, syncer, queue, cache, cache_dir, on_removed, on_renamed);
 
 	syncer.sync(meta_dir, cache_dir);
 }
@@ -369,16 +378,21 @@ void project_manager::save_config()
 }
 
 project_manager::project_manager()
+	: build_queue_(core::get_subsystem<core::task_system>())
 {
+	auto& am = core::get_subsystem<runtime::asset_manager>();
+	load_request_slot_ = am.on_load_request.connect(
+		[this](const std::string& key) { build_queue_.prioritize(key); });
+
 	load_config();
 	setup_meta_syncer(engine_meta_syncer_, fs::resolve_protocol("engine:/data"),
 					  fs::resolve_protocol("engine:/meta"));
-	setup_cache_syncer(engine_watchers_, engine_cache_syncer_, fs::resolve_protocol("engine:/meta"),
-					   fs::resolve_protocol("engine:/cache"));
+	setup_cache_syncer(engine_watchers_, engine_cache_syncer_, engine_build_cache_,
+					   fs::resolve_protocol("engine:/meta"), fs::resolve_protocol("engine:/cache"));
 	setup_meta_syncer(editor_meta_syncer_, fs::resolve_protocol("editor:/data"),
 					  fs::resolve_protocol("editor:/meta"));
-	setup_cache_syncer(editor_watchers_, editor_cache_syncer_, fs::resolve_protocol("editor:/meta"),
-					   fs::resolve_protocol("editor:/cache"));
+	setup_cache_syncer(editor_watchers_, editor_cache_syncer_, editor_build_cache_,
+					   fs::resolve_protocol("editor:/meta"), fs::resolve_protocol("editor:/cache"));
 }
 
 project_manager::~project_manager()
@@ -399,5 +413,13 @@ project_manager::~project_manager()
 
 	engine_meta_syncer_.unsync();
 	engine_cache_syncer_.unsync();
+
+	auto& am = core::get_subsystem<runtime::asset_manager>();
+	am.on_load_request.disconnect(load_request_slot_);
+	build_queue_.clear();
+
+	app_build_cache_.save();
+	editor_build_cache_.save();
+	engine_build_cache_.save();
 }
 } // namespace editor
@@ -1,6 +1,10 @@
 #pragma once
+#include "../assets/build_cache.h"
+#include "../assets/build_queue.h"
+
 #include <core/filesystem/filesystem_syncer.h>
 #include <core/math/math_includes.h>
+#include <core/signals/event.hpp>
 
 #include <deque>
 #include <mutex>
@@ -14,6 +18,8 @@ public:
 	{
 		///
 		std::deque<std::string> recent_project_paths;
+		/// How many assets may be compiled at once, 0 picks it from the thread count.
+		std::uint32_t build_jobs = 0;
 	};
 
 	project_manager();
@@ -107,26 +113,45 @@ public:
 		return options_;
 	}
 
+	//-----------------------------------------------------------------------------
+	//  Name : get_build_queue ()
+	/// <summary>
+	/// The queue the asset compilation of every synced directory goes through.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline asset_compiler::build_queue& get_build_queue()
+	{
+		return build_queue_;
+	}
+
 private:
 	void setup_directory(fs::syncer& syncer);
 	void setup_meta_syncer(fs::syncer& syncer, const fs::path& data_dir, const fs::path& meta_dir);
-	void setup_cache_syncer(std::vector<uint64_t>& watchers, fs::syncer& syncer, const fs::path& meta_dir,
+	void setup_cache_syncer(std::vector<uint64_t>& watchers, fs::syncer& syncer,
+							asset_compiler::build_cache& cache, const fs::path& meta_dir,
 							const fs::path& cache_dir);
 	/// Project options
 	options options_;
 	/// Current project name
 	std::string project_name_;
+	/// Asset compilation of all the syncers
+	asset_compiler::build_queue build_queue_;
+	/// Connection to the load requests of the asset manager
+	event<void(const std::string&)>::slot_key load_request_slot_;
 
 	fs::syncer app_meta_syncer_;
 	fs::syncer app_cache_syncer_;
+	asset_compiler::build_cache app_build_cache_;
 	std::vector<std::uint64_t> app_watchers_;
 
 	fs::syncer editor_meta_syncer_;
 	fs::syncer editor_cache_syncer_;
+	asset_compiler::build_cache editor_build_cache_;
 	std::vector<std::uint64_t> editor_watchers_;
 
 	fs::syncer engine_meta_syncer_;
 	fs::syncer engine_cache_syncer_;
+	asset_compiler::build_cache engine_build_cache_;
 	std::vector<std::uint64_t> engine_watchers_;
 };
 } // namespace editor
@@ -13,7 +13,7 @@ namespace priv
 
 namespace detail
 {
-static ALenum get_format_for_channels(std::uint32_t channels, std::uint32_t bytes_per_sample)
+ALenum get_format_for_channels(std::uint32_t channels, std::uint32_t bytes_per_sample)
 {
     ALenum format = 0;
     switch(channels)
@@ -61,62 +61,38 @@ static ALenum get_format_for_channels(std::uint32_t channels, std::uint32_t byte
 }
 }
 
-static const size_t CHUNK_SIZE = 64 * 1024; // size of buffer if streaming
-
-sound_impl::sound_impl(std::vector<std::uint8_t>&& buffer, const sound_info& info, bool stream /*= false*/)
+sound_impl::sound_impl(std::vector<std::uint8_t>&& buffer, const sound_info& info, sound_encoding encoding,
+                       bool stream /*= false*/)
     : buf_(std::move(buffer))
-    ,  buf_info_(info)
+    , buf_info_(info)
+    , encoding_(encoding)
+    // encoded data can only be played by decoding it while streaming
+    , stream_(stream || encoding != sound_encoding::pcm)
 {
     if(buf_.empty())
     {
         return;
     }
 
-    if(stream)
-    {
-        load_buffer(CHUNK_SIZE);
-    }
-    else
+    if(!stream_)
     {
-        load_buffer(buf_.size());
+        load_buffer();
     }
 }
 
 bool sound_impl::load_buffer()
-{
-    return load_buffer(CHUNK_SIZE);
-}
-
-bool sound_impl::load_buffer(const size_t chunk_size)
 {
     if (buf_.empty()) return false;
 
     ALenum format = detail::get_format_for_channels(buf_info_.channels, buf_info_.bytes_per_sample);
 
-    size_t size = buf_.size() - buf_ptr_;
-    if (size > chunk_size)
-    {
-        size = chunk_size;
-    }
-
     native_handle_type h;
     al_check(alGenBuffers(1, &h));
-    al_check(alBufferData(h, format, buf_.data() + buf_ptr_, ALsizei(size), ALsizei(buf_info_.sample_rate)));
+    al_check(alBufferData(h, format, buf_.data(), ALsizei(buf_.size()), ALsizei(buf_info_.sample_rate)));
     handles_.push_back(h);
 
-    buf_ptr_ += size;
-
-    if (buf_ptr_ == buf_.size())
-    {
-        // force deallocate
-        std::vector<std::uint8_t>().swap(buf_);
-    }
-
-    std::lock_guard<std::mutex> lock(mutex_);
-    for (auto source : bound_to_sources_)
-    {
-        source->enqueue_buffer(h);
-    }
+    // force deallocate
+    std::vector<std::uint8_t>().swap(buf_);
 
     return true;
 }
@@ -135,7 +111,12 @@ sound_impl::~sound_impl()
 
 bool sound_impl::is_valid() const
 {
-    return !handles_.empty();
+    return stream_ ? !buf_.empty() : !handles_.empty();
+}
+
+bool sound_impl::is_streamed() const
+{
+    return stream_;
 }
 
 void sound_impl::bind_to_source(source_impl* source)
@@ -173,8 +154,6 @@ void sound_impl::cleanup()
     {
         al_check(alDeleteBuffers(ALsizei(handles_.size()), handles_.data()));
         handles_.clear();
-        buf_.clear();
-        buf_ptr_ = 0;
     }
 
     unbind_from_all_sources();
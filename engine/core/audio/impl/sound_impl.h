@@ -10,6 +10,11 @@ namespace priv
 {
 class source_impl;
 
+namespace detail
+{
+ALenum get_format_for_channels(std::uint32_t channels, std::uint32_t bytes_per_sample);
+}
+
 class sound_impl
 {
 public:
@@ -17,7 +22,8 @@ public:
 
     sound_impl();
     ~sound_impl();
-    sound_impl(std::vector<std::uint8_t>&& buffer, const sound_info& info, bool stream = false);
+    sound_impl(std::vector<std::uint8_t>&& buffer, const sound_info& info, sound_encoding encoding,
+               bool stream = false);
 
     sound_impl(sound_impl&& rhs) = delete;
     sound_impl& operator=(sound_impl&& rhs) = delete;
@@ -30,12 +36,13 @@ public:
         return handles_;
     }
 
-    bool load_buffer();
+    bool is_streamed() const;
 
 private:
     friend class source_impl;
+    friend class stream_impl;
 
-    bool load_buffer(const size_t chunk_size);
+    bool load_buffer();
 
     void bind_to_source(source_impl* source);
     void unbind_from_source(source_impl* source);
@@ -44,10 +51,11 @@ private:
 
     std::vector<native_handle_type> handles_;
 
-    // transient data valid until the audio is being streamed from memory
+    // kept only when streamed, every playing source decodes from it
     std::vector<std::uint8_t> buf_;
-    size_t buf_ptr_ = 0;
     sound_info buf_info_;
+    sound_encoding encoding_ = sound_encoding::pcm;
+    bool stream_ = false;
 
     /// openal doesn't let us destroy sounds that are
     /// binded, so we have to keep this bookkeeping
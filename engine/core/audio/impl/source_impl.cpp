@@ -4,6 +4,9 @@
 #include "../exception.h"
 #include "../logger.h"
 #include "sound_impl.h"
+#include "stream_impl.h"
+
+#include <algorithm>
 
 namespace audio
 {
@@ -45,16 +48,24 @@ bool source_impl::bind(sound_impl* sound)
 
     bind_sound(sound);
 
-    const auto& handles = sound->native_handles();
-
     al_check(alSourcei(handle_, AL_SOURCE_RELATIVE, AL_FALSE));
     al_check(alSourcei(handle_, AL_BUFFER, 0));
-    alSourceQueueBuffers(handle_, ALsizei(handles.size()), handles.data());
+
+    if(sound->is_streamed())
+    {
+        al_check(alSourcei(handle_, AL_LOOPING, AL_FALSE));
+        stream_ = std::make_unique<stream_impl>(*sound);
+        stream_->update(handle_, loop_);
+    }
+    else
+    {
+        const auto& handles = sound->native_handles();
+        al_check(alSourcei(handle_, AL_LOOPING, loop_ ? AL_TRUE : AL_FALSE));
+        alSourceQueueBuffers(handle_, ALsizei(handles.size()), handles.data());
+    }
 
     // optional info
-    ALint channels = 1;
-    al_check(alGetBufferi(handles.front(), AL_CHANNELS, &channels));
-    if(channels > 1)
+    if(sound->buf_info_.channels > 1)
     {
         log_info("Sound is not mono. 3D Attenuation will not work.");
     }
@@ -73,14 +84,12 @@ void source_impl::unbind()
 {
     stop();
 
-    ALint queued;
-    al_check(alGetSourcei(handle_, AL_BUFFERS_QUEUED, &queued));
-    while (queued--)
-    {
-        ALuint buffer;
-        al_check(alSourceUnqueueBuffers(handle_, 1, &buffer));
-    }
+    // detaches the whole queue, unlike unqueueing this works for sources
+    // that never played
+    al_check(alSourcei(handle_, AL_BUFFER, 0));
 
+    // the buffers can only be deleted once detached
+    stream_.reset();
     unbind_sound();
 }
 
@@ -100,11 +109,18 @@ void source_impl::purge()
 
 void source_impl::set_playing_offset(float seconds)
 {
-    // temporary load the whole sound here
-    // until we figure out a good way to load until the position we need it
-    if (bound_sound_)
+    if(stream_ && bound_sound_)
     {
-        while(bound_sound_->load_buffer());
+        // the queue only holds the next few chunks, so decoding starts over at the offset
+        const bool was_playing = is_playing();
+        const auto frame = std::uint64_t(seconds * float(bound_sound_->buf_info_.sample_rate));
+        stream_->seek(handle_, frame);
+        stream_->update(handle_, loop_);
+        if(was_playing)
+        {
+            play();
+        }
+        return;
     }
 
     al_check(alSourcef(handle_, AL_SEC_OFFSET, seconds));
@@ -112,6 +128,15 @@ void source_impl::set_playing_offset(float seconds)
 
 float source_impl::get_playing_offset() const
 {
+    if(stream_ && bound_sound_)
+    {
+        ALint offset = 0;
+        al_check(alGetSourcei(handle_, AL_SAMPLE_OFFSET, &offset));
+        const auto frame_count = std::max<std::uint64_t>(stream_->get_frame_count(), 1);
+        const auto frame = (stream_->get_queued_frame() + std::uint64_t(offset)) % frame_count;
+        return float(frame) / float(bound_sound_->buf_info_.sample_rate);
+    }
+
     ALfloat seconds = 0.0f;
     al_check(alGetSourcef(handle_, AL_SEC_OFFSET, &seconds));
     return static_cast<float>(seconds);
@@ -126,18 +151,30 @@ float source_impl::get_playing_duration() const
     return 0;
 }
 
-void source_impl::play() const
+void source_impl::play()
 {
+    if(stream_)
+    {
+        // a finished stream starts over like a source replaying its buffers
+        if(is_stopped())
+        {
+            stream_->seek(handle_, 0);
+            stream_->update(handle_, loop_);
+        }
+        stream_playing_ = true;
+    }
     al_check(alSourcePlay(handle_));
 }
 
-void source_impl::stop() const
+void source_impl::stop()
 {
+    stream_playing_ = false;
     al_check(alSourceStop(handle_));
 }
 
-void source_impl::pause() const
+void source_impl::pause()
 {
+    stream_playing_ = false;
     al_check(alSourcePause(handle_));
 }
 
@@ -171,7 +208,11 @@ bool source_impl::is_binded() const
 
 void source_impl::set_loop(bool on)
 {
-    al_check(alSourcei(handle_, AL_LOOPING, on ? AL_TRUE : AL_FALSE));
+    loop_ = on;
+    if(!stream_)
+    {
+        al_check(alSourcei(handle_, AL_LOOPING, on ? AL_TRUE : AL_FALSE));
+    }
 }
 
 void source_impl::set_volume(float volume)
@@ -226,22 +267,36 @@ bool source_impl::is_valid() const
 
 bool source_impl::is_looping() const
 {
-    ALint loop;
-    al_check(alGetSourcei(handle_, AL_LOOPING, &loop));
-    return loop != 0;
+    return loop_;
+}
+
+bool source_impl::is_streaming() const
+{
+    return stream_ != nullptr;
 }
 
 void source_impl::update_stream()
 {
-    if (bound_sound_)
+    if(!stream_)
     {
-        bound_sound_->load_buffer();
+        return;
     }
-}
 
-void source_impl::enqueue_buffer(source_impl::native_handle_type h)
-{
-    alSourceQueueBuffers(handle_, 1, &h);
+    const auto queued = stream_->update(handle_, loop_);
+
+    // the source stops when it plays every queued buffer before they are
+    // refilled, so start it again unless the stream has ended
+    if(stream_playing_ && is_stopped())
+    {
+        if(queued > 0)
+        {
+            al_check(alSourcePlay(handle_));
+        }
+        else
+        {
+            stream_playing_ = false;
+        }
+    }
 }
 
 source_impl::native_handle_type source_impl::native_handle() const
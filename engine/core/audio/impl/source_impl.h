@@ -3,6 +3,7 @@
 #include "../types.h"
 #include <AL/al.h>
 #include <cstdint>
+#include <memory>
 #include <mutex>
 #include <vector>
 
@@ -11,6 +12,7 @@ namespace audio
 namespace priv
 {
 class sound_impl;
+class stream_impl;
 
 class source_impl
 {
@@ -43,9 +45,9 @@ public:
     float get_playing_offset() const;
     float get_playing_duration() const;
 
-    void play() const;
-    void stop() const;
-    void pause() const;
+    void play();
+    void stop();
+    void pause();
     bool is_playing() const;
     bool is_paused() const;
     bool is_stopped() const;
@@ -53,8 +55,8 @@ public:
     bool is_valid() const;
     bool is_looping() const;
 
+    bool is_streaming() const;
     void update_stream();
-    void enqueue_buffer(native_handle_type h);
 
     native_handle_type native_handle() const;
 
@@ -68,6 +70,13 @@ private:
 
     /// non owning
     sound_impl* bound_sound_ = nullptr;
+
+    /// decodes the bound sound if it is streamed
+    std::unique_ptr<stream_impl> stream_;
+    /// streams loop by refilling, so the source itself never loops them
+    bool loop_ = false;
+    /// whether the stream should be playing, to restart it if it ran dry
+    bool stream_playing_ = false;
 };
 }
 }
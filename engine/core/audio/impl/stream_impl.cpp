@@ -0,0 +1,182 @@
+#include "stream_impl.h"
+#include "../logger.h"
+#include "check.h"
+#include "sound_impl.h"
+#include "stb_vorbis.h"
+#include <algorithm>
+#include <cstring>
+
+namespace audio
+{
+namespace priv
+{
+
+stream_impl::stream_impl(const sound_impl& sound)
+    : data_(sound.buf_.data())
+    , data_size_(sound.buf_.size())
+    , encoding_(sound.encoding_)
+    , info_(sound.buf_info_)
+{
+    format_ = detail::get_format_for_channels(info_.channels, info_.bytes_per_sample);
+    frame_size_ = std::size_t(info_.channels) * info_.bytes_per_sample;
+    if(format_ == 0 || frame_size_ == 0 || data_size_ == 0)
+    {
+        return;
+    }
+
+    if(encoding_ == sound_encoding::vorbis)
+    {
+        int vorb_err = 0;
+        vorbis_ = stb_vorbis_open_memory(data_, int(data_size_), &vorb_err, nullptr);
+        if(vorbis_ == nullptr)
+        {
+            log_error("Cant open vorbis stream, error code : " + std::to_string(vorb_err));
+            return;
+        }
+        frame_count_ = stb_vorbis_stream_length_in_samples(vorbis_);
+    }
+    else
+    {
+        frame_count_ = data_size_ / frame_size_;
+    }
+
+    // whole frames only, so a chunk never splits a frame between buffers
+    chunk_.resize(chunk_size - chunk_size % frame_size_);
+
+    handles_.resize(buffer_count);
+    al_check(alGenBuffers(ALsizei(handles_.size()), handles_.data()));
+    free_ = handles_;
+}
+
+stream_impl::~stream_impl()
+{
+    if(!handles_.empty())
+    {
+        al_check(alDeleteBuffers(ALsizei(handles_.size()), handles_.data()));
+    }
+    if(vorbis_ != nullptr)
+    {
+        stb_vorbis_close(vorbis_);
+    }
+}
+
+bool stream_impl::is_valid() const
+{
+    return !handles_.empty();
+}
+
+std::size_t stream_impl::update(native_handle_type source, bool loop)
+{
+    if(!is_valid())
+    {
+        return 0;
+    }
+
+    ALint processed = 0;
+    al_check(alGetSourcei(source, AL_BUFFERS_PROCESSED, &processed));
+    while(processed-- > 0 && !queued_.empty())
+    {
+        native_handle_type h = 0;
+        al_check(alSourceUnqueueBuffers(source, 1, &h));
+
+        const auto& front = queued_.front();
+        queued_frame_ = frame_count_ > 0 ? (queued_frame_ + front.frames) % frame_count_ : 0;
+        queued_.pop_front();
+        free_.push_back(h);
+    }
+
+    std::size_t count = 0;
+    while(!free_.empty())
+    {
+        auto size = read(chunk_.data(), chunk_.size());
+        if(size == 0 && loop && read_frame_ > 0 && rewind(0))
+        {
+            size = read(chunk_.data(), chunk_.size());
+        }
+        if(size == 0)
+        {
+            break;
+        }
+
+        auto h = free_.back();
+        free_.pop_back();
+        al_check(alBufferData(h, format_, chunk_.data(), ALsizei(size), ALsizei(info_.sample_rate)));
+        al_check(alSourceQueueBuffers(source, 1, &h));
+        queued_.push_back({h, size / frame_size_});
+        ++count;
+    }
+
+    return count;
+}
+
+void stream_impl::seek(native_handle_type source, std::uint64_t frame)
+{
+    if(!is_valid())
+    {
+        return;
+    }
+
+    // detaches the whole queue, played or not
+    al_check(alSourceStop(source));
+    al_check(alSourcei(source, AL_BUFFER, 0));
+    al_check(alSourceRewind(source));
+    for(const auto& q : queued_)
+    {
+        free_.push_back(q.handle);
+    }
+    queued_.clear();
+
+    frame = frame_count_ > 0 ? frame % frame_count_ : 0;
+    if(rewind(frame))
+    {
+        queued_frame_ = frame;
+    }
+}
+
+std::uint64_t stream_impl::get_queued_frame() const
+{
+    return queued_frame_;
+}
+
+std::uint64_t stream_impl::get_frame_count() const
+{
+    return frame_count_;
+}
+
+std::size_t stream_impl::read(std::uint8_t* out, std::size_t size)
+{
+    if(encoding_ == sound_encoding::vorbis)
+    {
+        const auto channels = int(info_.channels);
+        const auto shorts = int(size / sizeof(std::int16_t));
+        const auto frames = stb_vorbis_get_samples_short_interleaved(
+            vorbis_, channels, reinterpret_cast<std::int16_t*>(out), shorts);
+        read_frame_ += std::uint64_t(frames);
+        return std::size_t(frames) * frame_size_;
+    }
+
+    const auto offset = std::size_t(read_frame_) * frame_size_;
+    size = std::min(size, data_size_ - offset);
+    std::memcpy(out, data_ + offset, size);
+    read_frame_ += size / frame_size_;
+    return size;
+}
+
+bool stream_impl::rewind(std::uint64_t frame)
+{
+    if(encoding_ == sound_encoding::vorbis)
+    {
+        const auto result = frame == 0 ? stb_vorbis_seek_start(vorbis_)
+                                       : stb_vorbis_seek(vorbis_, static_cast<unsigned int>(frame));
+        if(result == 0)
+        {
+            log_error("Cant seek vorbis stream to frame : " + std::to_string(frame));
+            return false;
+        }
+    }
+
+    read_frame_ = frame;
+    return true;
+}
+}
+}
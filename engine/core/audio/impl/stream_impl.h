@@ -0,0 +1,116 @@
+#pragma once
+
+#include "../sound_data.h"
+#include <AL/al.h>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+struct stb_vorbis;
+
+namespace audio
+{
+namespace priv
+{
+class sound_impl;
+
+//-----------------------------------------------------------------------------
+// Main Class Declarations
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//  Name : stream_impl (Class)
+/// <summary>
+/// Plays a sound on one source by decoding it a chunk at a time into a
+/// small ring of buffers, which are refilled as the source finishes them.
+/// The memory used stays the same no matter how long the sound is.
+/// </summary>
+//-----------------------------------------------------------------------------
+class stream_impl
+{
+public:
+    using native_handle_type = ALuint;
+
+    /// buffers in the ring
+    static constexpr std::size_t buffer_count = 4;
+    /// bytes decoded into each buffer
+    static constexpr std::size_t chunk_size = 64 * 1024;
+
+    stream_impl(const sound_impl& sound);
+    ~stream_impl();
+
+    stream_impl(stream_impl&& rhs) = delete;
+    stream_impl& operator=(stream_impl&& rhs) = delete;
+    stream_impl(const stream_impl& rhs) = delete;
+    stream_impl& operator=(const stream_impl& rhs) = delete;
+
+    bool is_valid() const;
+
+    //-----------------------------------------------------------------------------
+    //  Name : update ()
+    /// <summary>
+    /// Takes back the buffers the source has played and queues them again
+    /// with the next chunks. Returns how many buffers were queued.
+    /// </summary>
+    //-----------------------------------------------------------------------------
+    std::size_t update(native_handle_type source, bool loop);
+
+    //-----------------------------------------------------------------------------
+    //  Name : seek ()
+    /// <summary>
+    /// Stops the source, drops its queue and continues decoding from the
+    /// frame. Call update to queue the chunks again.
+    /// </summary>
+    //-----------------------------------------------------------------------------
+    void seek(native_handle_type source, std::uint64_t frame);
+
+    //-----------------------------------------------------------------------------
+    //  Name : get_queued_frame ()
+    /// <summary>
+    /// The frame the first queued buffer starts at.
+    /// </summary>
+    //-----------------------------------------------------------------------------
+    std::uint64_t get_queued_frame() const;
+
+    //-----------------------------------------------------------------------------
+    //  Name : get_frame_count ()
+    /// <summary>
+    /// Length of the whole sound in frames.
+    /// </summary>
+    //-----------------------------------------------------------------------------
+    std::uint64_t get_frame_count() const;
+
+private:
+    /// Decodes up to size bytes, returns how many were written.
+    std::size_t read(std::uint8_t* out, std::size_t size);
+    bool rewind(std::uint64_t frame);
+
+    struct queued
+    {
+        native_handle_type handle = 0;
+        std::uint64_t frames = 0;
+    };
+
+    /// the sound data, owned by the sound
+    const std::uint8_t* data_ = nullptr;
+    std::size_t data_size_ = 0;
+    sound_encoding encoding_ = sound_encoding::pcm;
+    sound_info info_;
+    ALenum format_ = 0;
+    std::size_t frame_size_ = 0;
+    std::uint64_t frame_count_ = 0;
+
+    /// position of the next read, in frames
+    std::uint64_t read_frame_ = 0;
+    stb_vorbis* vorbis_ = nullptr;
+
+    /// the ring of buffers
+    std::vector<native_handle_type> handles_;
+    std::vector<native_handle_type> free_;
+    std::deque<queued> queued_;
+    std::uint64_t queued_frame_ = 0;
+
+    /// decoding scratch memory
+    std::vector<std::uint8_t> chunk_;
+};
+}
+}
@@ -5,6 +5,9 @@ namespace audio
 
 bool load_ogg_from_memory(const std::uint8_t* data, std::size_t data_size, sound_data& result,
                           std::string& err);
+// reads only the info and keeps the data compressed, to be decoded while playing
+bool load_ogg_stream_from_memory(const std::uint8_t* data, std::size_t data_size, sound_data& result,
+                                 std::string& err);
 bool load_wav_from_memory(const std::uint8_t* data, std::size_t data_size, sound_data& result,
                           std::string& err);
 }
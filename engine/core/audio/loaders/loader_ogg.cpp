@@ -5,18 +5,19 @@
 namespace audio
 {
 
-bool load_ogg_from_memory(const std::uint8_t* data, std::size_t data_size, sound_data& result,
-                          std::string& err)
+namespace
+{
+stb_vorbis* open_ogg(const std::uint8_t* data, std::size_t data_size, sound_info& info, std::string& err)
 {
     if(!data)
     {
         err = "ERROR : No data to load from.";
-        return false;
+        return nullptr;
     }
     if(!data_size)
     {
         err = "ERROR : No data to load from.";
-        return false;
+        return nullptr;
     }
 
     int vorb_err = 0;
@@ -26,27 +27,53 @@ bool load_ogg_from_memory(const std::uint8_t* data, std::size_t data_size, sound
     {
         auto decoded_err = STBVorbisError(vorb_err);
         err = "ERROR : Vorbis error code : " + std::to_string(decoded_err);
+        return nullptr;
+    }
+    stb_vorbis_info vorb_info = stb_vorbis_get_info(oss);
+    info.channels = std::uint32_t(vorb_info.channels);
+    info.sample_rate = vorb_info.sample_rate;
+    info.bytes_per_sample = sizeof(std::int16_t);
+    info.duration = sound_info::duration_t(stb_vorbis_stream_length_in_seconds(oss));
+    return oss;
+}
+}
+
+bool load_ogg_from_memory(const std::uint8_t* data, std::size_t data_size, sound_data& result,
+                          std::string& err)
+{
+    auto* oss = open_ogg(data, data_size, result.info, err);
+    if(!oss)
+    {
         return false;
     }
-    stb_vorbis_info info = stb_vorbis_get_info(oss);
-    result.info.channels = std::uint32_t(info.channels);
-    result.info.sample_rate = info.sample_rate;
-    result.info.bytes_per_sample = sizeof(std::int16_t);
 
     auto stream_len_in_samples = std::size_t(stb_vorbis_stream_length_in_samples(oss));
 
-    std::size_t data_bytes =
-        (stream_len_in_samples * std::size_t(info.channels)) * result.info.bytes_per_sample;
+    std::size_t data_shorts = stream_len_in_samples * std::size_t(result.info.channels);
 
-    float seconds = stb_vorbis_stream_length_in_seconds(oss);
+    result.encoding = sound_encoding::pcm;
+    result.data.resize(data_shorts * result.info.bytes_per_sample, 0);
 
-    result.info.duration = sound_info::duration_t(seconds);
-    result.data.resize(data_bytes, 0);
+    stb_vorbis_get_samples_short_interleaved(oss, int(result.info.channels),
+                                             reinterpret_cast<std::int16_t*>(result.data.data()),
+                                             int(data_shorts));
 
-    stb_vorbis_get_samples_short_interleaved(
-        oss, info.channels, reinterpret_cast<std::int16_t*>(result.data.data()), int(data_bytes));
+    stb_vorbis_close(oss);
+    return true;
+}
 
+bool load_ogg_stream_from_memory(const std::uint8_t* data, std::size_t data_size, sound_data& result,
+                                 std::string& err)
+{
+    auto* oss = open_ogg(data, data_size, result.info, err);
+    if(!oss)
+    {
+        return false;
+    }
     stb_vorbis_close(oss);
+
+    result.encoding = sound_encoding::vorbis;
+    result.data.assign(data, data + data_size);
     return true;
 }
 }
@@ -8,7 +8,7 @@ sound::sound() = default;
 sound::~sound() = default;
 
 sound::sound(sound_data&& data, bool stream)
-    : impl_(std::make_unique<priv::sound_impl>(std::move(data.data), data.info, stream))
+    : impl_(std::make_unique<priv::sound_impl>(std::move(data.data), data.info, data.encoding, stream))
     , info_(std::move(data.info))
 {
 }
@@ -26,9 +26,9 @@ const sound_info& sound::get_info() const
     return info_;
 }
 
-bool sound::load_buffer()
+bool sound::is_streamed() const
 {
-    return impl_ && impl_->load_buffer();
+    return impl_ && impl_->is_streamed();
 }
 
 uintptr_t sound::uid() const
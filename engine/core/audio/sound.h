@@ -24,6 +24,13 @@ class sound
 public:
     sound();
     ~sound();
+    //-----------------------------------------------------------------------------
+    //  Name : sound ()
+    /// <summary>
+    /// Streamed sounds keep their data and every source playing them decodes
+    /// it a chunk at a time. Encoded data like vorbis is always streamed.
+    /// </summary>
+    //-----------------------------------------------------------------------------
     sound(sound_data&& data, bool stream = false);
     sound(sound&& rhs) noexcept;
     sound& operator=(sound&& rhs) noexcept;
@@ -47,7 +54,13 @@ public:
     //-----------------------------------------------------------------------------
     const sound_info& get_info() const;
 
-    bool load_buffer();
+    //-----------------------------------------------------------------------------
+    //  Name : is_streamed ()
+    /// <summary>
+    /// Checks whether the sound is decoded while playing.
+    /// </summary>
+    //-----------------------------------------------------------------------------
+    bool is_streamed() const;
 
     //-----------------------------------------------------------------------------
     //  Name : uid ()
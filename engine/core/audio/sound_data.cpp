@@ -7,7 +7,11 @@ namespace audio
 
 void sound_data::convert_to_mono()
 {
-    if(info.channels == 2)
+    if(encoding != sound_encoding::pcm)
+    {
+        log_error("Does not support mono conversion of encoded buffers");
+    }
+    else if(info.channels == 2)
     {
         data = utils::convert_to_mono(data, info.bytes_per_sample);
         info.channels = 1;
@@ -20,7 +24,11 @@ void sound_data::convert_to_mono()
 
 void sound_data::convert_to_stereo()
 {
-    if(info.channels == 1)
+    if(encoding != sound_encoding::pcm)
+    {
+        log_error("Does not support stereo conversion of encoded buffers");
+    }
+    else if(info.channels == 1)
     {
         data = utils::convert_to_stereo(data, info.bytes_per_sample);
         info.channels = 2;
@@ -9,6 +9,14 @@
 namespace audio
 {
 
+enum class sound_encoding : std::uint8_t
+{
+    /// raw interleaved samples
+    pcm,
+    /// ogg vorbis stream, decoded while playing
+    vorbis
+};
+
 struct sound_data
 {
     //-----------------------------------------------------------------------------
@@ -33,5 +41,8 @@ struct sound_data
 
     /// data buffer of pcm sound stored in uint8_t buffer
     std::vector<std::uint8_t> data;
+
+    /// how the data buffer is encoded
+    sound_encoding encoding = sound_encoding::pcm;
 };
 }
@@ -171,6 +171,15 @@ bool source::is_valid() const
     return impl_ && impl_->is_valid();
 }
 
+bool source::is_streaming() const
+{
+    if(is_valid())
+    {
+        return impl_->is_streaming();
+    }
+    return false;
+}
+
 void source::update_stream()
 {
     if (is_valid())
@@ -207,10 +207,20 @@ public:
     //-----------------------------------------------------------------------------
     bool is_valid() const;
 
+    //-----------------------------------------------------------------------------
+    //  Name : is_streaming ()
+    /// <summary>
+    /// Checks whether the bound sound is decoded while playing.
+    /// </summary>
+    //-----------------------------------------------------------------------------
+    bool is_streaming() const;
+
     //-----------------------------------------------------------------------------
     //  Name : update_stream ()
     /// <summary>
-    /// Updates the stream. Does nothing if there is no streaming
+    /// Decodes the next chunks of a streamed sound into the buffers the source
+    /// has played. Does nothing if there is no streaming. Sources can be
+    /// updated from different threads at once, but each from one at a time.
     /// </summary>
     //-----------------------------------------------------------------------------
     void update_stream();
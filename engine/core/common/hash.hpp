@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 
@@ -10,4 +11,20 @@ inline void hash_combine(std::size_t& seed, const T& v)
 	std::hash<T> hasher;
 	seed ^= hasher(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
 }
+
+constexpr std::uint64_t fnv1a_offset = 14695981039346656037ull;
+constexpr std::uint64_t fnv1a_prime = 1099511628211ull;
+
+/// 64 bit fnv-1a of the bytes, stable between runs and platforms unlike
+/// std::hash. Pass a previous result as hash to continue it.
+inline std::uint64_t fnv1a(const void* data, std::size_t size, std::uint64_t hash = fnv1a_offset)
+{
+	const auto bytes = static_cast<const std::uint8_t*>(data);
+	for(std::size_t i = 0; i < size; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= fnv1a_prime;
+	}
+	return hash;
+}
 }
@@ -0,0 +1,172 @@
+#include "mapped_file.h"
+
+#if ETH_ON(ETH_PLATFORM_WINDOWS)
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs
+{
+span_streambuf::pos_type span_streambuf::seekoff(off_type off, std::ios_base::seekdir dir,
+												 std::ios_base::openmode which)
+{
+	if((which & std::ios_base::in) == 0)
+	{
+		return pos_type(off_type(-1));
+	}
+
+	char* base = eback();
+	if(dir == std::ios_base::cur)
+	{
+		off += gptr() - base;
+	}
+	else if(dir == std::ios_base::end)
+	{
+		off += egptr() - base;
+	}
+
+	if(off < 0 || off > egptr() - base)
+	{
+		return pos_type(off_type(-1));
+	}
+
+	setg(base, base + off, egptr());
+	return pos_type(off);
+}
+
+span_streambuf::pos_type span_streambuf::seekpos(pos_type pos, std::ios_base::openmode which)
+{
+	return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+mapped_file::~mapped_file()
+{
+	close();
+}
+
+#if ETH_ON(ETH_PLATFORM_WINDOWS)
+bool mapped_file::open(const path& p, error_code& err)
+{
+	close();
+
+	HANDLE file = CreateFileW(p.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+							  FILE_ATTRIBUTE_NORMAL, nullptr);
+	if(file == INVALID_HANDLE_VALUE)
+	{
+		err = error_code(int(GetLastError()), std::system_category());
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if(!GetFileSizeEx(file, &size))
+	{
+		err = error_code(int(GetLastError()), std::system_category());
+		CloseHandle(file);
+		return false;
+	}
+
+	file_ = file;
+	is_open_ = true;
+	size_ = std::size_t(size.QuadPart);
+	// an empty file can't be mapped, it's just an empty span
+	if(size_ == 0)
+	{
+		return true;
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if(mapping == nullptr)
+	{
+		err = error_code(int(GetLastError()), std::system_category());
+		close();
+		return false;
+	}
+	mapping_ = mapping;
+
+	data_ = static_cast<const std::uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if(data_ == nullptr)
+	{
+		err = error_code(int(GetLastError()), std::system_category());
+		close();
+		return false;
+	}
+	return true;
+}
+
+void mapped_file::close()
+{
+	if(data_ != nullptr)
+	{
+		UnmapViewOfFile(data_);
+	}
+	if(mapping_ != nullptr)
+	{
+		CloseHandle(mapping_);
+	}
+	if(file_ != nullptr)
+	{
+		CloseHandle(file_);
+	}
+	data_ = nullptr;
+	mapping_ = nullptr;
+	file_ = nullptr;
+	size_ = 0;
+	is_open_ = false;
+}
+#else
+bool mapped_file::open(const path& p, error_code& err)
+{
+	close();
+
+	const int fd = ::open(p.c_str(), O_RDONLY);
+	if(fd < 0)
+	{
+		err = error_code(errno, std::generic_category());
+		return false;
+	}
+
+	struct stat st;
+	if(fstat(fd, &st) != 0)
+	{
+		err = error_code(errno, std::generic_category());
+		::close(fd);
+		return false;
+	}
+
+	size_ = std::size_t(st.st_size);
+	if(size_ > 0)
+	{
+		void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+		if(data == MAP_FAILED)
+		{
+			err = error_code(errno, std::generic_category());
+			::close(fd);
+			size_ = 0;
+			return false;
+		}
+		data_ = static_cast<const std::uint8_t*>(data);
+	}
+
+	// the mapping keeps the file referenced
+	::close(fd);
+	is_open_ = true;
+	return true;
+}
+
+void mapped_file::close()
+{
+	if(data_ != nullptr)
+	{
+		munmap(const_cast<std::uint8_t*>(data_), size_);
+	}
+	data_ = nullptr;
+	size_ = 0;
+	is_open_ = false;
+}
+#endif
+}
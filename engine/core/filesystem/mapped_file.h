@@ -0,0 +1,103 @@
+#pragma once
+
+#include "../common/platform/config.hpp"
+#include "detail/filesystem_includes.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <streambuf>
+
+namespace fs
+{
+//-----------------------------------------------------------------------------
+//  Name : byte_span
+/// <summary>
+/// Non owning view of a range of bytes.
+/// </summary>
+//-----------------------------------------------------------------------------
+struct byte_span
+{
+	const std::uint8_t* data = nullptr;
+	std::size_t size = 0;
+
+	bool empty() const
+	{
+		return size == 0;
+	}
+};
+
+//-----------------------------------------------------------------------------
+//  Name : span_streambuf
+/// <summary>
+/// Read only stream buffer over a byte span, to deserialize from memory
+/// without copying it into a string first.
+/// </summary>
+//-----------------------------------------------------------------------------
+class span_streambuf : public std::streambuf
+{
+public:
+	explicit span_streambuf(const byte_span& span)
+	{
+		auto begin = reinterpret_cast<char*>(const_cast<std::uint8_t*>(span.data));
+		setg(begin, begin, begin + span.size);
+	}
+
+protected:
+	pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+	pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+};
+
+//-----------------------------------------------------------------------------
+// Main Class Declarations
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//  Name : mapped_file (Class)
+/// <summary>
+/// Read only memory mapping of a whole file. The contents stay valid for as
+/// long as the mapping is open.
+/// </summary>
+//-----------------------------------------------------------------------------
+class mapped_file
+{
+public:
+	mapped_file() = default;
+	~mapped_file();
+	mapped_file(const mapped_file&) = delete;
+	mapped_file& operator=(const mapped_file&) = delete;
+
+	//-----------------------------------------------------------------------------
+	//  Name : open ()
+	/// <summary>
+	/// Maps the file, closing any previous mapping first.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool open(const path& p, error_code& err);
+
+	//-----------------------------------------------------------------------------
+	//  Name : close ()
+	/// <summary>
+	/// Unmaps the file.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void close();
+
+	bool is_open() const
+	{
+		return is_open_;
+	}
+
+	byte_span get_span() const
+	{
+		return {data_, size_};
+	}
+
+private:
+	const std::uint8_t* data_ = nullptr;
+	std::size_t size_ = 0;
+	bool is_open_ = false;
+#if ETH_ON(ETH_PLATFORM_WINDOWS)
+	void* file_ = nullptr;
+	void* mapping_ = nullptr;
+#endif
+};
+}
@@ -0,0 +1,397 @@
+#include "frame_graph.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace gfx
+{
+bool operator==(const transient_texture_desc& desc1, const transient_texture_desc& desc2)
+{
+	return desc1.width == desc2.width && desc1.height == desc2.height && desc1.format == desc2.format &&
+		   desc1.flags == desc2.flags;
+}
+
+std::size_t get_storage_size(const transient_texture_desc& desc)
+{
+	texture_info info;
+	calc_texture_size(info, desc.width, desc.height, 1, false, false, 1, desc.format);
+	return info.storageSize;
+}
+
+std::shared_ptr<texture> transient_texture_pool::acquire(const transient_texture_desc& desc)
+{
+	for(auto& e : entries_)
+	{
+		if(!e.in_use && e.desc == desc)
+		{
+			e.in_use = true;
+			e.last_used_frame = frame_;
+			return e.tex;
+		}
+	}
+
+	entry e;
+	e.desc = desc;
+	e.tex = std::make_shared<texture>(desc.width, desc.height, false, 1, desc.format, desc.flags);
+	e.in_use = true;
+	e.last_used_frame = frame_;
+	entries_.emplace_back(e);
+	return e.tex;
+}
+
+void transient_texture_pool::release(const std::shared_ptr<texture>& tex)
+{
+	for(auto& e : entries_)
+	{
+		if(e.tex == tex)
+		{
+			e.in_use = false;
+			return;
+		}
+	}
+}
+
+std::shared_ptr<frame_buffer>
+transient_texture_pool::get_fbo(const std::vector<std::shared_ptr<texture>>& textures)
+{
+	fbo_key key;
+	key.textures = textures;
+
+	auto it = fbos_.find(key);
+	if(it != fbos_.end())
+	{
+		it->second.second = true;
+		return it->second.first;
+	}
+
+	auto fbo = std::make_shared<frame_buffer>(textures);
+	fbos_[key] = std::pair<std::shared_ptr<frame_buffer>, bool>(fbo, true);
+	return fbo;
+}
+
+void transient_texture_pool::end_frame(std::uint32_t max_unused_frames)
+{
+	for(auto it = fbos_.begin(); it != fbos_.end();)
+	{
+		bool& used_this_frame = it->second.second;
+		if(!used_this_frame)
+		{
+			// also lets go of imported textures the frame buffer refers to
+			it = fbos_.erase(it);
+		}
+		else
+		{
+			used_this_frame = false;
+			++it;
+		}
+	}
+
+	const auto frame = frame_;
+	entries_.erase(std::remove_if(std::begin(entries_), std::end(entries_),
+								  [frame, max_unused_frames](const entry& e) {
+									  return !e.in_use && frame - e.last_used_frame >= max_unused_frames;
+								  }),
+				   std::end(entries_));
+
+	frame_++;
+}
+
+transient_texture_pool::stats transient_texture_pool::get_stats() const
+{
+	stats result;
+	result.texture_count = entries_.size();
+	for(const auto& e : entries_)
+	{
+		result.texture_bytes += get_storage_size(e.desc);
+	}
+	result.fbo_count = fbos_.size();
+	return result;
+}
+
+frame_graph::builder::builder(frame_graph& graph, std::size_t pass)
+	: graph_(graph)
+	, pass_(pass)
+{
+}
+
+frame_graph::resource_id frame_graph::builder::create(const std::string& name,
+													  const transient_texture_desc& desc)
+{
+	resource res;
+	res.name = name;
+	res.desc = desc;
+	graph_.resources_.emplace_back(res);
+	return write(resource_id(graph_.resources_.size() - 1));
+}
+
+frame_graph::resource_id frame_graph::builder::read(resource_id id)
+{
+	assert(id < graph_.resources_.size());
+	graph_.passes_[pass_].reads.emplace_back(id);
+	return id;
+}
+
+frame_graph::resource_id frame_graph::builder::write(resource_id id)
+{
+	assert(id < graph_.resources_.size());
+	graph_.passes_[pass_].writes.emplace_back(id);
+	graph_.resources_[id].producers.emplace_back(pass_);
+	return id;
+}
+
+void frame_graph::builder::side_effect()
+{
+	graph_.passes_[pass_].side_effect = true;
+}
+
+frame_graph::resources::resources(const frame_graph& graph)
+	: graph_(graph)
+{
+}
+
+const std::shared_ptr<texture>& frame_graph::resources::get_texture(resource_id id) const
+{
+	const auto& res = graph_.resources_[id];
+	if(res.imported)
+	{
+		return res.imported_texture;
+	}
+
+	return graph_.borrowed_[res.physical];
+}
+
+std::shared_ptr<frame_buffer> frame_graph::resources::get_fbo(const std::vector<resource_id>& ids) const
+{
+	std::vector<std::shared_ptr<texture>> textures;
+	textures.reserve(ids.size());
+	for(auto id : ids)
+	{
+		textures.emplace_back(get_texture(id));
+	}
+
+	return graph_.pool_.get_fbo(textures);
+}
+
+frame_graph::frame_graph(transient_texture_pool& pool)
+	: pool_(pool)
+{
+}
+
+frame_graph::resource_id frame_graph::import_texture(const std::string& name,
+													 const std::shared_ptr<texture>& tex)
+{
+	resource res;
+	res.name = name;
+	res.imported = true;
+	res.imported_texture = tex;
+	resources_.emplace_back(res);
+	return resource_id(resources_.size() - 1);
+}
+
+void frame_graph::add_pass(const std::string& name, const setup_t& setup, const execute_t& execute)
+{
+	pass p;
+	p.name = name;
+	p.location = profiling::is_enabled() ? &profiling::get_location(name) : nullptr;
+	p.execute = execute;
+	passes_.emplace_back(p);
+
+	builder b(*this, passes_.size() - 1);
+	setup(b);
+}
+
+void frame_graph::compile()
+{
+	cull();
+	compute_lifetimes();
+	assign_physical();
+}
+
+void frame_graph::cull()
+{
+	// writes to imported textures are visible outside of the graph
+	for(auto& p : passes_)
+	{
+		p.ref_count = p.writes.size();
+		p.culled = false;
+		for(auto id : p.writes)
+		{
+			p.side_effect |= resources_[id].imported;
+		}
+	}
+
+	for(auto& res : resources_)
+	{
+		res.ref_count = 0;
+	}
+	for(const auto& p : passes_)
+	{
+		for(auto id : p.reads)
+		{
+			resources_[id].ref_count++;
+		}
+	}
+
+	std::vector<resource_id> unused;
+	for(resource_id id = 0; id < resources_.size(); ++id)
+	{
+		if(resources_[id].ref_count == 0 && !resources_[id].imported)
+		{
+			unused.emplace_back(id);
+		}
+	}
+
+	// walk back from the unread resources and drop the passes whose every
+	// result goes unread
+	while(!unused.empty())
+	{
+		const auto id = unused.back();
+		unused.pop_back();
+
+		for(auto producer : resources_[id].producers)
+		{
+			auto& p = passes_[producer];
+			if(p.ref_count == 0 || --p.ref_count > 0 || p.side_effect)
+			{
+				continue;
+			}
+
+			p.culled = true;
+			for(auto read : p.reads)
+			{
+				auto& res = resources_[read];
+				if(--res.ref_count == 0 && !res.imported)
+				{
+					unused.emplace_back(read);
+				}
+			}
+		}
+	}
+}
+
+void frame_graph::compute_lifetimes()
+{
+	for(auto& res : resources_)
+	{
+		res.first_use = invalid_index;
+		res.last_use = invalid_index;
+	}
+
+	for(std::size_t i = 0; i < passes_.size(); ++i)
+	{
+		const auto& p = passes_[i];
+		if(p.culled)
+		{
+			continue;
+		}
+
+		for(const auto* ids : {&p.reads, &p.writes})
+		{
+			for(auto id : *ids)
+			{
+				auto& res = resources_[id];
+				if(res.first_use == invalid_index)
+				{
+					res.first_use = i;
+				}
+				res.last_use = i;
+			}
+		}
+	}
+}
+
+void frame_graph::assign_physical()
+{
+	physical_.clear();
+	report_ = {};
+	report_.pass_count = passes_.size();
+
+	std::vector<std::size_t> free_physical;
+	for(std::size_t i = 0; i < passes_.size(); ++i)
+	{
+		if(passes_[i].culled)
+		{
+			report_.culled_pass_count++;
+			continue;
+		}
+
+		for(auto& res : resources_)
+		{
+			if(res.imported || res.first_use != i)
+			{
+				continue;
+			}
+
+			auto it = std::find_if(std::begin(free_physical), std::end(free_physical),
+								   [this, &res](std::size_t index) { return physical_[index] == res.desc; });
+			if(it != std::end(free_physical))
+			{
+				res.physical = *it;
+				free_physical.erase(it);
+			}
+			else
+			{
+				res.physical = physical_.size();
+				physical_.emplace_back(res.desc);
+				report_.allocated_bytes += get_storage_size(res.desc);
+			}
+
+			report_.transient_count++;
+			report_.requested_bytes += get_storage_size(res.desc);
+		}
+
+		// released only after every texture of the pass got its target, a
+		// texture can't alias one used by the same pass
+		for(auto& res : resources_)
+		{
+			if(!res.imported && res.last_use == i)
+			{
+				free_physical.emplace_back(res.physical);
+			}
+		}
+	}
+
+	report_.physical_count = physical_.size();
+}
+
+void frame_graph::execute()
+{
+	borrowed_.clear();
+	borrowed_.reserve(physical_.size());
+	for(const auto& desc : physical_)
+	{
+		borrowed_.emplace_back(pool_.acquire(desc));
+	}
+
+	resources res(*this);
+	for(const auto& p : passes_)
+	{
+		if(!p.culled)
+		{
+			profiling::scoped_zone zone(p.location);
+			p.execute(res);
+		}
+	}
+
+	for(const auto& tex : borrowed_)
+	{
+		pool_.release(tex);
+	}
+	borrowed_.clear();
+}
+
+bool frame_graph::is_culled(std::size_t pass) const
+{
+	return passes_[pass].culled;
+}
+
+std::size_t frame_graph::get_physical_index(resource_id id) const
+{
+	return resources_[id].physical;
+}
+
+const frame_graph::memory_report& frame_graph::get_memory_report() const
+{
+	return report_;
+}
+}
@@ -0,0 +1,330 @@
+#pragma once
+
+#include "format.h"
+#include "frame_buffer.h"
+#include "render_view_keys.h"
+#include "texture.h"
+#include "../profiling/profiler.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace gfx
+{
+struct transient_texture_desc
+{
+	std::uint16_t width = 0;
+	std::uint16_t height = 0;
+	texture_format format = texture_format::Count;
+	std::uint64_t flags = get_default_rt_sampler_flags();
+};
+
+bool operator==(const transient_texture_desc& desc1, const transient_texture_desc& desc2);
+
+//-----------------------------------------------------------------------------
+//  Name : get_storage_size ()
+/// <summary>
+/// Bytes taken by a render target of the description.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::size_t get_storage_size(const transient_texture_desc& desc);
+
+//-----------------------------------------------------------------------------
+// Main Class Declarations
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//  Name : transient_texture_pool (Class)
+/// <summary>
+/// Render targets shared by all frame graphs. Graphs borrow textures for
+/// their execution and hand them back afterwards, so the passes of every
+/// view and probe face rendered in a frame reuse the same memory. Views are
+/// submitted in order, which makes the reuse safe on the gpu as well.
+/// </summary>
+//-----------------------------------------------------------------------------
+class transient_texture_pool
+{
+public:
+	struct stats
+	{
+		/// Textures owned by the pool.
+		std::size_t texture_count = 0;
+		/// Bytes of the textures owned by the pool.
+		std::size_t texture_bytes = 0;
+		/// Frame buffers cached by the pool.
+		std::size_t fbo_count = 0;
+	};
+
+	//-----------------------------------------------------------------------------
+	//  Name : acquire ()
+	/// <summary>
+	/// Returns a free texture of the description, creating it if needed.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::shared_ptr<texture> acquire(const transient_texture_desc& desc);
+
+	//-----------------------------------------------------------------------------
+	//  Name : release ()
+	/// <summary>
+	/// Gives the texture back to the pool.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void release(const std::shared_ptr<texture>& tex);
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_fbo ()
+	/// <summary>
+	/// Frame buffer for the attachments, cached while it is used.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::shared_ptr<frame_buffer> get_fbo(const std::vector<std::shared_ptr<texture>>& textures);
+
+	//-----------------------------------------------------------------------------
+	//  Name : end_frame ()
+	/// <summary>
+	/// Drops the frame buffers not used this frame and the textures that
+	/// stayed free for the given number of frames.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void end_frame(std::uint32_t max_unused_frames = 3);
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_stats ()
+	/// <summary>
+	/// Current usage of the pool.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	stats get_stats() const;
+
+private:
+	struct entry
+	{
+		transient_texture_desc desc;
+		std::shared_ptr<texture> tex;
+		bool in_use = false;
+		std::uint32_t last_used_frame = 0;
+	};
+
+	/// Textures owned by the pool.
+	std::vector<entry> entries_;
+	/// Frame buffers over pool or imported textures, flagged when used.
+	std::unordered_map<fbo_key, std::pair<std::shared_ptr<frame_buffer>, bool>> fbos_;
+	/// Frames seen by end_frame.
+	std::uint32_t frame_ = 0;
+};
+
+//-----------------------------------------------------------------------------
+//  Name : frame_graph (Class)
+/// <summary>
+/// Declarative description of the passes of one view. Passes declare the
+/// textures they create, read and write in a setup callback. compile() drops
+/// the passes whose results nobody reads, computes the lifetime of every
+/// transient texture and lets textures whose lifetimes don't overlap share
+/// the same render target. execute() then runs the remaining passes in
+/// declaration order. Imported textures are owned elsewhere, writing one
+/// keeps the pass alive.
+/// </summary>
+//-----------------------------------------------------------------------------
+class frame_graph
+{
+public:
+	using resource_id = std::uint32_t;
+
+	struct memory_report
+	{
+		/// Declared passes.
+		std::size_t pass_count = 0;
+		/// Passes dropped because nothing reads their results.
+		std::size_t culled_pass_count = 0;
+		/// Transient textures used by the remaining passes.
+		std::size_t transient_count = 0;
+		/// Render targets they were packed into.
+		std::size_t physical_count = 0;
+		/// Bytes the transient textures would take on their own.
+		std::size_t requested_bytes = 0;
+		/// Bytes of the render targets after aliasing.
+		std::size_t allocated_bytes = 0;
+	};
+
+	class builder
+	{
+	public:
+		//-----------------------------------------------------------------------------
+		//  Name : create ()
+		/// <summary>
+		/// Declares a transient texture written by the pass.
+		/// </summary>
+		//-----------------------------------------------------------------------------
+		resource_id create(const std::string& name, const transient_texture_desc& desc);
+
+		//-----------------------------------------------------------------------------
+		//  Name : read ()
+		/// <summary>
+		/// Declares that the pass samples the texture.
+		/// </summary>
+		//-----------------------------------------------------------------------------
+		resource_id read(resource_id id);
+
+		//-----------------------------------------------------------------------------
+		//  Name : write ()
+		/// <summary>
+		/// Declares that the pass renders to the texture.
+		/// </summary>
+		//-----------------------------------------------------------------------------
+		resource_id write(resource_id id);
+
+		//-----------------------------------------------------------------------------
+		//  Name : side_effect ()
+		/// <summary>
+		/// The pass does something outside of the graph and is never culled.
+		/// </summary>
+		//-----------------------------------------------------------------------------
+		void side_effect();
+
+	private:
+		friend class frame_graph;
+		builder(frame_graph& graph, std::size_t pass);
+
+		frame_graph& graph_;
+		std::size_t pass_;
+	};
+
+	class resources
+	{
+	public:
+		//-----------------------------------------------------------------------------
+		//  Name : get_texture ()
+		/// <summary>
+		/// The render target backing the resource during the pass.
+		/// </summary>
+		//-----------------------------------------------------------------------------
+		const std::shared_ptr<texture>& get_texture(resource_id id) const;
+
+		//-----------------------------------------------------------------------------
+		//  Name : get_fbo ()
+		/// <summary>
+		/// Frame buffer with the resources as attachments, in order.
+		/// </summary>
+		//-----------------------------------------------------------------------------
+		std::shared_ptr<frame_buffer> get_fbo(const std::vector<resource_id>& ids) const;
+
+	private:
+		friend class frame_graph;
+		resources(const frame_graph& graph);
+
+		const frame_graph& graph_;
+	};
+
+	using setup_t = std::function<void(builder&)>;
+	using execute_t = std::function<void(const resources&)>;
+
+	frame_graph(transient_texture_pool& pool);
+
+	//-----------------------------------------------------------------------------
+	//  Name : import_texture ()
+	/// <summary>
+	/// Makes a texture owned outside of the graph usable by the passes.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	resource_id import_texture(const std::string& name, const std::shared_ptr<texture>& tex);
+
+	//-----------------------------------------------------------------------------
+	//  Name : add_pass ()
+	/// <summary>
+	/// Adds a pass. The setup callback runs right away, the execute callback
+	/// runs from execute() unless the pass gets culled.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void add_pass(const std::string& name, const setup_t& setup, const execute_t& execute);
+
+	//-----------------------------------------------------------------------------
+	//  Name : compile ()
+	/// <summary>
+	/// Culls the passes, computes the lifetimes and assigns the transient
+	/// textures to render targets.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void compile();
+
+	//-----------------------------------------------------------------------------
+	//  Name : execute ()
+	/// <summary>
+	/// Borrows the render targets from the pool, runs the passes and hands
+	/// the render targets back.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void execute();
+
+	//-----------------------------------------------------------------------------
+	//  Name : is_culled ()
+	/// <summary>
+	/// Was the pass dropped by compile().
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool is_culled(std::size_t pass) const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_physical_index ()
+	/// <summary>
+	/// Render target the transient resource was assigned to by compile(),
+	/// resources sharing the index alias each other.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::size_t get_physical_index(resource_id id) const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_memory_report ()
+	/// <summary>
+	/// Memory use of the compiled graph.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	const memory_report& get_memory_report() const;
+
+private:
+	static constexpr std::size_t invalid_index = ~std::size_t(0);
+
+	struct resource
+	{
+		std::string name;
+		transient_texture_desc desc;
+		/// Owned outside of the graph, never aliased.
+		bool imported = false;
+		std::shared_ptr<texture> imported_texture;
+		/// Passes writing the resource.
+		std::vector<std::size_t> producers;
+		std::size_t ref_count = 0;
+		std::size_t first_use = invalid_index;
+		std::size_t last_use = invalid_index;
+		std::size_t physical = invalid_index;
+	};
+
+	struct pass
+	{
+		std::string name;
+		/// Looked up when the pass is added, null while not recording.
+		const profiling::source_location* location = nullptr;
+		execute_t execute;
+		std::vector<resource_id> reads;
+		std::vector<resource_id> writes;
+		bool side_effect = false;
+		std::size_t ref_count = 0;
+		bool culled = false;
+	};
+
+	void cull();
+	void compute_lifetimes();
+	void assign_physical();
+
+	transient_texture_pool& pool_;
+	std::vector<resource> resources_;
+	std::vector<pass> passes_;
+	/// Descriptions of the render targets after aliasing.
+	std::vector<transient_texture_desc> physical_;
+	/// Render targets borrowed while executing.
+	std::vector<std::shared_ptr<texture>> borrowed_;
+	memory_report report_;
+};
+}
@@ -14,7 +14,7 @@ program::program(const std::shared_ptr<shader>& compute_shader)
 
 		for(auto& uniform : compute_shader->uniforms)
 		{
-			uniforms[uniform->info.name] = uniform;
+			add_uniform(uniform->info.name, uniform);
 		}
 	}
 }
@@ -27,12 +27,12 @@ program::program(const std::shared_ptr<shader>& vertex_shader, const std::shared
 
 		for(auto& uniform : vertex_shader->uniforms)
 		{
-			uniforms[uniform->info.name] = uniform;
+			add_uniform(uniform->info.name, uniform);
 		}
 
 		for(auto& uniform : fragment_shader->uniforms)
 		{
-			uniforms[uniform->info.name] = uniform;
+			add_uniform(uniform->info.name, uniform);
 		}
 	}
 }
@@ -61,6 +61,30 @@ void program::set_texture(std::uint8_t _stage, const std::string& _sampler, gfx:
 	gfx::set_texture(_stage, get_uniform(_sampler, true)->native_handle(), _texture->native_handle(), _flags);
 }
 
+void program::set_texture(std::uint8_t _stage, const uniform_id& _sampler, gfx::frame_buffer* frameBuffer,
+						  uint8_t _attachment /*= 0 */,
+						  std::uint32_t _flags /*= std::numeric_limits<std::uint32_t>::max()*/)
+{
+	if(frameBuffer == nullptr)
+	{
+		return;
+	}
+
+	gfx::set_texture(_stage, get_uniform(_sampler, true)->native_handle(),
+					 frameBuffer->get_texture(_attachment)->native_handle(), _flags);
+}
+
+void program::set_texture(std::uint8_t _stage, const uniform_id& _sampler, gfx::texture* _texture,
+						  std::uint32_t _flags /*= std::numeric_limits<std::uint32_t>::max()*/)
+{
+	if(_texture == nullptr)
+	{
+		return;
+	}
+
+	gfx::set_texture(_stage, get_uniform(_sampler, true)->native_handle(), _texture->native_handle(), _flags);
+}
+
 void program::set_uniform(const std::string& _name, const void* _value, uint16_t _num)
 {
 	auto uniform = get_uniform(_name);
@@ -71,6 +95,16 @@ void program::set_uniform(const std::string& _name, const void* _value, uint16_t
 	}
 }
 
+void program::set_uniform(const uniform_id& _id, const void* _value, uint16_t _num)
+{
+	auto uniform = get_uniform(_id);
+
+	if(uniform != nullptr)
+	{
+		gfx::set_uniform(uniform->native_handle(), _value, _num);
+	}
+}
+
 std::shared_ptr<gfx::uniform> program::get_uniform(const std::string& _name, bool texture)
 {
 	std::shared_ptr<gfx::uniform> hUniform;
@@ -84,10 +118,39 @@ std::shared_ptr<gfx::uniform> program::get_uniform(const std::string& _name, boo
 		if(texture)
 		{
 			hUniform = std::make_shared<gfx::uniform>(_name, gfx::uniform_type::Int1, 1);
-			uniforms[_name] = hUniform;
+			add_uniform(_name, hUniform);
 		}
 	}
 
 	return hUniform;
 }
+
+gfx::uniform* program::get_uniform(const uniform_id& _id, bool texture)
+{
+	const auto index = _id.get_index();
+	if(index < uniforms_by_id.size() && uniforms_by_id[index] != nullptr)
+	{
+		return uniforms_by_id[index];
+	}
+
+	// unknown to this program, only samplers get created on demand
+	if(!texture)
+	{
+		return nullptr;
+	}
+
+	return get_uniform(_id.get_name(), true).get();
+}
+
+void program::add_uniform(const std::string& _name, const std::shared_ptr<gfx::uniform>& _uniform)
+{
+	uniforms[_name] = _uniform;
+
+	const auto index = uniform_id::intern(_name);
+	if(index >= uniforms_by_id.size())
+	{
+		uniforms_by_id.resize(index + 1, nullptr);
+	}
+	uniforms_by_id[index] = _uniform.get();
+}
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "handle_impl.h"
+#include "uniform_id.h"
 #include <limits>
 #include <memory>
 #include <unordered_map>
@@ -68,6 +69,25 @@ struct program : public handle_impl<program_handle>
 	void set_texture(std::uint8_t _stage, const std::string& _sampler, gfx::texture* _texture,
 					 std::uint32_t _flags = std::numeric_limits<std::uint32_t>::max());
 
+	//-----------------------------------------------------------------------------
+	//  Name : set_texture ()
+	/// <summary>
+	/// Same as the string version, but the sampler is found by array index.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_texture(std::uint8_t _stage, const uniform_id& _sampler, gfx::frame_buffer* _handle,
+					 uint8_t _attachment = 0,
+					 std::uint32_t _flags = std::numeric_limits<std::uint32_t>::max());
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_texture ()
+	/// <summary>
+	/// Same as the string version, but the sampler is found by array index.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_texture(std::uint8_t _stage, const uniform_id& _sampler, gfx::texture* _texture,
+					 std::uint32_t _flags = std::numeric_limits<std::uint32_t>::max());
+
 	//-----------------------------------------------------------------------------
 	//  Name : set_uniform ()
 	/// <summary>
@@ -78,6 +98,14 @@ struct program : public handle_impl<program_handle>
 	//-----------------------------------------------------------------------------
 	void set_uniform(const std::string& _name, const void* _value, std::uint16_t _num = 1);
 
+	//-----------------------------------------------------------------------------
+	//  Name : set_uniform ()
+	/// <summary>
+	/// Same as the string version, but the uniform is found by array index.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_uniform(const uniform_id& _id, const void* _value, std::uint16_t _num = 1);
+
 	//-----------------------------------------------------------------------------
 	//  Name : get_uniform ()
 	/// <summary>
@@ -88,7 +116,26 @@ struct program : public handle_impl<program_handle>
 	//-----------------------------------------------------------------------------
 	std::shared_ptr<gfx::uniform> get_uniform(const std::string& _name, bool texture = false);
 
+	//-----------------------------------------------------------------------------
+	//  Name : get_uniform ()
+	/// <summary>
+	/// Looks the uniform up by its interned index. Samplers the program does
+	/// not know yet are created through the string version once.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	gfx::uniform* get_uniform(const uniform_id& _id, bool texture = false);
+
+	//-----------------------------------------------------------------------------
+	//  Name : add_uniform ()
+	/// <summary>
+	/// Registers the uniform by name and by interned index.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void add_uniform(const std::string& _name, const std::shared_ptr<gfx::uniform>& _uniform);
+
 	/// All uniforms for this program.
 	std::unordered_map<std::string, std::shared_ptr<gfx::uniform>> uniforms;
+	/// The same uniforms indexed by uniform_id, empty slots are unknown names.
+	std::vector<gfx::uniform*> uniforms_by_id;
 };
 }
@@ -207,4 +207,14 @@ void render_view::release_unused_resources()
 	check_resources(fbos_);
 	check_resources(textures_);
 }
+
+void render_view::set_retain_g_buffer(bool retain)
+{
+	retain_g_buffer_ = retain;
+}
+
+bool render_view::get_retain_g_buffer() const
+{
+	return retain_g_buffer_;
+}
 } // namespace gfx
@@ -45,8 +45,19 @@ public:
 
 	void release_unused_resources();
 
+	//-----------------------------------------------------------------------------
+	//  Name : set_retain_g_buffer ()
+	/// <summary>
+	/// Renderers keep the g-buffer of a retaining view in the view itself
+	/// instead of sharing it with the other views, e.g. to show it later.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_retain_g_buffer(bool retain);
+	bool get_retain_g_buffer() const;
+
 private:
 	std::unordered_map<texture_key, std::pair<std::shared_ptr<texture>, bool>> textures_;
 	std::unordered_map<fbo_key, std::pair<std::shared_ptr<frame_buffer>, bool>> fbos_;
+	bool retain_g_buffer_ = false;
 };
 }
@@ -0,0 +1,60 @@
+#include "uniform_id.h"
+
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace gfx
+{
+namespace
+{
+struct registry
+{
+	std::mutex mutex;
+	std::unordered_map<std::string, uniform_id::index_t> indices;
+	/// Names by index, a deque so references to them stay valid.
+	std::deque<std::string> names;
+};
+
+registry& get_registry()
+{
+	// ids are usually statics, so this has to exist before any of them
+	static registry reg;
+	return reg;
+}
+}
+
+uniform_id::uniform_id(const std::string& name)
+	: index_(intern(name))
+{
+}
+
+const std::string& uniform_id::get_name() const
+{
+	return get_name(index_);
+}
+
+uniform_id::index_t uniform_id::intern(const std::string& name)
+{
+	auto& reg = get_registry();
+	std::lock_guard<std::mutex> lock(reg.mutex);
+
+	auto it = reg.indices.find(name);
+	if(it != reg.indices.end())
+	{
+		return it->second;
+	}
+
+	const auto index = static_cast<index_t>(reg.names.size());
+	reg.names.emplace_back(name);
+	reg.indices.emplace(name, index);
+	return index;
+}
+
+const std::string& uniform_id::get_name(index_t index)
+{
+	auto& reg = get_registry();
+	std::lock_guard<std::mutex> lock(reg.mutex);
+	return reg.names.at(index);
+}
+}
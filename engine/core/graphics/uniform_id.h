@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace gfx
+{
+//-----------------------------------------------------------------------------
+// Main Class Declarations
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//  Name : uniform_id (Class)
+/// <summary>
+/// Interned uniform name. Every distinct name gets a dense index once, on
+/// construction, which programs use to find their uniform with an array
+/// lookup instead of hashing the name on every set. Meant to be created
+/// once and kept, e.g. as a static next to the code that sets the uniform.
+/// </summary>
+//-----------------------------------------------------------------------------
+class uniform_id
+{
+public:
+	using index_t = std::uint32_t;
+
+	//-----------------------------------------------------------------------------
+	//  Name : uniform_id ()
+	/// <summary>
+	/// Interns the name, the same name always yields the same index.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	explicit uniform_id(const std::string& name);
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_index ()
+	/// <summary>
+	/// Dense index of the name.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	index_t get_index() const
+	{
+		return index_;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_name ()
+	/// <summary>
+	/// The interned name.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	const std::string& get_name() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : intern () (Static)
+	/// <summary>
+	/// Returns the index of the name, registering it if it is new.
+	/// Thread safe.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	static index_t intern(const std::string& name);
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_name () (Static)
+	/// <summary>
+	/// The name registered for the index.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	static const std::string& get_name(index_t index);
+
+private:
+	/// Dense index of the name.
+	index_t index_ = 0;
+};
+
+inline bool operator==(const uniform_id& lhs, const uniform_id& rhs)
+{
+	return lhs.get_index() == rhs.get_index();
+}
+
+inline bool operator!=(const uniform_id& lhs, const uniform_id& rhs)
+{
+	return !(lhs == rhs);
+}
+}
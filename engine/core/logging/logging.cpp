@@ -1,6 +1,139 @@
 #include "logging.h"
 
-int logging_obj_export_symbols()
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace logging
+{
+namespace
+{
+/// Records queued before the callers wait for the worker, a power of two.
+constexpr std::size_t async_queue_size = 8192;
+/// Longest a record waits in the queue while nobody asks for a flush.
+constexpr std::chrono::milliseconds async_flush_interval(500);
+
+std::mutex app_logger_mutex;
+std::shared_ptr<logger> app_logger;
+std::atomic<logger*> app_logger_ptr{nullptr};
+/// Replaced loggers, kept alive for the callers still using them.
+std::vector<std::shared_ptr<logger>> retired_loggers;
+
+/// Nobody must wait for the worker from the worker itself.
+std::atomic<std::thread::id> worker_thread_id{std::thread::id()};
+std::atomic_flag crashing = ATOMIC_FLAG_INIT;
+std::terminate_handler previous_terminate = nullptr;
+
+void flush_for_crash()
+{
+	if(crashing.test_and_set())
+	{
+		return;
+	}
+	flush();
+}
+
+void on_terminate()
+{
+	flush_for_crash();
+	if(previous_terminate != nullptr)
+	{
+		previous_terminate();
+	}
+	std::abort();
+}
+
+void set_app_logger(std::shared_ptr<logger> log)
+{
+	app_logger = std::move(log);
+	app_logger_ptr.store(app_logger.get(), std::memory_order_release);
+}
+}
+
+std::shared_ptr<logger> create_app_logger(const sink_ptr& sink, bool async)
+{
+	std::lock_guard<std::mutex> lock(app_logger_mutex);
+	if(app_logger != nullptr)
+	{
+		retired_loggers.emplace_back(app_logger);
+	}
+	drop(APPLOG);
+
+	if(async)
+	{
+		// only the app logger is async, others keep writing as they log
+		set_async_mode(async_queue_size, async_overflow_policy::block_retry,
+					   []() { worker_thread_id.store(std::this_thread::get_id()); }, async_flush_interval);
+	}
+	auto log = create(APPLOG, sink);
+	if(async)
+	{
+		set_sync_mode();
+	}
+
+	set_app_logger(log);
+	return log;
+}
+
+logger* get_app_logger()
+{
+	auto log = app_logger_ptr.load(std::memory_order_acquire);
+	if(log != nullptr)
+	{
+		return log;
+	}
+
+	// created straight through spdlog
+	std::lock_guard<std::mutex> lock(app_logger_mutex);
+	if(app_logger == nullptr)
+	{
+		set_app_logger(get(APPLOG));
+	}
+	return app_logger.get();
+}
+
+void flush()
+{
+	if(std::this_thread::get_id() == worker_thread_id.load(std::memory_order_relaxed))
+	{
+		return;
+	}
+
+	auto log = app_logger_ptr.load(std::memory_order_acquire);
+	if(log != nullptr)
+	{
+		log->flush();
+	}
+}
+
+void shutdown()
+{
+	std::lock_guard<std::mutex> lock(app_logger_mutex);
+	if(app_logger == nullptr || std::dynamic_pointer_cast<async_logger>(app_logger) == nullptr)
+	{
+		return;
+	}
+
+	app_logger->flush();
+
+	auto sync_logger = std::make_shared<logger>(APPLOG, std::begin(app_logger->sinks()),
+												std::end(app_logger->sinks()));
+	sync_logger->set_level(app_logger->level());
+	drop(APPLOG);
+	register_logger(sync_logger);
+
+	retired_loggers.emplace_back(app_logger);
+	set_app_logger(sync_logger);
+}
+
+void flush_on_crash()
 {
-	return 0;
-}
\ No newline at end of file
+	// flushing waits on locks and the worker, which a signal handler must not
+	// do, so fatal signals are left to their default action
+	previous_terminate = std::set_terminate(on_terminate);
+}
+}
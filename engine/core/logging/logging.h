@@ -47,6 +47,25 @@ using platform_sink_st = stdout_sink_st;
 #endif
 #include <spdlog/sinks/dist_sink.h>
 #include <spdlog/sinks/file_sinks.h>
+
+#include <memory>
+
+// levels for APPLOG_ACTIVE_LEVEL, calls below it are compiled out
+#define APPLOG_LEVEL_TRACE 0
+#define APPLOG_LEVEL_DEBUG 1
+#define APPLOG_LEVEL_INFO 2
+#define APPLOG_LEVEL_WARNING 3
+#define APPLOG_LEVEL_ERROR 4
+#define APPLOG_LEVEL_OFF 5
+
+#ifndef APPLOG_ACTIVE_LEVEL
+#if defined(NDEBUG)
+#define APPLOG_ACTIVE_LEVEL APPLOG_LEVEL_INFO
+#else
+#define APPLOG_ACTIVE_LEVEL APPLOG_LEVEL_TRACE
+#endif
+#endif
+
 namespace logging
 {
 using namespace spdlog;
@@ -55,11 +74,88 @@ inline std::shared_ptr<sinks::dist_sink_mt> get_mutable_logging_container()
 	static auto sink = std::make_shared<sinks::dist_sink_mt>();
 	return sink;
 }
+
+//-----------------------------------------------------------------------------
+//  Name : create_app_logger ()
+/// <summary>
+/// Creates the logger the APPLOG macros write to. An async logger only
+/// queues the records, a background thread formats and writes them.
+/// Errors still wait until they are written.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::shared_ptr<logger> create_app_logger(const sink_ptr& sink, bool async = true);
+
+//-----------------------------------------------------------------------------
+//  Name : get_app_logger ()
+/// <summary>
+/// The logger the APPLOG macros write to, without a registry lookup.
+/// </summary>
+//-----------------------------------------------------------------------------
+logger* get_app_logger();
+
+//-----------------------------------------------------------------------------
+//  Name : flush ()
+/// <summary>
+/// Blocks until every queued record is written. Does nothing on the
+/// thread writing them.
+/// </summary>
+//-----------------------------------------------------------------------------
+void flush();
+
+//-----------------------------------------------------------------------------
+//  Name : shutdown ()
+/// <summary>
+/// Writes the queued records and logs synchronously from then on, for
+/// whatever is logged while the app is torn down.
+/// </summary>
+//-----------------------------------------------------------------------------
+void shutdown();
+
+//-----------------------------------------------------------------------------
+//  Name : flush_on_crash ()
+/// <summary>
+/// Writes the queued records before the process dies of an unhandled
+/// exception, unless the logger worker itself threw it. A fatal signal
+/// loses the records still queued, but APPLOG_ERROR waits until its record
+/// and everything before it is written, so the last errors survive.
+/// </summary>
+//-----------------------------------------------------------------------------
+void flush_on_crash();
+}
+
 #define APPLOG "Log"
-#define APPLOG_INFO(...) spdlog::get(APPLOG)->info(__VA_ARGS__)
-#define APPLOG_TRACE(...) spdlog::get(APPLOG)->trace(__VA_ARGS__)
-#define APPLOG_ERROR(...) spdlog::get(APPLOG)->error(__VA_ARGS__)
-#define APPLOG_WARNING(...) spdlog::get(APPLOG)->warn(__VA_ARGS__)
-#define APPLOG_NOTICE(...) spdlog::get(APPLOG)->notice(__VA_ARGS__)
+
+#if APPLOG_ACTIVE_LEVEL <= APPLOG_LEVEL_TRACE
+#define APPLOG_TRACE(...) logging::get_app_logger()->trace(__VA_ARGS__)
+#else
+#define APPLOG_TRACE(...) (void)0
+#endif
+
+#if APPLOG_ACTIVE_LEVEL <= APPLOG_LEVEL_DEBUG
+#define APPLOG_DEBUG(...) logging::get_app_logger()->debug(__VA_ARGS__)
+#else
+#define APPLOG_DEBUG(...) (void)0
+#endif
+
+#if APPLOG_ACTIVE_LEVEL <= APPLOG_LEVEL_INFO
+#define APPLOG_INFO(...) logging::get_app_logger()->info(__VA_ARGS__)
+#define APPLOG_NOTICE(...) logging::get_app_logger()->info(__VA_ARGS__)
+#else
+#define APPLOG_INFO(...) (void)0
+#define APPLOG_NOTICE(...) (void)0
+#endif
+
+#if APPLOG_ACTIVE_LEVEL <= APPLOG_LEVEL_WARNING
+#define APPLOG_WARNING(...) logging::get_app_logger()->warn(__VA_ARGS__)
+#else
+#define APPLOG_WARNING(...) (void)0
+#endif
+
+#if APPLOG_ACTIVE_LEVEL <= APPLOG_LEVEL_ERROR
+// errors are written before the call returns, a crash may follow them
+#define APPLOG_ERROR(...) (logging::get_app_logger()->error(__VA_ARGS__), logging::flush())
+#else
+#define APPLOG_ERROR(...) (void)0
+#endif
+
 #define APPLOG_SEPARATOR() APPLOG_INFO("-----------------------------")
-}
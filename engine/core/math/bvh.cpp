@@ -0,0 +1,396 @@
+#include "bvh.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace math
+{
+///////////////////////////////////////////////////////////////////////////////
+// bvh Member Functions
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+//  Name : bvh () (Constructor)
+/// <summary>
+/// bvh Class Constructor
+/// </summary>
+//-----------------------------------------------------------------------------
+bvh::bvh(float margin)
+	: margin_(margin)
+{
+}
+
+//-----------------------------------------------------------------------------
+//  Name : insert ()
+/// <summary>
+/// Adds a box to the tree and returns its proxy.
+/// </summary>
+//-----------------------------------------------------------------------------
+bvh::proxy_t bvh::insert(const bbox& bounds, std::uint32_t user_data)
+{
+	const auto id = allocate_node();
+	auto& n = nodes_[std::size_t(id)];
+	n.bounds = bbox(bounds.min - vec3(margin_), bounds.max + vec3(margin_));
+	n.user_data = user_data;
+	n.height = 0;
+
+	insert_leaf(id);
+	proxy_count_++;
+	return id;
+}
+
+//-----------------------------------------------------------------------------
+//  Name : remove ()
+/// <summary>
+/// Removes the proxy from the tree.
+/// </summary>
+//-----------------------------------------------------------------------------
+void bvh::remove(proxy_t proxy)
+{
+	assert(proxy >= 0 && std::size_t(proxy) < nodes_.size() && nodes_[std::size_t(proxy)].is_leaf());
+
+	remove_leaf(proxy);
+	free_node(proxy);
+	proxy_count_--;
+}
+
+//-----------------------------------------------------------------------------
+//  Name : update ()
+/// <summary>
+/// Moves the proxy to new bounds, the tree is only touched if the bounds
+/// leave the fat box.
+/// </summary>
+//-----------------------------------------------------------------------------
+bool bvh::update(proxy_t proxy, const bbox& bounds)
+{
+	assert(proxy >= 0 && std::size_t(proxy) < nodes_.size() && nodes_[std::size_t(proxy)].is_leaf());
+
+	auto& fat = nodes_[std::size_t(proxy)].bounds;
+	if(contains(fat, bounds))
+	{
+		// a box shrunk far below its fat bounds would make the queries loose
+		const auto margin = vec3(margin_ * 4.0f);
+		if(contains(bbox(bounds.min - margin, bounds.max + margin), fat))
+		{
+			return false;
+		}
+	}
+
+	remove_leaf(proxy);
+	nodes_[std::size_t(proxy)].bounds = bbox(bounds.min - vec3(margin_), bounds.max + vec3(margin_));
+	insert_leaf(proxy);
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//  Name : clear ()
+/// <summary>
+/// Removes all proxies.
+/// </summary>
+//-----------------------------------------------------------------------------
+void bvh::clear()
+{
+	nodes_.clear();
+	root_ = null_node;
+	free_list_ = null_node;
+	proxy_count_ = 0;
+}
+
+//-----------------------------------------------------------------------------
+//  Name : get_user_data ()
+/// <summary>
+/// User data the proxy was inserted with.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::uint32_t bvh::get_user_data(proxy_t proxy) const
+{
+	return nodes_[std::size_t(proxy)].user_data;
+}
+
+//-----------------------------------------------------------------------------
+//  Name : get_fat_bounds ()
+/// <summary>
+/// Fattened box stored for the proxy.
+/// </summary>
+//-----------------------------------------------------------------------------
+const bbox& bvh::get_fat_bounds(proxy_t proxy) const
+{
+	return nodes_[std::size_t(proxy)].bounds;
+}
+
+//-----------------------------------------------------------------------------
+//  Name : get_proxy_count ()
+/// <summary>
+/// Number of proxies in the tree.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::size_t bvh::get_proxy_count() const
+{
+	return proxy_count_;
+}
+
+//-----------------------------------------------------------------------------
+//  Name : get_height ()
+/// <summary>
+/// Height of the tree.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::int32_t bvh::get_height() const
+{
+	return root_ == null_node ? -1 : nodes_[std::size_t(root_)].height;
+}
+
+bool bvh::overlaps(const bbox& a, const bbox& b)
+{
+	return a.min.x <= b.max.x && a.max.x >= b.min.x && a.min.y <= b.max.y && a.max.y >= b.min.y &&
+		   a.min.z <= b.max.z && a.max.z >= b.min.z;
+}
+
+bbox bvh::merge(const bbox& a, const bbox& b)
+{
+	return bbox(math::min(a.min, b.min), math::max(a.max, b.max));
+}
+
+bool bvh::contains(const bbox& outer, const bbox& inner)
+{
+	return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+		   outer.max.x >= inner.max.x && outer.max.y >= inner.max.y && outer.max.z >= inner.max.z;
+}
+
+float bvh::area(const bbox& b)
+{
+	const auto d = b.max - b.min;
+	return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+bvh::proxy_t bvh::allocate_node()
+{
+	if(free_list_ == null_node)
+	{
+		nodes_.emplace_back();
+		return proxy_t(nodes_.size() - 1);
+	}
+
+	const auto id = free_list_;
+	free_list_ = nodes_[std::size_t(id)].parent;
+	nodes_[std::size_t(id)] = node{};
+	return id;
+}
+
+void bvh::free_node(proxy_t id)
+{
+	auto& n = nodes_[std::size_t(id)];
+	n = node{};
+	n.parent = free_list_;
+	free_list_ = id;
+}
+
+void bvh::insert_leaf(proxy_t leaf)
+{
+	if(root_ == null_node)
+	{
+		root_ = leaf;
+		nodes_[std::size_t(root_)].parent = null_node;
+		return;
+	}
+
+	// walk down to the sibling with the smallest surface area increase
+	const auto leaf_bounds = nodes_[std::size_t(leaf)].bounds;
+	auto index = root_;
+	while(!nodes_[std::size_t(index)].is_leaf())
+	{
+		const auto& n = nodes_[std::size_t(index)];
+		const auto node_area = area(n.bounds);
+		const auto combined_area = area(merge(n.bounds, leaf_bounds));
+
+		// cost of making a new parent for this node and the leaf
+		const auto cost = 2.0f * combined_area;
+		// minimum cost of pushing the leaf further down
+		const auto inheritance_cost = 2.0f * (combined_area - node_area);
+
+		const auto child_cost = [&](proxy_t child) {
+			const auto& c = nodes_[std::size_t(child)];
+			const auto merged_area = area(merge(leaf_bounds, c.bounds));
+			if(c.is_leaf())
+			{
+				return merged_area + inheritance_cost;
+			}
+			return merged_area - area(c.bounds) + inheritance_cost;
+		};
+
+		const auto cost1 = child_cost(n.child1);
+		const auto cost2 = child_cost(n.child2);
+		if(cost < cost1 && cost < cost2)
+		{
+			break;
+		}
+
+		index = cost1 < cost2 ? n.child1 : n.child2;
+	}
+
+	// allocating may grow the storage, no references are held across it
+	const auto sibling = index;
+	const auto old_parent = nodes_[std::size_t(sibling)].parent;
+	const auto new_parent = allocate_node();
+	{
+		auto& p = nodes_[std::size_t(new_parent)];
+		p.parent = old_parent;
+		p.bounds = merge(leaf_bounds, nodes_[std::size_t(sibling)].bounds);
+		p.height = nodes_[std::size_t(sibling)].height + 1;
+		p.child1 = sibling;
+		p.child2 = leaf;
+	}
+
+	if(old_parent != null_node)
+	{
+		auto& op = nodes_[std::size_t(old_parent)];
+		if(op.child1 == sibling)
+		{
+			op.child1 = new_parent;
+		}
+		else
+		{
+			op.child2 = new_parent;
+		}
+	}
+	else
+	{
+		root_ = new_parent;
+	}
+	nodes_[std::size_t(sibling)].parent = new_parent;
+	nodes_[std::size_t(leaf)].parent = new_parent;
+
+	refit(new_parent);
+}
+
+void bvh::remove_leaf(proxy_t leaf)
+{
+	if(leaf == root_)
+	{
+		root_ = null_node;
+		return;
+	}
+
+	const auto parent = nodes_[std::size_t(leaf)].parent;
+	const auto grand_parent = nodes_[std::size_t(parent)].parent;
+	const auto sibling = nodes_[std::size_t(parent)].child1 == leaf ? nodes_[std::size_t(parent)].child2
+																	  : nodes_[std::size_t(parent)].child1;
+
+	if(grand_parent != null_node)
+	{
+		// the sibling takes the place of the parent
+		auto& gp = nodes_[std::size_t(grand_parent)];
+		if(gp.child1 == parent)
+		{
+			gp.child1 = sibling;
+		}
+		else
+		{
+			gp.child2 = sibling;
+		}
+		nodes_[std::size_t(sibling)].parent = grand_parent;
+		free_node(parent);
+
+		refit(grand_parent);
+	}
+	else
+	{
+		root_ = sibling;
+		nodes_[std::size_t(sibling)].parent = null_node;
+		free_node(parent);
+	}
+	nodes_[std::size_t(leaf)].parent = null_node;
+}
+
+void bvh::refit(proxy_t id)
+{
+	for(auto index = id; index != null_node;)
+	{
+		index = balance(index);
+
+		auto& n = nodes_[std::size_t(index)];
+		const auto& c1 = nodes_[std::size_t(n.child1)];
+		const auto& c2 = nodes_[std::size_t(n.child2)];
+		n.height = 1 + std::max(c1.height, c2.height);
+		n.bounds = merge(c1.bounds, c2.bounds);
+
+		index = n.parent;
+	}
+}
+
+bvh::proxy_t bvh::balance(proxy_t a_id)
+{
+	if(nodes_[std::size_t(a_id)].is_leaf() || nodes_[std::size_t(a_id)].height < 2)
+	{
+		return a_id;
+	}
+
+	const auto b_id = nodes_[std::size_t(a_id)].child1;
+	const auto c_id = nodes_[std::size_t(a_id)].child2;
+	const auto diff = nodes_[std::size_t(c_id)].height - nodes_[std::size_t(b_id)].height;
+
+	// lifts the taller child x of a in place of a, the taller grandchild
+	// stays under x and the other one moves under a
+	const auto rotate = [this, a_id](proxy_t x_id, proxy_t other_id, bool x_is_child2) {
+		auto& a = nodes_[std::size_t(a_id)];
+		auto& x = nodes_[std::size_t(x_id)];
+		const auto f_id = x.child1;
+		const auto g_id = x.child2;
+		auto& f = nodes_[std::size_t(f_id)];
+		auto& g = nodes_[std::size_t(g_id)];
+
+		x.child1 = a_id;
+		x.parent = a.parent;
+		a.parent = x_id;
+
+		if(x.parent != null_node)
+		{
+			auto& xp = nodes_[std::size_t(x.parent)];
+			if(xp.child1 == a_id)
+			{
+				xp.child1 = x_id;
+			}
+			else
+			{
+				xp.child2 = x_id;
+			}
+		}
+		else
+		{
+			root_ = x_id;
+		}
+
+		const auto& other = nodes_[std::size_t(other_id)];
+		const auto keep_id = f.height > g.height ? f_id : g_id;
+		const auto move_id = f.height > g.height ? g_id : f_id;
+		auto& keep = nodes_[std::size_t(keep_id)];
+		auto& move = nodes_[std::size_t(move_id)];
+
+		x.child2 = keep_id;
+		if(x_is_child2)
+		{
+			a.child2 = move_id;
+		}
+		else
+		{
+			a.child1 = move_id;
+		}
+		move.parent = a_id;
+
+		a.bounds = merge(other.bounds, move.bounds);
+		a.height = 1 + std::max(other.height, move.height);
+		x.bounds = merge(a.bounds, keep.bounds);
+		x.height = 1 + std::max(a.height, keep.height);
+		return x_id;
+	};
+
+	if(diff > 1)
+	{
+		return rotate(c_id, b_id, true);
+	}
+	if(diff < -1)
+	{
+		return rotate(b_id, c_id, false);
+	}
+	return a_id;
+}
+}
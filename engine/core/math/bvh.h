@@ -0,0 +1,279 @@
+#pragma once
+
+#include "bbox.h"
+#include "frustum.h"
+#include "math_types.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace math
+{
+using namespace glm;
+
+//-----------------------------------------------------------------------------
+// Main class declarations
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//  Name : bvh (Class)
+/// <summary>
+/// Dynamic bounding volume hierarchy of axis aligned boxes. Every proxy is
+/// stored with a fattened box so small movements do not touch the tree,
+/// boxes leaving their fat bounds are reinserted at the cheapest sibling and
+/// the ancestors are refitted and rebalanced on the way up. Queries walk the
+/// tree top down and skip whole subtrees that are fully inside or outside.
+/// </summary>
+//-----------------------------------------------------------------------------
+class bvh
+{
+public:
+	/// Index of a proxy or tree node, null_node for none.
+	using proxy_t = std::int32_t;
+	static constexpr proxy_t null_node = -1;
+
+	//-------------------------------------------------------------------------
+	// Constructors & Destructors
+	//-------------------------------------------------------------------------
+	bvh(float margin = 0.1f);
+
+	//-------------------------------------------------------------------------
+	// Public Methods
+	//-------------------------------------------------------------------------
+	//-----------------------------------------------------------------------------
+	//  Name : insert ()
+	/// <summary>
+	/// Adds a box to the tree and returns its proxy. The user data is handed
+	/// back by the queries.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	proxy_t insert(const bbox& bounds, std::uint32_t user_data);
+
+	//-----------------------------------------------------------------------------
+	//  Name : remove ()
+	/// <summary>
+	/// Removes the proxy, its index may be handed out again by insert.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void remove(proxy_t proxy);
+
+	//-----------------------------------------------------------------------------
+	//  Name : update ()
+	/// <summary>
+	/// Moves the proxy to new bounds. Returns false if the bounds still fit
+	/// in the fat box and the tree was left untouched.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool update(proxy_t proxy, const bbox& bounds);
+
+	//-----------------------------------------------------------------------------
+	//  Name : clear ()
+	/// <summary>
+	/// Removes all proxies.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void clear();
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_user_data ()
+	/// <summary>
+	/// User data the proxy was inserted with.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::uint32_t get_user_data(proxy_t proxy) const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_fat_bounds ()
+	/// <summary>
+	/// Fattened box stored for the proxy, it always contains the last bounds
+	/// passed to insert or update.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	const bbox& get_fat_bounds(proxy_t proxy) const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_proxy_count ()
+	/// <summary>
+	/// Number of proxies in the tree.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::size_t get_proxy_count() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_height ()
+	/// <summary>
+	/// Height of the tree, 0 for a single leaf and -1 when empty.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::int32_t get_height() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : query ()
+	/// <summary>
+	/// Calls f(user_data, volume_query) for every proxy whose fat box touches
+	/// the frustum. A subtree fully inside is reported without testing its
+	/// children and passes volume_query::inside, proxies reported with
+	/// volume_query::intersect may need a finer test by the caller. Planes a
+	/// node is fully inside of are not tested again for its children.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	template <typename F>
+	void query(const frustum& f, F&& callback) const
+	{
+		if(root_ == null_node)
+		{
+			return;
+		}
+
+		auto& stack = query_stack_;
+		stack.clear();
+		stack.push_back({root_, 0, -1});
+		while(!stack.empty())
+		{
+			auto current = stack.back();
+			stack.pop_back();
+
+			const auto& n = nodes_[std::size_t(current.id)];
+			const auto result = f.classify_aabb(n.bounds, current.frustum_bits, current.last_outside);
+			if(result == volume_query::outside)
+			{
+				continue;
+			}
+
+			if(result == volume_query::inside)
+			{
+				for_each_leaf(current.id, [&callback](std::uint32_t user_data) {
+					callback(user_data, volume_query::inside);
+				});
+				continue;
+			}
+
+			if(n.is_leaf())
+			{
+				callback(n.user_data, volume_query::intersect);
+				continue;
+			}
+
+			stack.push_back({n.child1, current.frustum_bits, current.last_outside});
+			stack.push_back({n.child2, current.frustum_bits, current.last_outside});
+		}
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : query ()
+	/// <summary>
+	/// Calls f(user_data) for every proxy whose fat box overlaps the box.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	template <typename F>
+	void query(const bbox& bounds, F&& callback) const
+	{
+		if(root_ == null_node)
+		{
+			return;
+		}
+
+		auto& stack = leaf_stack_;
+		stack.clear();
+		stack.push_back(root_);
+		while(!stack.empty())
+		{
+			const auto& n = nodes_[std::size_t(stack.back())];
+			stack.pop_back();
+
+			if(!overlaps(n.bounds, bounds))
+			{
+				continue;
+			}
+
+			if(n.is_leaf())
+			{
+				callback(n.user_data);
+				continue;
+			}
+
+			stack.push_back(n.child1);
+			stack.push_back(n.child2);
+		}
+	}
+
+private:
+	struct node
+	{
+		bool is_leaf() const
+		{
+			return child1 == null_node;
+		}
+
+		/// Fat box for leaves, union of the children otherwise.
+		bbox bounds;
+		/// Parent while allocated, next free node while in the free list.
+		proxy_t parent = null_node;
+		proxy_t child1 = null_node;
+		proxy_t child2 = null_node;
+		/// Leaves are 0, free nodes -1.
+		std::int32_t height = -1;
+		std::uint32_t user_data = 0;
+	};
+
+	struct frustum_entry
+	{
+		proxy_t id;
+		/// Planes the parent is fully inside of.
+		unsigned int frustum_bits;
+		/// Plane that rejected the last box, tested first.
+		int last_outside;
+	};
+
+	template <typename F>
+	void for_each_leaf(proxy_t id, F&& f) const
+	{
+		// the frustum query is already walking query_stack_
+		auto& stack = leaf_stack_;
+		stack.clear();
+		stack.push_back(id);
+		while(!stack.empty())
+		{
+			const auto& n = nodes_[std::size_t(stack.back())];
+			stack.pop_back();
+			if(n.is_leaf())
+			{
+				f(n.user_data);
+				continue;
+			}
+			stack.push_back(n.child1);
+			stack.push_back(n.child2);
+		}
+	}
+
+	static bool overlaps(const bbox& a, const bbox& b);
+	static bbox merge(const bbox& a, const bbox& b);
+	static bool contains(const bbox& outer, const bbox& inner);
+	static float area(const bbox& b);
+
+	proxy_t allocate_node();
+	void free_node(proxy_t id);
+	void insert_leaf(proxy_t leaf);
+	void remove_leaf(proxy_t leaf);
+	void refit(proxy_t id);
+
+	//-----------------------------------------------------------------------------
+	//  Name : balance ()
+	/// <summary>
+	/// Rotates the node if its children heights differ by more than one and
+	/// returns the node that took its place.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	proxy_t balance(proxy_t id);
+
+	/// Node storage, leaves and internal nodes share it.
+	std::vector<node> nodes_;
+	proxy_t root_ = null_node;
+	proxy_t free_list_ = null_node;
+	std::size_t proxy_count_ = 0;
+	/// Boxes are grown by this much on every side.
+	float margin_ = 0.1f;
+	/// Scratch stacks reused by the queries.
+	mutable std::vector<proxy_t> leaf_stack_;
+	mutable std::vector<frustum_entry> query_stack_;
+};
+}
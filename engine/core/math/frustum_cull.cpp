@@ -0,0 +1,243 @@
+#include "frustum_cull.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MATH_CULL_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace math
+{
+namespace
+{
+std::size_t padded(std::size_t count)
+{
+	return (count + 3) & ~std::size_t(3);
+}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// cull_batch Member Functions
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+//  Name : clear ()
+/// <summary>
+/// Removes all volumes, the storage is kept.
+/// </summary>
+//-----------------------------------------------------------------------------
+void cull_batch::clear()
+{
+	count_ = 0;
+	for(auto* v : {&center_x_, &center_y_, &center_z_, &axis_xx_, &axis_xy_, &axis_xz_, &axis_yx_, &axis_yy_,
+				   &axis_yz_, &axis_zx_, &axis_zy_, &axis_zz_, &radius_})
+	{
+		v->clear();
+	}
+}
+
+//-----------------------------------------------------------------------------
+//  Name : reserve ()
+/// <summary>
+/// Reserves storage for the number of volumes.
+/// </summary>
+//-----------------------------------------------------------------------------
+void cull_batch::reserve(std::size_t count)
+{
+	for(auto* v : {&center_x_, &center_y_, &center_z_, &axis_xx_, &axis_xy_, &axis_xz_, &axis_yx_, &axis_yy_,
+				   &axis_yz_, &axis_zx_, &axis_zy_, &axis_zz_, &radius_})
+	{
+		v->reserve(padded(count));
+	}
+}
+
+//-----------------------------------------------------------------------------
+//  Name : add_obb ()
+/// <summary>
+/// Adds the local box placed by the world transform.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::size_t cull_batch::add_obb(const bbox& bounds, const transform& t)
+{
+	const auto half = bounds.get_extents();
+	const auto center = t.transform_coord(bounds.get_center());
+	return push(center, t.x_axis() * half.x, t.y_axis() * half.y, t.z_axis() * half.z, 0.0f);
+}
+
+//-----------------------------------------------------------------------------
+//  Name : add_aabb ()
+/// <summary>
+/// Adds a world space box.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::size_t cull_batch::add_aabb(const bbox& bounds)
+{
+	const auto half = bounds.get_extents();
+	return push(bounds.get_center(), vec3(half.x, 0.0f, 0.0f), vec3(0.0f, half.y, 0.0f),
+				vec3(0.0f, 0.0f, half.z), 0.0f);
+}
+
+//-----------------------------------------------------------------------------
+//  Name : add_sphere ()
+/// <summary>
+/// Adds a world space sphere.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::size_t cull_batch::add_sphere(const vec3& center, float radius)
+{
+	return push(center, vec3(0.0f), vec3(0.0f), vec3(0.0f), radius);
+}
+
+//-----------------------------------------------------------------------------
+//  Name : size ()
+/// <summary>
+/// Number of volumes in the batch.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::size_t cull_batch::size() const
+{
+	return count_;
+}
+
+//-----------------------------------------------------------------------------
+//  Name : test ()
+/// <summary>
+/// Writes one visibility bit per volume.
+/// </summary>
+//-----------------------------------------------------------------------------
+void cull_batch::test(const frustum& f, std::vector<std::uint32_t>& visibility) const
+{
+	visibility.assign((count_ + 31) / 32, 0);
+	run(f, visibility.data());
+}
+
+//-----------------------------------------------------------------------------
+//  Name : test_any ()
+/// <summary>
+/// ORs the visibility bits of the volumes into the mask.
+/// </summary>
+//-----------------------------------------------------------------------------
+void cull_batch::test_any(const frustum& f, std::vector<std::uint32_t>& visibility) const
+{
+	visibility.resize((count_ + 31) / 32, 0);
+	run(f, visibility.data());
+}
+
+//-----------------------------------------------------------------------------
+//  Name : any_visible () (Static)
+/// <summary>
+/// Is at least one bit of the mask set.
+/// </summary>
+//-----------------------------------------------------------------------------
+bool cull_batch::any_visible(const std::vector<std::uint32_t>& visibility)
+{
+	return std::any_of(visibility.begin(), visibility.end(), [](std::uint32_t bits) { return bits != 0; });
+}
+
+std::size_t cull_batch::push(const vec3& center, const vec3& axis_x, const vec3& axis_y, const vec3& axis_z,
+							 float radius)
+{
+	// keep the arrays padded so the kernel never reads past the end, the
+	// bits of the padding are cleared after the test
+	if(count_ == center_x_.size())
+	{
+		const auto size = padded(count_ + 1);
+		for(auto* v : {&center_x_, &center_y_, &center_z_, &axis_xx_, &axis_xy_, &axis_xz_, &axis_yx_,
+					   &axis_yy_, &axis_yz_, &axis_zx_, &axis_zy_, &axis_zz_, &radius_})
+		{
+			v->resize(size, 0.0f);
+		}
+	}
+
+	const auto i = count_++;
+	center_x_[i] = center.x;
+	center_y_[i] = center.y;
+	center_z_[i] = center.z;
+	axis_xx_[i] = axis_x.x;
+	axis_xy_[i] = axis_x.y;
+	axis_xz_[i] = axis_x.z;
+	axis_yx_[i] = axis_y.x;
+	axis_yy_[i] = axis_y.y;
+	axis_yz_[i] = axis_y.z;
+	axis_zx_[i] = axis_z.x;
+	axis_zy_[i] = axis_z.y;
+	axis_zz_[i] = axis_z.z;
+	radius_[i] = radius;
+	return i;
+}
+
+void cull_batch::run(const frustum& f, std::uint32_t* visibility) const
+{
+	// A volume is outside a plane when its center lies further in front of
+	// it than the projection of the volume onto the plane normal.
+#if defined(MATH_CULL_SSE2)
+	const auto sign_mask = _mm_set1_ps(-0.0f);
+	for(std::size_t i = 0; i < count_; i += 4)
+	{
+		const auto cx = _mm_loadu_ps(&center_x_[i]);
+		const auto cy = _mm_loadu_ps(&center_y_[i]);
+		const auto cz = _mm_loadu_ps(&center_z_[i]);
+		const auto xx = _mm_loadu_ps(&axis_xx_[i]);
+		const auto xy = _mm_loadu_ps(&axis_xy_[i]);
+		const auto xz = _mm_loadu_ps(&axis_xz_[i]);
+		const auto yx = _mm_loadu_ps(&axis_yx_[i]);
+		const auto yy = _mm_loadu_ps(&axis_yy_[i]);
+		const auto yz = _mm_loadu_ps(&axis_yz_[i]);
+		const auto zx = _mm_loadu_ps(&axis_zx_[i]);
+		const auto zy = _mm_loadu_ps(&axis_zy_[i]);
+		const auto zz = _mm_loadu_ps(&axis_zz_[i]);
+		const auto r = _mm_loadu_ps(&radius_[i]);
+
+		auto outside = _mm_setzero_ps();
+		for(const auto& plane : f.planes)
+		{
+			const auto nx = _mm_set1_ps(plane.data.x);
+			const auto ny = _mm_set1_ps(plane.data.y);
+			const auto nz = _mm_set1_ps(plane.data.z);
+			const auto nw = _mm_set1_ps(plane.data.w);
+
+			const auto dist = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy)), _mm_add_ps(_mm_mul_ps(nz, cz), nw));
+
+			const auto px = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, xx), _mm_mul_ps(ny, xy)), _mm_mul_ps(nz, xz));
+			const auto py = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, yx), _mm_mul_ps(ny, yy)), _mm_mul_ps(nz, yz));
+			const auto pz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, zx), _mm_mul_ps(ny, zy)), _mm_mul_ps(nz, zz));
+			const auto extent = _mm_add_ps(_mm_add_ps(_mm_andnot_ps(sign_mask, px), _mm_andnot_ps(sign_mask, py)),
+										   _mm_add_ps(_mm_andnot_ps(sign_mask, pz), r));
+
+			outside = _mm_or_ps(outside, _mm_cmpgt_ps(dist, extent));
+		}
+
+		const auto visible = std::uint32_t(~_mm_movemask_ps(outside) & 0xF);
+		visibility[i / 32] |= visible << (i % 32);
+	}
+#else
+	for(std::size_t i = 0; i < count_; ++i)
+	{
+		bool outside = false;
+		for(const auto& plane : f.planes)
+		{
+			const auto& n = plane.data;
+			const float dist = n.x * center_x_[i] + n.y * center_y_[i] + n.z * center_z_[i] + n.w;
+			const float extent = std::abs(n.x * axis_xx_[i] + n.y * axis_xy_[i] + n.z * axis_xz_[i]) +
+								 std::abs(n.x * axis_yx_[i] + n.y * axis_yy_[i] + n.z * axis_yz_[i]) +
+								 std::abs(n.x * axis_zx_[i] + n.y * axis_zy_[i] + n.z * axis_zz_[i]) +
+								 radius_[i];
+			outside |= dist > extent;
+		}
+
+		if(!outside)
+		{
+			visibility[i / 32] |= std::uint32_t(1) << (i % 32);
+		}
+	}
+#endif
+
+	// drop the bits of the padding
+	if(count_ % 32 != 0)
+	{
+		visibility[count_ / 32] &= (std::uint32_t(1) << (count_ % 32)) - 1;
+	}
+}
+}
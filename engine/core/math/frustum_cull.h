@@ -0,0 +1,133 @@
+#pragma once
+
+#include "bbox.h"
+#include "frustum.h"
+#include "math_types.h"
+#include "transform.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace math
+{
+using namespace glm;
+
+//-----------------------------------------------------------------------------
+// Main class declarations
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//  Name : cull_batch (Class)
+/// <summary>
+/// World space bounding volumes laid out as structure of arrays so a whole
+/// batch can be tested against a frustum four at a time. Oriented boxes are
+/// stored as a center and three half axes, spheres as a center and a radius.
+/// Unlike frustum::test_obb the frustum is never transformed, the planes are
+/// tested against the projected radius of every volume instead.
+/// </summary>
+//-----------------------------------------------------------------------------
+class cull_batch
+{
+public:
+	//-------------------------------------------------------------------------
+	// Public Methods
+	//-------------------------------------------------------------------------
+	//-----------------------------------------------------------------------------
+	//  Name : clear ()
+	/// <summary>
+	/// Removes all volumes, the storage is kept.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void clear();
+
+	//-----------------------------------------------------------------------------
+	//  Name : reserve ()
+	/// <summary>
+	/// Reserves storage for the number of volumes.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void reserve(std::size_t count);
+
+	//-----------------------------------------------------------------------------
+	//  Name : add_obb ()
+	/// <summary>
+	/// Adds the local box placed by the world transform and returns its index.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::size_t add_obb(const bbox& bounds, const transform& t);
+
+	//-----------------------------------------------------------------------------
+	//  Name : add_aabb ()
+	/// <summary>
+	/// Adds a world space box and returns its index.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::size_t add_aabb(const bbox& bounds);
+
+	//-----------------------------------------------------------------------------
+	//  Name : add_sphere ()
+	/// <summary>
+	/// Adds a world space sphere and returns its index.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::size_t add_sphere(const vec3& center, float radius);
+
+	//-----------------------------------------------------------------------------
+	//  Name : size ()
+	/// <summary>
+	/// Number of volumes in the batch.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::size_t size() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : test ()
+	/// <summary>
+	/// Writes one bit per volume, set if the volume is not fully outside one
+	/// of the frustum planes. Bit i lives in visibility[i / 32]. The mask is
+	/// resized to fit the batch and bits past the end are cleared.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void test(const frustum& f, std::vector<std::uint32_t>& visibility) const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : test_any ()
+	/// <summary>
+	/// Like test but ORs the result into the mask, for volumes visible from
+	/// any of several frustums. The mask has to come from a previous test.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void test_any(const frustum& f, std::vector<std::uint32_t>& visibility) const;
+
+	//-------------------------------------------------------------------------
+	// Public Static Functions
+	//-------------------------------------------------------------------------
+	static bool is_visible(const std::vector<std::uint32_t>& visibility, std::size_t index)
+	{
+		return ((visibility[index / 32] >> (index % 32)) & 0x1) != 0;
+	}
+
+	static bool any_visible(const std::vector<std::uint32_t>& visibility);
+
+private:
+	//-------------------------------------------------------------------------
+	// Private Methods
+	//-------------------------------------------------------------------------
+	std::size_t push(const vec3& center, const vec3& axis_x, const vec3& axis_y, const vec3& axis_z,
+					 float radius);
+	void run(const frustum& f, std::uint32_t* visibility) const;
+
+	//-------------------------------------------------------------------------
+	// Private Member Variables
+	//-------------------------------------------------------------------------
+	/// Number of volumes, the arrays are padded to a multiple of four.
+	std::size_t count_ = 0;
+	/// Centers.
+	std::vector<float> center_x_, center_y_, center_z_;
+	/// Half axes, each column scaled by the half extent of the box.
+	std::vector<float> axis_xx_, axis_xy_, axis_xz_;
+	std::vector<float> axis_yx_, axis_yy_, axis_yz_;
+	std::vector<float> axis_zx_, axis_zy_, axis_zz_;
+	/// Sphere radius, zero for boxes.
+	std::vector<float> radius_;
+};
+}
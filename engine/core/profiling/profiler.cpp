@@ -0,0 +1,323 @@
+#include "profiler.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+
+namespace profiling
+{
+namespace
+{
+using clock_t = std::chrono::steady_clock;
+
+/// Zones a thread can record in one frame, a power of two.
+constexpr std::uint32_t thread_buffer_size = 4096;
+constexpr std::size_t default_frame_capacity = 120;
+
+// written by its thread, read by whoever ends the frame
+struct thread_buffer
+{
+	std::array<zone, thread_buffer_size> zones;
+	std::atomic<std::uint32_t> head{0};
+	std::atomic<std::uint32_t> tail{0};
+	std::atomic<std::uint64_t> dropped{0};
+	/// Cleared when the thread exits so another one can take the buffer over.
+	std::atomic<bool> in_use{true};
+	std::uint32_t index = 0;
+	std::string name;
+};
+
+struct profiler_state
+{
+	std::atomic<bool> enabled{PROFILER_ENABLED != 0};
+	clock_t::time_point epoch = clock_t::now();
+
+	std::mutex threads_mutex;
+	std::vector<std::unique_ptr<thread_buffer>> threads;
+
+	std::mutex locations_mutex;
+	std::unordered_map<std::string, std::unique_ptr<source_location>> locations;
+
+	std::mutex frames_mutex;
+	std::deque<frame> frames;
+	std::size_t frame_capacity = default_frame_capacity;
+	std::uint64_t frame_index = 0;
+	std::uint64_t frame_start = 0;
+};
+
+profiler_state& get_state()
+{
+	// never destroyed, threads may still record while statics go away
+	static auto state = new profiler_state();
+	return *state;
+}
+
+struct thread_buffer_owner
+{
+	~thread_buffer_owner()
+	{
+		if(buffer != nullptr)
+		{
+			buffer->in_use.store(false, std::memory_order_release);
+		}
+	}
+
+	thread_buffer* buffer = nullptr;
+};
+
+thread_local thread_buffer_owner current_thread;
+
+thread_buffer& get_thread_buffer()
+{
+	if(current_thread.buffer != nullptr)
+	{
+		return *current_thread.buffer;
+	}
+
+	auto& state = get_state();
+	std::lock_guard<std::mutex> lock(state.threads_mutex);
+	for(auto& buffer : state.threads)
+	{
+		bool in_use = false;
+		if(buffer->in_use.compare_exchange_strong(in_use, true, std::memory_order_acquire))
+		{
+			buffer->name.clear();
+			current_thread.buffer = buffer.get();
+			return *buffer;
+		}
+	}
+
+	state.threads.emplace_back(std::make_unique<thread_buffer>());
+	auto& buffer = *state.threads.back();
+	buffer.index = std::uint32_t(state.threads.size());
+	current_thread.buffer = &buffer;
+	return buffer;
+}
+
+void write_string(std::ostream& stream, const char* str)
+{
+	stream << '"';
+	for(; *str != 0; ++str)
+	{
+		const auto c = *str;
+		if(c == '"' || c == '\\')
+		{
+			stream << '\\' << c;
+		}
+		else if(static_cast<unsigned char>(c) < 0x20)
+		{
+			stream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c) << std::dec
+				   << std::setfill(' ');
+		}
+		else
+		{
+			stream << c;
+		}
+	}
+	stream << '"';
+}
+
+void write_microseconds(std::ostream& stream, std::uint64_t ns)
+{
+	stream << ns / 1000 << '.' << std::setw(3) << std::setfill('0') << ns % 1000 << std::setfill(' ');
+}
+}
+
+void set_enabled(bool enabled)
+{
+	get_state().enabled.store(PROFILER_ENABLED != 0 && enabled, std::memory_order_relaxed);
+}
+
+bool is_enabled()
+{
+	return get_state().enabled.load(std::memory_order_relaxed);
+}
+
+void set_thread_name(const std::string& name)
+{
+	auto& buffer = get_thread_buffer();
+	std::lock_guard<std::mutex> lock(get_state().threads_mutex);
+	buffer.name = name;
+}
+
+const source_location& get_location(const std::string& name)
+{
+	auto& state = get_state();
+	std::lock_guard<std::mutex> lock(state.locations_mutex);
+	auto& location = state.locations[name];
+	if(location == nullptr)
+	{
+		location = std::make_unique<source_location>();
+		// the key lives as long as the entry
+		location->name = state.locations.find(name)->first.c_str();
+	}
+	return *location;
+}
+
+std::uint64_t now()
+{
+	const auto elapsed = clock_t::now() - get_state().epoch;
+	return std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+void record(const source_location& location, std::uint64_t start, std::uint64_t end, std::int32_t index)
+{
+	auto& buffer = get_thread_buffer();
+	const auto head = buffer.head.load(std::memory_order_relaxed);
+	const auto tail = buffer.tail.load(std::memory_order_acquire);
+	if(head - tail >= thread_buffer_size)
+	{
+		buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	auto& z = buffer.zones[head & (thread_buffer_size - 1)];
+	z.location = &location;
+	z.start = start;
+	z.end = end;
+	z.index = index;
+	z.thread = buffer.index;
+	buffer.head.store(head + 1, std::memory_order_release);
+}
+
+void end_frame()
+{
+	auto& state = get_state();
+
+	frame f;
+	f.end = now();
+	{
+		std::lock_guard<std::mutex> lock(state.frames_mutex);
+		f.index = state.frame_index++;
+		f.start = state.frame_start;
+		state.frame_start = f.end;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(state.threads_mutex);
+		for(auto& buffer : state.threads)
+		{
+			const auto tail = buffer->tail.load(std::memory_order_relaxed);
+			const auto head = buffer->head.load(std::memory_order_acquire);
+			for(auto i = tail; i != head; ++i)
+			{
+				f.zones.emplace_back(buffer->zones[i & (thread_buffer_size - 1)]);
+			}
+			buffer->tail.store(head, std::memory_order_release);
+			f.dropped += buffer->dropped.exchange(0, std::memory_order_relaxed);
+		}
+	}
+
+	if(!is_enabled() && f.zones.empty())
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(state.frames_mutex);
+	state.frames.emplace_back(std::move(f));
+	while(state.frames.size() > state.frame_capacity)
+	{
+		state.frames.pop_front();
+	}
+}
+
+void set_frame_capacity(std::size_t count)
+{
+	auto& state = get_state();
+	std::lock_guard<std::mutex> lock(state.frames_mutex);
+	state.frame_capacity = count;
+	while(state.frames.size() > state.frame_capacity)
+	{
+		state.frames.pop_front();
+	}
+}
+
+std::size_t get_frame_capacity()
+{
+	auto& state = get_state();
+	std::lock_guard<std::mutex> lock(state.frames_mutex);
+	return state.frame_capacity;
+}
+
+std::vector<frame> get_frames()
+{
+	auto& state = get_state();
+	std::lock_guard<std::mutex> lock(state.frames_mutex);
+	return {std::begin(state.frames), std::end(state.frames)};
+}
+
+void write_chrome_trace(std::ostream& stream)
+{
+	auto& state = get_state();
+	const auto frames = get_frames();
+
+	stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	stream << R"({"name":"thread_name","ph":"M","pid":1,"tid":0,"args":{"name":"frames"}})";
+	{
+		std::lock_guard<std::mutex> lock(state.threads_mutex);
+		for(const auto& buffer : state.threads)
+		{
+			const auto name = buffer->name.empty() ? "thread " + std::to_string(buffer->index) : buffer->name;
+			stream << ",\n"
+				   << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << buffer->index
+				   << R"(,"args":{"name":)";
+			write_string(stream, name.c_str());
+			stream << "}}";
+		}
+	}
+
+	for(const auto& f : frames)
+	{
+		stream << ",\n"
+			   << R"({"name":"frame )" << f.index << R"(","cat":"frame","ph":"X","pid":1,"tid":0,"ts":)";
+		write_microseconds(stream, f.start);
+		stream << ",\"dur\":";
+		write_microseconds(stream, f.end - f.start);
+		stream << R"(,"args":{"dropped":)" << f.dropped << "}}";
+
+		for(const auto& z : f.zones)
+		{
+			stream << ",\n{\"name\":";
+			write_string(stream, z.location->name);
+			stream << R"(,"cat":"zone","ph":"X","pid":1,"tid":)" << z.thread << ",\"ts\":";
+			write_microseconds(stream, z.start);
+			stream << ",\"dur\":";
+			write_microseconds(stream, z.end - z.start);
+			stream << ",\"args\":{\"file\":";
+			write_string(stream, z.location->file);
+			stream << ",\"line\":" << z.location->line;
+			if(z.index >= 0)
+			{
+				stream << ",\"index\":" << z.index;
+			}
+			stream << "}}";
+		}
+	}
+	stream << "\n]}\n";
+}
+
+bool save_chrome_trace(const std::string& path, std::string& err)
+{
+	std::ofstream stream(path, std::ios::out | std::ios::trunc);
+	if(!stream.good())
+	{
+		err = "Cant write " + path;
+		return false;
+	}
+
+	write_chrome_trace(stream);
+	if(!stream.good())
+	{
+		err = "Cant write " + path;
+		return false;
+	}
+	return true;
+}
+}
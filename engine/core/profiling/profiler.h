@@ -0,0 +1,205 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// zones compile to nothing when this is 0
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 1
+#endif
+
+namespace profiling
+{
+/// Where a zone is, records must outlive every captured frame.
+struct source_location
+{
+	const char* name = "";
+	const char* file = "";
+	std::uint32_t line = 0;
+};
+
+struct zone
+{
+	const source_location* location = nullptr;
+	/// Nanoseconds since the profiler started.
+	std::uint64_t start = 0;
+	std::uint64_t end = 0;
+	/// Tells apart zones sharing a location, negative when unused.
+	std::int32_t index = -1;
+	/// Index of the recording thread.
+	std::uint32_t thread = 0;
+};
+
+struct frame
+{
+	std::uint64_t index = 0;
+	/// Nanoseconds since the profiler started.
+	std::uint64_t start = 0;
+	std::uint64_t end = 0;
+	/// Zones that ended during the frame.
+	std::vector<zone> zones;
+	/// Zones lost because a thread recorded more than its buffer holds.
+	std::uint64_t dropped = 0;
+};
+
+//-----------------------------------------------------------------------------
+//  Name : set_enabled ()
+/// <summary>
+/// Starts or stops recording. Zones cost a single check while stopped.
+/// </summary>
+//-----------------------------------------------------------------------------
+void set_enabled(bool enabled);
+bool is_enabled();
+
+//-----------------------------------------------------------------------------
+//  Name : set_thread_name ()
+/// <summary>
+/// Names the calling thread in the exported traces.
+/// </summary>
+//-----------------------------------------------------------------------------
+void set_thread_name(const std::string& name);
+
+//-----------------------------------------------------------------------------
+//  Name : get_location ()
+/// <summary>
+/// A location for names only known at runtime, the same one every time a
+/// name is asked for. Prefer the static ones of PROFILE_SCOPE.
+/// </summary>
+//-----------------------------------------------------------------------------
+const source_location& get_location(const std::string& name);
+
+//-----------------------------------------------------------------------------
+//  Name : now ()
+/// <summary>
+/// Nanoseconds since the profiler started.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::uint64_t now();
+
+//-----------------------------------------------------------------------------
+//  Name : record ()
+/// <summary>
+/// Adds a finished zone to the buffer of the calling thread. Never blocks,
+/// the zone is dropped when the buffer is full.
+/// </summary>
+//-----------------------------------------------------------------------------
+void record(const source_location& location, std::uint64_t start, std::uint64_t end,
+			std::int32_t index = -1);
+
+//-----------------------------------------------------------------------------
+//  Name : end_frame ()
+/// <summary>
+/// Collects the zones every thread recorded into a new frame, dropping the
+/// oldest one once there are more than the frame capacity.
+/// </summary>
+//-----------------------------------------------------------------------------
+void end_frame();
+
+//-----------------------------------------------------------------------------
+//  Name : set_frame_capacity ()
+/// <summary>
+/// Sets how many of the last frames are kept.
+/// </summary>
+//-----------------------------------------------------------------------------
+void set_frame_capacity(std::size_t count);
+std::size_t get_frame_capacity();
+
+//-----------------------------------------------------------------------------
+//  Name : get_frames ()
+/// <summary>
+/// The kept frames, oldest first.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::vector<frame> get_frames();
+
+//-----------------------------------------------------------------------------
+//  Name : write_chrome_trace ()
+/// <summary>
+/// Writes the kept frames in the trace event format chrome://tracing and
+/// Perfetto open.
+/// </summary>
+//-----------------------------------------------------------------------------
+void write_chrome_trace(std::ostream& stream);
+
+//-----------------------------------------------------------------------------
+//  Name : save_chrome_trace ()
+/// <summary>
+/// Writes the kept frames to a trace file.
+/// </summary>
+//-----------------------------------------------------------------------------
+bool save_chrome_trace(const std::string& path, std::string& err);
+
+//-----------------------------------------------------------------------------
+//  Name : scoped_zone (Class)
+/// <summary>
+/// Records the time between its construction and destruction.
+/// </summary>
+//-----------------------------------------------------------------------------
+class scoped_zone
+{
+public:
+	explicit scoped_zone(const source_location& location, std::int32_t index = -1)
+		: location_(is_enabled() ? &location : nullptr)
+		, index_(index)
+	{
+		if(location_ != nullptr)
+		{
+			start_ = now();
+		}
+	}
+
+	/// Records nothing for a null location.
+	explicit scoped_zone(const source_location* location, std::int32_t index = -1)
+		: location_(is_enabled() ? location : nullptr)
+		, index_(index)
+	{
+		if(location_ != nullptr)
+		{
+			start_ = now();
+		}
+	}
+
+	/// Looks the location up only while recording.
+	explicit scoped_zone(const std::string& name, std::int32_t index = -1)
+		: location_(is_enabled() ? &get_location(name) : nullptr)
+		, index_(index)
+	{
+		if(location_ != nullptr)
+		{
+			start_ = now();
+		}
+	}
+
+	~scoped_zone()
+	{
+		if(location_ != nullptr)
+		{
+			record(*location_, start_, now(), index_);
+		}
+	}
+
+	scoped_zone(const scoped_zone&) = delete;
+	scoped_zone& operator=(const scoped_zone&) = delete;
+
+private:
+	const source_location* location_ = nullptr;
+	std::uint64_t start_ = 0;
+	std::int32_t index_ = -1;
+};
+}
+
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+
+#if PROFILER_ENABLED
+#define PROFILE_LOCATION PROFILE_CONCAT(profile_location_, __LINE__)
+#define PROFILE_SCOPE(name)                                                                                  \
+	static const ::profiling::source_location PROFILE_LOCATION = {name, __FILE__, __LINE__};                 \
+	::profiling::scoped_zone PROFILE_CONCAT(profile_zone_, __LINE__)(PROFILE_LOCATION)
+#else
+#define PROFILE_SCOPE(name) (void)0
+#endif
+
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__func__)
@@ -85,6 +85,20 @@ public:
 		emit(std::forward<Args>(args)...);
 	}
 
+	/// Emits the events through invoke(index, slot, args...) instead of calling
+	/// the slots directly, e.g. to time each of them on its own
+	/// \param invoke Called once per slot, with the slot's position
+	/// \param args The arguments to emit to the slots connected to the signal
+	template <typename F>
+	void emit_with(F&& invoke, Args... args) const
+	{
+		std::size_t index = 0;
+		for(auto& slot : slots_)
+		{
+			invoke(index++, slot, args...);
+		}
+	}
+
 	// comparision operators for sorting and comparing
 
 	bool operator==(const event& s) const
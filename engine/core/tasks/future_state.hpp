@@ -0,0 +1,443 @@
+#pragma once
+
+#include "task_pool.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace core
+{
+namespace detail
+{
+
+//-----------------------------------------------------------------------------
+//  Name : continuation (Struct)
+/// <summary>
+/// Intrusive node that gets notified once a future_state becomes ready. The
+/// node is owned by whoever registered it and must stay alive until
+/// on_ready has returned. on_ready is called on the thread that completed
+/// the state and must not throw.
+/// </summary>
+//-----------------------------------------------------------------------------
+struct continuation
+{
+	virtual void on_ready() noexcept = 0;
+
+	continuation* next_continuation = nullptr;
+
+protected:
+	~continuation() = default;
+};
+
+//-----------------------------------------------------------------------------
+// Main Class Declarations
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//  Name : future_state_base (Class)
+/// <summary>
+/// Shared state between a task and its task_futures. Replaces the
+/// std::packaged_task / std::shared_future pair. It is intrusively ref counted
+/// and allocated from the task_pool. Readiness is a single atomic so polling it
+/// is cheap; the mutex and condition variable are only touched when a thread
+/// actually blocks on the state. Dependents register continuations instead
+/// of polling it.
+/// </summary>
+//-----------------------------------------------------------------------------
+class future_state_base
+{
+public:
+	future_state_base(const future_state_base&) = delete;
+	future_state_base& operator=(const future_state_base&) = delete;
+
+	void add_ref() noexcept
+	{
+		refs_.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	bool is_ready() const noexcept
+	{
+		return status_.load(std::memory_order_acquire) != status::pending;
+	}
+
+	void wait() const
+	{
+		if(is_ready())
+		{
+			return;
+		}
+
+		waiters_.fetch_add(1, std::memory_order_seq_cst);
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			cv_.wait(lock, [this]() { return is_ready(); });
+		}
+		waiters_.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	template <class Clock, class Dur>
+	std::future_status wait_until(const std::chrono::time_point<Clock, Dur>& abs_time) const
+	{
+		if(is_ready())
+		{
+			return std::future_status::ready;
+		}
+
+		waiters_.fetch_add(1, std::memory_order_seq_cst);
+		bool ready = false;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			ready = cv_.wait_until(lock, abs_time, [this]() { return is_ready(); });
+		}
+		waiters_.fetch_sub(1, std::memory_order_relaxed);
+
+		return ready ? std::future_status::ready : std::future_status::timeout;
+	}
+
+	template <class Rep, class Per>
+	std::future_status wait_for(const std::chrono::duration<Rep, Per>& rel_time) const
+	{
+		if(is_ready() || rel_time <= rel_time.zero())
+		{
+			return is_ready() ? std::future_status::ready : std::future_status::timeout;
+		}
+		return wait_until(std::chrono::steady_clock::now() + rel_time);
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : add_continuation ()
+	/// <summary>
+	/// Registers a node to be notified when the state becomes ready. Returns
+	/// false if the state is already ready, in which case the node is never
+	/// called.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool add_continuation(continuation* c) noexcept
+	{
+		auto* head = continuations_.load(std::memory_order_acquire);
+		do
+		{
+			if(head == closed_list())
+			{
+				return false;
+			}
+			c->next_continuation = head;
+		} while(!continuations_.compare_exchange_weak(head, c, std::memory_order_acq_rel,
+													  std::memory_order_acquire));
+		return true;
+	}
+
+	void set_exception(std::exception_ptr e)
+	{
+		exception_ = std::move(e);
+		make_ready(status::exception);
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_broken ()
+	/// <summary>
+	/// Called when a task is destroyed without being executed. Mirrors the
+	/// broken_promise error of std::packaged_task.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_broken()
+	{
+		set_exception(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : try_start ()
+	/// <summary>
+	/// Claimed by the thread about to run the task. Fails if the task was
+	/// cancelled first, the task must then be dropped instead.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool try_start() noexcept
+	{
+		auto expected = run_state::idle;
+		return run_.compare_exchange_strong(expected, run_state::started, std::memory_order_acq_rel);
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : try_cancel ()
+	/// <summary>
+	/// Fails once the task has started, its result is then still delivered.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool try_cancel() noexcept
+	{
+		auto expected = run_state::idle;
+		return run_.compare_exchange_strong(expected, run_state::cancelled, std::memory_order_acq_rel);
+	}
+
+	bool is_cancelled() const noexcept
+	{
+		return run_.load(std::memory_order_acquire) == run_state::cancelled;
+	}
+
+	static void* operator new(std::size_t size)
+	{
+		return task_pool::allocate(size);
+	}
+
+	static void operator delete(void* ptr, std::size_t size) noexcept
+	{
+		task_pool::deallocate(ptr, size);
+	}
+
+	// over-aligned results bypass the pool
+	static void* operator new(std::size_t size, std::align_val_t al)
+	{
+		return ::operator new(size, al);
+	}
+
+	static void operator delete(void* ptr, std::size_t size, std::align_val_t al) noexcept
+	{
+		::operator delete(ptr, size, al);
+	}
+
+protected:
+	enum class status : std::uint8_t
+	{
+		pending,
+		value,
+		exception
+	};
+
+	enum class run_state : std::uint8_t
+	{
+		idle,
+		started,
+		cancelled
+	};
+
+	future_state_base() = default;
+	~future_state_base() = default;
+
+	bool release_ref() noexcept
+	{
+		return refs_.fetch_sub(1, std::memory_order_acq_rel) == 1;
+	}
+
+	void make_ready(status s)
+	{
+		status_.store(s, std::memory_order_seq_cst);
+		if(waiters_.load(std::memory_order_seq_cst) > 0)
+		{
+			// lock so that a waiter can't miss us between its check and its wait
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+			}
+			cv_.notify_all();
+		}
+
+		auto* c = continuations_.exchange(closed_list(), std::memory_order_acq_rel);
+		while(c != nullptr)
+		{
+			// the node may be destroyed by on_ready
+			auto* next = c->next_continuation;
+			c->on_ready();
+			c = next;
+		}
+	}
+
+	void rethrow_if_exception() const
+	{
+		if(status_.load(std::memory_order_acquire) == status::exception)
+		{
+			std::rethrow_exception(exception_);
+		}
+	}
+
+	static continuation* closed_list() noexcept
+	{
+		struct closed_continuation : continuation
+		{
+			void on_ready() noexcept override
+			{
+			}
+		};
+		static closed_continuation sentinel;
+		return &sentinel;
+	}
+
+	std::atomic<std::uint32_t> refs_{1};
+	std::atomic<status> status_{status::pending};
+	/// Whether the task behind the state started or got cancelled.
+	std::atomic<run_state> run_{run_state::idle};
+	/// Dependents to notify, closed_list() once the state is ready.
+	std::atomic<continuation*> continuations_{nullptr};
+	mutable std::atomic<std::uint32_t> waiters_{0};
+	mutable std::mutex mutex_;
+	mutable std::condition_variable cv_;
+	std::exception_ptr exception_;
+};
+
+template <typename T>
+class future_state : public future_state_base
+{
+	using storage_t = std::conditional_t<std::is_reference<T>::value,
+										 std::reference_wrapper<std::remove_reference_t<T>>, T>;
+
+public:
+	using result_t = std::conditional_t<std::is_reference<T>::value, T, const T&>;
+
+	static future_state* create()
+	{
+		return new future_state();
+	}
+
+	void release() noexcept
+	{
+		if(release_ref())
+		{
+			delete this;
+		}
+	}
+
+	template <typename... Args>
+	void set_value(Args&&... args)
+	{
+		::new(static_cast<void*>(&storage_)) storage_t(std::forward<Args>(args)...);
+		make_ready(status::value);
+	}
+
+	result_t get() const
+	{
+		rethrow_if_exception();
+		return *reinterpret_cast<const storage_t*>(&storage_);
+	}
+
+private:
+	future_state() = default;
+	~future_state()
+	{
+		if(status_.load(std::memory_order_relaxed) == status::value)
+		{
+			reinterpret_cast<storage_t*>(&storage_)->~storage_t();
+		}
+	}
+
+	typename std::aligned_storage<sizeof(storage_t), alignof(storage_t)>::type storage_;
+};
+
+template <>
+class future_state<void> : public future_state_base
+{
+public:
+	using result_t = void;
+
+	static future_state* create()
+	{
+		return new future_state();
+	}
+
+	void release() noexcept
+	{
+		if(release_ref())
+		{
+			delete this;
+		}
+	}
+
+	void set_value()
+	{
+		make_ready(status::value);
+	}
+
+	void get() const
+	{
+		rethrow_if_exception();
+	}
+
+private:
+	future_state() = default;
+	~future_state() = default;
+};
+
+//-----------------------------------------------------------------------------
+//  Name : future_state_ptr (Class)
+/// <summary>
+/// Intrusive smart pointer over a future_state.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <typename T>
+class future_state_ptr
+{
+public:
+	future_state_ptr() noexcept = default;
+
+	//-----------------------------------------------------------------------------
+	//  Name : future_state_ptr ()
+	/// <summary>
+	/// Takes over a reference that the caller already owns.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	explicit future_state_ptr(future_state<T>* state) noexcept
+		: state_(state)
+	{
+	}
+
+	future_state_ptr(const future_state_ptr& other) noexcept
+		: state_(other.state_)
+	{
+		if(state_)
+		{
+			state_->add_ref();
+		}
+	}
+
+	future_state_ptr(future_state_ptr&& other) noexcept
+		: state_(other.state_)
+	{
+		other.state_ = nullptr;
+	}
+
+	~future_state_ptr()
+	{
+		if(state_)
+		{
+			state_->release();
+		}
+	}
+
+	future_state_ptr& operator=(future_state_ptr other) noexcept
+	{
+		std::swap(state_, other.state_);
+		return *this;
+	}
+
+	future_state<T>* get() const noexcept
+	{
+		return state_;
+	}
+
+	future_state<T>* operator->() const noexcept
+	{
+		return state_;
+	}
+
+	explicit operator bool() const noexcept
+	{
+		return state_ != nullptr;
+	}
+
+private:
+	future_state<T>* state_ = nullptr;
+};
+
+template <typename T>
+inline future_state_ptr<T> make_future_state()
+{
+	return future_state_ptr<T>(future_state<T>::create());
+}
+} // namespace detail
+} // namespace core
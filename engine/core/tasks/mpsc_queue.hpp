@@ -0,0 +1,136 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+//  Name : mpsc_node (Struct)
+/// <summary>
+/// Intrusive hook for mpsc_queue. Types stored in the queue derive from it.
+/// </summary>
+//-----------------------------------------------------------------------------
+struct mpsc_node
+{
+	std::atomic<mpsc_node*> mpsc_next_{nullptr};
+};
+
+//-----------------------------------------------------------------------------
+// Main Class Declarations
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//  Name : mpsc_queue (Class)
+/// <summary>
+/// Intrusive unbounded multi-producer single-consumer queue (Vyukov).
+/// Push is wait-free, pop is lock-free and may transiently report empty while
+/// a producer is in the middle of a push. The queue never owns the nodes.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <typename T>
+class mpsc_queue
+{
+public:
+	mpsc_queue() noexcept
+		: head_(&stub_)
+		, tail_(&stub_)
+	{
+	}
+
+	mpsc_queue(const mpsc_queue&) = delete;
+	mpsc_queue& operator=(const mpsc_queue&) = delete;
+
+	//-----------------------------------------------------------------------------
+	//  Name : push ()
+	/// <summary>
+	/// Pushes a node. Can be called from any thread.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void push(T* node) noexcept
+	{
+		// counted first so that the node is never queued while empty() holds
+		size_.fetch_add(1, std::memory_order_seq_cst);
+		push_node(node);
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : pop ()
+	/// <summary>
+	/// Pops the oldest node or nullptr. Consumer thread only.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	T* pop() noexcept
+	{
+		mpsc_node* tail = tail_;
+		mpsc_node* next = tail->mpsc_next_.load(std::memory_order_acquire);
+
+		if(tail == &stub_)
+		{
+			if(next == nullptr)
+			{
+				return nullptr;
+			}
+			tail_ = next;
+			tail = next;
+			next = next->mpsc_next_.load(std::memory_order_acquire);
+		}
+
+		if(next != nullptr)
+		{
+			tail_ = next;
+			return popped(tail);
+		}
+
+		const mpsc_node* head = head_.load(std::memory_order_acquire);
+		if(tail != head)
+		{
+			// a producer is between the exchange and the link
+			return nullptr;
+		}
+
+		push_node(&stub_);
+
+		next = tail->mpsc_next_.load(std::memory_order_acquire);
+		if(next != nullptr)
+		{
+			tail_ = next;
+			return popped(tail);
+		}
+
+		return nullptr;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : empty ()
+	/// <summary>
+	/// Can be called from any thread. Never true while a pushed node has not
+	/// been popped yet, even if pop transiently returns nullptr for it.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool empty() const noexcept
+	{
+		return size_.load(std::memory_order_seq_cst) == 0;
+	}
+
+private:
+	T* popped(mpsc_node* node) noexcept
+	{
+		size_.fetch_sub(1, std::memory_order_relaxed);
+		return static_cast<T*>(node);
+	}
+
+	void push_node(mpsc_node* node) noexcept
+	{
+		node->mpsc_next_.store(nullptr, std::memory_order_relaxed);
+		mpsc_node* prev = head_.exchange(node, std::memory_order_acq_rel);
+		prev->mpsc_next_.store(node, std::memory_order_release);
+	}
+
+	mpsc_node stub_;
+	alignas(64) std::atomic<mpsc_node*> head_;
+	alignas(64) mpsc_node* tail_;
+	/// Pushed nodes that have not been popped.
+	alignas(64) std::atomic<std::size_t> size_{0};
+};
+} // namespace core
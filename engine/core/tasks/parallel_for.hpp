@@ -0,0 +1,263 @@
+#pragma once
+
+#include "task_system.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace core
+{
+namespace detail
+{
+
+//-----------------------------------------------------------------------------
+//  Name : parallel_for_state (Class)
+/// <summary>
+/// Shared state of one parallel_for call. Chunks are claimed from a single
+/// atomic cursor. Each claim takes a share of what is left, so chunks start
+/// big and get smaller towards the end of the range, which keeps the claim
+/// count low while still balancing the tail across threads.
+/// Helpers that start after the range is exhausted only touch this state, so
+/// it is shared with them and outlives the call.
+/// </summary>
+//-----------------------------------------------------------------------------
+class parallel_for_state
+{
+public:
+	using body_t = void (*)(void* body, std::size_t begin, std::size_t end);
+
+	parallel_for_state(std::size_t begin, std::size_t end, std::size_t grain, std::size_t threads,
+					   void* body, body_t invoke)
+		: next_(begin)
+		, end_(end)
+		, total_(end - begin)
+		, grain_(grain)
+		, divisor_(std::max<std::size_t>(threads, 1) * 2)
+		, body_(body)
+		, invoke_(invoke)
+	{
+		auto done = task::make_ready_task([]() {});
+		done_task_ = std::move(done.first);
+		done_ = std::move(done.second);
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : work ()
+	/// <summary>
+	/// Claims and executes chunks until the range is exhausted.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void work() noexcept
+	{
+		std::size_t begin = 0;
+		std::size_t end = 0;
+		while(claim(begin, end))
+		{
+			if(!failed_.load(std::memory_order_relaxed))
+			{
+				try
+				{
+					invoke_(body_, begin, end);
+				}
+				catch(...)
+				{
+					std::lock_guard<std::mutex> lock(error_mutex_);
+					if(!error_)
+					{
+						error_ = std::current_exception();
+					}
+					failed_.store(true, std::memory_order_relaxed);
+				}
+			}
+
+			const auto count = end - begin;
+			if(finished_.fetch_add(count, std::memory_order_acq_rel) + count == total_)
+			{
+				done_task_();
+			}
+		}
+	}
+
+	const task_future<void>& get_done() const
+	{
+		return done_;
+	}
+
+	void rethrow_if_failed()
+	{
+		if(failed_.load(std::memory_order_acquire))
+		{
+			std::rethrow_exception(error_);
+		}
+	}
+
+private:
+	bool claim(std::size_t& begin, std::size_t& end) noexcept
+	{
+		auto current = next_.load(std::memory_order_relaxed);
+		do
+		{
+			if(current >= end_)
+			{
+				return false;
+			}
+			const auto left = end_ - current;
+			const auto chunk = std::min(left, std::max(grain_, left / divisor_));
+			begin = current;
+			end = current + chunk;
+		} while(!next_.compare_exchange_weak(current, end, std::memory_order_relaxed));
+
+		return true;
+	}
+
+	std::atomic<std::size_t> next_;
+	std::atomic<std::size_t> finished_{0};
+	const std::size_t end_;
+	const std::size_t total_;
+	const std::size_t grain_;
+	const std::size_t divisor_;
+	void* body_ = nullptr;
+	body_t invoke_ = nullptr;
+	std::atomic_bool failed_{false};
+	std::mutex error_mutex_;
+	std::exception_ptr error_;
+	task done_task_;
+	task_future<void> done_;
+};
+} // namespace detail
+
+//-----------------------------------------------------------------------------
+//  Name : parallel_for_range ()
+/// <summary>
+/// Calls f(chunk_begin, chunk_end) for consecutive chunks covering
+/// [begin, end) on the worker threads of the task system. The calling thread
+/// executes chunks too and returns once every chunk has finished. While
+/// waiting for the last chunks a system thread keeps processing its queue,
+/// so nesting parallel loops does not deadlock. Chunks are never smaller than
+/// grain items. The first exception thrown by f is rethrown here, chunks not
+/// started yet are skipped.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <typename F>
+inline void parallel_for_range(task_system& ts, std::size_t begin, std::size_t end, F&& f,
+							   std::size_t grain = 1)
+{
+	if(begin >= end)
+	{
+		return;
+	}
+
+	grain = std::max<std::size_t>(grain, 1);
+	const auto threads = ts.get_threads_count();
+	const auto count = end - begin;
+	if(threads == 1 || count <= grain)
+	{
+		f(begin, end);
+		return;
+	}
+
+	using body_t = std::remove_reference_t<F>;
+	auto state = std::make_shared<detail::parallel_for_state>(
+		begin, end, grain, threads, const_cast<void*>(static_cast<const void*>(std::addressof(f))),
+		[](void* body, std::size_t b, std::size_t e) { (*static_cast<body_t*>(body))(b, e); });
+
+	// no point in waking up more helpers than there are chunks to take
+	const auto workers = threads - 1;
+	const auto helpers = std::min(workers, (count + grain - 1) / grain - 1);
+	const bool from_worker = ts.is_worker_thread();
+	for(std::size_t i = 0; i < helpers; ++i)
+	{
+		auto helper = [state]() { state->work(); };
+		if(from_worker)
+		{
+			// lands in our own deque where idle workers can steal it
+			ts.push_on_worker_thread(std::move(helper));
+		}
+		else
+		{
+			ts.push_on_thread(1 + i % workers, std::move(helper));
+		}
+	}
+
+	state->work();
+	ts.wait(state->get_done());
+	state->rethrow_if_failed();
+}
+
+//-----------------------------------------------------------------------------
+//  Name : parallel_for ()
+/// <summary>
+/// Calls f(i) for every index in [begin, end). See parallel_for_range.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <typename F>
+inline void parallel_for(task_system& ts, std::size_t begin, std::size_t end, F&& f,
+						 std::size_t grain = 1)
+{
+	parallel_for_range(ts, begin, end,
+					   [&f](std::size_t b, std::size_t e) {
+						   for(auto i = b; i < e; ++i)
+						   {
+							   f(i);
+						   }
+					   },
+					   grain);
+}
+
+//-----------------------------------------------------------------------------
+//  Name : parallel_for_each ()
+/// <summary>
+/// Calls f(element) for every element in [first, last). Ranges without
+/// random access iterators (multi component entt views for example) are
+/// gathered into a temporary vector first.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <typename It, typename F>
+inline void parallel_for_each(task_system& ts, It first, It last, F&& f, std::size_t grain = 1)
+{
+	using category_t = typename std::iterator_traits<It>::iterator_category;
+	using value_t = typename std::iterator_traits<It>::value_type;
+
+	if constexpr(std::is_base_of<std::random_access_iterator_tag, category_t>::value)
+	{
+		const auto count = static_cast<std::size_t>(std::distance(first, last));
+		parallel_for_range(ts, 0, count,
+						   [&f, first](std::size_t b, std::size_t e) {
+							   auto it = std::next(first, static_cast<std::ptrdiff_t>(b));
+							   for(auto i = b; i < e; ++i, ++it)
+							   {
+								   f(*it);
+							   }
+						   },
+						   grain);
+	}
+	else
+	{
+		std::vector<value_t> items(first, last);
+		parallel_for_range(ts, 0, items.size(),
+						   [&f, &items](std::size_t b, std::size_t e) {
+							   for(auto i = b; i < e; ++i)
+							   {
+								   f(items[i]);
+							   }
+						   },
+						   grain);
+	}
+}
+
+template <typename Range, typename F>
+inline void parallel_for_each(task_system& ts, Range&& range, F&& f, std::size_t grain = 1)
+{
+	using std::begin;
+	using std::end;
+	parallel_for_each(ts, begin(range), end(range), std::forward<F>(f), grain);
+}
+} // namespace core
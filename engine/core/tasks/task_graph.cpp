@@ -0,0 +1,193 @@
+#include "task_graph.h"
+#include "../common/assert.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace core
+{
+
+struct task_graph::run_state
+{
+	explicit run_state(const task_graph& g)
+		: graph(g)
+		, pending(g.nodes_.size())
+		, remaining(g.nodes_.size())
+	{
+		for(std::size_t i = 0; i < g.nodes_.size(); ++i)
+		{
+			pending[i].store(g.nodes_[i].predecessors, std::memory_order_relaxed);
+		}
+
+		auto done = task::make_ready_task([]() {});
+		done_task = std::move(done.first);
+		done_future = std::move(done.second);
+	}
+
+	const task_graph& graph;
+	std::vector<std::atomic<std::size_t>> pending;
+	std::atomic<std::size_t> remaining;
+	std::atomic_bool failed{false};
+	std::mutex error_mutex;
+	std::exception_ptr error;
+	task done_task;
+	task_future<void> done_future;
+};
+
+task_graph::node_id task_graph::add_node(std::string name, job_t job, thread_affinity affinity)
+{
+	node n;
+	n.name = std::move(name);
+	n.job = std::move(job);
+	n.affinity = affinity;
+	nodes_.emplace_back(std::move(n));
+	return nodes_.size() - 1;
+}
+
+void task_graph::precede(node_id before, node_id after)
+{
+	expects(before < nodes_.size() && after < nodes_.size());
+	expects(before != after);
+
+	auto& successors = nodes_[before].successors;
+	if(std::find(std::begin(successors), std::end(successors), after) != std::end(successors))
+	{
+		return;
+	}
+	successors.push_back(after);
+	nodes_[after].predecessors++;
+}
+
+void task_graph::clear()
+{
+	nodes_.clear();
+}
+
+std::size_t task_graph::size() const
+{
+	return nodes_.size();
+}
+
+const std::string& task_graph::get_name(node_id id) const
+{
+	return nodes_[id].name;
+}
+
+task_graph::thread_affinity task_graph::get_affinity(node_id id) const
+{
+	return nodes_[id].affinity;
+}
+
+const std::vector<task_graph::node_id>& task_graph::get_successors(node_id id) const
+{
+	return nodes_[id].successors;
+}
+
+std::vector<task_graph::node_id> task_graph::get_topological_order() const
+{
+	std::vector<std::size_t> pending;
+	pending.reserve(nodes_.size());
+	std::vector<node_id> order;
+	order.reserve(nodes_.size());
+	for(node_id id = 0; id < nodes_.size(); ++id)
+	{
+		pending.push_back(nodes_[id].predecessors);
+		if(pending.back() == 0)
+		{
+			order.push_back(id);
+		}
+	}
+
+	for(std::size_t i = 0; i < order.size(); ++i)
+	{
+		for(auto next : nodes_[order[i]].successors)
+		{
+			if(--pending[next] == 0)
+			{
+				order.push_back(next);
+			}
+		}
+	}
+
+	ensures(order.size() == nodes_.size() && "task_graph has a cycle");
+	return order;
+}
+
+void task_graph::run(task_system& ts)
+{
+	if(nodes_.empty())
+	{
+		return;
+	}
+
+#ifndef NDEBUG
+	get_topological_order();
+#endif
+
+	auto state = std::make_shared<run_state>(*this);
+	for(node_id id = 0; id < nodes_.size(); ++id)
+	{
+		if(nodes_[id].predecessors == 0)
+		{
+			schedule(ts, state, id);
+		}
+	}
+
+	ts.wait(state->done_future);
+
+	if(state->failed.load(std::memory_order_acquire))
+	{
+		std::rethrow_exception(state->error);
+	}
+}
+
+void task_graph::schedule(task_system& ts, const std::shared_ptr<run_state>& state, node_id id)
+{
+	auto job = [&ts, state, id]() { execute(ts, state, id); };
+	if(state->graph.nodes_[id].affinity == thread_affinity::owner)
+	{
+		ts.push_on_owner_thread(std::move(job));
+	}
+	else
+	{
+		ts.push_on_worker_thread(std::move(job));
+	}
+}
+
+void task_graph::execute(task_system& ts, const std::shared_ptr<run_state>& state, node_id id)
+{
+	const auto& n = state->graph.nodes_[id];
+	if(!state->failed.load(std::memory_order_relaxed) && n.job)
+	{
+		try
+		{
+			n.job();
+		}
+		catch(...)
+		{
+			std::lock_guard<std::mutex> lock(state->error_mutex);
+			if(!state->error)
+			{
+				state->error = std::current_exception();
+			}
+			state->failed.store(true, std::memory_order_relaxed);
+		}
+	}
+
+	for(auto next : n.successors)
+	{
+		if(state->pending[next].fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			schedule(ts, state, next);
+		}
+	}
+
+	// the graph may be gone once the last job is done, only the state is safe
+	if(state->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		state->done_task();
+	}
+}
+} // namespace core
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "task_system.h"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+// Main Class Declarations
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//  Name : task_graph (Class)
+/// <summary>
+/// A set of jobs with "A must finish before B" edges that can be executed on
+/// a task_system as many times as needed, for example once per frame. Jobs
+/// with no path between them may run concurrently. A job is scheduled as soon
+/// as the last of its predecessors finishes, there are no barriers between
+/// levels of the graph.
+/// </summary>
+//-----------------------------------------------------------------------------
+class task_graph
+{
+public:
+	using node_id = std::size_t;
+	using job_t = std::function<void()>;
+
+	enum class thread_affinity
+	{
+		/// Any worker thread.
+		worker,
+		/// The owner thread of the task system.
+		owner
+	};
+
+	//-----------------------------------------------------------------------------
+	//  Name : add_node ()
+	/// <summary>
+	/// Adds a job to the graph and returns its id.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	node_id add_node(std::string name, job_t job, thread_affinity affinity = thread_affinity::worker);
+
+	//-----------------------------------------------------------------------------
+	//  Name : precede ()
+	/// <summary>
+	/// Declares that the job 'before' must finish before 'after' can start.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void precede(node_id before, node_id after);
+
+	//-----------------------------------------------------------------------------
+	//  Name : run ()
+	/// <summary>
+	/// Executes every job once, honoring the declared order, and returns when
+	/// all of them finished. The calling thread processes its own task queue
+	/// while waiting, so jobs with owner affinity run when called from the
+	/// owner thread. The first exception thrown by a job is rethrown here, no
+	/// job starts after one has failed.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void run(task_system& ts);
+
+	//-----------------------------------------------------------------------------
+	//  Name : clear ()
+	/// <summary>
+	/// Removes all jobs and edges.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void clear();
+
+	std::size_t size() const;
+
+	const std::string& get_name(node_id id) const;
+
+	thread_affinity get_affinity(node_id id) const;
+
+	const std::vector<node_id>& get_successors(node_id id) const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_topological_order ()
+	/// <summary>
+	/// Returns the jobs in an order that respects every edge. Asserts if the
+	/// edges form a cycle.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::vector<node_id> get_topological_order() const;
+
+private:
+	struct node
+	{
+		std::string name;
+		job_t job;
+		thread_affinity affinity = thread_affinity::worker;
+		std::vector<node_id> successors;
+		std::size_t predecessors = 0;
+	};
+
+	struct run_state;
+
+	static void schedule(task_system& ts, const std::shared_ptr<run_state>& state, node_id id);
+
+	static void execute(task_system& ts, const std::shared_ptr<run_state>& state, node_id id);
+
+	std::vector<node> nodes_;
+};
+} // namespace core
@@ -0,0 +1,193 @@
+#include "task_pool.h"
+
+#include <array>
+#include <atomic>
+#include <new>
+
+namespace core
+{
+namespace task_pool
+{
+namespace
+{
+constexpr std::size_t min_class_size = 64;
+constexpr std::size_t size_classes = 5; // 64, 128, 256, 512, 1024
+constexpr std::size_t max_class_size = min_class_size << (size_classes - 1);
+
+/// Upper bound of cached blocks per size class and thread. The rest goes to
+/// the shared lists.
+constexpr std::size_t max_cached_blocks = 256;
+/// Upper bound of blocks per size class in the shared lists.
+constexpr std::size_t max_shared_blocks = 8192;
+
+std::size_t get_size_class(std::size_t size) noexcept
+{
+	std::size_t cls = 0;
+	std::size_t class_size = min_class_size;
+	while(class_size < size)
+	{
+		class_size <<= 1;
+		++cls;
+	}
+	return cls;
+}
+
+struct free_block
+{
+	free_block* next = nullptr;
+};
+
+//-----------------------------------------------------------------------------
+//  Name : shared_list (Struct)
+/// <summary>
+/// Tasks are mostly allocated on the thread that pushes them and freed on the
+/// workers that run them, so the thread caches alone would fill up on one side
+/// and stay empty on the other. Blocks overflowing a thread cache are pushed
+/// here and an empty cache takes all of them at once. Taking the whole list
+/// instead of single blocks keeps it free of ABA problems.
+/// </summary>
+//-----------------------------------------------------------------------------
+struct shared_list
+{
+	void push(free_block* block) noexcept
+	{
+		if(count.load(std::memory_order_relaxed) >= max_shared_blocks)
+		{
+			::operator delete(block);
+			return;
+		}
+
+		count.fetch_add(1, std::memory_order_relaxed);
+		auto* head = this->head.load(std::memory_order_relaxed);
+		do
+		{
+			block->next = head;
+		} while(!this->head.compare_exchange_weak(head, block, std::memory_order_release,
+												  std::memory_order_relaxed));
+	}
+
+	free_block* take_all(std::size_t& taken) noexcept
+	{
+		auto* blocks = head.exchange(nullptr, std::memory_order_acquire);
+		taken = 0;
+		for(auto* block = blocks; block != nullptr; block = block->next)
+		{
+			++taken;
+		}
+		count.fetch_sub(taken, std::memory_order_relaxed);
+		return blocks;
+	}
+
+	std::atomic<free_block*> head{nullptr};
+	std::atomic<std::size_t> count{0};
+};
+
+std::array<shared_list, size_classes>& get_shared_lists()
+{
+	// never destroyed, threads may release blocks while statics go away
+	static auto lists = new std::array<shared_list, size_classes>();
+	return *lists;
+}
+
+/// Set once the calling thread's cache has been destroyed. Blocks released
+/// during thread (or program) teardown after that go straight to the heap.
+thread_local bool cache_destroyed = false;
+
+struct thread_cache
+{
+	~thread_cache()
+	{
+		cache_destroyed = true;
+		auto& shared = get_shared_lists();
+		for(std::size_t cls = 0; cls < size_classes; ++cls)
+		{
+			auto& list = lists[cls];
+			while(list.head)
+			{
+				auto* block = list.head;
+				list.head = block->next;
+				shared[cls].push(block);
+			}
+		}
+	}
+
+	struct free_list
+	{
+		free_block* head = nullptr;
+		std::size_t count = 0;
+	};
+	std::array<free_list, size_classes> lists;
+};
+
+thread_cache& get_cache()
+{
+	static thread_local thread_cache cache;
+	return cache;
+}
+} // namespace
+
+void* allocate(std::size_t size)
+{
+	if(size > max_class_size)
+	{
+		return ::operator new(size);
+	}
+
+	// always hand out whole class sized blocks since any thread may cache them
+	const auto cls = get_size_class(size);
+	if(cache_destroyed)
+	{
+		return ::operator new(min_class_size << cls);
+	}
+
+	auto& list = get_cache().lists[cls];
+	if(list.head == nullptr)
+	{
+		list.head = get_shared_lists()[cls].take_all(list.count);
+	}
+
+	if(list.head)
+	{
+		auto* block = list.head;
+		list.head = block->next;
+		--list.count;
+		return block;
+	}
+
+	return ::operator new(min_class_size << cls);
+}
+
+void deallocate(void* ptr, std::size_t size) noexcept
+{
+	if(ptr == nullptr)
+	{
+		return;
+	}
+
+	if(size > max_class_size)
+	{
+		::operator delete(ptr);
+		return;
+	}
+
+	const auto cls = get_size_class(size);
+	auto* block = ::new(ptr) free_block();
+	if(cache_destroyed)
+	{
+		get_shared_lists()[cls].push(block);
+		return;
+	}
+
+	auto& list = get_cache().lists[cls];
+	if(list.count >= max_cached_blocks)
+	{
+		get_shared_lists()[cls].push(block);
+		return;
+	}
+
+	block->next = list.head;
+	list.head = block;
+	++list.count;
+}
+} // namespace task_pool
+} // namespace core
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+
+namespace core
+{
+namespace task_pool
+{
+
+//-----------------------------------------------------------------------------
+//  Name : allocate ()
+/// <summary>
+/// Allocates a block for a task node or a future state. Blocks are grouped in
+/// a few size classes and recycled through per-thread free lists backed by
+/// lock free shared ones, so once the caches are warm pushing a task does not
+/// touch the global heap, whichever thread frees it. Requests bigger than the
+/// largest size class fall back to operator new.
+/// </summary>
+//-----------------------------------------------------------------------------
+void* allocate(std::size_t size);
+
+//-----------------------------------------------------------------------------
+//  Name : deallocate ()
+/// <summary>
+/// Returns a block to the calling thread's cache, or to the shared lists once
+/// that is full. The size must be the same one that was passed to allocate.
+/// Can be called from any thread.
+/// </summary>
+//-----------------------------------------------------------------------------
+void deallocate(void* ptr, std::size_t size) noexcept;
+} // namespace task_pool
+} // namespace core
@@ -1,9 +1,28 @@
 #include "task_system.h"
 #include "../common/platform/thread.hpp"
+#include "../profiling/profiler.h"
 #include <limits>
+#include <string>
 
 namespace core
 {
+namespace
+{
+struct worker_tls
+{
+	const task_system* system = nullptr;
+	std::size_t index = 0;
+};
+
+thread_local worker_tls current_worker;
+
+/// How many tasks a thread runs before it looks at its deferred tasks again.
+constexpr std::size_t deferred_check_interval = 16;
+
+/// While a thread holds deferred tasks (inputs that are not task_futures) it
+/// cannot sleep forever since nobody will notify it when they become ready.
+constexpr std::chrono::milliseconds deferred_poll_interval(1);
+} // namespace
 
 task::task_concept::~task_concept() noexcept = default;
 
@@ -13,223 +32,410 @@ task::task_concept::task_concept() noexcept
 	id_ = id++;
 }
 
-void task_system::task_queue::sort()
+void task::task_concept::inputs_ready_() noexcept
 {
-	if(tasks_.size() > 1)
+	system_->schedule_awaited(this);
+}
+
+std::size_t task_system::get_current_thread_idx() const
+{
+	if(current_worker.system == this)
 	{
-		std::stable_partition(tasks_.begin(), tasks_.end(), [](const auto& task1) { return task1.ready(); });
+		return current_worker.index;
 	}
+
+	if(std::this_thread::get_id() == owner_thread_id_)
+	{
+		return get_owner_thread_idx();
+	}
+
+	return invalid_index;
 }
 
-task_system::task_queue::task_queue(task_system::task_queue&& other) noexcept
-	: tasks_(std::move(other.tasks_))
-	, done_(other.done_.load())
+bool task_system::is_worker_thread() const
 {
+	const auto idx = get_current_thread_idx();
+	return idx != invalid_index && idx != get_owner_thread_idx();
 }
 
-std::size_t task_system::task_queue::get_pending_tasks() const
+std::size_t task_system::get_any_worker_thread_idx() const
 {
-	std::lock_guard<std::mutex> lock(mutex_);
-	return tasks_.size();
+	if(threads_count_ == 1)
+	{
+		return get_owner_thread_idx();
+	}
+
+	// a worker keeps its own work local, thieves will balance it out
+	const auto current_idx = get_current_thread_idx();
+	if(current_idx != invalid_index && current_idx != get_owner_thread_idx())
+	{
+		return current_idx;
+	}
+
+	// injection queues cannot be stolen from so prefer someone who is idle
+	if(sleeping_count_.load(std::memory_order_relaxed) > 0)
+	{
+		for(std::size_t i = 1; i < threads_count_; ++i)
+		{
+			if(queues_[i]->sleeping.load(std::memory_order_relaxed))
+			{
+				return i;
+			}
+		}
+	}
+
+	return get_most_free_queue_idx(true);
 }
 
-void task_system::task_queue::clear()
+std::size_t task_system::get_most_busy_queue_idx(bool skip_owner) const
 {
-	std::unique_lock<std::mutex> lock(mutex_);
-	tasks_.clear();
+	if(threads_count_ == 1)
+	{
+		return get_owner_thread_idx();
+	}
+
+	std::size_t result = skip_owner ? 1 : 0;
+	std::size_t max_pending = 0;
+	for(std::size_t i = result; i < threads_count_; ++i)
+	{
+		const auto pending = queues_[i]->pending.load(std::memory_order_relaxed);
+		if(pending > max_pending)
+		{
+			max_pending = pending;
+			result = i;
+		}
+	}
+	return result;
 }
 
-void task_system::task_queue::set_done()
+std::size_t task_system::get_most_free_queue_idx(bool skip_owner) const
 {
-	done_.store(true);
-	cv_.notify_all();
+	if(threads_count_ == 1)
+	{
+		return get_owner_thread_idx();
+	}
+
+	std::size_t result = skip_owner ? 1 : 0;
+	std::size_t min_pending = std::numeric_limits<std::size_t>::max();
+	for(std::size_t i = result; i < threads_count_; ++i)
+	{
+		const auto pending = queues_[i]->pending.load(std::memory_order_relaxed);
+		if(pending < min_pending)
+		{
+			min_pending = pending;
+			result = i;
+		}
+	}
+	return result;
 }
 
-bool task_system::task_queue::is_done() const
+void task_system::push_task(task t, std::size_t idx)
 {
-	return done_.load();
+	if(!t.ready())
+	{
+		auto* ptr = t.release();
+		ptr->system_ = this;
+		ptr->target_idx_ = idx;
+
+		awaiting_count_.fetch_add(1, std::memory_order_relaxed);
+		if(ptr->await_())
+		{
+			// the last input to complete will schedule it
+			return;
+		}
+		awaiting_count_.fetch_sub(1, std::memory_order_relaxed);
+
+		// can't be notified, it will be polled from the deferred list
+		t = task(ptr);
+	}
+
+	enqueue_task(std::move(t), idx);
 }
 
-std::pair<bool, task> task_system::task_queue::try_pop()
+void task_system::schedule_awaited(task::task_concept* ptr) noexcept
 {
-	std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+	awaiting_count_.fetch_sub(1, std::memory_order_relaxed);
 
-	if(!lock || tasks_.empty())
+	if(stopped_.load())
 	{
-		return std::make_pair(false, task{});
+		task discard(ptr);
+		return;
 	}
-	if(tasks_.front().ready())
+
+	// workers are interchangeable so keep the continuation on the worker
+	// that produced its input
+	auto idx = ptr->target_idx_;
+	const auto current_idx = get_current_thread_idx();
+	if(idx != get_owner_thread_idx() && current_idx != invalid_index && current_idx != get_owner_thread_idx())
 	{
-		auto t = std::move(tasks_.front());
-		tasks_.pop_front();
-		return std::make_pair(true, std::move(t));
+		idx = current_idx;
 	}
 
-	sort();
-	return std::make_pair(false, task{});
+	enqueue_task(task(ptr), idx);
 }
 
-bool task_system::task_queue::try_push(task& t)
+void task_system::enqueue_task(task t, std::size_t idx)
 {
+	auto& queue = *queues_[idx];
+	queue.pending.fetch_add(1, std::memory_order_relaxed);
+
+	if(idx != get_owner_thread_idx() && get_current_thread_idx() == idx)
 	{
-		std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
-		if(!lock)
-		{
-			return false;
-		}
+		queue.deque.push(t.release());
 
-		tasks_.emplace_back(std::move(t));
+		// give a sleeping thief the chance to take it
+		wake_one(idx);
+		return;
 	}
 
-	cv_.notify_one();
-	return true;
+	queue.inbox.push(t.release());
+
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if(queue.sleeping.load(std::memory_order_relaxed))
+	{
+		unpark(idx);
+	}
 }
 
-std::pair<bool, task> task_system::task_queue::pop(duration_t pop_timeout)
+void task_system::unpark(std::size_t idx) noexcept
 {
-	std::unique_lock<std::mutex> lock(mutex_);
-	bool wait = pop_timeout > duration_t(0);
-	bool timed_wait = pop_timeout != duration_t::max();
-	if(wait && tasks_.empty())
+	auto& queue = *queues_[idx];
+	{
+		std::lock_guard<std::mutex> lock(queue.park_mutex);
+		queue.notified = true;
+	}
+	queue.park_cv.notify_one();
+}
+
+void task_system::wake_one(std::size_t skip_idx)
+{
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if(sleeping_count_.load(std::memory_order_relaxed) == 0)
+	{
+		return;
+	}
+
+	for(std::size_t i = 1; i < threads_count_; ++i)
 	{
-		if(timed_wait)
+		if(i == skip_idx)
 		{
-			cv_.wait_for(lock, pop_timeout);
+			continue;
 		}
-		else
+
+		if(queues_[i]->sleeping.load(std::memory_order_relaxed))
 		{
-			cv_.wait(lock);
+			unpark(i);
+			return;
 		}
 	}
+}
 
-	if(tasks_.empty())
+bool task_system::has_pending_work(std::size_t idx, bool allow_steal) const
+{
+	const auto& queue = *queues_[idx];
+	if(!queue.inbox.empty() || !queue.deque.empty())
 	{
-		return std::make_pair(false, task{});
+		return true;
 	}
 
-	if(tasks_.front().ready())
+	if(allow_steal)
 	{
-		auto t = std::move(tasks_.front());
-		tasks_.pop_front();
-		return std::make_pair(true, std::move(t));
+		for(std::size_t i = 1; i < threads_count_; ++i)
+		{
+			if(!queues_[i]->deque.empty())
+			{
+				return true;
+			}
+		}
 	}
+	return false;
+}
 
-	sort();
+void task_system::park(std::size_t idx, bool allow_steal)
+{
+	auto& queue = *queues_[idx];
+	const bool is_worker = idx != get_owner_thread_idx();
 
-	// try after sort
-	if(tasks_.front().ready())
+	queue.sleeping.store(true, std::memory_order_relaxed);
+	if(is_worker)
 	{
-		auto t = std::move(tasks_.front());
-		tasks_.pop_front();
-		return std::make_pair(true, std::move(t));
+		sleeping_count_.fetch_add(1, std::memory_order_seq_cst);
 	}
+	std::atomic_thread_fence(std::memory_order_seq_cst);
 
-	return std::make_pair(false, task{});
-}
+	// re-check after announcing ourselves so that a concurrent push either
+	// sees us sleeping or we see its task
+	if(!has_pending_work(idx, allow_steal) && !done_.load())
+	{
+		std::unique_lock<std::mutex> lock(queue.park_mutex);
+		const auto pred = [&queue]() { return queue.notified; };
+		if(queue.deferred.empty())
+		{
+			queue.park_cv.wait(lock, pred);
+		}
+		else
+		{
+			queue.park_cv.wait_for(lock, deferred_poll_interval, pred);
+		}
+		queue.notified = false;
+	}
 
-void task_system::task_queue::push(task t)
-{
+	if(is_worker)
 	{
-		std::unique_lock<std::mutex> lock(mutex_);
-		tasks_.emplace_back(std::move(t));
+		sleeping_count_.fetch_sub(1, std::memory_order_relaxed);
 	}
-	cv_.notify_one();
+	queue.sleeping.store(false, std::memory_order_relaxed);
 }
 
-void task_system::task_queue::wake_up()
+bool task_system::try_pop_task(std::size_t idx, bool allow_steal, task& out)
 {
-	cv_.notify_all();
-}
+	auto& queue = *queues_[idx];
+	const bool is_worker = idx != get_owner_thread_idx();
 
-bool task_system::task_queue::cancel(uint64_t id)
-{
-	bool res = false;
-	{
-		std::unique_lock<std::mutex> lock(mutex_);
-		tasks_.erase(std::remove_if(std::begin(tasks_), std::end(tasks_),
-									[id, &res](const auto& task) {
-										auto cmp = task.get_id() == id;
-										if(cmp)
-										{
-											res = true;
-										}
-										return cmp;
-									}),
-					 std::end(tasks_));
-	}
-	cv_.notify_one();
-
-	return res;
-}
+	const auto check_deferred = [&]() {
+		queue.since_deferred_check = 0;
+		for(;;)
+		{
+			auto it = std::find_if(std::begin(queue.deferred), std::end(queue.deferred),
+								   [](const task& t) { return t.cancelled() || t.ready(); });
+			if(it == std::end(queue.deferred))
+			{
+				return false;
+			}
+			task t = std::move(*it);
+			queue.deferred.erase(it);
+			queue.pending.fetch_sub(1, std::memory_order_relaxed);
+			if(!t.cancelled())
+			{
+				out = std::move(t);
+				return true;
+			}
+		}
+	};
 
-void task_system::run(std::size_t idx, const std::function<bool()>& condition, duration_t pop_timeout)
-{
-	while(condition())
+	// don't starve the deferred tasks under constant load
+	if(!queue.deferred.empty() && ++queue.since_deferred_check >= deferred_check_interval)
 	{
-		const auto queue_index = get_thread_queue_idx(idx);
-		bool is_done = queues_[queue_index].is_done();
-		bool is_empty = queues_[queue_index].get_pending_tasks() == 0;
-		if(is_done && is_empty)
+		if(check_deferred())
 		{
-			return;
+			return true;
+		}
+	}
+
+	for(;;)
+	{
+		task::task_concept* ptr = nullptr;
+		std::size_t source_idx = idx;
+
+		if(!is_worker || !queue.deque.pop(ptr))
+		{
+			ptr = queue.inbox.pop();
 		}
 
-		std::pair<bool, task> p = {false, task()};
+		if(ptr != nullptr && is_worker)
+		{
+			// make the rest of the injected work visible to thieves
+			while(auto* next = queue.inbox.pop())
+			{
+				queue.deque.push(next);
+			}
+		}
 
-		if(idx != 0 && is_empty)
+		if(ptr == nullptr && allow_steal && threads_count_ > 2)
 		{
-			std::size_t steal_attempts = threads_count_;
-			const auto queue_idx = get_most_free_queue_idx(true);
-			for(std::size_t k = 0; k < steal_attempts; ++k)
+			const auto workers = threads_count_ - 1;
+			for(std::size_t k = 0; k < workers && ptr == nullptr; ++k)
 			{
-				if(queue_index != queue_idx)
+				const auto victim = 1 + ((queue.steal_seed + k) % workers);
+				if(victim == idx)
+				{
+					continue;
+				}
+				if(queues_[victim]->deque.steal(ptr))
+				{
+					source_idx = victim;
+				}
+				else
 				{
-					p = queues_[queue_idx].try_pop();
-					if(p.first)
-					{
-						break;
-					}
+					ptr = nullptr;
 				}
 			}
+			++queue.steal_seed;
 		}
 
-		if(!p.first)
+		if(ptr == nullptr)
+		{
+			break;
+		}
+
+		queues_[source_idx]->pending.fetch_sub(1, std::memory_order_relaxed);
+
+		task t(ptr);
+		if(t.cancelled())
 		{
-			p = queues_[queue_index].pop(pop_timeout);
+			continue;
 		}
 
-		if(p.first)
+		if(!t.ready())
 		{
-			p.second();
+			queue.pending.fetch_add(1, std::memory_order_relaxed);
+			queue.deferred.emplace_back(std::move(t));
+			continue;
 		}
+
+		out = std::move(t);
+		return true;
 	}
-}
 
-std::size_t task_system::get_thread_queue_idx(std::size_t idx, std::size_t seed)
-{
-	// if owner thread then just return
-	if(idx == get_owner_thread_idx())
+	if(!queue.deferred.empty())
 	{
-		return get_owner_thread_idx();
+		return check_deferred();
 	}
 
-	auto queue_index = ((idx + seed) % threads_count_);
+	return false;
+}
 
-	if(queue_index == get_owner_thread_idx())
+void task_system::execute(task& t)
+{
+	// a cancelled task is just dropped
+	if(t.start())
 	{
-		queue_index++;
+		PROFILE_SCOPE("task");
+		t();
 	}
-
-	return queue_index;
+	t = task();
 }
 
-std::thread::id task_system::get_thread_id(std::size_t index)
+void task_system::run(std::size_t idx)
 {
-	const auto& thread = threads_[index];
+	current_worker.system = this;
+	current_worker.index = idx;
+	profiling::set_thread_name("task_worker " + std::to_string(idx));
 
-	const auto thread_id = (index == get_owner_thread_idx()) ? owner_thread_id_ : thread.get_id();
+	for(;;)
+	{
+		const bool is_done = done_.load();
+		if(is_done && !wait_on_destruct_)
+		{
+			break;
+		}
 
-	return thread_id;
+		task t;
+		if(try_pop_task(idx, true, t))
+		{
+			execute(t);
+			continue;
+		}
+
+		if(is_done)
+		{
+			break;
+		}
+
+		park(idx, true);
+	}
+
+	current_worker = {};
 }
 
 task_system::task_system(bool wait_on_destruct)
@@ -238,36 +444,32 @@ task_system::task_system(bool wait_on_destruct)
 }
 
 task_system::task_system(bool wait_on_destruct, std::size_t nthreads)
-	: threads_count_{nthreads}
+	: threads_count_{std::max<std::size_t>(nthreads, 1)}
 	, wait_on_destruct_(wait_on_destruct)
 {
 	queues_.reserve(threads_count_);
-	queues_.emplace_back();
-	for(std::size_t th = 1; th < threads_count_; ++th)
+	for(std::size_t th = 0; th < threads_count_; ++th)
 	{
-		queues_.emplace_back();
+		queues_.emplace_back(std::make_unique<thread_queue>());
 	}
 
 	// two seperate loops.
 	threads_.reserve(threads_count_);
 	threads_.emplace_back();
-	using namespace std::literals;
 	for(std::size_t th = 1; th < threads_count_; ++th)
 	{
-		threads_.emplace_back(&task_system::run, this, th, []() { return true; }, 50ms);
+		threads_.emplace_back(&task_system::run, this, th);
 		platform::set_thread_name(threads_.back(), "task_worker");
 	}
 }
 
 task_system::~task_system()
 {
-	for(auto& q : queues_)
+	done_.store(true);
+
+	for(std::size_t i = 0; i < threads_count_; ++i)
 	{
-		if(!wait_on_destruct_)
-		{
-			q.clear();
-		}
-		q.set_done();
+		unpark(i);
 	}
 
 	for(auto& th : threads_)
@@ -277,28 +479,40 @@ task_system::~task_system()
 			th.join();
 		}
 	}
+	stopped_.store(true);
+
+	// every thread is gone so we can safely act as the owner of all queues
+	for(auto& queue : queues_)
+	{
+		task::task_concept* ptr = nullptr;
+		while(queue->deque.pop(ptr))
+		{
+			task discard(ptr);
+		}
+		while((ptr = queue->inbox.pop()) != nullptr)
+		{
+			task discard(ptr);
+		}
+		queue->deferred.clear();
+	}
 }
 
 void task_system::run_on_owner_thread(duration_t max_duration)
 {
-	const auto queue_index = get_thread_queue_idx(0);
+	const auto queue_index = get_owner_thread_idx();
 
-	using namespace std::literals;
 	auto now = std::chrono::steady_clock::now();
 	auto end = now + max_duration;
 
 	while(now < end)
 	{
-		auto p = queues_[queue_index].pop(0ms);
-		if(!p.first)
+		task t;
+		if(!try_pop_task(queue_index, false, t))
 		{
 			return;
 		}
 
-		if(p.first)
-		{
-			p.second();
-		}
+		execute(t);
 
 		now = std::chrono::steady_clock::now();
 	}
@@ -312,9 +526,11 @@ task_system::system_info task_system::get_info() const
 	{
 		info.queue_infos.emplace_back();
 		auto& q_info = info.queue_infos.back();
-		q_info.pending_tasks = queue.get_pending_tasks();
+		q_info.pending_tasks = queue->pending.load(std::memory_order_relaxed);
 		info.pending_tasks += q_info.pending_tasks;
 	}
+	info.awaiting_tasks = awaiting_count_.load(std::memory_order_relaxed);
+	info.pending_tasks += info.awaiting_tasks;
 	return info;
 }
 } // namespace core
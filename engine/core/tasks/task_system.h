@@ -1,19 +1,25 @@
 #ifndef TASK_SYSTEM_H
 #define TASK_SYSTEM_H
 
+#include "future_state.hpp"
 #include "future_traits.hpp"
+#include "mpsc_queue.hpp"
+#include "work_stealing_deque.hpp"
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <cstddef>
 #include <cstdint>
-#include <deque>
 #include <exception>
 #include <future>
+#include <limits>
 #include <memory>
 #include <mutex>
+#include <new>
 #include <thread>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -30,17 +36,20 @@ public:
 	{
 		wait();
 
-		return future_.get();
+		if(!state_)
+		{
+			throw std::future_error(std::future_errc::no_state);
+		}
+		return state_->get();
 	}
 
-	decltype(auto) valid() const
+	bool valid() const
 	{
-		return future_.valid();
+		return static_cast<bool>(state_);
 	}
 	bool is_ready() const
 	{
-		using namespace std::chrono_literals;
-		return valid() && wait_for(0s) == std::future_status::ready;
+		return valid() && state_->is_ready();
 	}
 
 	//-----------------------------------------------------------------------------
@@ -60,22 +69,14 @@ public:
 	std::future_status wait_for(const std::chrono::duration<Rep, Per>& rel_time) const
 	{
 		// wait for duration
-		return future_.wait_for(rel_time);
+		return state_->wait_for(rel_time);
 	}
 
 	template <class Clock, class Dur>
 	std::future_status wait_until(const std::chrono::time_point<Clock, Dur>& abs_time) const
 	{
 		// wait until time point
-		return future_.wait_until(abs_time);
-	}
-
-	static task_future<T> from_shared_future(std::shared_future<T>&& fut, std::uint64_t id = 0)
-	{
-		task_future<T> res;
-		res.future_ = std::move(fut);
-		res.id_ = id;
-		return res;
+		return state_->wait_until(abs_time);
 	}
 
 	std::uint64_t get_id() const
@@ -90,19 +91,29 @@ public:
 
 private:
 	friend class task_system;
-	std::shared_future<T> future_;
+	friend class task;
+
+	static task_future<T> from_state(detail::future_state_ptr<T> state, std::uint64_t id)
+	{
+		task_future<T> res;
+		res.state_ = std::move(state);
+		res.id_ = id;
+		return res;
+	}
+
+	detail::future_state_ptr<T> state_;
 	task_system* executor_ = nullptr;
 	std::uint64_t id_ = 0;
 };
 
 /*
- * awaitable_task; a type-erased, std::packaged_task that
- * also contains its own arguments.
+ * task; a type-erased callable that also contains its own arguments
+ * and the shared state of its task_future.
  *
  * There are two forms of tasks: ready tasks and awaitable tasks.
  *
  *      Ready tasks are assumed to be immediately invokable; that is,
- *      invoking the underlying pakcaged_task with the provided arguments
+ *      invoking the underlying callable with the provided arguments
  *      will not block. This is contrasted with awaitable tasks where some or
  *      all of the provided arguments may be futures waiting on results of
  *      other tasks.
@@ -114,31 +125,34 @@ private:
  *
  * There are two helper methods for creating task objects:
  * make_ready_task and make_awaitable_task, both of which return a pair of
- * the newly constructed task and a std::future object to the
+ * the newly constructed task and a task_future object to the
  * return value.
  */
 
 template <typename T>
 using is_future = async::detail::is_future<T>;
 
+template <typename T>
+struct is_task_future_impl : std::false_type
+{
+};
+
+template <typename T>
+struct is_task_future_impl<task_future<T>> : std::true_type
+{
+};
+
+template <typename T>
+using is_task_future = is_task_future_impl<std::decay_t<T>>;
+
 class task
 {
 	template <typename T>
 	using decay_future_t = async::detail::decay_future_t<T>;
 
-	template <class T>
-	using decay_if_future_t = typename std::conditional<is_future<T>::value, decay_future_t<T>, T>::type;
-
 	template <typename F, typename... Args>
 	using invoke_result_t = typename nonstd::function_traits<F>::result_type;
 
-	struct ready_task_tag
-	{
-	};
-	struct awaitable_task_tag
-	{
-	};
-
 public:
 	task() = default;
 	~task() = default;
@@ -164,11 +178,11 @@ public:
 	{
 		using invoke_res = invoke_result_t<F, Args...>;
 		using pair_type = std::pair<task, task_future<invoke_res>>;
-		using model_type = ready_task_model<invoke_res(Args...)>;
+		using model_type = ready_task_model<std::decay_t<F>, invoke_res(Args...)>;
 
-		task t(ready_task_tag(), std::forward<F>(f), std::forward<Args>(args)...);
-		auto fut = static_cast<model_type&>(*t.t_).get_future();
-		return pair_type(std::move(t), std::move(fut));
+		auto* model = new model_type(std::forward<F>(f), std::forward<Args>(args)...);
+		auto fut = model->get_future();
+		return pair_type(task(model), std::move(fut));
 	}
 
 	template <class F, class... Args>
@@ -176,11 +190,11 @@ public:
 	{
 		using invoke_res = invoke_result_t<F, Args...>;
 		using pair_type = std::pair<task, task_future<invoke_res>>;
-		using model_type = awaitable_task_model<invoke_res(decay_if_future_t<Args>...), Args...>;
+		using model_type = awaitable_task_model<std::decay_t<F>, invoke_res, Args...>;
 
-		task t(awaitable_task_tag(), std::forward<F>(f), std::forward<Args>(args)...);
-		auto fut = static_cast<model_type&>(*t.t_).get_future();
-		return pair_type(std::move(t), std::move(fut));
+		auto* model = new model_type(std::forward<F>(f), std::forward<Args>(args)...);
+		auto fut = model->get_future();
+		return pair_type(task(model), std::move(fut));
 	}
 
 	void operator()()
@@ -210,61 +224,205 @@ public:
 		return 0;
 	}
 
-private:
-	template <class F, class... Args>
-	task(ready_task_tag /*unused*/, F&& f, Args&&... args) noexcept
-		: t_(new ready_task_model<invoke_result_t<F, Args...>(Args...)>(std::forward<F>(f),
-																		std::forward<Args>(args)...))
+	//-----------------------------------------------------------------------------
+	//  Name : start ()
+	/// <summary>
+	/// Claims the task for execution. Returns false if it was cancelled, it
+	/// must not be invoked then.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool start() noexcept
 	{
+		if(t_)
+		{
+			return t_->start_();
+		}
+
+		return false;
 	}
 
-	template <class F, class... Args>
-	task(awaitable_task_tag /*unused*/, F&& f, Args&&... args) noexcept
-		: t_(new awaitable_task_model<invoke_result_t<F, Args...>(decay_if_future_t<Args>...), Args...>(
-			  std::forward<F>(f), std::forward<Args>(args)...))
+	bool cancelled() const noexcept
 	{
+		if(t_)
+		{
+			return t_->cancelled_();
+		}
+
+		return false;
 	}
 
-	struct task_concept
+private:
+	friend class task_system;
+
+	//-----------------------------------------------------------------------------
+	//  Name : task_concept ()
+	/// <summary>
+	/// Type erased task. Derives from mpsc_node so that it can be linked
+	/// directly into the task_system injection queues without extra nodes.
+	/// Models are allocated from the task_pool and store the callable and its
+	/// arguments inline.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	struct task_concept : mpsc_node
 	{
 		task_concept() noexcept;
 		virtual ~task_concept() noexcept;
 		virtual void invoke_() = 0;
 		virtual bool ready_() const noexcept = 0;
+		virtual bool start_() noexcept = 0;
+		virtual bool cancelled_() const noexcept = 0;
+
+		//-----------------------------------------------------------------------------
+		//  Name : await_ ()
+		/// <summary>
+		/// Registers the task as a dependent of its inputs that are not ready yet.
+		/// Once the last one completes inputs_ready_ hands the task back to its
+		/// task_system. Ownership of the task passes to its inputs on success.
+		/// Returns false if some input cannot notify us, the scheduler then has
+		/// to poll ready_ instead.
+		/// </summary>
+		//-----------------------------------------------------------------------------
+		virtual bool await_() noexcept
+		{
+			return false;
+		}
+
+		//-----------------------------------------------------------------------------
+		//  Name : inputs_ready_ ()
+		/// <summary>
+		/// Schedules an awaiting task on system_ now that all its inputs are ready.
+		/// </summary>
+		//-----------------------------------------------------------------------------
+		void inputs_ready_() noexcept;
+
+		static void* operator new(std::size_t size)
+		{
+			return task_pool::allocate(size);
+		}
+
+		static void operator delete(void* ptr, std::size_t size) noexcept
+		{
+			task_pool::deallocate(ptr, size);
+		}
+
+		// over-aligned callables bypass the pool
+		static void* operator new(std::size_t size, std::align_val_t al)
+		{
+			return ::operator new(size, al);
+		}
+
+		static void operator delete(void* ptr, std::size_t size, std::align_val_t al) noexcept
+		{
+			::operator delete(ptr, size, al);
+		}
+
 		std::uint64_t id_ = 0;
+		/// Where an awaiting task goes once its inputs are ready.
+		task_system* system_ = nullptr;
+		std::size_t target_idx_ = 0;
 	};
 
-	template <class>
+	//-----------------------------------------------------------------------------
+	//  Name : task_model ()
+	/// <summary>
+	/// Owns the shared state of the task's future. A task that is destroyed
+	/// without being invoked breaks its promise, just like std::packaged_task.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	template <class R>
+	struct task_model : task_concept
+	{
+		task_model()
+			: state_(detail::make_future_state<R>())
+		{
+		}
+
+		~task_model() noexcept override
+		{
+			if(!state_->is_ready())
+			{
+				try
+				{
+					state_->set_broken();
+				}
+				catch(...)
+				{
+				}
+			}
+		}
+
+		task_future<R> get_future()
+		{
+			return task_future<R>::from_state(state_, this->id_);
+		}
+
+		bool start_() noexcept override
+		{
+			return state_->try_start();
+		}
+
+		bool cancelled_() const noexcept override
+		{
+			return state_->is_cancelled();
+		}
+
+	protected:
+		template <typename Fn>
+		void fulfill(Fn&& fn)
+		{
+			try
+			{
+				set_result(std::is_void<R>(), fn);
+			}
+			catch(...)
+			{
+				state_->set_exception(std::current_exception());
+			}
+		}
+
+	private:
+		template <typename Fn>
+		void set_result(std::true_type /*unused*/, Fn& fn)
+		{
+			fn();
+			state_->set_value();
+		}
+
+		template <typename Fn>
+		void set_result(std::false_type /*unused*/, Fn& fn)
+		{
+			state_->set_value(fn());
+		}
+
+		detail::future_state_ptr<R> state_;
+	};
+
+	template <class, class>
 	struct ready_task_model;
 
 	//-----------------------------------------------------------------------------
 	//  Name : ready_task_model ()
 	/// <summary>
 	/// Ready tasks are assumed to be immediately invokable, that is,
-	/// invoking the underlying pakcaged_task with the provided arguments
+	/// invoking the underlying callable with the provided arguments
 	/// will not block. This is contrasted with async tasks where some or all
 	/// of the provided arguments may be futures waiting on results of other
 	/// tasks.
 	/// </summary>
 	//-----------------------------------------------------------------------------
-	template <class R, class... Args>
-	struct ready_task_model<R(Args...)> : task_concept
+	template <class F, class R, class... Args>
+	struct ready_task_model<F, R(Args...)> : task_model<R>
 	{
-		template <class F>
-		explicit ready_task_model(F&& f, Args&&... args) noexcept
-			: f_(std::forward<F>(f))
+		template <class Fn>
+		explicit ready_task_model(Fn&& f, Args&&... args)
+			: f_(std::forward<Fn>(f))
 			, args_(std::forward<Args>(args)...)
 		{
 		}
 
-		task_future<R> get_future()
-		{
-			return task_future<R>::from_shared_future(f_.get_future().share(), id_);
-		}
-
 		void invoke_() override
 		{
-			nonstd::apply(f_, args_);
+			do_invoke_(std::index_sequence_for<Args...>());
 		}
 
 		bool ready_() const noexcept override
@@ -273,57 +431,127 @@ private:
 		}
 
 	private:
-		std::packaged_task<R(Args...)> f_;
+		// by value arguments are moved out since a task runs only once
+		template <typename Arg, typename Stored,
+				  typename std::enable_if_t<!std::is_reference<Arg>::value &&
+											std::is_same<std::decay_t<Arg>, Stored>::value>* = nullptr>
+		static inline Stored&& pass_arg(Stored& s) noexcept
+		{
+			return std::move(s);
+		}
+
+		template <typename Arg, typename Stored,
+				  typename std::enable_if_t<std::is_reference<Arg>::value ||
+											!std::is_same<std::decay_t<Arg>, Stored>::value>* = nullptr>
+		static inline Stored& pass_arg(Stored& s) noexcept
+		{
+			return s;
+		}
+
+		template <std::size_t... I>
+		inline void do_invoke_(std::index_sequence<I...> /*unused*/)
+		{
+			this->fulfill([this]() -> decltype(auto) {
+				return nonstd::invoke(f_, pass_arg<Args>(std::get<I>(args_))...);
+			});
+		}
+
+		F f_;
 		std::tuple<nonstd::special_decay_t<Args>...> args_;
 	};
 
-	template <class...>
-	struct awaitable_task_model;
-
 	//-----------------------------------------------------------------------------
 	//  Name : awaitable_task_model ()
 	/// <summary>
 	/// Async tasks are assumed to take arguments where some or all are
 	/// backed by futures waiting on results of other tasks. This is
 	/// contrasted with ready tasks that are assumed to be immediately
-	/// invokable.
+	/// invokable. When all the futures are task_futures the task keeps a
+	/// counter of unfinished inputs and is only scheduled once it drops to
+	/// zero, so it never sits in a queue while blocked.
 	/// </summary>
 	//-----------------------------------------------------------------------------
-	template <class R, class... CallArgs, class... FutArgs>
-	struct awaitable_task_model<R(CallArgs...), FutArgs...> : task_concept
+	template <class F, class R, class... FutArgs>
+	struct awaitable_task_model : task_model<R>
 	{
-		template <class F, class... Args>
-		explicit awaitable_task_model(F&& f, Args&&... args) noexcept
-			: f_(std::forward<F>(f))
+		template <class Fn, class... Args>
+		explicit awaitable_task_model(Fn&& f, Args&&... args)
+			: f_(std::forward<Fn>(f))
 			, args_(std::forward<Args>(args)...)
 		{
 		}
 
-		task_future<R> get_future()
+		void invoke_() override
 		{
-			return task_future<R>::from_shared_future(f_.get_future().share(), id_);
+			do_invoke_(std::index_sequence_for<FutArgs...>());
 		}
 
-		void invoke_() override
+		bool ready_() const noexcept override
 		{
-			constexpr const std::size_t arity = sizeof...(FutArgs);
-			try
+			return do_ready_(std::index_sequence_for<FutArgs...>());
+		}
+
+		bool await_() noexcept override
+		{
+			return do_await_(can_await(), std::index_sequence_for<FutArgs...>());
+		}
+
+	private:
+		using can_await = nonstd::conjunction<
+			nonstd::disjunction<nonstd::negation<is_future<FutArgs>>, is_task_future<FutArgs>>...>;
+
+		static constexpr std::size_t input_count = sizeof...(FutArgs);
+
+		struct input_node : detail::continuation
+		{
+			void on_ready() noexcept override
 			{
-				do_invoke_(std::make_index_sequence<arity>());
+				owner->input_ready_();
 			}
-			catch(const std::future_error& e)
+
+			awaitable_task_model* owner = nullptr;
+		};
+
+		void input_ready_() noexcept
+		{
+			if(pending_inputs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
 			{
-				(void)e;
+				this->inputs_ready_();
 			}
 		}
 
-		bool ready_() const noexcept override
+		template <typename T, typename std::enable_if_t<!is_task_future<T>::value>* = nullptr>
+		inline void call_await(const T& /*unused*/, input_node& /*unused*/) noexcept
 		{
-			constexpr const std::size_t arity = sizeof...(FutArgs);
-			return do_ready_(std::make_index_sequence<arity>());
+			input_ready_();
+		}
+
+		template <typename T, typename std::enable_if_t<is_task_future<T>::value>* = nullptr>
+		inline void call_await(const T& t, input_node& node) noexcept
+		{
+			node.owner = this;
+			if(!t.state_ || !t.state_->add_continuation(&node))
+			{
+				input_ready_();
+			}
+		}
+
+		template <std::size_t... I>
+		inline bool do_await_(std::false_type /*unused*/, std::index_sequence<I...> /*unused*/) noexcept
+		{
+			return false;
+		}
+
+		template <std::size_t... I>
+		inline bool do_await_(std::true_type /*unused*/, std::index_sequence<I...> /*unused*/) noexcept
+		{
+			// the extra count keeps us from being scheduled while still registering
+			pending_inputs_.store(input_count + 1, std::memory_order_relaxed);
+			nonstd::ignore((call_await(std::get<I>(args_), inputs_[I]), 0)...);
+			input_ready_();
+			return true;
 		}
 
-	private:
 		template <typename T, typename std::enable_if_t<!is_future<T>::value>* = nullptr>
 		static inline decltype(auto) call_get(T&& t)
 		{
@@ -339,14 +567,10 @@ private:
 		template <std::size_t... I>
 		inline void do_invoke_(std::index_sequence<I...> /*unused*/)
 		{
-			try
-			{
-				nonstd::invoke(f_, call_get(std::get<I>(std::move(args_)))...);
-			}
-			catch(const std::future_error& e)
-			{
-				(void)e;
-			}
+			// a broken input future propagates its exception to our future
+			this->fulfill([this]() -> decltype(auto) {
+				return nonstd::invoke(f_, call_get(std::get<I>(std::move(args_)))...);
+			});
 		}
 
 		template <typename T, typename std::enable_if_t<!is_future<T>::value>* = nullptr>
@@ -354,8 +578,16 @@ private:
 		{
 			return true;
 		}
-            
-		template <typename T, typename std::enable_if_t<is_future<T>::value>* = nullptr>
+
+		template <typename T, typename std::enable_if_t<is_task_future<T>::value>* = nullptr>
+		static inline bool call_ready(const T& t) noexcept
+		{
+			// an invalid future can never become ready, let get() report it
+			return !t.valid() || t.is_ready();
+		}
+
+		template <typename T,
+				  typename std::enable_if_t<is_future<T>::value && !is_task_future<T>::value>* = nullptr>
 		static inline bool call_ready(const T& t) noexcept
 		{
 			using namespace std::chrono_literals;
@@ -368,10 +600,22 @@ private:
 			return nonstd::check_all_true(call_ready(std::get<I>(args_))...);
 		}
 
-		std::packaged_task<R(CallArgs...)> f_;
+		F f_;
 		std::tuple<nonstd::special_decay_t<FutArgs>...> args_;
+		std::array<input_node, input_count> inputs_;
+		std::atomic<std::size_t> pending_inputs_{0};
 	};
 
+	explicit task(task_concept* t) noexcept
+		: t_(t)
+	{
+	}
+
+	task_concept* release() noexcept
+	{
+		return t_.release();
+	}
+
 	std::unique_ptr<task_concept> t_;
 };
 
@@ -380,6 +624,7 @@ class task_system
 	using duration_t = std::chrono::steady_clock::duration;
 	template <typename T>
 	friend class task_future;
+	friend class task;
 
 public:
 	struct queue_info
@@ -389,6 +634,8 @@ public:
 	struct system_info
 	{
 		std::size_t pending_tasks = 0;
+		/// Tasks waiting for their inputs. They are not in any queue yet.
+		std::size_t awaiting_tasks = 0;
 		std::vector<queue_info> queue_infos;
 	};
 
@@ -413,6 +660,48 @@ public:
 	void run_on_owner_thread(duration_t max_duration = duration_t(0));
 
 	system_info get_info() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_threads_count ()
+	/// <summary>
+	/// Number of threads that execute tasks, the owner thread included.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::size_t get_threads_count() const
+	{
+		return threads_count_;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : is_worker_thread ()
+	/// <summary>
+	/// Returns true when called from one of the worker threads of this system.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool is_worker_thread() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : wait ()
+	/// <summary>
+	/// Waits for a future that was not created by this system (for example
+	/// one from task::make_ready_task) while processing tasks on the calling
+	/// thread the same way task_future::wait does.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	template <typename T>
+	void wait(const task_future<T>& t)
+	{
+		if(!t.valid() || t.is_ready())
+		{
+			return;
+		}
+
+		if(!processing_wait(t))
+		{
+			t.state_->wait();
+		}
+	}
+
 	//-----------------------------------------------------------------------------
 	//  Name : get_owner_thread_idx ()
 	/// <summary>
@@ -430,61 +719,31 @@ public:
 	//  Name : get_any_worker_thread_idx ()
 	/// <summary>
 	/// Gets one of the worker threads id. Can be used to push a task directly
-	/// there.
+	/// there. When called from a worker thread it returns that worker so that the
+	/// task lands in its local deque, otherwise it prefers a parked worker.
 	/// </summary>
 	//-----------------------------------------------------------------------------
-	std::size_t get_any_worker_thread_idx() const
-	{
-		return get_most_free_queue_idx(true);
-	}
+	std::size_t get_any_worker_thread_idx() const;
 
 	//-----------------------------------------------------------------------------
 	//  Name : get_most_busy_queue_idx ()
 	/// <summary>
-	/// Gets the most busy queue idx. This is basicly used by the work stealing
-	/// mechanism.
+	/// Gets the most busy queue idx. Reads the per queue counters without
+	/// taking any locks so the result is only a hint.
 	/// </summary>
 	//-----------------------------------------------------------------------------
-	std::size_t get_most_busy_queue_idx(bool skip_owner) const
-	{
-		if(threads_count_ == 1)
-		{
-			return get_owner_thread_idx();
-		}
-
-		auto info = get_info();
-		auto begin_it = skip_owner ? std::begin(info.queue_infos) + 1 : std::begin(info.queue_infos);
-		auto end_it = std::end(info.queue_infos);
-		auto min_el = std::min_element(begin_it, end_it, [](const auto& lhs, const auto& rhs) {
-			return lhs.pending_tasks > rhs.pending_tasks;
-		});
-		const std::size_t idx = static_cast<std::size_t>(std::distance(std::begin(info.queue_infos), min_el));
-		return idx;
-	}
+	std::size_t get_most_busy_queue_idx(bool skip_owner) const;
 
 	//-----------------------------------------------------------------------------
 	//  Name : get_most_free_queue_idx ()
 	/// <summary>
 	/// Gets the most free queue idx. This is basicly used by the load balancing
-	/// mechanism.
+	/// mechanism. Reads the per queue counters without taking any locks so the
+	/// result is only a hint.
 	/// </summary>
 	//-----------------------------------------------------------------------------
-	std::size_t get_most_free_queue_idx(bool skip_owner) const
-	{
-		if(threads_count_ == 1)
-		{
-			return get_owner_thread_idx();
-		}
+	std::size_t get_most_free_queue_idx(bool skip_owner) const;
 
-		auto info = get_info();
-		auto begin_it = skip_owner ? std::begin(info.queue_infos) + 1 : std::begin(info.queue_infos);
-		auto end_it = std::end(info.queue_infos);
-		auto min_el = std::min_element(begin_it, end_it, [](const auto& lhs, const auto& rhs) {
-			return lhs.pending_tasks < rhs.pending_tasks;
-		});
-		const std::size_t idx = static_cast<std::size_t>(std::distance(std::begin(info.queue_infos), min_el));
-		return idx;
-	}
 	//-----------------------------------------------------------------------------
 	//  Name : push_on_thread ()
 	/// <summary>
@@ -581,12 +840,14 @@ public:
 	}
 
 private:
+	static constexpr std::size_t invalid_index = std::numeric_limits<std::size_t>::max();
+
 	//-----------------------------------------------------------------------------
 	//  Name : push_impl ()
 	/// <summary>
 	/// Pushes a immediately invokable task to be executed.
 	/// Ready tasks are assumed to be immediately invokable; that is,
-	/// invoking the underlying pakcaged_task with the provided arguments
+	/// invoking the underlying callable with the provided arguments
 	/// will not block.This is contrasted with async tasks where some or
 	/// all of the provided arguments may be futures waiting on results of
 	/// other tasks.
@@ -622,7 +883,7 @@ private:
 	/// <summary>
 	/// Pushes a task to be executed.
 	/// Ready tasks are assumed to be immediately invokable; that is,
-	/// invoking the underlying pakcaged_task with the provided arguments
+	/// invoking the underlying callable with the provided arguments
 	/// will not block.This is contrasted with async tasks where some or
 	/// all of the provided arguments may be futures waiting on results of
 	/// other tasks.
@@ -637,36 +898,62 @@ private:
 	{
 		t.second.executor_ = this;
 
-		const auto queue_index = get_thread_queue_idx(idx);
 		if(execute_if_ready && t.first.ready() &&
-		   ((get_thread_id(queue_index) == std::this_thread::get_id()) || (queue_index != 0)))
+		   ((get_current_thread_idx() == idx) || (idx != get_owner_thread_idx())))
 		{
 			t.first();
 
 			return std::move(t.second);
 		}
 
-		queues_[queue_index].push(std::move(t.first));
+		push_task(std::move(t.first), idx);
 		return std::move(t.second);
 	}
 
-	bool cancel(std::uint64_t id)
-	{
-		bool cancelled = false;
-		for(std::size_t i = 0; i < threads_count_; ++i)
-		{
-			auto queue_index = get_thread_queue_idx(i, 0);
+	//-----------------------------------------------------------------------------
+	//  Name : push_task ()
+	/// <summary>
+	/// Hands a type erased task to the thread with index idx. A task whose
+	/// inputs are not ready is parked on them and only enqueued once the last
+	/// one completes.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void push_task(task t, std::size_t idx);
 
-			auto& queue = queues_[queue_index];
-			if(queue.cancel(id))
-			{
-				cancelled = true;
-				break;
-			}
-		}
+	//-----------------------------------------------------------------------------
+	//  Name : enqueue_task ()
+	/// <summary>
+	/// Puts a task in the queue of the thread with index idx. A worker pushing
+	/// to itself uses its local deque, everything else goes through the
+	/// target's lock-free injection queue.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void enqueue_task(task t, std::size_t idx);
 
-		return cancelled;
+	//-----------------------------------------------------------------------------
+	//  Name : schedule_awaited ()
+	/// <summary>
+	/// Called from task::task_concept::inputs_ready_ on the thread that
+	/// completed the last input of an awaiting task.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void schedule_awaited(task::task_concept* ptr) noexcept;
+
+	//-----------------------------------------------------------------------------
+	//  Name : cancel ()
+	/// <summary>
+	/// Marks a task as cancelled. Queued tasks cannot be removed from the lock
+	/// free queues so they are dropped when a thread pops them instead.
+	/// Returns false if the task has already started, it then runs to
+	/// completion.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	template <typename T>
+	bool cancel(const task_future<T>& f)
+	{
+		return f.state_->try_cancel();
 	}
+
 	//-----------------------------------------------------------------------------
 	//  Name : processing_wait ()
 	/// <summary>
@@ -679,93 +966,176 @@ private:
 	template <typename T>
 	bool processing_wait(const task_future<T>& t)
 	{
-		using namespace std::literals;
-		constexpr std::size_t invalid_index = 77777;
-
-		std::pair<bool, task> p = {false, task()};
+		const auto idx = get_current_thread_idx();
+		if(idx == invalid_index)
+		{
+			return false;
+		}
 
-		const auto this_thread_id = std::this_thread::get_id();
+		// the owner does not steal from the workers, it only helps with its own queue
+		const bool allow_steal = idx != get_owner_thread_idx();
 
-		std::size_t queue_index = invalid_index;
+		wake_node node(*this, idx);
+		bool registered = false;
 
-		for(std::size_t i = 0; i < threads_count_; ++i)
+		while(!t.is_ready())
 		{
-			if(get_thread_id(i) == this_thread_id)
+			task work;
+			if(try_pop_task(idx, allow_steal, work))
 			{
-				queue_index = get_thread_queue_idx(i, 0);
-				break;
+				execute(work);
+				continue;
 			}
+
+			// nothing to help with, sleep until the future or new work wakes us
+			if(!registered)
+			{
+				if(!t.state_->add_continuation(&node))
+				{
+					break;
+				}
+				registered = true;
+			}
+
+			park(idx, allow_steal);
 		}
 
-		if(queue_index == invalid_index)
+		if(registered)
 		{
-			return false;
+			// the completing thread may still be inside node.on_ready
+			node.wait_fired();
 		}
 
-		const auto condition = [&t]() { return !t.is_ready(); };
-
-		run(queue_index, condition, 5ms);
-
 		return true;
 	}
 
+	//-----------------------------------------------------------------------------
+	//  Name : wake_node ()
+	/// <summary>
+	/// Continuation used by processing_wait to unpark the waiting thread.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	struct wake_node : detail::continuation
+	{
+		wake_node(task_system& system, std::size_t idx)
+			: system_(system)
+			, idx_(idx)
+		{
+		}
+
+		void on_ready() noexcept override
+		{
+			system_.unpark(idx_);
+			fired_.store(true, std::memory_order_release);
+		}
+
+		void wait_fired() const noexcept
+		{
+			while(!fired_.load(std::memory_order_acquire))
+			{
+				std::this_thread::yield();
+			}
+		}
+
+	private:
+		task_system& system_;
+		std::size_t idx_ = 0;
+		std::atomic_bool fired_{false};
+	};
+
 	//-----------------------------------------------------------------------------
 	//  Name : run ()
 	/// <summary>
 	/// Main loop of our worker threads
 	/// </summary>
 	//-----------------------------------------------------------------------------
-	void run(std::size_t idx, const std::function<bool()>& condition,
-			 duration_t pop_timeout = duration_t::max());
+	void run(std::size_t idx);
 
 	//-----------------------------------------------------------------------------
-	//  Name : get_thread_queue_idx ()
+	//  Name : try_pop_task ()
 	/// <summary>
-	/// Gets the thread's queue index.
+	/// Looks for a runnable task for thread idx. Order is local deque (LIFO),
+	/// injection queue (FIFO), stealing from other workers (FIFO) and finally
+	/// the deferred tasks whose inputs were not ready when they were popped.
 	/// </summary>
 	//-----------------------------------------------------------------------------
-	std::size_t get_thread_queue_idx(std::size_t idx, std::size_t seed = 0);
+	bool try_pop_task(std::size_t idx, bool allow_steal, task& out);
 
 	//-----------------------------------------------------------------------------
-	//  Name : get_thread_id ()
+	//  Name : execute ()
 	/// <summary>
-	/// Gets the thread's id by thread index.
+	/// Executes a popped task.
 	/// </summary>
 	//-----------------------------------------------------------------------------
-	std::thread::id get_thread_id(std::size_t index);
+	void execute(task& t);
 
-	class task_queue
-	{
+	//-----------------------------------------------------------------------------
+	//  Name : get_current_thread_idx ()
+	/// <summary>
+	/// Gets the index of the calling thread or invalid_index if the calling
+	/// thread is not managed by this system.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::size_t get_current_thread_idx() const;
 
-	public:
-		task_queue() = default;
-		task_queue(task_queue const&) = delete;
-		task_queue(task_queue&& other) noexcept;
+	//-----------------------------------------------------------------------------
+	//  Name : park ()
+	/// <summary>
+	/// Puts an idle thread to sleep until someone pushes work for it or
+	/// unparks it explicitly.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void park(std::size_t idx, bool allow_steal);
 
-		std::size_t get_pending_tasks() const;
-		void set_done();
-		bool is_done() const;
-		std::pair<bool, task> try_pop();
-		bool try_push(task& t);
-		std::pair<bool, task> pop(duration_t pop_timeout = duration_t::max());
+	//-----------------------------------------------------------------------------
+	//  Name : unpark ()
+	/// <summary>
+	/// Wakes up the thread with index idx if it is parked, or makes its next
+	/// park return immediately.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void unpark(std::size_t idx) noexcept;
 
-		void push(task t);
-		void wake_up();
+	//-----------------------------------------------------------------------------
+	//  Name : wake_one ()
+	/// <summary>
+	/// Unparks one sleeping worker, if any, so that it can steal.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void wake_one(std::size_t skip_idx);
 
-		bool cancel(std::uint64_t id);
-		void clear();
+	bool has_pending_work(std::size_t idx, bool allow_steal) const;
 
-	private:
-		void sort();
-		std::deque<task> tasks_;
-		std::condition_variable cv_;
-		mutable std::mutex mutex_;
-		std::atomic_bool done_{false};
+	struct thread_queue
+	{
+		/// Injection queue. Any thread may push, only the queue's thread pops.
+		mpsc_queue<task::task_concept> inbox;
+		/// Local work stealing deque. Unused for the owner thread.
+		work_stealing_deque<task::task_concept*> deque;
+		/// Tasks popped before their inputs were ready. Queue's thread only.
+		std::vector<task> deferred;
+		/// Tasks currently assigned to this queue.
+		std::atomic<std::size_t> pending{0};
+		/// Set while the thread is parked.
+		std::atomic_bool sleeping{false};
+		std::mutex park_mutex;
+		std::condition_variable park_cv;
+		bool notified = false;
+		/// Rotates the steal victim so that thieves spread out.
+		std::size_t steal_seed = 0;
+		/// Executed tasks since deferred were last checked.
+		std::size_t since_deferred_check = 0;
 	};
 
-	std::vector<task_queue> queues_;
+	std::vector<std::unique_ptr<thread_queue>> queues_;
 	std::vector<std::thread> threads_;
 	std::size_t threads_count_;
+	std::atomic<std::size_t> sleeping_count_{0};
+	/// Tasks parked on their inputs.
+	std::atomic<std::size_t> awaiting_count_{0};
+	std::atomic_bool done_{false};
+	/// Set once the workers are joined. Late continuations just drop their task.
+	std::atomic_bool stopped_{false};
 	//
 	const std::thread::id owner_thread_id_ = std::this_thread::get_id();
 	bool wait_on_destruct_ = false;
@@ -786,7 +1156,7 @@ inline decltype(auto) task_future<T>::then_on_owner(F&& f)
 template <typename T>
 inline void task_future<T>::wait() const
 {
-	if(!future_.valid())
+	if(!valid())
 	{
 		return;
 	}
@@ -797,12 +1167,12 @@ inline void task_future<T>::wait() const
 		{
 			if(!executor_->processing_wait(*this))
 			{
-				future_.wait();
+				state_->wait();
 			}
 		}
 		else
 		{
-			future_.wait();
+			state_->wait();
 		}
 	}
 }
@@ -810,14 +1180,14 @@ inline void task_future<T>::wait() const
 template <typename T>
 inline void task_future<T>::cancel() const
 {
-	if(!future_.valid())
+	if(!valid())
 	{
 		return;
 	}
 
 	if(executor_)
 	{
-		bool cancelled = executor_->cancel(id_);
+		bool cancelled = executor_->cancel(*this);
 
 		if(!cancelled)
 		{
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+// Main Class Declarations
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//  Name : work_stealing_deque (Class)
+/// <summary>
+/// Chase-Lev dynamic circular work stealing deque as described in
+/// "Correct and Efficient Work-Stealing for Weak Memory Models" (Le et al.).
+/// Only the owning thread may call push and pop (LIFO end). Any thread may
+/// call steal (FIFO end). Elements must be trivially copyable since thieves
+/// read them speculatively before claiming them.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <typename T>
+class work_stealing_deque
+{
+	static_assert(std::is_trivially_copyable<T>::value, "work_stealing_deque requires trivially copyable T");
+
+	struct circular_array
+	{
+		explicit circular_array(std::int64_t capacity)
+			: capacity_(capacity)
+			, mask_(capacity - 1)
+			, buffer_(new std::atomic<T>[static_cast<std::size_t>(capacity)])
+		{
+		}
+
+		std::int64_t capacity() const noexcept
+		{
+			return capacity_;
+		}
+
+		void put(std::int64_t i, T x) noexcept
+		{
+			buffer_[static_cast<std::size_t>(i & mask_)].store(x, std::memory_order_relaxed);
+		}
+
+		T get(std::int64_t i) const noexcept
+		{
+			return buffer_[static_cast<std::size_t>(i & mask_)].load(std::memory_order_relaxed);
+		}
+
+		circular_array* grow(std::int64_t bottom, std::int64_t top) const
+		{
+			auto* arr = new circular_array(capacity_ * 2);
+			for(std::int64_t i = top; i != bottom; ++i)
+			{
+				arr->put(i, get(i));
+			}
+			return arr;
+		}
+
+	private:
+		std::int64_t capacity_ = 0;
+		std::int64_t mask_ = 0;
+		std::unique_ptr<std::atomic<T>[]> buffer_;
+	};
+
+public:
+	explicit work_stealing_deque(std::int64_t capacity = 1024)
+	{
+		// capacity must be a power of two for the index masking
+		std::int64_t cap = 1;
+		while(cap < capacity)
+		{
+			cap <<= 1;
+		}
+		auto* arr = new circular_array(cap);
+		garbage_.emplace_back(arr);
+		array_.store(arr, std::memory_order_relaxed);
+	}
+
+	work_stealing_deque(const work_stealing_deque&) = delete;
+	work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+	//-----------------------------------------------------------------------------
+	//  Name : push ()
+	/// <summary>
+	/// Pushes an element at the bottom. Owner thread only.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void push(T x)
+	{
+		const auto b = bottom_.load(std::memory_order_relaxed);
+		const auto t = top_.load(std::memory_order_acquire);
+		auto* arr = array_.load(std::memory_order_relaxed);
+
+		if(b - t > arr->capacity() - 1)
+		{
+			// old arrays are kept alive since a thief may still read from them
+			arr = arr->grow(b, t);
+			garbage_.emplace_back(arr);
+			array_.store(arr, std::memory_order_release);
+		}
+
+		arr->put(b, x);
+		bottom_.store(b + 1, std::memory_order_release);
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : pop ()
+	/// <summary>
+	/// Pops the most recently pushed element. Owner thread only.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool pop(T& out)
+	{
+		const auto b = bottom_.load(std::memory_order_relaxed) - 1;
+		auto* arr = array_.load(std::memory_order_relaxed);
+		bottom_.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		auto t = top_.load(std::memory_order_relaxed);
+
+		if(t > b)
+		{
+			// empty
+			bottom_.store(b + 1, std::memory_order_relaxed);
+			return false;
+		}
+
+		out = arr->get(b);
+		if(t == b)
+		{
+			// last element, race against thieves
+			const bool won =
+				top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+			bottom_.store(b + 1, std::memory_order_relaxed);
+			return won;
+		}
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : steal ()
+	/// <summary>
+	/// Steals the oldest element. Can be called from any thread.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool steal(T& out)
+	{
+		auto t = top_.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const auto b = bottom_.load(std::memory_order_acquire);
+
+		if(t >= b)
+		{
+			return false;
+		}
+
+		auto* arr = array_.load(std::memory_order_acquire);
+		out = arr->get(t);
+		return top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : size ()
+	/// <summary>
+	/// Approximate number of elements. Exact only when called by the owner
+	/// with no concurrent thieves.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::size_t size() const noexcept
+	{
+		const auto b = bottom_.load(std::memory_order_relaxed);
+		const auto t = top_.load(std::memory_order_relaxed);
+		return b > t ? static_cast<std::size_t>(b - t) : 0;
+	}
+
+	bool empty() const noexcept
+	{
+		return size() == 0;
+	}
+
+private:
+	alignas(64) std::atomic<std::int64_t> top_{0};
+	alignas(64) std::atomic<std::int64_t> bottom_{0};
+	alignas(64) std::atomic<circular_array*> array_{nullptr};
+	/// Owner-only list of every array ever allocated
+	std::vector<std::unique_ptr<circular_array>> garbage_;
+};
+} // namespace core
@@ -2,12 +2,45 @@
 #include <core/math/math_includes.h>
 
 #include <chrono>
+#include <cstdint>
 #include <string>
 #include <vector>
 
 namespace runtime
 {
 
+//-----------------------------------------------------------------------------
+//  Name : quantized_keys (Struct)
+/// <summary>
+/// Keys of one channel track packed to 16 bits per component by the asset
+/// compiler. Times are multiples of time_scale. Vectors are stored relative
+/// to the range of the track, quaternion components are mapped from [-1, 1].
+/// </summary>
+//-----------------------------------------------------------------------------
+struct quantized_keys
+{
+	/// Seconds per time step.
+	float time_scale = 0.0f;
+	/// Smallest value of the track, vector tracks only.
+	math::vec3 min = math::vec3(0.0f);
+	/// Value of one step per component, vector tracks only.
+	math::vec3 scale = math::vec3(0.0f);
+	/// Time of every key in steps.
+	std::vector<std::uint16_t> times;
+	/// Components of every key, three per vector key and four per rotation key.
+	std::vector<std::uint16_t> values;
+
+	bool empty() const
+	{
+		return times.empty();
+	}
+
+	std::size_t size() const
+	{
+		return times.size();
+	}
+};
+
 struct node_animation
 {
 	using seconds_t = std::chrono::duration<float>;
@@ -42,6 +75,12 @@ struct node_animation
 	/// If there are scaling keys, there will also be at least one
 	/// position and one rotation key.
 	std::vector<key<math::vec3>> scaling_keys;
+
+	/// Quantized tracks written by the asset compiler. A track is either
+	/// stored as float keys above or quantized here, never both.
+	quantized_keys quantized_position_keys;
+	quantized_keys quantized_rotation_keys;
+	quantized_keys quantized_scaling_keys;
 };
 
 struct animation
@@ -59,6 +98,4 @@ struct animation
 	std::vector<node_animation> channels;
 };
 
-// elapsed_time = math::modf(elapsed_time + dt , anim.duration);
-
 } // namespace runtime
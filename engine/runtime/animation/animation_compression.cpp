@@ -0,0 +1,204 @@
+#include "animation_compression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace runtime
+{
+namespace
+{
+constexpr float quantized_max = 65535.0f;
+
+float get_error(const math::vec3& a, const math::vec3& b)
+{
+	return math::length(a - b);
+}
+
+float get_error(const math::quat& a, const math::quat& b)
+{
+	const auto d = std::min(std::abs(math::dot(a, b)), 1.0f);
+	return 2.0f * std::acos(d);
+}
+
+math::vec3 interpolate(const math::vec3& a, const math::vec3& b, float t)
+{
+	return math::mix(a, b, t);
+}
+
+math::quat interpolate(const math::quat& a, const math::quat& b, float t)
+{
+	return math::slerp(a, b, t);
+}
+
+std::uint16_t to_quantized(float value)
+{
+	return std::uint16_t(std::min(std::max(std::round(value), 0.0f), quantized_max));
+}
+
+template <typename T>
+std::size_t reduce(std::vector<node_animation::key<T>>& keys, float tolerance)
+{
+	if(keys.size() < 2)
+	{
+		return 0;
+	}
+
+	std::vector<node_animation::key<T>> result;
+	result.reserve(keys.size());
+	result.emplace_back(keys.front());
+
+	// grow the span from the last kept key for as long as interpolating
+	// across it reproduces every key inside
+	std::size_t anchor = 0;
+	for(std::size_t i = 1; i + 1 < keys.size(); ++i)
+	{
+		const auto& a = keys[anchor];
+		const auto& b = keys[i + 1];
+		const auto span = b.time.count() - a.time.count();
+
+		bool fits = true;
+		for(auto j = anchor + 1; j <= i && fits; ++j)
+		{
+			const auto t = span > 0.0f ? (keys[j].time.count() - a.time.count()) / span : 0.0f;
+			fits = get_error(interpolate(a.value, b.value, t), keys[j].value) <= tolerance;
+		}
+
+		if(!fits)
+		{
+			result.emplace_back(keys[i]);
+			anchor = i;
+		}
+	}
+	result.emplace_back(keys.back());
+
+	// a constant track needs a single key
+	if(result.size() == 2 && get_error(result[0].value, result[1].value) <= tolerance)
+	{
+		result.pop_back();
+	}
+
+	const auto dropped = keys.size() - result.size();
+	keys = std::move(result);
+	return dropped;
+}
+
+template <typename T>
+void quantize_times(const std::vector<node_animation::key<T>>& keys, quantized_keys& quantized)
+{
+	float max_time = 0.0f;
+	for(const auto& key : keys)
+	{
+		max_time = std::max(max_time, key.time.count());
+	}
+
+	quantized.time_scale = max_time / quantized_max;
+	quantized.times.reserve(keys.size());
+	for(const auto& key : keys)
+	{
+		quantized.times.emplace_back(
+			quantized.time_scale > 0.0f ? to_quantized(key.time.count() / quantized.time_scale) : 0);
+	}
+}
+
+void quantize(std::vector<node_animation::key<math::vec3>>& keys, quantized_keys& quantized)
+{
+	quantized = {};
+	if(keys.empty())
+	{
+		return;
+	}
+
+	math::vec3 low(std::numeric_limits<float>::max());
+	math::vec3 high(std::numeric_limits<float>::lowest());
+	for(const auto& key : keys)
+	{
+		low = math::min(low, key.value);
+		high = math::max(high, key.value);
+	}
+
+	quantized.min = low;
+	quantized.scale = (high - low) / quantized_max;
+	quantize_times(keys, quantized);
+
+	quantized.values.reserve(keys.size() * 3);
+	for(const auto& key : keys)
+	{
+		for(int c = 0; c < 3; ++c)
+		{
+			const auto scale = quantized.scale[c];
+			quantized.values.emplace_back(scale > 0.0f ? to_quantized((key.value[c] - low[c]) / scale) : 0);
+		}
+	}
+
+	keys.clear();
+	keys.shrink_to_fit();
+}
+
+void quantize(std::vector<node_animation::key<math::quat>>& keys, quantized_keys& quantized)
+{
+	quantized = {};
+	if(keys.empty())
+	{
+		return;
+	}
+
+	quantize_times(keys, quantized);
+
+	quantized.values.reserve(keys.size() * 4);
+	for(const auto& key : keys)
+	{
+		const auto q = math::normalize(key.value);
+		for(auto c : {q.x, q.y, q.z, q.w})
+		{
+			quantized.values.emplace_back(to_quantized((c * 0.5f + 0.5f) * quantized_max));
+		}
+	}
+
+	keys.clear();
+	keys.shrink_to_fit();
+}
+}
+
+std::size_t reduce_keys(animation& anim, const animation_compression_settings& settings)
+{
+	std::size_t dropped = 0;
+	for(auto& channel : anim.channels)
+	{
+		dropped += reduce(channel.position_keys, settings.position_tolerance);
+		dropped += reduce(channel.rotation_keys, settings.rotation_tolerance);
+		dropped += reduce(channel.scaling_keys, settings.scaling_tolerance);
+	}
+	return dropped;
+}
+
+void quantize_keys(animation& anim)
+{
+	for(auto& channel : anim.channels)
+	{
+		// tracks that are already quantized have no float keys and stay as they are
+		if(!channel.position_keys.empty())
+		{
+			quantize(channel.position_keys, channel.quantized_position_keys);
+		}
+		if(!channel.rotation_keys.empty())
+		{
+			quantize(channel.rotation_keys, channel.quantized_rotation_keys);
+		}
+		if(!channel.scaling_keys.empty())
+		{
+			quantize(channel.scaling_keys, channel.quantized_scaling_keys);
+		}
+	}
+}
+
+void compress(animation& anim, const animation_compression_settings& settings)
+{
+	reduce_keys(anim, settings);
+	if(settings.quantize)
+	{
+		quantize_keys(anim);
+	}
+}
+
+} // namespace runtime
@@ -0,0 +1,45 @@
+#pragma once
+#include "animation.h"
+
+namespace runtime
+{
+
+struct animation_compression_settings
+{
+	/// Largest position error a dropped key may introduce, in units.
+	float position_tolerance = 0.0005f;
+	/// Largest rotation error a dropped key may introduce, in radians.
+	float rotation_tolerance = 0.0005f;
+	/// Largest scaling error a dropped key may introduce.
+	float scaling_tolerance = 0.0005f;
+	/// Store the remaining keys as quantized tracks.
+	bool quantize = true;
+};
+
+//-----------------------------------------------------------------------------
+//  Name : reduce_keys ()
+/// <summary>
+/// Drops the keys that the interpolation of their remaining neighbours
+/// reproduces within the tolerances. Every track keeps at least one key.
+/// Returns the number of dropped keys.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::size_t reduce_keys(animation& anim, const animation_compression_settings& settings);
+
+//-----------------------------------------------------------------------------
+//  Name : quantize_keys ()
+/// <summary>
+/// Moves the float keys of every track into its quantized form.
+/// </summary>
+//-----------------------------------------------------------------------------
+void quantize_keys(animation& anim);
+
+//-----------------------------------------------------------------------------
+//  Name : compress ()
+/// <summary>
+/// Reduces and optionally quantizes the keys as set up in the settings.
+/// </summary>
+//-----------------------------------------------------------------------------
+void compress(animation& anim, const animation_compression_settings& settings);
+
+} // namespace runtime
@@ -0,0 +1,194 @@
+#include "animation_player.h"
+#include "../rendering/mesh/skeleton.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace runtime
+{
+
+std::size_t animation_player::add_layer(const asset_handle<animation>& clip, float weight)
+{
+	layer l;
+	l.clip = clip;
+	l.weight = weight;
+	layers_.emplace_back(l);
+	bindings_.emplace_back();
+	return layers_.size() - 1;
+}
+
+void animation_player::remove_layer(std::size_t index)
+{
+	if(index >= layers_.size())
+	{
+		return;
+	}
+
+	layers_.erase(layers_.begin() + std::ptrdiff_t(index));
+	bindings_.erase(bindings_.begin() + std::ptrdiff_t(index));
+}
+
+void animation_player::clear()
+{
+	layers_.clear();
+	bindings_.clear();
+}
+
+animation_player::layer& animation_player::get_layer(std::size_t index)
+{
+	return layers_[index];
+}
+
+const animation_player::layer& animation_player::get_layer(std::size_t index) const
+{
+	return layers_[index];
+}
+
+std::size_t animation_player::get_layer_count() const
+{
+	return layers_.size();
+}
+
+void animation_player::update(seconds_t dt)
+{
+	for(auto& l : layers_)
+	{
+		const auto clip = l.clip.get();
+		if(clip == nullptr)
+		{
+			continue;
+		}
+
+		const auto duration = clip->duration.count();
+		auto time = l.time.count() + dt.count() * l.speed;
+		if(duration <= 0.0f)
+		{
+			time = 0.0f;
+		}
+		else if(l.loop)
+		{
+			time = std::fmod(time, duration);
+			if(time < 0.0f)
+			{
+				time += duration;
+			}
+		}
+		else
+		{
+			time = std::min(std::max(time, 0.0f), duration);
+		}
+
+		l.time = seconds_t(time);
+	}
+}
+
+void animation_player::bind(binding& b, const animation& clip, const skeleton& skel)
+{
+	b.clip = &clip;
+	b.skel = &skel;
+	b.node_count = skel.get_node_count();
+
+	b.channel_nodes.clear();
+	b.channel_nodes.reserve(clip.channels.size());
+	for(const auto& channel : clip.channels)
+	{
+		b.channel_nodes.emplace_back(skel.find_node(channel.node_name));
+	}
+	b.cursors.assign(clip.channels.size(), channel_cursor{});
+}
+
+void animation_player::evaluate(const skeleton& skel, skeleton_pose& pose)
+{
+	const auto node_count = skel.get_node_count();
+	auto& local = pose.get_local_transforms();
+	if(local.size() != node_count)
+	{
+		return;
+	}
+
+	const bool any_active = std::any_of(std::begin(layers_), std::end(layers_), [](const layer& l) {
+		return l.clip && l.weight > 0.0f;
+	});
+	if(!any_active)
+	{
+		return;
+	}
+
+	positions_.assign(node_count, math::vec3(0.0f));
+	rotations_.assign(node_count, math::quat(0.0f, 0.0f, 0.0f, 0.0f));
+	scalings_.assign(node_count, math::vec3(0.0f));
+	weights_.assign(node_count, 0.0f);
+
+	const auto accumulate = [this](std::size_t node, float weight, const math::vec3& position,
+								   math::quat rotation, const math::vec3& scaling) {
+		// keep the rotations in one hemisphere so they don't cancel out
+		if(math::dot(rotations_[node], rotation) < 0.0f)
+		{
+			rotation = -rotation;
+		}
+		positions_[node] += position * weight;
+		rotations_[node] += rotation * weight;
+		scalings_[node] += scaling * weight;
+		weights_[node] += weight;
+	};
+
+	const auto& rest = skel.get_bind_pose();
+	for(std::size_t i = 0; i < layers_.size(); ++i)
+	{
+		const auto& l = layers_[i];
+		const auto clip = l.clip.get();
+		if(clip == nullptr || l.weight <= 0.0f)
+		{
+			continue;
+		}
+
+		auto& b = bindings_[i];
+		if(b.clip != clip || b.skel != &skel || b.node_count != node_count ||
+		   b.channel_nodes.size() != clip->channels.size())
+		{
+			bind(b, *clip, skel);
+		}
+
+		const auto time = l.time.count();
+		for(std::size_t c = 0; c < clip->channels.size(); ++c)
+		{
+			const auto node = b.channel_nodes[c];
+			if(node == skeleton::invalid_index)
+			{
+				continue;
+			}
+
+			const auto& node_rest = rest[std::size_t(node)];
+			auto position = node_rest.get_position();
+			auto rotation = node_rest.get_rotation();
+			auto scaling = node_rest.get_scale();
+			sample_channel(clip->channels[c], time, b.cursors[c], position, rotation, scaling);
+			accumulate(std::size_t(node), l.weight, position, rotation, scaling);
+		}
+	}
+
+	for(std::size_t node = 0; node < node_count; ++node)
+	{
+		const auto& node_rest = rest[node];
+		auto weight = weights_[node];
+		if(weight <= 0.0f)
+		{
+			local[node] = node_rest;
+			continue;
+		}
+
+		if(weight < 1.0f)
+		{
+			accumulate(node, 1.0f - weight, node_rest.get_position(), node_rest.get_rotation(),
+					   node_rest.get_scale());
+			weight = 1.0f;
+		}
+
+		auto& transform = local[node];
+		transform.set_position(positions_[node] / weight);
+		transform.set_rotation(math::normalize(rotations_[node]));
+		transform.set_scale(scalings_[node] / weight);
+	}
+}
+
+} // namespace runtime
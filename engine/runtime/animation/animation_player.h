@@ -0,0 +1,133 @@
+#pragma once
+#include "animation.h"
+#include "animation_sampler.h"
+
+#include "../assets/asset_handle.h"
+
+#include <cstdint>
+#include <vector>
+
+class skeleton;
+class skeleton_pose;
+
+namespace runtime
+{
+
+//-----------------------------------------------------------------------------
+// Main Class Declarations
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//  Name : animation_player (Class)
+/// <summary>
+/// Plays a stack of weighted animation layers on a skeleton. Every layer
+/// keeps its channels bound to the skeleton nodes and a key cursor per
+/// channel, so evaluating a frame is a linear walk over the channels.
+/// Layers are blended by weight, nodes with less than full weight are
+/// completed with their rest pose.
+/// </summary>
+//-----------------------------------------------------------------------------
+class animation_player
+{
+public:
+	using seconds_t = animation::seconds_t;
+
+	struct layer
+	{
+		/// Clip played by the layer.
+		asset_handle<animation> clip;
+		/// Playback position.
+		seconds_t time = seconds_t(0);
+		/// Multiplier of the time step.
+		float speed = 1.0f;
+		/// Blend weight relative to the other layers.
+		float weight = 1.0f;
+		/// Wrap around at the end of the clip instead of holding the last frame.
+		bool loop = true;
+	};
+
+	//-----------------------------------------------------------------------------
+	//  Name : add_layer ()
+	/// <summary>
+	/// Adds a layer playing the clip and returns its index.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::size_t add_layer(const asset_handle<animation>& clip, float weight = 1.0f);
+
+	//-----------------------------------------------------------------------------
+	//  Name : remove_layer ()
+	/// <summary>
+	/// Removes the layer, the following layers move down by one.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void remove_layer(std::size_t index);
+
+	//-----------------------------------------------------------------------------
+	//  Name : clear ()
+	/// <summary>
+	/// Removes all layers.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void clear();
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_layer ()
+	/// <summary>
+	/// Access to a layer, to change its clip, time or weight.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	layer& get_layer(std::size_t index);
+	const layer& get_layer(std::size_t index) const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_layer_count ()
+	/// <summary>
+	/// Number of layers.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::size_t get_layer_count() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : update ()
+	/// <summary>
+	/// Advances the time of every layer with a loaded clip.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void update(seconds_t dt);
+
+	//-----------------------------------------------------------------------------
+	//  Name : evaluate ()
+	/// <summary>
+	/// Samples and blends the layers into the local transforms of the pose.
+	/// The pose is left untouched while no layer has a loaded clip and a
+	/// positive weight.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void evaluate(const skeleton& skel, skeleton_pose& pose);
+
+private:
+	struct binding
+	{
+		/// Clip and skeleton the channels were bound for.
+		const animation* clip = nullptr;
+		const skeleton* skel = nullptr;
+		std::size_t node_count = 0;
+		/// Skeleton node of every channel, invalid when it has none.
+		std::vector<std::int32_t> channel_nodes;
+		/// Key cursor of every channel.
+		std::vector<channel_cursor> cursors;
+	};
+
+	void bind(binding& b, const animation& clip, const skeleton& skel);
+
+	std::vector<layer> layers_;
+	/// Binding of every layer, kept in step with layers_.
+	std::vector<binding> bindings_;
+
+	/// Blend accumulators per skeleton node, reused between frames.
+	std::vector<math::vec3> positions_;
+	std::vector<math::quat> rotations_;
+	std::vector<math::vec3> scalings_;
+	std::vector<float> weights_;
+};
+
+} // namespace runtime
@@ -0,0 +1,239 @@
+#include "animation_sampler.h"
+
+#include <algorithm>
+
+namespace runtime
+{
+namespace
+{
+/// Steps taken from the cursor before falling back to a binary search.
+constexpr std::uint32_t max_linear_steps = 4;
+
+struct vec3_track
+{
+	const std::vector<node_animation::key<math::vec3>>& keys;
+
+	std::size_t size() const
+	{
+		return keys.size();
+	}
+	float time(std::size_t i) const
+	{
+		return keys[i].time.count();
+	}
+	math::vec3 value(std::size_t i) const
+	{
+		return keys[i].value;
+	}
+	static math::vec3 interpolate(const math::vec3& a, const math::vec3& b, float t)
+	{
+		return math::mix(a, b, t);
+	}
+};
+
+struct quat_track
+{
+	const std::vector<node_animation::key<math::quat>>& keys;
+
+	std::size_t size() const
+	{
+		return keys.size();
+	}
+	float time(std::size_t i) const
+	{
+		return keys[i].time.count();
+	}
+	math::quat value(std::size_t i) const
+	{
+		return keys[i].value;
+	}
+	static math::quat interpolate(const math::quat& a, const math::quat& b, float t)
+	{
+		return math::slerp(a, b, t);
+	}
+};
+
+struct quantized_vec3_track
+{
+	const quantized_keys& keys;
+
+	std::size_t size() const
+	{
+		return keys.size();
+	}
+	float time(std::size_t i) const
+	{
+		return float(keys.times[i]) * keys.time_scale;
+	}
+	math::vec3 value(std::size_t i) const
+	{
+		const auto* v = &keys.values[i * 3];
+		return keys.min + keys.scale * math::vec3(float(v[0]), float(v[1]), float(v[2]));
+	}
+	static math::vec3 interpolate(const math::vec3& a, const math::vec3& b, float t)
+	{
+		return math::mix(a, b, t);
+	}
+};
+
+struct quantized_quat_track
+{
+	const quantized_keys& keys;
+
+	std::size_t size() const
+	{
+		return keys.size();
+	}
+	float time(std::size_t i) const
+	{
+		return float(keys.times[i]) * keys.time_scale;
+	}
+	math::quat value(std::size_t i) const
+	{
+		const auto* v = &keys.values[i * 4];
+		const auto decode = [](std::uint16_t c) { return float(c) / 65535.0f * 2.0f - 1.0f; };
+		return math::normalize(math::quat(decode(v[3]), decode(v[0]), decode(v[1]), decode(v[2])));
+	}
+	static math::quat interpolate(const math::quat& a, const math::quat& b, float t)
+	{
+		return math::slerp(a, b, t);
+	}
+};
+
+//-----------------------------------------------------------------------------
+//  Name : seek ()
+/// <summary>
+/// Index of the last key at or before the time. Regular playback is handled
+/// by a few steps from the cursor, jumps by a binary search.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <typename Track>
+std::uint32_t seek(const Track& track, float time, std::uint32_t cursor)
+{
+	const auto count = std::uint32_t(track.size());
+	if(cursor >= count || track.time(cursor) > time)
+	{
+		// went backwards, usually a looping clip starting over
+		cursor = 0;
+	}
+
+	for(std::uint32_t step = 0; step < max_linear_steps; ++step)
+	{
+		if(cursor + 1 >= count || track.time(cursor + 1) > time)
+		{
+			return cursor;
+		}
+		++cursor;
+	}
+
+	// time(low) <= time < time(high)
+	auto low = cursor;
+	auto high = count;
+	while(high - low > 1)
+	{
+		const auto mid = low + (high - low) / 2;
+		if(track.time(mid) <= time)
+		{
+			low = mid;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+	return low;
+}
+
+template <typename Track, typename T>
+void sample(const Track& track, float time, std::uint32_t& cursor, T& value)
+{
+	if(track.size() == 0)
+	{
+		return;
+	}
+
+	cursor = seek(track, time, cursor);
+	const auto next = cursor + 1;
+	if(next >= track.size())
+	{
+		value = track.value(cursor);
+		return;
+	}
+
+	const auto t0 = track.time(cursor);
+	const auto t1 = track.time(next);
+	if(time <= t0 || t1 <= t0)
+	{
+		value = track.value(cursor);
+		return;
+	}
+
+	const auto t = std::min((time - t0) / (t1 - t0), 1.0f);
+	value = Track::interpolate(track.value(cursor), track.value(next), t);
+}
+
+std::size_t get_memory(const quantized_keys& keys)
+{
+	return (keys.times.size() + keys.values.size()) * sizeof(std::uint16_t);
+}
+}
+
+void sample_channel(const node_animation& channel, float time, channel_cursor& cursor,
+					math::vec3& position, math::quat& rotation, math::vec3& scaling)
+{
+	if(!channel.position_keys.empty())
+	{
+		sample(vec3_track{channel.position_keys}, time, cursor.position, position);
+	}
+	else
+	{
+		sample(quantized_vec3_track{channel.quantized_position_keys}, time, cursor.position, position);
+	}
+
+	if(!channel.rotation_keys.empty())
+	{
+		sample(quat_track{channel.rotation_keys}, time, cursor.rotation, rotation);
+	}
+	else
+	{
+		sample(quantized_quat_track{channel.quantized_rotation_keys}, time, cursor.rotation, rotation);
+	}
+
+	if(!channel.scaling_keys.empty())
+	{
+		sample(vec3_track{channel.scaling_keys}, time, cursor.scaling, scaling);
+	}
+	else
+	{
+		sample(quantized_vec3_track{channel.quantized_scaling_keys}, time, cursor.scaling, scaling);
+	}
+}
+
+std::size_t get_key_count(const animation& anim)
+{
+	std::size_t count = 0;
+	for(const auto& channel : anim.channels)
+	{
+		count += channel.position_keys.size() + channel.rotation_keys.size() + channel.scaling_keys.size();
+		count += channel.quantized_position_keys.size() + channel.quantized_rotation_keys.size() +
+				 channel.quantized_scaling_keys.size();
+	}
+	return count;
+}
+
+std::size_t get_key_memory(const animation& anim)
+{
+	std::size_t bytes = 0;
+	for(const auto& channel : anim.channels)
+	{
+		bytes += channel.position_keys.size() * sizeof(node_animation::key<math::vec3>);
+		bytes += channel.rotation_keys.size() * sizeof(node_animation::key<math::quat>);
+		bytes += channel.scaling_keys.size() * sizeof(node_animation::key<math::vec3>);
+		bytes += get_memory(channel.quantized_position_keys);
+		bytes += get_memory(channel.quantized_rotation_keys);
+		bytes += get_memory(channel.quantized_scaling_keys);
+	}
+	return bytes;
+}
+
+} // namespace runtime
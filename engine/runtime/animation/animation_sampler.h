@@ -0,0 +1,51 @@
+#pragma once
+#include "animation.h"
+
+#include <cstdint>
+
+namespace runtime
+{
+
+//-----------------------------------------------------------------------------
+//  Name : channel_cursor (Struct)
+/// <summary>
+/// Last key used for every track of a channel. Playback mostly moves
+/// forward by less than a key per frame, so the next search starts here
+/// instead of at the beginning of the track.
+/// </summary>
+//-----------------------------------------------------------------------------
+struct channel_cursor
+{
+	std::uint32_t position = 0;
+	std::uint32_t rotation = 0;
+	std::uint32_t scaling = 0;
+};
+
+//-----------------------------------------------------------------------------
+//  Name : sample_channel ()
+/// <summary>
+/// Samples the channel at the time, float or quantized tracks alike. Values
+/// of tracks without keys are left as they are, so the caller can preset
+/// them with the rest pose of the node.
+/// </summary>
+//-----------------------------------------------------------------------------
+void sample_channel(const node_animation& channel, float time, channel_cursor& cursor,
+					math::vec3& position, math::quat& rotation, math::vec3& scaling);
+
+//-----------------------------------------------------------------------------
+//  Name : get_key_count ()
+/// <summary>
+/// Number of keys of all tracks of the animation.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::size_t get_key_count(const animation& anim);
+
+//-----------------------------------------------------------------------------
+//  Name : get_key_memory ()
+/// <summary>
+/// Bytes taken by the keys of the animation.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::size_t get_key_memory(const animation& anim);
+
+} // namespace runtime
@@ -1,5 +1,9 @@
 #include "asset_manager.h"
 
+#include <core/logging/logging.h>
+
+#include <algorithm>
+
 namespace runtime
 {
 asset_manager::asset_manager()
@@ -27,4 +31,42 @@ void asset_manager::clear(const std::string& group)
 		storage->clear(group);
 	}
 }
+
+bool asset_manager::mount_pack(const fs::path& pack_path)
+{
+	auto pack = std::make_shared<asset_pack>();
+	std::string err;
+	if(!pack->open(pack_path, err))
+	{
+		APPLOG_ERROR("Failed mounting pack : {0}", err);
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(packs_mutex_);
+	packs_.emplace_back(std::move(pack));
+	return true;
+}
+
+void asset_manager::unmount_pack(const fs::path& pack_path)
+{
+	std::lock_guard<std::mutex> lock(packs_mutex_);
+	packs_.erase(std::remove_if(std::begin(packs_), std::end(packs_),
+								[&pack_path](const auto& pack) { return pack->get_path() == pack_path; }),
+				 std::end(packs_));
+}
+
+asset_manager::packed_asset asset_manager::find_packed(const std::string& compiled_key) const
+{
+	std::lock_guard<std::mutex> lock(packs_mutex_);
+	packed_asset result;
+	for(auto it = packs_.rbegin(); it != packs_.rend(); ++it)
+	{
+		if((*it)->find(compiled_key, result.data))
+		{
+			result.pack = *it;
+			break;
+		}
+	}
+	return result;
+}
 }
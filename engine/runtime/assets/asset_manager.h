@@ -1,18 +1,36 @@
 #pragma once
 
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 
 #include "asset_flags.h"
+#include "asset_pack.h"
 #include "asset_storage.h"
 #include <cassert>
 
+#include <core/signals/event.hpp>
+
 namespace runtime
 {
 
 class asset_manager
 {
 public:
+	struct packed_asset
+	{
+		/// Keeps the data mapped for as long as it is referenced.
+		std::shared_ptr<const asset_pack> pack;
+		fs::byte_span data;
+
+		explicit operator bool() const
+		{
+			return pack != nullptr;
+		}
+	};
+
 	asset_manager();
 	~asset_manager();
 	//-----------------------------------------------------------------------------
@@ -52,6 +70,8 @@ public:
 	template <typename T>
 	core::task_future<asset_handle<T>> load(const std::string& key, load_flags flags = load_flags::standard)
 	{
+		on_load_request.emit(key);
+
 		auto& storage = get_storage<T>();
 		return load_asset_from_file_impl<T>(key, flags, storage.container_mutex, storage.container,
 											storage.load_from_file);
@@ -127,6 +147,38 @@ public:
 		}
 	}
 
+	//-----------------------------------------------------------------------------
+	//  Name : mount_pack ()
+	/// <summary>
+	/// Opens a pack whose assets are looked up ahead of the loose compiled
+	/// files. Packs mounted later are looked up first, so a patch pack can
+	/// override the assets of the packs before it.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool mount_pack(const fs::path& pack_path);
+
+	//-----------------------------------------------------------------------------
+	//  Name : unmount_pack ()
+	/// <summary>
+	/// Stops looking up assets in the pack. Assets already loaded from it keep
+	/// it mapped until they are released.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void unmount_pack(const fs::path& pack_path);
+
+	//-----------------------------------------------------------------------------
+	//  Name : find_packed ()
+	/// <summary>
+	/// Finds a compiled asset like "app:/cache/textures/wall.png.asset" in the
+	/// mounted packs.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	packed_asset find_packed(const std::string& compiled_key) const;
+
+	/// Emitted with the key of every load request, from the requesting thread.
+	/// Connect at startup only, emitting doesn't lock the slots.
+	event<void(const std::string&)> on_load_request;
+
 private:
 	//-----------------------------------------------------------------------------
 	//  Name : load_asset_from_file_impl ()
@@ -264,5 +316,9 @@ private:
 	}
 	/// Different storages
 	std::unordered_map<std::size_t, std::unique_ptr<basic_storage>> storages_;
+	/// Mounted packs, in mount order
+	std::vector<std::shared_ptr<const asset_pack>> packs_;
+	/// Loads look up the packs from the worker threads
+	mutable std::mutex packs_mutex_;
 };
 }
@@ -0,0 +1,266 @@
+#include "asset_pack.h"
+
+#include <core/common/hash.hpp>
+#include <core/filesystem/filesystem.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+
+namespace runtime
+{
+namespace
+{
+constexpr std::array<char, 4> magic = {{'E', 'P', 'A', 'K'}};
+/// magic, version, entry count, reserved, data offset
+constexpr std::size_t header_size = 4 + 4 + 4 + 4 + 8;
+/// offset, size, hash, key size, followed by the key
+constexpr std::size_t index_entry_size = 8 + 8 + 8 + 4;
+/// every blob starts aligned for whoever reads it in place
+constexpr std::uint64_t data_alignment = 16;
+
+std::uint64_t align(std::uint64_t value)
+{
+	return (value + data_alignment - 1) & ~(data_alignment - 1);
+}
+
+// reads the values in the host byte order they were written in
+class index_reader
+{
+public:
+	explicit index_reader(const fs::byte_span& span)
+		: span_(span)
+	{
+	}
+
+	template <typename T>
+	bool read(T& value)
+	{
+		if(span_.size - pos_ < sizeof(T))
+		{
+			return false;
+		}
+		std::memcpy(&value, span_.data + pos_, sizeof(T));
+		pos_ += sizeof(T);
+		return true;
+	}
+
+	bool read(std::string& value, std::size_t size)
+	{
+		if(span_.size - pos_ < size)
+		{
+			return false;
+		}
+		value.assign(reinterpret_cast<const char*>(span_.data + pos_), size);
+		pos_ += size;
+		return true;
+	}
+
+private:
+	fs::byte_span span_;
+	std::size_t pos_ = 0;
+};
+
+template <typename T>
+void write_value(std::ostream& stream, const T& value)
+{
+	stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+}
+
+bool asset_pack::open(const fs::path& pack_path, std::string& err)
+{
+	entries_.clear();
+	path_ = pack_path;
+
+	fs::error_code ec;
+	if(!file_.open(pack_path, ec))
+	{
+		err = "Cant map " + pack_path.string() + " : " + ec.message();
+		return false;
+	}
+
+	const auto span = file_.get_span();
+	index_reader reader(span);
+
+	std::array<char, 4> file_magic;
+	std::uint32_t file_version = 0;
+	std::uint32_t count = 0;
+	std::uint32_t reserved = 0;
+	std::uint64_t data_offset = 0;
+	if(!reader.read(file_magic) || file_magic != magic)
+	{
+		err = pack_path.string() + " is not an asset pack";
+		file_.close();
+		return false;
+	}
+	if(!reader.read(file_version) || file_version != version)
+	{
+		err = pack_path.string() + " has an unsupported version";
+		file_.close();
+		return false;
+	}
+	if(!reader.read(count) || !reader.read(reserved) || !reader.read(data_offset))
+	{
+		err = pack_path.string() + " has a truncated header";
+		file_.close();
+		return false;
+	}
+
+	entries_.reserve(count);
+	for(std::uint32_t i = 0; i < count; ++i)
+	{
+		entry e;
+		std::uint32_t key_size = 0;
+		std::string key;
+		if(!reader.read(e.offset) || !reader.read(e.size) || !reader.read(e.hash) ||
+		   !reader.read(key_size) || !reader.read(key, key_size))
+		{
+			err = pack_path.string() + " has a truncated index";
+			entries_.clear();
+			file_.close();
+			return false;
+		}
+
+		if(e.offset < data_offset || e.offset > span.size || e.size > span.size - e.offset)
+		{
+			err = pack_path.string() + " has an entry out of bounds : " + key;
+			entries_.clear();
+			file_.close();
+			return false;
+		}
+		entries_[key] = e;
+	}
+
+	return true;
+}
+
+bool asset_pack::find(const std::string& key, fs::byte_span& data) const
+{
+	auto it = entries_.find(key);
+	if(it == entries_.end())
+	{
+		return false;
+	}
+
+	const auto& e = it->second;
+	data.data = file_.get_span().data + e.offset;
+	data.size = std::size_t(e.size);
+	return true;
+}
+
+bool asset_pack::verify(const std::string& key) const
+{
+	fs::byte_span data;
+	if(!find(key, data))
+	{
+		return false;
+	}
+	return utils::fnv1a(data.data, data.size) == entries_.at(key).hash;
+}
+
+bool asset_pack::write(const fs::path& pack_path, const sources_t& sources, std::string& err)
+{
+	std::ofstream stream(pack_path.string(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if(!stream.good())
+	{
+		err = "Cant write " + pack_path.string();
+		return false;
+	}
+
+	std::uint64_t index_size = 0;
+	for(const auto& source : sources)
+	{
+		index_size += index_entry_size + source.first.size();
+	}
+	const auto data_offset = align(header_size + index_size);
+
+	// the data goes first, the index is filled in once the hashes are known
+	std::vector<entry> entries;
+	entries.reserve(sources.size());
+	std::array<char, 64 * 1024> buffer;
+	auto offset = data_offset;
+	stream.seekp(std::streamoff(offset));
+	for(const auto& source : sources)
+	{
+		std::ifstream input(source.second.string(), std::ios::in | std::ios::binary);
+		if(!input.good())
+		{
+			err = "Cant read " + source.second.string();
+			stream.close();
+			fs::error_code ec;
+			fs::remove(pack_path, ec);
+			return false;
+		}
+
+		entry e;
+		e.offset = offset;
+		e.hash = utils::fnv1a_offset;
+		while(input.read(buffer.data(), std::streamsize(buffer.size())) || input.gcount() > 0)
+		{
+			const auto count = std::size_t(input.gcount());
+			e.hash = utils::fnv1a(buffer.data(), count, e.hash);
+			e.size += count;
+			stream.write(buffer.data(), std::streamsize(count));
+		}
+		entries.emplace_back(e);
+
+		const auto next = align(offset + e.size);
+		for(auto i = offset + e.size; i < next; ++i)
+		{
+			stream.put(0);
+		}
+		offset = next;
+	}
+
+	stream.seekp(0);
+	stream.write(magic.data(), std::streamsize(magic.size()));
+	write_value(stream, version);
+	write_value(stream, std::uint32_t(sources.size()));
+	write_value(stream, std::uint32_t(0));
+	write_value(stream, data_offset);
+	for(std::size_t i = 0; i < sources.size(); ++i)
+	{
+		const auto& key = sources[i].first;
+		write_value(stream, entries[i].offset);
+		write_value(stream, entries[i].size);
+		write_value(stream, entries[i].hash);
+		write_value(stream, std::uint32_t(key.size()));
+		stream.write(key.data(), std::streamsize(key.size()));
+	}
+
+	if(!stream.good())
+	{
+		err = "Cant write " + pack_path.string();
+		stream.close();
+		fs::error_code ec;
+		fs::remove(pack_path, ec);
+		return false;
+	}
+	return true;
+}
+
+bool asset_pack::write_directory(const fs::path& pack_path, const fs::path& dir, std::string& err)
+{
+	sources_t sources;
+	fs::error_code ec;
+	for(fs::recursive_directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec))
+	{
+		const auto& p = it->path();
+		if(it->is_regular_file(ec) && p.extension() == ".asset")
+		{
+			sources.emplace_back(fs::convert_to_protocol(p).generic_string(), p);
+		}
+	}
+	if(ec)
+	{
+		err = "Cant list " + dir.string() + " : " + ec.message();
+		return false;
+	}
+
+	// a stable order keeps rebuilt packs identical
+	std::sort(std::begin(sources), std::end(sources));
+	return write(pack_path, sources, err);
+}
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <core/filesystem/mapped_file.h>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace runtime
+{
+//-----------------------------------------------------------------------------
+// Main Class Declarations
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//  Name : asset_pack (Class)
+/// <summary>
+/// Many compiled assets in a single file. The file starts with an index of
+/// the keys with the offset, size and content hash of their data. Opening a
+/// pack maps the file once and lookups return spans straight into the
+/// mapping, so nothing is read or copied until the data is used.
+/// </summary>
+//-----------------------------------------------------------------------------
+class asset_pack
+{
+public:
+	/// Bump whenever the layout changes, older packs fail to open.
+	static constexpr std::uint32_t version = 1;
+
+	struct entry
+	{
+		/// Position of the data from the start of the file.
+		std::uint64_t offset = 0;
+		std::uint64_t size = 0;
+		/// fnv-1a of the data.
+		std::uint64_t hash = 0;
+	};
+
+	using entries_t = std::unordered_map<std::string, entry>;
+	/// Key and the file holding its data.
+	using sources_t = std::vector<std::pair<std::string, fs::path>>;
+
+	//-----------------------------------------------------------------------------
+	//  Name : open ()
+	/// <summary>
+	/// Maps the pack and reads its index.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool open(const fs::path& pack_path, std::string& err);
+
+	//-----------------------------------------------------------------------------
+	//  Name : find ()
+	/// <summary>
+	/// Finds the data of the key. The span stays valid while the pack is open.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool find(const std::string& key, fs::byte_span& data) const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : verify ()
+	/// <summary>
+	/// Checks the data of the key against its content hash.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool verify(const std::string& key) const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_entries ()
+	/// <summary>
+	/// The index of the pack.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	const entries_t& get_entries() const
+	{
+		return entries_;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_path ()
+	/// <summary>
+	/// Where the pack was opened from.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	const fs::path& get_path() const
+	{
+		return path_;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : write ()
+	/// <summary>
+	/// Writes a pack with the contents of the source files under their keys.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	static bool write(const fs::path& pack_path, const sources_t& sources, std::string& err);
+
+	//-----------------------------------------------------------------------------
+	//  Name : write_directory ()
+	/// <summary>
+	/// Writes a pack with every compiled asset under the directory, keyed by
+	/// their protocol path like "app:/cache/textures/wall.png.asset", which is
+	/// what the asset reader looks up.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	static bool write_directory(const fs::path& pack_path, const fs::path& dir, std::string& err);
+
+private:
+	/// Where the pack was opened from.
+	fs::path path_;
+	/// The mapped pack.
+	fs::mapped_file file_;
+	/// The index of the pack.
+	entries_t entries_;
+};
+}
@@ -22,11 +22,48 @@
 #include <core/serialization/types/vector.hpp>
 
 #include <cstdint>
+#include <istream>
 
 namespace runtime
 {
 namespace asset_reader
 {
+namespace
+{
+void release_pack(void*, void* user_data)
+{
+	delete static_cast<std::shared_ptr<const asset_pack>*>(user_data);
+}
+
+// references the data in the mapped pack instead of copying it, the pack
+// stays mapped until the renderer is done with the memory
+const gfx::memory_view* make_ref(const asset_manager::packed_asset& packed)
+{
+	return gfx::make_ref(packed.data.data, static_cast<std::uint32_t>(packed.data.size), release_pack,
+						 new std::shared_ptr<const asset_pack>(packed.pack));
+}
+
+template <typename F>
+bool read_compiled(const asset_manager::packed_asset& packed, const std::string& compiled_absolute_key,
+				   F&& read_func)
+{
+	if(packed)
+	{
+		fs::span_streambuf buffer(packed.data);
+		std::istream stream(&buffer);
+		read_func(stream);
+		return true;
+	}
+
+	std::ifstream stream{compiled_absolute_key, std::ios::in | std::ios::binary};
+	if(stream.bad())
+	{
+		return false;
+	}
+	read_func(stream);
+	return true;
+}
+}
 
 template <>
 bool load_from_file<gfx::texture>(core::task_future<asset_handle<gfx::texture>>& output,
@@ -39,6 +76,7 @@ bool load_from_file<gfx::texture>(core::task_future<asset_handle<gfx::texture>>&
 	}
 
 	auto& ts = core::get_subsystem<core::task_system>();
+	auto& am = core::get_subsystem<asset_manager>();
 
 	auto create_resource_func_fallback = [ result = original, key ]() mutable
 	{
@@ -56,15 +94,29 @@ bool load_from_file<gfx::texture>(core::task_future<asset_handle<gfx::texture>>&
 	auto cache_key = fs::replace(key, ":/data", ":/cache");
 	fs::path absolute_key = fs::absolute(fs::resolve_protocol(cache_key).string());
 	auto compiled_absolute_key = absolute_key.string() + ".asset";
+	auto packed = am.find_packed(cache_key.generic_string() + ".asset");
 
 	fs::error_code err;
-	if(!fs::exists(compiled_absolute_key, err))
+	if(!packed && !fs::exists(compiled_absolute_key, err))
 	{
 		APPLOG_ERROR("Asset with key {0} and absolute_path {1} does not exist!", key, compiled_absolute_key);
 		output = ts.push_or_execute_on_worker_thread(create_resource_func_fallback);
 		return true;
 	}
 
+	if(packed)
+	{
+		auto create_resource_from_pack_func = [ result = original, packed, key ]() mutable
+		{
+			result.link->id = key;
+			result.link->asset = std::make_shared<gfx::texture>(make_ref(packed), 0, 0, nullptr);
+			return result;
+		};
+
+		output = ts.push_on_owner_thread(create_resource_from_pack_func);
+		return true;
+	}
+
 	auto read_memory = std::make_shared<fs::byte_array_t>();
 	auto read_memory_func = [read_memory, compiled_absolute_key]() {
 		if(!read_memory)
@@ -125,6 +177,7 @@ bool load_from_file<gfx::shader>(core::task_future<asset_handle<gfx::shader>>& o
 	}
 
 	auto& ts = core::get_subsystem<core::task_system>();
+	auto& am = core::get_subsystem<asset_manager>();
 
 	auto create_resource_func_fallback = [ result = original, key ]() mutable
 	{
@@ -144,15 +197,29 @@ bool load_from_file<gfx::shader>(core::task_future<asset_handle<gfx::shader>>& o
 	fs::path absolute_key = fs::absolute(fs::resolve_protocol(cache_key).string());
 	const auto& renderer_extension = gfx::get_renderer_filename_extension();
 	auto compiled_absolute_key = absolute_key.string() + renderer_extension + ".asset";
+	auto packed = am.find_packed(cache_key.generic_string() + renderer_extension + ".asset");
 
 	fs::error_code err;
-	if(!fs::exists(compiled_absolute_key, err))
+	if(!packed && !fs::exists(compiled_absolute_key, err))
 	{
 		APPLOG_ERROR("Asset with key {0} and absolute_path {1} does not exist!", key, compiled_absolute_key);
 		output = ts.push_or_execute_on_worker_thread(create_resource_func_fallback);
 		return true;
 	}
 
+	if(packed)
+	{
+		auto create_resource_from_pack_func = [ result = original, packed, key ]() mutable
+		{
+			result.link->id = key;
+			result.link->asset = std::make_shared<gfx::shader>(make_ref(packed));
+			return result;
+		};
+
+		output = ts.push_on_owner_thread(create_resource_from_pack_func);
+		return true;
+	}
+
 	auto read_memory = std::make_shared<fs::byte_array_t>();
 
 	auto read_memory_func = [read_memory, compiled_absolute_key]() {
@@ -212,6 +279,7 @@ bool load_from_file<mesh>(core::task_future<asset_handle<mesh>>& output, const s
 	}
 
 	auto& ts = core::get_subsystem<core::task_system>();
+	auto& am = core::get_subsystem<asset_manager>();
 
 	auto create_resource_func_fallback = [ result = original, key ]() mutable
 	{
@@ -230,9 +298,10 @@ bool load_from_file<mesh>(core::task_future<asset_handle<mesh>>& output, const s
 	fs::path absolute_key = fs::absolute(fs::resolve_protocol(cache_key).string());
 
 	auto compiled_absolute_key = absolute_key.string() + ".asset";
+	auto packed = am.find_packed(cache_key.generic_string() + ".asset");
 
 	fs::error_code err;
-	if(!fs::exists(compiled_absolute_key, err))
+	if(!packed && !fs::exists(compiled_absolute_key, err))
 	{
 		APPLOG_ERROR("Asset with key {0} and absolute_path {1} does not exist!", key, compiled_absolute_key);
 		output = ts.push_or_execute_on_worker_thread(create_resource_func_fallback);
@@ -242,22 +311,21 @@ bool load_from_file<mesh>(core::task_future<asset_handle<mesh>>& output, const s
 	struct wrapper_t
 	{
 		std::shared_ptr<::mesh> mesh = std::make_shared<::mesh>();
+		const gfx::memory_view* vb_mem = nullptr;
+		const gfx::memory_view* ib_mem = nullptr;
 	};
 
 	auto wrapper = std::make_shared<wrapper_t>();
-	auto read_memory_func = [wrapper, compiled_absolute_key]() mutable {
+	auto read_memory_func = [wrapper, packed, compiled_absolute_key]() mutable {
 		mesh::load_data data;
-		{
-			std::ifstream stream{compiled_absolute_key, std::ios::in | std::ios::binary};
-
-			if(stream.bad())
-			{
-				return false;
-			}
-
+		const auto read_result = read_compiled(packed, compiled_absolute_key, [&data](std::istream& stream) {
 			cereal::iarchive_binary_t ar(stream);
 
 			try_load(ar, cereal::make_nvp("mesh", data));
+		});
+		if(!read_result)
+		{
+			return false;
 		}
 		wrapper->mesh->prepare_mesh(data.vertex_format);
 		wrapper->mesh->set_vertex_source(&data.vertex_data[0], data.vertex_count, data.vertex_format);
@@ -266,6 +334,14 @@ bool load_from_file<mesh>(core::task_future<asset_handle<mesh>>& output, const s
 		wrapper->mesh->bind_skin(data.skin_data);
 		wrapper->mesh->bind_armature(data.root_node);
 		wrapper->mesh->end_prepare(true, false, false, false);
+		if(wrapper->mesh->get_status() != mesh_status::prepared)
+		{
+			return false;
+		}
+
+		// Only the buffer creation itself is left for the owner thread.
+		wrapper->vb_mem = wrapper->mesh->copy_vb();
+		wrapper->ib_mem = wrapper->mesh->copy_ib();
 
 		return true;
 	};
@@ -275,8 +351,8 @@ bool load_from_file<mesh>(core::task_future<asset_handle<mesh>>& output, const s
 		// Build the mesh
 		if(read_result)
 		{
-			wrapper->mesh->build_vb();
-			wrapper->mesh->build_ib();
+			wrapper->mesh->build_vb(wrapper->vb_mem);
+			wrapper->mesh->build_ib(wrapper->ib_mem);
 
 			if(wrapper->mesh->get_status() == mesh_status::prepared)
 			{
@@ -305,6 +381,7 @@ bool load_from_file<audio::sound>(core::task_future<asset_handle<audio::sound>>&
 	}
 
 	auto& ts = core::get_subsystem<core::task_system>();
+	auto& am = core::get_subsystem<asset_manager>();
 
 	auto create_resource_func_fallback = [ result = original, key ]() mutable
 	{
@@ -323,9 +400,10 @@ bool load_from_file<audio::sound>(core::task_future<asset_handle<audio::sound>>&
 	fs::path absolute_key = fs::absolute(fs::resolve_protocol(cache_key).string());
 
 	auto compiled_absolute_key = absolute_key.string() + ".asset";
+	auto packed = am.find_packed(cache_key.generic_string() + ".asset");
 
 	fs::error_code err;
-	if(!fs::exists(compiled_absolute_key, err))
+	if(!packed && !fs::exists(compiled_absolute_key, err))
 	{
 		APPLOG_ERROR("Asset with key {0} and absolute_path {1} does not exist!", key, compiled_absolute_key);
 		output = ts.push_or_execute_on_worker_thread(create_resource_func_fallback);
@@ -338,20 +416,12 @@ bool load_from_file<audio::sound>(core::task_future<asset_handle<audio::sound>>&
 	};
 
 	auto wrapper = std::make_shared<wrapper_t>();
-	auto read_memory_func = [wrapper, compiled_absolute_key]() mutable {
-		{
-			std::ifstream stream{compiled_absolute_key, std::ios::in | std::ios::binary};
-
-			if(stream.bad())
-			{
-				return false;
-			}
-
+	auto read_memory_func = [wrapper, packed, compiled_absolute_key]() mutable {
+		return read_compiled(packed, compiled_absolute_key, [&wrapper](std::istream& stream) {
 			cereal::iarchive_binary_t ar(stream);
 
 			try_load(ar, cereal::make_nvp("sound", wrapper->data));
-		}
-		return true;
+		});
 	};
 
 	auto create_resource_func = [ result = original, wrapper, key ](bool read_result) mutable
@@ -385,6 +455,7 @@ bool load_from_file<runtime::animation>(core::task_future<asset_handle<runtime::
 	}
 
 	auto& ts = core::get_subsystem<core::task_system>();
+	auto& am = core::get_subsystem<asset_manager>();
 
 	auto create_resource_func_fallback = [ result = original, key ]() mutable
 	{
@@ -403,9 +474,10 @@ bool load_from_file<runtime::animation>(core::task_future<asset_handle<runtime::
 	fs::path absolute_key = fs::absolute(fs::resolve_protocol(cache_key).string());
 
 	auto compiled_absolute_key = absolute_key.string() + ".asset";
+	auto packed = am.find_packed(cache_key.generic_string() + ".asset");
 
 	fs::error_code err;
-	if(!fs::exists(compiled_absolute_key, err))
+	if(!packed && !fs::exists(compiled_absolute_key, err))
 	{
 		APPLOG_ERROR("Asset with key {0} and absolute_path {1} does not exist!", key, compiled_absolute_key);
 		output = ts.push_or_execute_on_worker_thread(create_resource_func_fallback);
@@ -418,22 +490,13 @@ bool load_from_file<runtime::animation>(core::task_future<asset_handle<runtime::
 	};
 
 	auto wrapper = std::make_shared<wrapper_t>();
-	auto read_memory_func = [wrapper, compiled_absolute_key]() mutable {
+	auto read_memory_func = [wrapper, packed, compiled_absolute_key]() mutable {
 		auto& data = *wrapper->anim;
-		{
-			std::ifstream stream{compiled_absolute_key, std::ios::in | std::ios::binary};
-
-			if(stream.bad())
-			{
-				return false;
-			}
-
+		return read_compiled(packed, compiled_absolute_key, [&data](std::istream& stream) {
 			cereal::iarchive_binary_t ar(stream);
 
 			try_load(ar, cereal::make_nvp("animation", data));
-		}
-
-		return true;
+		});
 	};
 
 	auto create_resource_func = [ result = original, wrapper, key ](bool read_result) mutable
@@ -485,9 +548,10 @@ bool load_from_file<material>(core::task_future<asset_handle<material>>& output,
 	fs::path absolute_key = fs::absolute(fs::resolve_protocol(cache_key).string());
 
 	auto compiled_absolute_key = absolute_key.string() + ".asset";
+	auto packed = am.find_packed(cache_key.generic_string() + ".asset");
 
 	fs::error_code err;
-	if(!fs::exists(compiled_absolute_key, err))
+	if(!packed && !fs::exists(compiled_absolute_key, err))
 	{
 		APPLOG_ERROR("Asset with key {0} and absolute_path {1} does not exist!", key, compiled_absolute_key);
 		output = am.load<material>("embedded:/fallback");
@@ -501,18 +565,12 @@ bool load_from_file<material>(core::task_future<asset_handle<material>>& output,
 
 	auto wrapper = std::make_shared<wrapper_t>();
 
-	auto read_memory_func = [wrapper, compiled_absolute_key]() mutable {
-		std::ifstream stream{compiled_absolute_key, std::ios::in | std::ios::binary};
-
-		if(stream.bad())
-		{
-			return false;
-		}
-		cereal::iarchive_binary_t ar(stream);
-
-		try_load(ar, cereal::make_nvp("material", wrapper->material));
+	auto read_memory_func = [wrapper, packed, compiled_absolute_key]() mutable {
+		return read_compiled(packed, compiled_absolute_key, [&wrapper](std::istream& stream) {
+			cereal::iarchive_binary_t ar(stream);
 
-		return true;
+			try_load(ar, cereal::make_nvp("material", wrapper->material));
+		});
 	};
 
 	auto create_resource_func = [ result = original, wrapper, key ](bool read_result) mutable
@@ -542,6 +600,7 @@ bool load_from_file<prefab>(core::task_future<asset_handle<prefab>>& output, con
 	}
 
 	auto& ts = core::get_subsystem<core::task_system>();
+	auto& am = core::get_subsystem<asset_manager>();
 
 	auto create_resource_func_fallback = [ result = original, key ]() mutable
 	{
@@ -560,9 +619,10 @@ bool load_from_file<prefab>(core::task_future<asset_handle<prefab>>& output, con
 	fs::path absolute_key = fs::absolute(fs::resolve_protocol(cache_key).string());
 
 	auto compiled_absolute_key = absolute_key.string() + ".asset";
+	auto packed = am.find_packed(cache_key.generic_string() + ".asset");
 
 	fs::error_code err;
-	if(!fs::exists(compiled_absolute_key, err))
+	if(!packed && !fs::exists(compiled_absolute_key, err))
 	{
 		APPLOG_ERROR("Asset with key {0} and absolute_path {1} does not exist!", key, compiled_absolute_key);
 		output = ts.push_or_execute_on_worker_thread(create_resource_func_fallback);
@@ -571,12 +631,20 @@ bool load_from_file<prefab>(core::task_future<asset_handle<prefab>>& output, con
 
 	std::shared_ptr<std::istringstream> read_memory = std::make_shared<std::istringstream>();
 
-	auto read_memory_func = [read_memory, compiled_absolute_key]() {
+	auto read_memory_func = [read_memory, packed, compiled_absolute_key]() {
 		if(!read_memory)
 		{
 			return false;
 		}
 
+		// the instances read from their own stream, so packed data is copied once
+		if(packed)
+		{
+			const auto chars = reinterpret_cast<const char*>(packed.data.data);
+			*read_memory = std::istringstream(std::string(chars, packed.data.size));
+			return true;
+		}
+
 		auto stream =
 			std::fstream{compiled_absolute_key, std::fstream::in | std::fstream::out | std::ios::binary};
 		auto mem = fs::read_stream(stream);
@@ -614,6 +682,7 @@ bool load_from_file<scene>(core::task_future<asset_handle<scene>>& output, const
 	}
 
 	auto& ts = core::get_subsystem<core::task_system>();
+	auto& am = core::get_subsystem<asset_manager>();
 
 	auto create_resource_func_fallback = [ result = original, key ]() mutable
 	{
@@ -632,9 +701,10 @@ bool load_from_file<scene>(core::task_future<asset_handle<scene>>& output, const
 	fs::path absolute_key = fs::absolute(fs::resolve_protocol(cache_key).string());
 
 	auto compiled_absolute_key = absolute_key.string() + ".asset";
+	auto packed = am.find_packed(cache_key.generic_string() + ".asset");
 
 	fs::error_code err;
-	if(!fs::exists(compiled_absolute_key, err))
+	if(!packed && !fs::exists(compiled_absolute_key, err))
 	{
 		APPLOG_ERROR("Asset with key {0} and absolute_path {1} does not exist!", key, compiled_absolute_key);
 		output = ts.push_or_execute_on_worker_thread(create_resource_func_fallback);
@@ -643,12 +713,20 @@ bool load_from_file<scene>(core::task_future<asset_handle<scene>>& output, const
 
 	std::shared_ptr<std::istringstream> read_memory = std::make_shared<std::istringstream>();
 
-	auto read_memory_func = [read_memory, compiled_absolute_key]() {
+	auto read_memory_func = [read_memory, packed, compiled_absolute_key]() {
 		if(!read_memory)
 		{
 			return false;
 		}
 
+		// the instances read from their own stream, so packed data is copied once
+		if(packed)
+		{
+			const auto chars = reinterpret_cast<const char*>(packed.data.data);
+			*read_memory = std::istringstream(std::string(chars, packed.data.size));
+			return true;
+		}
+
 		auto stream =
 			std::fstream{compiled_absolute_key, std::fstream::in | std::fstream::out | std::ios::binary};
 		auto mem = fs::read_stream(stream);
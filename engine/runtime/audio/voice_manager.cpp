@@ -0,0 +1,107 @@
+#include "voice_manager.h"
+
+#include <algorithm>
+
+namespace runtime
+{
+namespace
+{
+/// Voices quieter than this, about -60dB, are never real.
+constexpr float min_audibility = 0.001f;
+/// Real voices rank as if this much louder, so voices of about the same
+/// loudness don't keep trading their sources every frame.
+constexpr float real_bias = 1.1f;
+}
+
+float voice_manager::get_audibility(const voice& v, const math::vec3& listener)
+{
+	if(!v.positional)
+	{
+		return v.volume;
+	}
+
+	const auto distance = math::distance(v.position, listener);
+	const auto span = v.range.max - v.range.min;
+	if(distance <= v.range.min || span <= 0.0f)
+	{
+		return distance <= v.range.min ? v.volume : 0.0f;
+	}
+
+	const auto d = std::min(distance, v.range.max);
+	const auto gain = 1.0f - v.rolloff * (d - v.range.min) / span;
+	return v.volume * math::clamp(gain, 0.0f, 1.0f);
+}
+
+void voice_manager::update(const math::vec3& listener, std::vector<voice>& voices)
+{
+	stats_.voices = voices.size();
+	stats_.playing = 0;
+	stats_.steals = 0;
+
+	ranked_.clear();
+	for(std::size_t i = 0; i < voices.size(); ++i)
+	{
+		auto& v = voices[i];
+		v.audibility = v.playing ? get_audibility(v, listener) : 0.0f;
+		if(v.playing)
+		{
+			++stats_.playing;
+		}
+		if(v.playing && v.audibility > min_audibility)
+		{
+			ranked_.push_back(i);
+		}
+	}
+
+	const auto count = std::min(max_voices_, ranked_.size());
+	const auto ranks_before = [&voices](std::size_t lhs, std::size_t rhs) {
+		const auto& l = voices[lhs];
+		const auto& r = voices[rhs];
+		if(l.priority != r.priority)
+		{
+			return l.priority > r.priority;
+		}
+		const auto l_score = l.real ? l.audibility * real_bias : l.audibility;
+		const auto r_score = r.real ? r.audibility * real_bias : r.audibility;
+		return l_score > r_score;
+	};
+	std::nth_element(std::begin(ranked_), std::begin(ranked_) + std::ptrdiff_t(count), std::end(ranked_),
+					 ranks_before);
+
+	// audible voices left out while real were pushed out by the ones ranked above them
+	for(std::size_t i = count; i < ranked_.size(); ++i)
+	{
+		if(voices[ranked_[i]].real)
+		{
+			++stats_.steals;
+		}
+	}
+	for(auto& v : voices)
+	{
+		v.real = false;
+	}
+	for(std::size_t i = 0; i < count; ++i)
+	{
+		voices[ranked_[i]].real = true;
+	}
+
+	stats_.real = count;
+	stats_.virtual_voices = stats_.playing - count;
+	stats_.total_steals += stats_.steals;
+}
+
+void voice_manager::set_max_voices(std::size_t count)
+{
+	max_voices_ = count;
+}
+
+std::size_t voice_manager::get_max_voices() const
+{
+	return max_voices_;
+}
+
+const voice_manager::stats& voice_manager::get_stats() const
+{
+	return stats_;
+}
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <core/common/basetypes.hpp>
+#include <core/math/math_includes.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace runtime
+{
+
+//-----------------------------------------------------------------------------
+// Main Class Declarations
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//  Name : voice_manager (Class)
+/// <summary>
+/// Decides which sound emitters get one of the few real audio sources.
+/// Every emitter is a cheap virtual voice, ranked by priority and then by
+/// how loud it would be at the listener. Only the top voices are real,
+/// the rest keep their playback position and are brought back when they
+/// rank high enough again.
+/// </summary>
+//-----------------------------------------------------------------------------
+class voice_manager
+{
+public:
+	struct voice
+	{
+		/// Position of the emitter.
+		math::vec3 position{0.0f, 0.0f, 0.0f};
+		float volume = 1.0f;
+		float rolloff = 1.0f;
+		/// Distance the attenuation starts at and the one it reaches its maximum at.
+		frange_t range = {1.0f, 20.0f};
+		/// Voices with a higher priority are preferred regardless of loudness.
+		std::int32_t priority = 0;
+		/// Whether the voice is being played at all.
+		bool playing = false;
+		/// Only mono sounds are attenuated by distance.
+		bool positional = true;
+		/// Whether the voice has a real source, updated by update.
+		bool real = false;
+		/// Loudness at the listener, updated by update.
+		float audibility = 0.0f;
+	};
+
+	struct stats
+	{
+		/// Voices known this frame.
+		std::size_t voices = 0;
+		/// Voices being played.
+		std::size_t playing = 0;
+		/// Voices with a real source.
+		std::size_t real = 0;
+		/// Playing voices without a real source.
+		std::size_t virtual_voices = 0;
+		/// Real voices that lost their source to a more important one this frame.
+		std::size_t steals = 0;
+		/// Steals since the manager was created.
+		std::uint64_t total_steals = 0;
+	};
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_audibility ()
+	/// <summary>
+	/// Loudness of the voice at the listener, following the linear distance
+	/// model the audio device uses.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	static float get_audibility(const voice& v, const math::vec3& listener);
+
+	//-----------------------------------------------------------------------------
+	//  Name : update ()
+	/// <summary>
+	/// Ranks the voices and marks the ones that should be real this frame.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void update(const math::vec3& listener, std::vector<voice>& voices);
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_max_voices ()
+	/// <summary>
+	/// Sets how many voices can be real at once.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_max_voices(std::size_t count);
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_max_voices ()
+	/// <summary>
+	/// How many voices can be real at once.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::size_t get_max_voices() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_stats ()
+	/// <summary>
+	/// Voice counts of the last update.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	const stats& get_stats() const;
+
+private:
+	/// Voice indices of the current update, kept for the storage.
+	std::vector<std::size_t> ranked_;
+	std::size_t max_voices_ = 32;
+	stats stats_;
+};
+}
@@ -0,0 +1,94 @@
+#include "animation_component.h"
+
+void animation_component::set_animation(asset_handle<runtime::animation> animation)
+{
+	animation_ = animation;
+	apply_base_layer();
+
+	touch();
+}
+
+asset_handle<runtime::animation> animation_component::get_animation() const
+{
+	return animation_;
+}
+
+void animation_component::set_speed(float speed)
+{
+	if(speed_ == speed)
+	{
+		return;
+	}
+
+	speed_ = speed;
+	apply_base_layer();
+
+	touch();
+}
+
+float animation_component::get_speed() const
+{
+	return speed_;
+}
+
+void animation_component::set_loop(bool on)
+{
+	if(loop_ == on)
+	{
+		return;
+	}
+
+	loop_ = on;
+	apply_base_layer();
+
+	touch();
+}
+
+bool animation_component::is_looping() const
+{
+	return loop_;
+}
+
+void animation_component::set_playing(bool on)
+{
+	if(playing_ == on)
+	{
+		return;
+	}
+
+	playing_ = on;
+
+	touch();
+}
+
+bool animation_component::is_playing() const
+{
+	return playing_;
+}
+
+runtime::animation_player& animation_component::get_player()
+{
+	return player_;
+}
+
+const runtime::animation_player& animation_component::get_player() const
+{
+	return player_;
+}
+
+void animation_component::apply_base_layer()
+{
+	if(player_.get_layer_count() == 0)
+	{
+		player_.add_layer(animation_);
+	}
+
+	auto& base = player_.get_layer(0);
+	if(base.clip != animation_)
+	{
+		base.clip = animation_;
+		base.time = runtime::animation_player::seconds_t(0);
+	}
+	base.speed = speed_;
+	base.loop = loop_;
+}
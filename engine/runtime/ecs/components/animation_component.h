@@ -0,0 +1,82 @@
+#pragma once
+
+#include "../../animation/animation_player.h"
+#include "../../assets/asset_handle.h"
+#include "runtime/ecs/ent.h"
+
+//-----------------------------------------------------------------------------
+// Main Class Declarations
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//  Name : animation_component (Class)
+/// <summary>
+/// Plays animations on the skeleton of the model of the entity. The
+/// animation set here drives the base layer of the player, more layers can
+/// be blended on top of it through get_player().
+/// </summary>
+//-----------------------------------------------------------------------------
+class animation_component : public ent::component_impl<animation_component>
+{
+	SERIALIZABLE(animation_component)
+	REFLECTABLEV(animation_component, component)
+
+public:
+	//-------------------------------------------------------------------------
+	// Public Methods
+	//-------------------------------------------------------------------------
+	//-----------------------------------------------------------------------------
+	//  Name : set_animation ()
+	/// <summary>
+	/// Sets the clip of the base layer.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_animation(asset_handle<runtime::animation> animation);
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_animation ()
+	/// <summary>
+	/// Clip of the base layer.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	asset_handle<runtime::animation> get_animation() const;
+
+	void set_speed(float speed);
+	float get_speed() const;
+	void set_loop(bool on);
+	bool is_looping() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_playing ()
+	/// <summary>
+	/// Advance the time of the layers every frame. A stopped player still
+	/// holds its current pose.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_playing(bool on);
+	bool is_playing() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_player ()
+	/// <summary>
+	/// The player, to blend further layers or seek.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	runtime::animation_player& get_player();
+	const runtime::animation_player& get_player() const;
+
+private:
+	void apply_base_layer();
+	//-------------------------------------------------------------------------
+	// Private Member Variables.
+	//-------------------------------------------------------------------------
+	///
+	asset_handle<runtime::animation> animation_;
+	///
+	float speed_ = 1.0f;
+	///
+	bool loop_ = true;
+	///
+	bool playing_ = true;
+	/// Runtime state, not serialized.
+	runtime::animation_player player_;
+};
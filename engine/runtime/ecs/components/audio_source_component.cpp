@@ -1,40 +1,167 @@
 #include "audio_source_component.h"
+
+#include <cmath>
 #include <limits>
 
-void audio_source_component::update(const math::transform& t)
+void audio_source_component::update(const math::transform& t, delta_t dt)
+{
+	const auto pos = t.get_position();
+	if(has_position_ && dt.count() > 0.0f)
+	{
+		velocity_ = (pos - position_) / dt.count();
+	}
+	position_ = pos;
+	forward_ = t.z_unit_axis();
+	up_ = t.y_unit_axis();
+	has_position_ = true;
+}
+
+void audio_source_component::update_playback(delta_t dt)
+{
+	if(state_ != playback_state::playing)
+	{
+		return;
+	}
+
+	if(is_real())
+	{
+		auto& source = *source_.source;
+		if(source.is_stopped())
+		{
+			// reached the end of the sound
+			state_ = playback_state::stopped;
+			offset_ = audio::sound_info::duration_t(0);
+		}
+		else
+		{
+			offset_ = source.get_playing_offset();
+		}
+		return;
+	}
+
+	const auto duration = get_playing_duration();
+	offset_ += audio::sound_info::duration_t(dt.count() * pitch_);
+	if(offset_ < duration)
+	{
+		return;
+	}
+
+	if(loop_ && duration.count() > 0.0)
+	{
+		offset_ = audio::sound_info::duration_t(std::fmod(offset_.count(), duration.count()));
+	}
+	else
+	{
+		state_ = playback_state::stopped;
+		offset_ = audio::sound_info::duration_t(0);
+	}
+}
+
+void audio_source_component::update_source()
+{
+	if(!is_real())
+	{
+		return;
+	}
+
+	auto& source = *source_.source;
+	source.set_position({{position_.x, position_.y, position_.z}});
+	source.set_orientation({{forward_.x, forward_.y, forward_.z}}, {{up_.x, up_.y, up_.z}});
+	source.set_velocity({{velocity_.x, velocity_.y, velocity_.z}});
+}
+
+void audio_source_component::make_real(std::unique_ptr<audio::source> source)
+{
+	source_.source = std::move(source);
+	if(!is_real())
+	{
+		return;
+	}
+
+	auto& real = *source_.source;
+	real.set_loop(loop_);
+	if(is_sound_valid())
+	{
+		real.bind(*sound_.get());
+	}
+	real.set_volume(volume_);
+	real.set_pitch(pitch_);
+	real.set_volume_rolloff(volume_rolloff_);
+	real.set_distance(range_.min, range_.max);
+	update_source();
+
+	real.set_playing_offset(offset_);
+	if(state_ == playback_state::playing)
+	{
+		real.play();
+	}
+}
+
+std::unique_ptr<audio::source> audio_source_component::make_virtual()
+{
+	if(is_real() && state_ == playback_state::playing)
+	{
+		offset_ = source_.source->get_playing_offset();
+	}
+	if(is_real())
+	{
+		source_.source->stop();
+	}
+	return std::move(source_.source);
+}
+
+bool audio_source_component::is_real() const
+{
+	return source_.source != nullptr;
+}
+
+bool audio_source_component::is_positional() const
 {
-	auto pos = t.get_position();
-	auto forward = t.z_unit_axis();
-	auto up = t.y_unit_axis();
-	source_.set_position({{pos.x, pos.y, pos.z}});
-	source_.set_orientation({{forward.x, forward.y, forward.z}}, {{up.x, up.y, up.z}});
+	return is_sound_valid() && sound_->get_info().channels == 1;
+}
+
+const math::vec3& audio_source_component::get_position() const
+{
+	return position_;
 }
 
 void audio_source_component::set_loop(bool on)
 {
 	loop_ = on;
-	source_.set_loop(on);
+	if(is_real())
+	{
+		source_.source->set_loop(on);
+	}
 }
 
 void audio_source_component::set_volume(float volume)
 {
 	math::clamp(volume, 0.0f, 1.0f);
 	volume_ = volume;
-	source_.set_volume(volume);
+	if(is_real())
+	{
+		source_.source->set_volume(volume);
+	}
 }
 
 void audio_source_component::set_pitch(float pitch)
 {
 	math::clamp(pitch, 0.5f, 2.0f);
 	pitch_ = pitch;
-	source_.set_pitch(pitch);
+	if(is_real())
+	{
+		source_.source->set_pitch(pitch);
+	}
 }
 
 void audio_source_component::set_volume_rolloff(float rolloff)
 {
 	math::clamp(rolloff, 0.0f, 10.0f);
 	volume_rolloff_ = rolloff;
-	source_.set_volume_rolloff(rolloff);
+	if(is_real())
+	{
+		source_.source->set_volume_rolloff(rolloff);
+	}
 }
 
 void audio_source_component::set_range(const frange_t& range)
@@ -43,7 +170,10 @@ void audio_source_component::set_range(const frange_t& range)
 	math::clamp(range.max, range.min, std::numeric_limits<float>::max());
 
 	range_ = range;
-	source_.set_distance(range.min, range.max);
+	if(is_real())
+	{
+		source_.source->set_distance(range.min, range.max);
+	}
 }
 
 void audio_source_component::set_autoplay(bool on)
@@ -62,6 +192,16 @@ bool audio_source_component::get_autoplay() const
 	return auto_play_;
 }
 
+void audio_source_component::set_priority(std::int32_t priority)
+{
+	priority_ = priority;
+}
+
+std::int32_t audio_source_component::get_priority() const
+{
+	return priority_;
+}
+
 float audio_source_component::get_volume() const
 {
 	return volume_;
@@ -84,46 +224,88 @@ const frange_t& audio_source_component::get_range() const
 
 void audio_source_component::set_playing_offset(audio::sound_info::duration_t offset)
 {
-	source_.set_playing_offset(offset);
+	offset_ = offset;
+	if(is_real())
+	{
+		source_.source->set_playing_offset(offset);
+	}
 }
 
 audio::sound_info::duration_t audio_source_component::get_playing_offset() const
 {
-	return source_.get_playing_offset();
+	if(is_real() && state_ != playback_state::stopped)
+	{
+		return source_.source->get_playing_offset();
+	}
+	return offset_;
 }
 
 audio::sound_info::duration_t audio_source_component::get_playing_duration() const
 {
-	return source_.get_playing_duration();
+	if(is_sound_valid())
+	{
+		return sound_->get_info().duration;
+	}
+	return audio::sound_info::duration_t(0);
 }
 
 void audio_source_component::play()
 {
-	if(sound_)
+	if(!is_sound_valid())
+	{
+		return;
+	}
+
+	if(state_ != playback_state::paused)
+	{
+		offset_ = audio::sound_info::duration_t(0);
+		if(is_real())
+		{
+			source_.source->set_playing_offset(offset_);
+		}
+	}
+	state_ = playback_state::playing;
+
+	// virtual voices are given a source by the audio system once they are audible
+	if(is_real())
 	{
-		source_.bind(*sound_.get());
-		source_.play();
+		source_.source->play();
 	}
 }
 
 void audio_source_component::stop()
 {
-	source_.stop();
+	state_ = playback_state::stopped;
+	offset_ = audio::sound_info::duration_t(0);
+	if(is_real())
+	{
+		source_.source->stop();
+	}
 }
 
 void audio_source_component::pause()
 {
-	source_.pause();
+	if(state_ != playback_state::playing)
+	{
+		return;
+	}
+
+	state_ = playback_state::paused;
+	if(is_real())
+	{
+		offset_ = source_.source->get_playing_offset();
+		source_.source->pause();
+	}
 }
 
 bool audio_source_component::is_playing() const
 {
-	return source_.is_playing();
+	return state_ == playback_state::playing;
 }
 
 bool audio_source_component::is_paused() const
 {
-	return source_.is_paused();
+	return state_ == playback_state::paused;
 }
 
 bool audio_source_component::is_looping() const
@@ -136,6 +318,10 @@ void audio_source_component::set_sound(asset_handle<audio::sound> sound)
 	stop();
 
 	sound_ = std::move(sound);
+	if(is_real() && is_sound_valid())
+	{
+		source_.source->bind(*sound_.get());
+	}
 
 	apply_all();
 }
@@ -147,7 +333,20 @@ asset_handle<audio::sound> audio_source_component::get_sound() const
 
 bool audio_source_component::has_binded_sound() const
 {
-	return source_.has_binded_sound();
+	return is_sound_valid();
+}
+
+bool audio_source_component::is_streaming() const
+{
+	return is_real() && source_.source->is_streaming();
+}
+
+void audio_source_component::update_stream()
+{
+	if(is_real())
+	{
+		source_.source->update_stream();
+	}
 }
 
 void audio_source_component::apply_all()
@@ -7,6 +7,9 @@
 #include <core/common/basetypes.hpp>
 #include <core/math/math_includes.h>
 
+#include <cstdint>
+#include <memory>
+
 //-----------------------------------------------------------------------------
 // Main Class Declarations
 //-----------------------------------------------------------------------------
@@ -32,12 +35,63 @@ public:
 	//-----------------------------------------------------------------------------
 	//  Name : update ()
 	/// <summary>
-	///
-	///
-	///
+	/// Follows the transform. Nothing reaches the audio device until
+	/// update_source is called.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void update(const math::transform& t, delta_t dt);
+
+	//-----------------------------------------------------------------------------
+	//  Name : update_playback ()
+	/// <summary>
+	/// Advances the playing offset. Virtual voices advance it themselves so
+	/// they continue in the right place once they are real again.
 	/// </summary>
 	//-----------------------------------------------------------------------------
-	void update(const math::transform& t);
+	void update_playback(delta_t dt);
+
+	//-----------------------------------------------------------------------------
+	//  Name : update_source ()
+	/// <summary>
+	/// Sends the position, orientation and velocity to the real source.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void update_source();
+
+	//-----------------------------------------------------------------------------
+	//  Name : make_real ()
+	/// <summary>
+	/// Plays the voice through the given source from where it is now.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void make_real(std::unique_ptr<audio::source> source);
+
+	//-----------------------------------------------------------------------------
+	//  Name : make_virtual ()
+	/// <summary>
+	/// Stops the real source and gives it back, the voice keeps playing
+	/// virtually.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::unique_ptr<audio::source> make_virtual();
+
+	//-----------------------------------------------------------------------------
+	//  Name : is_real ()
+	/// <summary>
+	/// Checks whether the voice plays through a real source.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool is_real() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : is_positional ()
+	/// <summary>
+	/// Checks whether the sound is attenuated by distance, only mono ones are.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool is_positional() const;
+
+	const math::vec3& get_position() const;
 
 	void set_loop(bool on);
 	void set_volume(float volume);
@@ -47,6 +101,8 @@ public:
 	void set_range(const frange_t& range);
 	void set_autoplay(bool on);
 	bool get_autoplay() const;
+	void set_priority(std::int32_t priority);
+	std::int32_t get_priority() const;
 
 	float get_volume() const;
 	float get_pitch() const;
@@ -70,9 +126,50 @@ public:
 
 	bool has_binded_sound() const;
 
+	//-----------------------------------------------------------------------------
+	//  Name : is_streaming ()
+	/// <summary>
+	/// Checks whether the sound is decoded while playing.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool is_streaming() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : update_stream ()
+	/// <summary>
+	/// Decodes the next chunks of a streamed sound.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void update_stream();
+
 private:
 	void apply_all();
 	bool is_sound_valid() const;
+
+	enum class playback_state : std::uint8_t
+	{
+		stopped,
+		playing,
+		paused
+	};
+
+	// the real source belongs to one component only, copies start virtual
+	struct voice_source
+	{
+		voice_source() = default;
+		voice_source(const voice_source&)
+		{
+		}
+		voice_source(voice_source&&) = default;
+		voice_source& operator=(const voice_source&)
+		{
+			source.reset();
+			return *this;
+		}
+		voice_source& operator=(voice_source&&) = default;
+
+		std::unique_ptr<audio::source> source;
+	};
 	//-------------------------------------------------------------------------
 	// Private Member Variables.
 	//-------------------------------------------------------------------------
@@ -83,6 +180,14 @@ private:
 	float pitch_ = 1.0f;
 	float volume_rolloff_ = 1.0f;
 	frange_t range_ = {1.0f, 20.0f};
-	audio::source source_;
+	std::int32_t priority_ = 0;
+	playback_state state_ = playback_state::stopped;
+	audio::sound_info::duration_t offset_ = audio::sound_info::duration_t(0);
+	bool has_position_ = false;
+	math::vec3 position_{0.0f, 0.0f, 0.0f};
+	math::vec3 forward_{0.0f, 0.0f, 1.0f};
+	math::vec3 up_{0.0f, 1.0f, 0.0f};
+	math::vec3 velocity_{0.0f, 0.0f, 0.0f};
+	voice_source source_;
 	asset_handle<audio::sound> sound_;
 };
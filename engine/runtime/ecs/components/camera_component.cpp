@@ -7,6 +7,20 @@ camera_component::camera_component()
 	camera_.set_viewport_size({640, 480});
 }
 
+camera_component::camera_component(const camera_component& rhs)
+	: ent::component_impl<camera_component>(rhs)
+	, camera_(rhs.camera_)
+	, hdr_(rhs.hdr_)
+{
+}
+
+camera_component& camera_component::operator=(const camera_component& rhs)
+{
+	camera_ = rhs.camera_;
+	hdr_ = rhs.hdr_;
+	return *this;
+}
+
 camera_component::~camera_component()
 {
 }
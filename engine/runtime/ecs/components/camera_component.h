@@ -32,6 +32,11 @@ public:
 	// Constructors & Destructors
 	//-------------------------------------------------------------------------
 	camera_component();
+	// render targets are not shared, a copy gets its own render view
+	camera_component(const camera_component& rhs);
+	camera_component(camera_component&&) = default;
+	camera_component& operator=(const camera_component& rhs);
+	camera_component& operator=(camera_component&&) = default;
 	virtual ~camera_component();
 
 	//-------------------------------------------------------------------------
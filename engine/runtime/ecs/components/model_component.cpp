@@ -59,16 +59,36 @@ void model_component::set_model(const model& model)
 	touch();
 }
 
-void model_component::set_bone_transforms(const std::vector<math::transform>& bone_transforms)
+void model_component::set_bone_entities_enabled(bool enabled)
 {
-	bone_transforms_ = bone_transforms;
+	if(bone_entities_enabled_ == enabled)
+	{
+		return;
+	}
 
 	touch();
+
+	bone_entities_enabled_ = enabled;
+}
+
+bool model_component::get_bone_entities_enabled() const
+{
+	return bone_entities_enabled_;
+}
+
+skeleton_pose& model_component::get_pose()
+{
+	return pose_;
+}
+
+const skeleton_pose& model_component::get_pose() const
+{
+	return pose_;
 }
 
 const std::vector<math::transform>& model_component::get_bone_transforms() const
 {
-	return bone_transforms_;
+	return pose_.get_bone_transforms();
 }
 
 void model_component::set_bone_entities(const std::vector<EntityType>& bone_entities)
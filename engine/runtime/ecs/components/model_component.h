@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../../rendering/mesh/skeleton.h"
 #include "../../rendering/model.h"
 #include "runtime/ecs/ent.h"
 
@@ -105,9 +106,41 @@ public:
 	//-----------------------------------------------------------------------------
 	void set_model(const model& model);
 
+	//-----------------------------------------------------------------------------
+	//  Name : set_bone_entities_enabled ()
+	/// <summary>
+	/// Mirror the bones into entities, for the editor or to attach things to
+	/// them. The skinning itself only needs the pose.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_bone_entities_enabled(bool enabled);
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_bone_entities_enabled ()
+	/// <summary>
+	/// Are the bones mirrored into entities.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool get_bone_entities_enabled() const;
+
 	void set_bone_entities(const std::vector<EntityType>& bone_entities);
 	const std::vector<EntityType>& get_bone_entities() const;
-	void set_bone_transforms(const std::vector<math::transform>& bone_transforms);
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_pose ()
+	/// <summary>
+	/// Pose of the skeleton of the model, resolved by the bone_system.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	skeleton_pose& get_pose();
+	const skeleton_pose& get_pose() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_bone_transforms ()
+	/// <summary>
+	/// World transform of every bone of the skin, empty for static models.
+	/// </summary>
+	//-----------------------------------------------------------------------------
 	const std::vector<math::transform>& get_bone_transforms() const;
 
 private:
@@ -123,6 +156,9 @@ private:
 	///
 	model model_;
 	///
+	bool bone_entities_enabled_{false};
+	///
 	std::vector<EntityType> bone_entities_;
-	std::vector<math::transform> bone_transforms_;
+	/// Runtime pose, not serialized.
+	skeleton_pose pose_;
 };
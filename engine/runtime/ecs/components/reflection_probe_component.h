@@ -39,7 +39,12 @@ public:
 	bool is_touched() { return true; }
 
 	reflection_probe_component() {};
-	reflection_probe_component(const reflection_probe_component& p) {};
+	// render targets are not shared, a copy gets its own render views
+	reflection_probe_component(const reflection_probe_component& p)
+		: ent::component_impl<reflection_probe_component>(p)
+		, probe_(p.probe_)
+	{
+	}
 	// void operator=(const reflection_probe_component& p) {};
 
 private:
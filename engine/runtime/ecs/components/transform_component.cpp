@@ -418,18 +418,8 @@ void transform_component::set_transform(const math::transform& tr)
 
 void transform_component::apply_transform(const math::transform& trans)
 {
-	// eh just find the parent outside maybe...
-
-	// if(parent_.valid())
-	// {
-	// 	auto parent_transform = parent_.get_component<transform_component>().lock();
-	// 	if(parent_transform)
-	// 	{
-	// 		auto inv_parent_transform = math::inverse(parent_transform->get_transform());
-	// 		trans = inv_parent_transform * trans;
-	// 	}
-	// }
-	set_local_transform(trans);
+	// world space in, local space of the parent out
+	set_local_transform(math::inverse(parent_transform_) * trans);
 }
 
 void transform_component::apply_local_transform(const math::transform& trans)
@@ -455,6 +445,16 @@ void transform_component::set_world_transform(const math::transform& trans) {
 	world_transform_ = trans;
 }
 
+void transform_component::set_parent_transform(const math::transform& trans)
+{
+	parent_transform_ = trans;
+}
+
+const math::transform& transform_component::get_parent_transform() const
+{
+	return parent_transform_;
+}
+
 void transform_component::resolve(bool force)
 {
 	// if(force || is_dirty())
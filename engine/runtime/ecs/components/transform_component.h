@@ -69,6 +69,15 @@ public:
 	void set_local_transform(const math::transform& trans);
 	void set_transform(const math::transform& trans);
 	void set_world_transform(const math::transform& trans);
+	//-----------------------------------------------------------------------------
+	//  Name : set_parent_transform()
+	/// <summary>
+	/// Cached world transform of the parent, set by the transform system.
+	/// Used to bring world space changes to local space.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_parent_transform(const math::transform& trans);
+	const math::transform& get_parent_transform() const;
 	void look_at(const math::vec3& eye, const math::vec3& at);
 	void look_at(const math::vec3& eye, const math::vec3& at, const math::vec3& up);
 	bool can_adjust_pivot() const;
@@ -97,6 +106,8 @@ protected:
 	math::transform local_transform_;
 	/// Cached world transformation at pivot point.
 	math::transform world_transform_;
+	/// Cached world transformation of the parent.
+	math::transform parent_transform_;
 	/// Should recalc world transform.
 	bool dirty_ = true;
 };
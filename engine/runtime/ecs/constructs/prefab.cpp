@@ -1,18 +1,58 @@
 #include "prefab.h"
-// #include "utils.h"
+#include "snapshots.h"
+#include "../components/relation.h"
+
+#include <core/system/subsystem.h>
+
+#include <algorithm>
 
 EntityType prefab::instantiate()
 {
-  return {};
-	// std::vector<EntityType> out_data;
-	// if(!data)
-	// 	return {};
-
-	// if(!ecs::utils::deserialize_data(*data, out_data))
-	// 	return {};
-
-	// if(out_data.empty())
-	// 	return {};
-	// else
-	// 	return out_data.front();
+	auto roots = instantiate(1);
+	return roots.empty() ? EntityType(entt::null) : roots.front();
+}
+
+std::vector<EntityType> prefab::instantiate(std::size_t count)
+{
+	std::vector<EntityType> roots;
+	if(!load_template())
+		return roots;
+
+	auto& ecs = core::get_subsystem<SpatialSystem>();
+	auto copies = ecs::clone(*template_, template_entities_, ecs, count);
+
+	roots.reserve(count);
+	for(std::size_t i = template_root_; i < copies.size(); i += template_entities_.size())
+	{
+		roots.push_back(copies[i]);
+	}
+	return roots;
+}
+
+bool prefab::load_template()
+{
+	if(template_)
+		return !template_entities_.empty();
+
+	if(!data)
+		return false;
+
+	template_ = std::make_shared<Registry>();
+	data->clear();
+	data->seekg(0);
+	if(!ecs::deserialize(*data, *template_, template_entities_))
+		template_entities_.clear();
+
+	// the root is the one whose parent did not come along
+	auto& reg = *template_;
+	auto it = std::find_if(std::begin(template_entities_), std::end(template_entities_), [&reg](EntityType e) {
+		if(!reg.has<Relation>(e))
+			return true;
+		const auto parent = reg.get<Relation>(e).parent;
+		return parent == entt::null || !reg.valid(parent);
+	});
+	if(it != std::end(template_entities_))
+		template_root_ = static_cast<std::size_t>(std::distance(std::begin(template_entities_), it));
+
+	return !template_entities_.empty();
 }
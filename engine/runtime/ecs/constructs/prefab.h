@@ -3,9 +3,35 @@
 #include "runtime/ecs/ent.h"
 #include <fstream>
 #include <memory>
+#include <vector>
 
 struct prefab
 {
+	//-----------------------------------------------------------------------------
+	//  Name : instantiate ()
+	/// <summary>
+	/// Spawns one copy of the prefab and returns its root.
+	/// </summary>
+	//-----------------------------------------------------------------------------
 	EntityType instantiate();
+
+	//-----------------------------------------------------------------------------
+	//  Name : instantiate ()
+	/// <summary>
+	/// Spawns count copies in one go and returns the root of each. The data is
+	/// parsed once into a private registry, copies are cloned from there.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::vector<EntityType> instantiate(std::size_t count);
+
 	std::shared_ptr<std::istream> data;
+
+private:
+	bool load_template();
+
+	/// parsed data, the source of every copy
+	std::shared_ptr<Registry> template_;
+	std::vector<EntityType> template_entities_;
+	/// index of the root in template_entities_
+	std::size_t template_root_ = 0;
 };
@@ -2,6 +2,7 @@
 #include <core/serialization/associative_archive.h>
 #include <core/serialization/binary_archive.h>
 
+#include "runtime/ecs/components/animation_component.h"
 #include "runtime/ecs/components/audio_listener_component.h"
 #include "runtime/ecs/components/audio_source_component.h"
 #include "runtime/ecs/components/camera_component.h"
@@ -11,40 +12,88 @@
 #include "runtime/ecs/components/relation.h"
 #include "runtime/ecs/components/transform_component.h"
 
+#include <type_traits>
+#include <unordered_map>
+
 namespace ecs {
 
-template<typename Archive>
-void serialize_t(std::ostream& stream, const Registry& reg, const std::vector<EntityType>& ents)
+template<typename... C>
+struct component_list {};
+
+// every component stored in snapshots, the same names are used by both formats
+using snapshot_components =
+    component_list<animation_component, audio_listener_component, audio_source_component, camera_component,
+                   light_component, model_component, reflection_probe_component, Relation,
+                   transform_component, Name>;
+
+template<typename C>
+constexpr const char* component_name = nullptr;
+template<>
+constexpr const char* component_name<animation_component> = "animation_component";
+template<>
+constexpr const char* component_name<audio_listener_component> = "audio_listener";
+template<>
+constexpr const char* component_name<audio_source_component> = "audio_source_component";
+template<>
+constexpr const char* component_name<camera_component> = "camera_component";
+template<>
+constexpr const char* component_name<light_component> = "light_component";
+template<>
+constexpr const char* component_name<model_component> = "model_component";
+template<>
+constexpr const char* component_name<reflection_probe_component> = "reflection_probe_component";
+template<>
+constexpr const char* component_name<Relation> = "relation";
+template<>
+constexpr const char* component_name<transform_component> = "transform_component";
+template<>
+constexpr const char* component_name<Name> = "name";
+
+template<typename Snapshot, typename... C>
+void serialize_t(Snapshot& snap, component_list<C...>)
 {
-    Archive ar(stream);
-    output_archive snap(ar, reg, ents);
-
-    snap.set<audio_listener_component>("audio_listenero_listener");
-    snap.set<audio_source_component>("audio_source_component");
-    snap.set<camera_component>("camera_component");
-    snap.set<light_component>("light_component");
-    snap.set<model_component>("model_component");
-    snap.set<reflection_probe_component>("reflection_probe_component");
-    snap.set<Relation>("relation");
-    snap.set<transform_component>("transform_component");
-    snap.set<Name>("name");
-}
-
-template<typename Archive>
-void deserialize_t(std::istream& stream, Registry& reg)
+    (snap.template set<C>(component_name<C>), ...);
+}
+
+template<typename C, typename Loader>
+void deserialize_component(Loader& loader)
 {
-    Archive ar(stream);
-    continuous_archive loader(ar, reg);
-    loader.get<audio_listener_component>("audio_listener");
-    loader.get<audio_source_component>("audio_source_component");
-    loader.get<camera_component>("camera_component");
-    loader.get<light_component>("light_component");
-    loader.get<model_component>("model_component");
-    loader.get<reflection_probe_component>("reflection_probe_component");
-    loader.get<Relation>("relation", &Relation::parent);
-    loader.get<transform_component>("transform_component");
-    loader.get<Name>("name");
+    if constexpr (std::is_same<C, Relation>::value) {
+        loader.template get<C>(component_name<C>, &Relation::parent);
+    } else {
+        loader.template get<C>(component_name<C>);
+    }
+}
 
+template<typename Loader, typename... C>
+void deserialize_t(Loader& loader, component_list<C...>)
+{
+    (deserialize_component<C>(loader), ...);
+}
+
+static thread_local std::uint32_t loading_snapshot_version = binary_snapshot_version;
+
+std::uint32_t get_loading_snapshot_version()
+{
+    return loading_snapshot_version;
+}
+
+std::uint32_t set_loading_snapshot_version(std::uint32_t version)
+{
+    const auto previous = loading_snapshot_version;
+    loading_snapshot_version = version;
+    return previous;
+}
+
+static bool is_binary_snapshot(std::istream& stream)
+{
+    const auto start = stream.tellg();
+    std::uint32_t magic{0};
+    stream.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    const bool binary = stream.gcount() == sizeof(magic) && magic == binary_snapshot_magic;
+    stream.clear();
+    stream.seekg(start);
+    return binary;
 }
 
 // struct catcher {
@@ -67,35 +116,164 @@ struct assign_defaults {
 };
 
 
-EntityType clone(Registry& reg, EntityType ent)
+template<typename C, typename F>
+void remap_entities(C&, const F&)
+{
+}
+
+template<typename F>
+void remap_entities(Relation& relation, const F& remap)
+{
+    relation.parent = remap(relation.parent);
+}
+
+template<typename F>
+void remap_entities(model_component& model, const F& remap)
+{
+    auto bones = model.get_bone_entities();
+    if (bones.empty()) {
+        return;
+    }
+    for (auto& bone : bones) {
+        bone = remap(bone);
+    }
+    model.set_bone_entities(bones);
+}
+
+// copies[k * ents.size() + i] is the k-th copy of ents[i]
+template<typename C, typename F>
+void clone_component(const Registry& src, const std::vector<EntityType>& ents, Registry& dst,
+                     const std::vector<EntityType>& copies, const F& remap)
 {
-    std::stringstream stream;
-    {
-        serialize_t<cereal::oarchive_associative_t>(stream, reg, {ent});
+    std::size_t used = 0;
+    for (auto e : ents) {
+        used += src.has<C>(e) ? 1 : 0;
+    }
+    if (used == 0) {
+        return;
+    }
+
+    const auto count = copies.size() / ents.size();
+    dst.reserve<C>(dst.size<C>() + used * count);
+    for (std::size_t i = 0; i < copies.size(); ++i) {
+        const auto e = ents[i % ents.size()];
+        if (!src.has<C>(e)) {
+            continue;
+        }
+        // copy first, src and dst may share the pool
+        C component = src.get<C>(e);
+        const auto copy = i / ents.size();
+        remap_entities(component, [&remap, copy](EntityType ref) { return remap(ref, copy); });
+        dst.assign<C>(copies[i], std::move(component));
     }
-    // EntityType cloned;
-    // catcher c;
-    // we can use Name as default componnet
-    // reg.construction<Name>().connect<&catcher::set_last_ent>(&c);
-    std::vector<EntityType> result;
-    deserialize(stream, reg, result);
-    assert(result.size() == 1);
-    if (result.size() == 0) return entt::null;
-    // reg.construction<Name>().disconnect<&catcher::set_last_ent>(&c);
-    return result[0];
+}
 
+// Relation is left out, clone copies it before everything else
+template<typename C, typename F>
+void clone_listed_component(const Registry& src, const std::vector<EntityType>& ents, Registry& dst,
+                            const std::vector<EntityType>& copies, const F& remap)
+{
+    if constexpr (!std::is_same<C, Relation>::value) {
+        clone_component<C>(src, ents, dst, copies, remap);
+    }
 }
 
-void deserialize(std::istream& stream, Registry& reg, std::vector<EntityType>& output) {
+template<typename... C, typename F>
+void clone_components(const Registry& src, const std::vector<EntityType>& ents, Registry& dst,
+                      const std::vector<EntityType>& copies, const F& remap, component_list<C...>)
+{
+    (clone_listed_component<C>(src, ents, dst, copies, remap), ...);
+}
+
+std::vector<EntityType> clone(const Registry& src, const std::vector<EntityType>& ents, Registry& dst,
+                              std::size_t count, const clone_remap_t& remap)
+{
+    std::vector<EntityType> copies;
+    if (ents.empty() || count == 0) {
+        return copies;
+    }
+
+    copies.reserve(ents.size() * count);
+    dst.reserve(dst.size() + ents.size() * count);
+    for (std::size_t i = 0; i < ents.size() * count; ++i) {
+        copies.push_back(dst.create());
+    }
+
+    std::unordered_map<EntityType, std::size_t> index_of;
+    for (std::size_t i = 0; i < ents.size(); ++i) {
+        index_of.emplace(ents[i], i);
+    }
+
+    const bool same_registry = &src == &dst;
+    const auto map_reference = [&](EntityType e, std::size_t copy) -> EntityType {
+        if (e == entt::null) {
+            return e;
+        }
+        auto it = index_of.find(e);
+        if (it != index_of.end()) {
+            return copies[copy * ents.size() + it->second];
+        }
+        if (remap) {
+            return remap(e);
+        }
+        return same_registry ? e : EntityType(entt::null);
+    };
+
+    // Relation goes first so the scene graph links the copies before the
+    // other systems get to see them
+    clone_component<Relation>(src, ents, dst, copies, map_reference);
+    // never serialized, but the copies have to be deletable like the originals
+    clone_component<MarkDelete>(src, ents, dst, copies, map_reference);
+    clone_components(src, ents, dst, copies, map_reference, snapshot_components{});
+
+    return copies;
+}
+
+EntityType clone(Registry& reg, EntityType ent)
+{
+    const auto result = clone(reg, std::vector<EntityType>{ent}, reg);
+    return result.empty() ? EntityType(entt::null) : result.front();
+}
+
+bool deserialize(std::istream& stream, Registry& reg, std::vector<EntityType>& output) {
     assign_defaults assigner(output);
 
     reg.construction<Name>().connect<&assign_defaults::on_new_ent>(&assigner);
-    deserialize_t<cereal::iarchive_associative_t>(stream, reg);
+    bool result = true;
+    try {
+        if (is_binary_snapshot(stream)) {
+            binary_continuous_archive loader(stream, reg);
+            deserialize_t(loader, snapshot_components{});
+        } else {
+            cereal::iarchive_associative_t ar(stream);
+            continuous_archive loader(ar, reg);
+            deserialize_t(loader, snapshot_components{});
+        }
+    } catch (const cereal::Exception&) {
+        result = false;
+    }
     reg.construction<Name>().disconnect<&assign_defaults::on_new_ent>(&assigner);
+    return result;
 }
 
-void serialize(std::ostream& stream, const Registry& reg, const std::vector<EntityType>& ents) {
-    serialize_t<cereal::oarchive_associative_t>(stream, reg, ents);
+bool serialize(std::ostream& stream, const Registry& reg, const std::vector<EntityType>& ents,
+               snapshot_format format) {
+    try {
+        if (format == snapshot_format::binary) {
+            binary_output_archive snap(stream, reg, ents);
+            serialize_t(snap, snapshot_components{});
+            return snap.finish();
+        }
+
+        {
+            cereal::oarchive_associative_t ar(stream);
+            output_archive snap(ar, reg, ents);
+            serialize_t(snap, snapshot_components{});
+        }
+        return stream.good();
+    } catch (const cereal::Exception&) {
+        return false;
+    }
 }
 
 } // namespace ecs
@@ -1,10 +1,45 @@
 #pragma once
 
 #include <core/serialization/associative_archive.h>
+#include <core/serialization/binary_archive.h>
+#include <core/serialization/types/string.hpp>
 #include "runtime/ecs/ent.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
 namespace ecs {
 
+/// "ESNP", first word of a binary snapshot
+constexpr std::uint32_t binary_snapshot_magic = 0x504e5345;
+/// bump when the block layout changes, older files stay loadable
+/// 2: audio_source_component priority
+constexpr std::uint32_t binary_snapshot_version = 2;
+
+//-----------------------------------------------------------------------------
+//  Name : get_loading_snapshot_version ()
+/// <summary>
+/// Version of the binary snapshot the calling thread is loading, or
+/// binary_snapshot_version when it loads none. Lets components read the
+/// layouts older versions wrote.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::uint32_t get_loading_snapshot_version();
+std::uint32_t set_loading_snapshot_version(std::uint32_t version);
+
+enum class snapshot_format {
+    /// human readable, used for the editable source files
+    json,
+    /// compact per component blocks, used for compiled assets
+    binary
+};
+
 // template<typename Storage>
 class output_archive {
 public:
@@ -142,8 +177,222 @@ private:
 };
 
 
+/*----------  Binary Output Archive  ----------*/
+
+// Layout: magic, version, block count, a table of (name, byte size) and
+// then the blocks themselves. The first block holds the entities, every
+// other one the instances of a single component type. Each block gets its
+// own archive so cereal's pointer and version tracking never spans two of
+// them. Blocks are buffered until finish writes them out.
+class binary_output_archive {
+public:
+    binary_output_archive(std::ostream &stream, const Registry& reg)
+        : _stream{stream}, _reg(reg)
+    {
+        begin_block();
+        _reg.snapshot().entities(*this);
+        end_block("entities");
+    }
+
+    binary_output_archive(std::ostream &stream, const Registry& reg, const std::vector<EntityType>& ents)
+        : _stream{stream}, _ents(ents), _reg(reg)
+    {
+        begin_block();
+        _reg.snapshot().entities(*this);
+        end_block("entities");
+    }
+
+    // writes the header and the buffered blocks, returns false if the
+    // stream failed
+    bool finish() {
+        cereal::oarchive_binary_t storage(_stream);
+        storage(binary_snapshot_magic, binary_snapshot_version);
+        storage(static_cast<std::uint32_t>(_blocks.size()));
+        for (const auto& block : _blocks) {
+            storage(block.first, static_cast<std::uint64_t>(block.second.size()));
+        }
+        for (const auto& block : _blocks) {
+            _stream.write(block.second.data(), static_cast<std::streamsize>(block.second.size()));
+        }
+        _blocks.clear();
+        return _stream.good();
+    }
+
+    template<typename C>
+    void set(const char* s) {
+        if (_ents.size()) {
+            bool hasComp = false;
+            for (auto ent : _ents) {
+                if (_reg.has<C>(ent)) {
+                    hasComp = true;
+                    break;
+                }
+            }
+            if (hasComp) {
+                begin_block();
+                _reg.snapshot().component<C>(*this, _ents.begin(), _ents.end());
+                end_block(s);
+            }
+        } else {
+            if (_reg.view<const C>().size() > 0) {
+                begin_block();
+                _reg.snapshot().component<C>(*this);
+                end_block(s);
+            }
+        }
+    }
+
+    template<typename... Value>
+    void operator()(const Value &... value) {
+        ((*_block)(value), ...);
+    }
+
+private:
+    void begin_block() {
+        _buffer.str({});
+        _block = std::make_unique<cereal::oarchive_binary_t>(_buffer);
+    }
+
+    void end_block(const char* s) {
+        _block.reset();
+        _blocks.emplace_back(s, _buffer.str());
+    }
+
+    std::ostream &_stream;
+    std::vector<EntityType> _ents;
+    const Registry &_reg;
+    std::ostringstream _buffer;
+    std::unique_ptr<cereal::oarchive_binary_t> _block;
+    std::vector<std::pair<std::string, std::string>> _blocks;
+};
+
+/*----------  Binary Continuous Archive  ----------*/
+
+// Reads the layout written by binary_output_archive straight from the
+// stream, which has to be seekable. Blocks are found through the table so
+// they can be asked for in any order, the ones nobody asks for
+// (components unknown to this build) are never read.
+class binary_continuous_archive {
+public:
+    binary_continuous_archive(std::istream &stream, Registry& reg)
+        : _stream{stream}, _loader(reg)
+    {
+        cereal::iarchive_binary_t storage(_stream);
+        std::uint32_t magic{0};
+        std::uint32_t count{0};
+        storage(magic, _version);
+        if (magic != binary_snapshot_magic || _version > binary_snapshot_version) {
+            throw cereal::Exception("unsupported binary snapshot");
+        }
+        _version_scope.set(_version);
+
+        storage(count);
+        _blocks.resize(count);
+        for (auto& block : _blocks) {
+            storage(block.first, block.second);
+        }
+        _data_start = _stream.tellg();
+
+        if (seek("entities")) {
+            _loader.entities(*this);
+        }
+    }
+
+    template<typename C, typename... Type, typename... Member>
+    void get(const char* s, Member Type:: *... member) {
+        if (seek(s)) {
+            _loader.component<C>(*this, member...);
+        }
+    }
+
+    template<typename... Value>
+    void operator()(Value &... value) {
+        ((*_block)(value), ...);
+    }
+
+    std::uint32_t get_version() const {
+        return _version;
+    }
+
+private:
+    // the components read the version while the archive is alive
+    struct version_scope {
+        ~version_scope() {
+            if (active) {
+                set_loading_snapshot_version(previous);
+            }
+        }
+
+        void set(std::uint32_t version) {
+            previous = set_loading_snapshot_version(version);
+            active = true;
+        }
+
+        std::uint32_t previous{0};
+        bool active{false};
+    };
+
+    bool seek(const char* s) {
+        auto it = std::find_if(_blocks.begin(), _blocks.end(),
+                               [s](const auto& block) { return block.first == s; });
+        if (it == _blocks.end()) {
+            return false;
+        }
+
+        const auto target = static_cast<std::size_t>(std::distance(_blocks.begin(), it));
+        std::uint64_t offset = 0;
+        for (std::size_t i = 0; i < target; ++i) {
+            offset += _blocks[i].second;
+        }
+        _stream.seekg(_data_start + static_cast<std::streamoff>(offset));
+        _block = std::make_unique<cereal::iarchive_binary_t>(_stream);
+        return true;
+    }
+
+    std::istream &_stream;
+    entt::continuous_loader _loader;
+    std::unique_ptr<cereal::iarchive_binary_t> _block;
+    std::uint32_t _version{0};
+    version_scope _version_scope;
+    std::vector<std::pair<std::string, std::uint64_t>> _blocks;
+    std::streampos _data_start{0};
+};
+
+
+/// Maps an entity referenced from outside of the cloned set.
+using clone_remap_t = std::function<EntityType(EntityType)>;
+
+//-----------------------------------------------------------------------------
+//  Name : clone ()
+/// <summary>
+/// Copies the components of every entity in ents straight from src to new
+/// entities in dst, count times. References between the cloned entities
+/// (Relation::parent, bone entities) point to the copies. Other references
+/// go through remap, by default they are kept when cloning inside one
+/// registry and dropped otherwise. The pools of dst are reserved up front.
+/// Returns the copies in the order of ents, one full set after another.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::vector<EntityType> clone(const Registry& src, const std::vector<EntityType>& ents, Registry& dst,
+                              std::size_t count = 1, const clone_remap_t& remap = {});
 EntityType clone(Registry& reg, EntityType ent);
-void deserialize(std::istream& stream, Registry& reg, std::vector<EntityType>& output);
-void serialize(std::ostream& stream, const Registry& reg, const std::vector<EntityType>& ents);
+//-----------------------------------------------------------------------------
+//  Name : deserialize ()
+/// <summary>
+/// Loads a snapshot in either format, the binary one is recognized by its
+/// magic. The loaded entities are appended to output. Returns false if the
+/// data could not be read.
+/// </summary>
+//-----------------------------------------------------------------------------
+bool deserialize(std::istream& stream, Registry& reg, std::vector<EntityType>& output);
+//-----------------------------------------------------------------------------
+//  Name : serialize ()
+/// <summary>
+/// Writes the given entities, or the whole registry if ents is empty.
+/// Returns false if the stream could not be written.
+/// </summary>
+//-----------------------------------------------------------------------------
+bool serialize(std::ostream& stream, const Registry& reg, const std::vector<EntityType>& ents,
+               snapshot_format format = snapshot_format::json);
 
 }  // namespace ecs
@@ -7,6 +7,7 @@
 #include <core/serialization/serialization.h>
 #include <core/system/subsystem.h>
 #include <runtime/ecs/components/relation.h>
+#include <runtime/ecs/systems/scene_graph.h>
 #include "./snapshots.cpp"
 
 namespace ecs
@@ -39,13 +40,13 @@ static bool deserialize_t(std::istream& stream, std::vector<EntityType>& out_dat
 	{
 		// IArchive ar(stream);
 		auto& ecs = core::get_subsystem<SpatialSystem>();
-		deserialize(stream, ecs, out_data);
+		const bool result = deserialize(stream, ecs, out_data);
 		// try_load(ar, cereal::make_nvp("data", out_data));
 
 		stream.clear();
 		stream.seekg(0);
 		// runtime::get_serialization_map().clear();
-		return true;
+		return result;
 	}
 	return false;
 }
@@ -86,7 +87,14 @@ bool load_entities_from_file(const fs::path& full_path, std::vector<EntityType>&
 EntityType clone_entity(const EntityType data)
 {
 	auto& ecs = core::get_subsystem<SpatialSystem>();
-	return clone(ecs, data);
+	auto& sg = core::get_subsystem<runtime::scene_graph>();
+
+	// the whole subtree comes along, the copy stays under the same parent
+	std::vector<EntityType> subtree{data};
+	sg.for_each_descendant(data, [&subtree](EntityType e) { subtree.push_back(e); });
+
+	auto copies = clone(ecs, subtree, ecs);
+	return copies.empty() ? EntityType(entt::null) : copies.front();
 }
 
 bool deserialize_data(std::istream& stream, std::vector<EntityType>& out_data)
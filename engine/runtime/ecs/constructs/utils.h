@@ -12,6 +12,12 @@ namespace ecs
 namespace utils
 {
 
+//-----------------------------------------------------------------------------
+//  Name : clone_entity ()
+/// <summary>
+/// Copies the entity and its descendants, returns the copy of the entity.
+/// </summary>
+//-----------------------------------------------------------------------------
 EntityType clone_entity(const EntityType data);
 //-----------------------------------------------------------------------------
 //  Name : save_entity ()
@@ -0,0 +1,74 @@
+#include "animation_system.h"
+#include "../../rendering/mesh/mesh.h"
+#include "../../system/system_scheduler.h"
+#include "../components/animation_component.h"
+#include "../components/model_component.h"
+
+#include <core/system/subsystem.h>
+#include <core/tasks/parallel_for.hpp>
+
+namespace runtime
+{
+namespace
+{
+/// Characters animated by one task at least.
+constexpr std::size_t animate_grain = 4;
+}
+
+void animation_system::frame_update(delta_t dt)
+{
+	auto& ecs = core::get_subsystem<SpatialSystem>();
+	auto& ts = core::get_subsystem<core::task_system>();
+
+	entries_.clear();
+	ecs.view<animation_component, model_component>().each(
+		[this](EntityType, auto& animation_comp, auto& model_comp) {
+			entries_.push_back({&animation_comp, &model_comp});
+		});
+
+	core::parallel_for(ts, 0, entries_.size(),
+					   [this, dt](std::size_t i) {
+						   auto& animation_comp = *entries_[i].animation;
+						   auto& model_comp = *entries_[i].model;
+
+						   const auto& model = model_comp.get_model();
+						   auto mesh = model.get_lod(0);
+						   if(!mesh)
+							   return;
+
+						   const auto& skel = mesh->get_skeleton();
+						   if(skel.empty())
+							   return;
+
+						   auto& pose = model_comp.get_pose();
+						   if(!pose.is_bound_to(skel))
+						   {
+							   pose.reset(skel);
+						   }
+
+						   auto& player = animation_comp.get_player();
+						   if(animation_comp.is_playing())
+						   {
+							   player.update(dt);
+						   }
+						   player.evaluate(skel, pose);
+					   },
+					   animate_grain);
+}
+
+animation_system::animation_system()
+{
+	// the poses have to be written before the bones are resolved
+	auto& scheduler = core::get_subsystem<system_scheduler>();
+	scheduler.add_system("animation_system", this, &animation_system::frame_update)
+		.before("bone_system")
+		.writes<animation_component>()
+		.writes<model_component>();
+}
+
+animation_system::~animation_system()
+{
+	auto& scheduler = core::get_subsystem<system_scheduler>();
+	scheduler.remove_system("animation_system");
+}
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <core/common/basetypes.hpp>
+
+#include <vector>
+
+class animation_component;
+class model_component;
+
+namespace runtime
+{
+class animation_system
+{
+public:
+	animation_system();
+	~animation_system();
+	//-----------------------------------------------------------------------------
+	//  Name : frame_update (virtual )
+	/// <summary>
+	/// Advances the animation players and writes their poses into the
+	/// skeletons of the models. Entities are independent of each other and
+	/// are spread over the task_system workers.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void frame_update(delta_t dt);
+
+private:
+	struct entry
+	{
+		animation_component* animation = nullptr;
+		model_component* model = nullptr;
+	};
+
+	/// Animated entities of the current frame, kept for the storage.
+	std::vector<entry> entries_;
+};
+}
@@ -1,34 +1,148 @@
 #include "audio_system.h"
-#include "../../system/events.h"
+#include "../../system/system_scheduler.h"
 #include "../components/audio_listener_component.h"
 #include "../components/audio_source_component.h"
 #include "../components/transform_component.h"
 
+#include <core/audio/exception.h>
+#include <core/audio/source.h>
+#include <core/logging/logging.h>
 #include <core/system/subsystem.h>
+#include <core/tasks/parallel_for.hpp>
+
+#include <algorithm>
 
 namespace runtime
 {
 void audio_system::frame_update(delta_t dt)
 {
 	auto& ecs = core::get_subsystem<SpatialSystem>();
+	auto& ts = core::get_subsystem<core::task_system>();
 
-	ecs.view<transform_component, audio_source_component>().each(
-		[](EntityType e, auto& transform, auto& source) {
-			source.update(transform.get_transform());
-		});
+	bool has_listener = false;
+	math::vec3 listener_position{0.0f, 0.0f, 0.0f};
 	ecs.view<transform_component, audio_listener_component>().each(
-		[](EntityType e, auto& transform, auto& listener) {
+		[&](EntityType e, auto& transform, auto& listener) {
 			listener.update(transform.get_transform());
+			if(!has_listener)
+			{
+				listener_position = transform.get_transform().get_position();
+				has_listener = true;
+			}
 		});
+
+	voices_.clear();
+	emitters_.clear();
+	ecs.view<transform_component, audio_source_component>().each(
+		[this, dt](EntityType e, auto& transform, auto& source) {
+			source.update(transform.get_transform(), dt);
+
+			voice_manager::voice v;
+			v.position = source.get_position();
+			v.volume = source.get_volume();
+			v.rolloff = source.get_volume_rolloff();
+			v.range = source.get_range();
+			v.priority = source.get_priority();
+			v.playing = source.is_playing();
+			v.positional = source.is_positional();
+			v.real = source.is_real();
+			voices_.emplace_back(v);
+			emitters_.push_back(&source);
+		});
+
+	voice_manager_.update(listener_position, voices_);
+
+	// free the sources first so the promoted voices can reuse them
+	for(std::size_t i = 0; i < voices_.size(); ++i)
+	{
+		if(!voices_[i].real && emitters_[i]->is_real())
+		{
+			free_sources_.emplace_back(emitters_[i]->make_virtual());
+		}
+	}
+	for(std::size_t i = 0; i < voices_.size(); ++i)
+	{
+		if(voices_[i].real && !emitters_[i]->is_real())
+		{
+			auto source = acquire_source();
+			if(!source)
+			{
+				// the device has no more sources to give, stop asking for them
+				const auto is_real = [](const audio_source_component* emitter) { return emitter->is_real(); };
+				const auto real =
+					std::size_t(std::count_if(std::begin(emitters_), std::end(emitters_), is_real));
+				APPLOG_WARNING("Out of audio sources, limiting real voices to {0}", real);
+				voice_manager_.set_max_voices(real);
+				break;
+			}
+			emitters_[i]->make_real(std::move(source));
+		}
+	}
+
+	streams_.clear();
+	for(auto emitter : emitters_)
+	{
+		if(emitter->is_streaming())
+		{
+			streams_.push_back(emitter);
+		}
+	}
+
+	// every stream decodes into its own buffers
+	core::parallel_for(ts, 0, streams_.size(), [this](std::size_t i) { streams_[i]->update_stream(); }, 1);
+
+	// only the real voices reach the audio device
+	for(auto emitter : emitters_)
+	{
+		emitter->update_playback(dt);
+		emitter->update_source();
+	}
+}
+
+voice_manager& audio_system::get_voice_manager()
+{
+	return voice_manager_;
+}
+
+const voice_manager::stats& audio_system::get_voice_stats() const
+{
+	return voice_manager_.get_stats();
+}
+
+std::unique_ptr<audio::source> audio_system::acquire_source()
+{
+	if(!free_sources_.empty())
+	{
+		auto source = std::move(free_sources_.back());
+		free_sources_.pop_back();
+		return source;
+	}
+
+	try
+	{
+		return std::make_unique<audio::source>();
+	}
+	catch(const audio::exception&)
+	{
+		return nullptr;
+	}
 }
 
 audio_system::audio_system()
 {
-	on_frame_update.connect(this, &audio_system::frame_update);
+	// talks to the audio device
+	auto& scheduler = core::get_subsystem<system_scheduler>();
+	scheduler.add_system("audio_system", this, &audio_system::frame_update)
+		.reads<transform_component>()
+		.writes<audio_source_component>()
+		.writes<audio_listener_component>()
+		.after("transform_system")
+		.on_owner_thread();
 }
 
 audio_system::~audio_system()
 {
-	on_frame_update.disconnect(this, &audio_system::frame_update);
+	auto& scheduler = core::get_subsystem<system_scheduler>();
+	scheduler.remove_system("audio_system");
 }
 }
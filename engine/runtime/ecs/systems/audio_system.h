@@ -1,7 +1,19 @@
 #pragma once
 
+#include "../../audio/voice_manager.h"
+
 #include <core/common/basetypes.hpp>
 
+#include <memory>
+#include <vector>
+
+class audio_source_component;
+
+namespace audio
+{
+class source;
+}
+
 namespace runtime
 {
 class audio_system
@@ -12,11 +24,41 @@ public:
 	//-----------------------------------------------------------------------------
 	//  Name : frame_update (virtual )
 	/// <summary>
-	///
-	///
-	///
+	/// Moves the sources and listeners with their entities, gives the real
+	/// sources to the most audible voices and decodes the next chunks of the
+	/// streamed sounds, spread over the task_system workers.
 	/// </summary>
 	//-----------------------------------------------------------------------------
 	void frame_update(delta_t dt);
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_voice_manager ()
+	/// <summary>
+	/// The voice manager deciding which sources are real, for tuning the
+	/// number of real voices.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	voice_manager& get_voice_manager();
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_voice_stats ()
+	/// <summary>
+	/// Voice counts and steals of the last frame.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	const voice_manager::stats& get_voice_stats() const;
+
+private:
+	std::unique_ptr<audio::source> acquire_source();
+
+	voice_manager voice_manager_;
+	/// Voices of this frame, one per emitter, kept for the storage.
+	std::vector<voice_manager::voice> voices_;
+	/// Emitters of this frame, in the order of their voices.
+	std::vector<audio_source_component*> emitters_;
+	/// Sources playing a streamed sound this frame, kept for the storage.
+	std::vector<audio_source_component*> streams_;
+	/// Real sources no voice is using, reused before creating new ones.
+	std::vector<std::unique_ptr<audio::source>> free_sources_;
 };
 }
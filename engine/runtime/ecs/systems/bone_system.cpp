@@ -1,116 +1,149 @@
 #include "bone_system.h"
 #include "../../rendering/mesh/mesh.h"
-#include "../../system/events.h"
+#include "../../system/system_scheduler.h"
 #include "../components/model_component.h"
+#include "../components/relation.h"
 #include "../components/transform_component.h"
 #include <runtime/ecs/constructs/utils.h>
 #include <core/system/subsystem.h>
+#include <core/tasks/parallel_for.hpp>
 
 namespace runtime
 {
-
-void process_node(const std::unique_ptr<mesh::armature_node>& node, const skin_bind_data& bind_data,
-				  EntityType parent, std::vector<EntityType>& entity_nodes,
-				  SpatialSystem& ecs)
+namespace
 {
-	// if(!parent.valid())
-	// 	return;
-	auto factory = ecs::utils::get_default_ent_factory(ecs);
-	auto entity_node = factory.create();
-	// entity_node.set_name(node->name);
-
-	auto& transf_comp = ecs.assign<transform_component>(entity_node);
-	// transf_comp->set_parent(parent);
-	transf_comp.set_local_transform(node->local_transform);
-
-	auto bone = bind_data.find_bone_by_id(node->name);
-	if(bone)
-	{
-		entity_nodes.push_back(entity_node);
-	}
+/// Skeletons resolved by one task at least.
+constexpr std::size_t resolve_grain = 8;
+}
 
-	for(auto& child : node->children)
+static void release_bone_entities(model_component& model_comp, SpatialSystem& ecs)
+{
+	for(auto e : model_comp.get_bone_entities())
 	{
-		process_node(child, bind_data, entity_node, entity_nodes, ecs);
+		if(ecs.valid(e) && ecs.has<MarkDelete>(e))
+		{
+			ecs.get<MarkDelete>(e).markDelete();
+		}
 	}
+	model_comp.set_bone_entities({});
 }
 
-static std::vector<math::transform>
-get_transforms_for_bones(const std::vector<EntityType>& bone_entities)
+static void create_bone_entities(model_component& model_comp, const skeleton& skel, SpatialSystem& ecs)
 {
-	auto& ecs = core::get_subsystem<SpatialSystem>();
+	const auto& names = skel.get_names();
+	const auto& bone_nodes = skel.get_bone_nodes();
 
-	std::vector<math::transform> result;
-	if(!bone_entities.empty())
+	auto factory = ecs::utils::get_default_ent_factory(ecs);
+	std::vector<EntityType> bone_entities;
+	bone_entities.reserve(bone_nodes.size());
+	for(auto node : bone_nodes)
 	{
-		result.reserve(bone_entities.size());
-		for(const auto& e : bone_entities)
+		auto entity = factory.create();
+		if(node != skeleton::invalid_index)
 		{
-			// if(e.valid())
-			if (true)
-			{
-				const auto& bone_transform = ecs.get<transform_component>(e);
-				// if(!bone_transform.expired())
-				if (true)
-				{
-					result.emplace_back(bone_transform.get_transform());
-				}
-				else
-				{
-					result.emplace_back();
-				}
-			}
-			else
-			{
-				result.emplace_back();
-			}
+			ecs.get<Name>(entity).name = names[std::size_t(node)];
 		}
+		ecs.assign<transform_component>(entity);
+		bone_entities.emplace_back(entity);
 	}
-
-	return result;
+	model_comp.set_bone_entities(bone_entities);
 }
 
 void bone_system::frame_update(delta_t)
 {
 	auto& ecs = core::get_subsystem<SpatialSystem>();
-	ecs.view<model_component>().each([&ecs](EntityType e, auto& model_comp) {
+	auto& ts = core::get_subsystem<core::task_system>();
+
+	entries_.clear();
+	ecs.view<transform_component, model_component>().each(
+		[this](EntityType, auto& transform_comp, auto& model_comp) {
+			entries_.push_back({&transform_comp, &model_comp});
+		});
+
+	core::parallel_for(ts, 0, entries_.size(),
+					   [this](std::size_t i) {
+						   const auto& transform_comp = *entries_[i].transform;
+						   auto& model_comp = *entries_[i].model;
+
+						   const auto& model = model_comp.get_model();
+						   auto mesh = model.get_lod(0);
+
+						   // If mesh isnt loaded yet skip it.
+						   if(!mesh)
+							   return;
+
+						   const auto& skel = mesh->get_skeleton();
+						   if(!mesh->get_skin_bind_data().has_bones() || skel.empty())
+							   return;
+
+						   auto& pose = model_comp.get_pose();
+						   if(!pose.is_bound_to(skel))
+						   {
+							   pose.reset(skel);
+							   model_comp.set_static(false);
+						   }
+
+						   pose.compute_model_space(skel);
+						   pose.compute_bone_transforms(skel, transform_comp.get_transform());
+					   },
+					   resolve_grain);
+}
 
+void bone_system::sync_bone_entities(delta_t)
+{
+	auto& ecs = core::get_subsystem<SpatialSystem>();
+	ecs.view<model_component>().each([&ecs](EntityType, auto& model_comp) {
 		const auto& model = model_comp.get_model();
 		auto mesh = model.get_lod(0);
+		const auto& bone_transforms = model_comp.get_bone_transforms();
 
-		// If mesh isnt loaded yet skip it.
-		if(!mesh)
+		if(!model_comp.get_bone_entities_enabled() || !mesh || bone_transforms.empty())
+		{
+			if(!model_comp.get_bone_entities().empty())
+			{
+				release_bone_entities(model_comp, ecs);
+			}
 			return;
+		}
 
-		const auto& skin_data = mesh->get_skin_bind_data();
+		if(model_comp.get_bone_entities().size() != bone_transforms.size())
+		{
+			release_bone_entities(model_comp, ecs);
+			create_bone_entities(model_comp, mesh->get_skeleton(), ecs);
+		}
 
-		// Has skinning data?
-		if(skin_data.has_bones())
+		const auto& bone_entities = model_comp.get_bone_entities();
+		for(std::size_t i = 0; i < bone_entities.size(); ++i)
 		{
-			if(model_comp.get_bone_entities().size() <= 1)
+			const auto e = bone_entities[i];
+			if(ecs.valid(e) && ecs.has<transform_component>(e))
 			{
-				const auto& armature = mesh->get_armature();
-				std::vector<EntityType> be;
-				process_node(armature, skin_data, e, be, ecs);
-				model_comp.set_bone_entities(be);
-				model_comp.set_static(false);
+				ecs.get<transform_component>(e).set_transform(bone_transforms[i]);
 			}
-
-			const auto& bone_entities = model_comp.get_bone_entities();
-			auto transforms = get_transforms_for_bones(bone_entities);
-			model_comp.set_bone_transforms(std::move(transforms));
 		}
-
 	});
 }
 
 bone_system::bone_system()
 {
-	runtime::on_frame_update.connect(this, &bone_system::frame_update);
+	auto& scheduler = core::get_subsystem<system_scheduler>();
+	scheduler.add_system("bone_system", this, &bone_system::frame_update)
+		.reads<transform_component>()
+		.writes<model_component>();
+
+	// creates the bone entities so it can't overlap with anything
+	scheduler.add_system("bone_entity_system", this, &bone_system::sync_bone_entities)
+		.after("bone_system")
+		.writes<transform_component>()
+		.writes<model_component>()
+		.on_owner_thread()
+		.exclusive();
 }
 
 bone_system::~bone_system()
 {
-	runtime::on_frame_update.disconnect(this, &bone_system::frame_update);
+	auto& scheduler = core::get_subsystem<system_scheduler>();
+	scheduler.remove_system("bone_entity_system");
+	scheduler.remove_system("bone_system");
 }
 }
@@ -2,6 +2,11 @@
 
 #include <core/common/basetypes.hpp>
 
+#include <vector>
+
+class model_component;
+class transform_component;
+
 namespace runtime
 {
 class bone_system
@@ -12,11 +17,31 @@ public:
 	//-----------------------------------------------------------------------------
 	//  Name : frame_update (virtual )
 	/// <summary>
-	///
-	///
-	///
+	/// Resolves the skeleton pose of every skinned model into its bone
+	/// transforms. Works on the contiguous pose buffers of the models and
+	/// doesn't touch the registry layout, so the models are spread over the
+	/// task_system workers.
 	/// </summary>
 	//-----------------------------------------------------------------------------
 	void frame_update(delta_t dt);
+
+	//-----------------------------------------------------------------------------
+	//  Name : sync_bone_entities ()
+	/// <summary>
+	/// Creates, updates or releases the bone entities of the models that ask
+	/// for them.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void sync_bone_entities(delta_t dt);
+
+private:
+	struct entry
+	{
+		const transform_component* transform = nullptr;
+		model_component* model = nullptr;
+	};
+
+	/// Skinned entities of the current frame, kept for the storage.
+	std::vector<entry> entries_;
 };
 }
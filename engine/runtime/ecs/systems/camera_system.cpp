@@ -1,5 +1,5 @@
 #include "camera_system.h"
-#include "../../system/events.h"
+#include "../../system/system_scheduler.h"
 #include "../components/camera_component.h"
 #include "../components/transform_component.h"
 
@@ -19,11 +19,18 @@ void camera_system::frame_update(delta_t)
 
 camera_system::camera_system()
 {
-	on_frame_update.connect(this, &camera_system::frame_update);
+	// releases gpu resources of the render views
+	auto& scheduler = core::get_subsystem<system_scheduler>();
+	scheduler.add_system("camera_system", this, &camera_system::frame_update)
+		.reads<transform_component>()
+		.writes<camera_component>()
+		.after("transform_system")
+		.on_owner_thread();
 }
 
 camera_system::~camera_system()
 {
-	on_frame_update.disconnect(this, &camera_system::frame_update);
+	auto& scheduler = core::get_subsystem<system_scheduler>();
+	scheduler.remove_system("camera_system");
 }
 }
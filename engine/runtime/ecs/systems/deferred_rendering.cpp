@@ -11,6 +11,7 @@
 #include "../components/model_component.h"
 #include "../components/reflection_probe_component.h"
 #include "../components/transform_component.h"
+#include "transform_system.h"
 
 #include <core/graphics/index_buffer.h>
 #include <core/graphics/render_pass.h>
@@ -21,6 +22,34 @@
 
 namespace runtime
 {
+namespace
+{
+// interned once, the passes set these for every light and probe
+namespace uniforms
+{
+const gfx::uniform_id s_input("s_input");
+const gfx::uniform_id s_tex0("s_tex0");
+const gfx::uniform_id s_tex1("s_tex1");
+const gfx::uniform_id s_tex2("s_tex2");
+const gfx::uniform_id s_tex3("s_tex3");
+const gfx::uniform_id s_tex4("s_tex4");
+const gfx::uniform_id s_tex5("s_tex5");
+const gfx::uniform_id s_tex6("s_tex6");
+const gfx::uniform_id s_tex_cube("s_tex_cube");
+const gfx::uniform_id u_camera_clip_planes("u_camera_clip_planes");
+const gfx::uniform_id u_camera_position("u_camera_position");
+const gfx::uniform_id u_camera_wpos("u_camera_wpos");
+const gfx::uniform_id u_data0("u_data0");
+const gfx::uniform_id u_data1("u_data1");
+const gfx::uniform_id u_data2("u_data2");
+const gfx::uniform_id u_inv_world("u_inv_world");
+const gfx::uniform_id u_light_color_intensity("u_light_color_intensity");
+const gfx::uniform_id u_light_data("u_light_data");
+const gfx::uniform_id u_light_direction("u_light_direction");
+const gfx::uniform_id u_light_position("u_light_position");
+const gfx::uniform_id u_lod_params("u_lod_params");
+}
+}
 
 bool update_lod_data(lod_data& data, const std::vector<urange32_t>& lod_limits, std::size_t total_lods,
 					 float transition_time, float dt, asset_handle<mesh> mesh, const math::transform& world,
@@ -66,52 +95,26 @@ bool update_lod_data(lod_data& data, const std::vector<urange32_t>& lod_limits,
 	return true;
 }
 
-bool should_rebuild_reflections(visibility_set_models_t& visibility_set, const reflection_probe& probe)
+bool should_rebuild_reflections(const math::cull_batch& dirty_bounds, const reflection_probe& probe,
+								const math::transform& probe_transform)
 {
 
 	if(probe.method == reflect_method::environment)
 		return false;
 
-	auto& ecs = core::get_subsystem<SpatialSystem>();
-	for(auto e : visibility_set)
-	{
-		// auto& transform_comp_handle = std::get<1>(element);
-		// auto& model_comp_handle = std::get<2>(element);
-		// auto transform_comp_ptr = transform_comp_handle.lock();
-		// auto model_comp_ptr = model_comp_handle.lock();
-		// if(!transform_comp_ptr || !model_comp_ptr)
-		// 	continue;
-
-		// auto& transform_comp_ref = *transform_comp_ptr.get();
-		// auto& model_comp_ref = *model_comp_ptr.get();
-		// auto& transform_comp_ref = *transform_comp_ptr.get();
-		// auto& model_comp_ref = *model_comp_ptr.get();
-		const auto& transform_comp_ref = ecs.get<transform_component>(e);
-		const auto& model_comp_ref = ecs.get<model_component>(e);
-
-		const auto& model = model_comp_ref.get_model();
-		if(!model.is_valid())
-			continue;
-
-		const auto mesh = model.get_lod(0);
-
-		const auto& world_transform = transform_comp_ref.get_transform();
-
-		const auto& bounds = mesh->get_bounds();
-
-		bool result = false;
-
-		for(std::uint32_t i = 0; i < 6; ++i)
-		{
-			const auto& frustum = camera::get_face_camera(i, world_transform).get_frustum();
-			result |= math::frustum::test_obb(frustum, bounds, world_transform);
-		}
+	if(dirty_bounds.size() == 0)
+		return false;
 
-		if(result)
-			return true;
+	// Rebuild if any dirty model is seen by any of the cube faces.
+	std::vector<std::uint32_t> visibility;
+	dirty_bounds.test(camera::get_face_camera(0, probe_transform).get_frustum(), visibility);
+	for(std::uint32_t i = 1; i < 6; ++i)
+	{
+		const auto& frustum = camera::get_face_camera(i, probe_transform).get_frustum();
+		dirty_bounds.test_any(frustum, visibility);
 	}
 
-	return false;
+	return math::cull_batch::any_visible(visibility);
 }
 
 bool should_rebuild_shadows(visibility_set_models_t& visibility_set, const light&)
@@ -159,88 +162,213 @@ visibility_set_models_t deferred_rendering::gather_visible_models(SpatialSystem&
 																  bool require_reflection_caster /*= false*/)
 {
 	visibility_set_models_t result;
-	// chandle<transform_component> transform_comp_handle;
-	// chandle<model_component> model_comp_handle;
-	for(EntityType ent : ecs.view<transform_component, model_component>())
-	{
-		const auto& model_comp_ref = ecs.get<model_component>(ent);
-		const auto& transform_comp_ref = ecs.get<transform_component>(ent);
 
+	const auto filter = [&](const model_component& model_comp_ref,
+							const transform_component& transform_comp_ref) {
 		if(static_only && !model_comp_ref.is_static())
 		{
-			continue;
+			return false;
 		}
 
 		if(require_reflection_caster && !model_comp_ref.casts_reflection())
 		{
-			continue;
+			return false;
 		}
 
-		auto mesh = model_comp_ref.get_model().get_lod(0);
+		// Only dirty mesh components.
+		if(dirty_only && !transform_comp_ref.is_touched() && !model_comp_ref.is_touched())
+		{
+			return false;
+		}
 
-		// If mesh isnt loaded yet skip it.
-		if(!mesh)
-			continue;
+		return true;
+	};
 
-		if(camera)
+	if(camera == nullptr)
+	{
+		for(EntityType ent : ecs.view<transform_component, model_component>())
 		{
-			const auto& frustum = camera->get_frustum();
+			const auto& model_comp_ref = ecs.get<model_component>(ent);
+			const auto& transform_comp_ref = ecs.get<transform_component>(ent);
 
-			const auto& world_transform = transform_comp_ref.get_transform();
+			// If mesh isnt loaded yet skip it.
+			if(!model_comp_ref.get_model().get_lod(0))
+				continue;
 
-			const auto& bounds = mesh->get_bounds();
-
-			// Test the bounding box of the mesh
-			if(math::frustum::test_obb(frustum, bounds, world_transform))
+			if(filter(model_comp_ref, transform_comp_ref))
 			{
-				// Only dirty mesh components.
-				if(dirty_only)
-				{
-					if(transform_comp_ref.is_touched() || model_comp_ref.is_touched())
-					{
-						result.emplace_back(ent);
-					}
-				} // End if dirty_only
-				else
-				{
-					result.emplace_back(ent);
-				}
+				result.emplace_back(ent);
+			}
+		}
+		return result;
+	}
+
+	// Boxes straddling the frustum are collected and tested in one batch.
+	const auto& frustum = camera->get_frustum();
+	cull_batch_.clear();
+	cull_entities_.clear();
+	model_tree_.query(frustum, [&](std::uint32_t user_data, math::volume_query query) {
+		const auto ent = EntityType(user_data);
+		const auto& model_comp_ref = ecs.get<model_component>(ent);
+		const auto& transform_comp_ref = ecs.get<transform_component>(ent);
+
+		if(!filter(model_comp_ref, transform_comp_ref))
+		{
+			return;
+		}
+
+		auto mesh = model_comp_ref.get_model().get_lod(0);
+		if(!mesh)
+			return;
 
-			} // Enf if visble
+		if(query == math::volume_query::intersect)
+		{
+			cull_batch_.add_obb(mesh->get_bounds(), transform_comp_ref.get_transform());
+			cull_entities_.emplace_back(ent);
+			return;
 		}
-		else
+
+		result.emplace_back(ent);
+	});
+
+	cull_batch_.test(frustum, cull_visibility_);
+	for(std::size_t i = 0; i < cull_entities_.size(); ++i)
+	{
+		if(math::cull_batch::is_visible(cull_visibility_, i))
 		{
-			// Only dirty mesh components.
-			if(dirty_only)
-			{
-				if(transform_comp_ref.is_touched() || model_comp_ref.is_touched())
-				{
-					result.emplace_back(ent);
-				}
-			} // End if dirty_only
-			else
-			{
-				result.emplace_back(ent);
-			}
+			result.emplace_back(cull_entities_[i]);
 		}
 	}
+
 	return result;
 }
 
+void deferred_rendering::update_model_tree(SpatialSystem& ecs)
+{
+	// A swapped or reimported mesh has other bounds. Every proxy is checked
+	// since the stale box may be out of every frustum the tree is asked for.
+	std::vector<EntityType> removed;
+	for(const auto& entry : model_proxies_)
+	{
+		const auto e = entry.first;
+		if(!ecs.valid(e) || !ecs.has<model_component>(e))
+		{
+			removed.emplace_back(e);
+			continue;
+		}
+
+		const auto mesh = ecs.get<model_component>(e).get_model().get_lod(0);
+		if(mesh.get() != entry.second.source)
+		{
+			pending_models_.emplace_back(e);
+		}
+	}
+	for(auto e : removed)
+	{
+		remove_model_proxy(e);
+	}
+
+	for(auto e : core::get_subsystem<transform_system>().get_changed())
+	{
+		if(model_proxies_.count(e) != 0)
+		{
+			refit_model(ecs, e);
+		}
+	}
+
+	auto pending = std::move(pending_models_);
+	pending_models_.clear();
+	for(auto e : pending)
+	{
+		if(ecs.valid(e) && ecs.has<transform_component>(e) && ecs.has<model_component>(e))
+		{
+			refit_model(ecs, e);
+		}
+	}
+}
+
+void deferred_rendering::refit_model(SpatialSystem& ecs, EntityType e)
+{
+	const auto& model_comp_ref = ecs.get<model_component>(e);
+	const auto& transform_comp_ref = ecs.get<transform_component>(e);
+
+	auto mesh = model_comp_ref.get_model().get_lod(0);
+	if(!mesh)
+	{
+		// Try again once the mesh is loaded.
+		remove_model_proxy(e);
+		pending_models_.emplace_back(e);
+		return;
+	}
+
+	const auto bounds = math::bbox::mul(mesh->get_bounds(), transform_comp_ref.get_transform());
+	auto& proxy = model_proxies_[e];
+	if(proxy.proxy == math::bvh::null_node)
+	{
+		proxy.proxy = model_tree_.insert(bounds, std::uint32_t(e));
+	}
+	else
+	{
+		model_tree_.update(proxy.proxy, bounds);
+	}
+	proxy.source = mesh.get();
+}
+
+void deferred_rendering::remove_model_proxy(EntityType e)
+{
+	auto it = model_proxies_.find(e);
+	if(it == model_proxies_.end())
+	{
+		return;
+	}
+
+	if(it->second.proxy != math::bvh::null_node)
+	{
+		model_tree_.remove(it->second.proxy);
+	}
+	model_proxies_.erase(it);
+}
+
+void deferred_rendering::on_model_constructed(Registry&, EntityType e)
+{
+	pending_models_.emplace_back(e);
+}
+
+void deferred_rendering::on_transform_destroyed(Registry&, EntityType e)
+{
+	remove_model_proxy(e);
+}
+
 void deferred_rendering::frame_render(std::chrono::duration<float> dt)
 {
 	auto& ecs = core::get_subsystem<SpatialSystem>();
 
+	update_model_tree(ecs);
+
 	build_reflections_pass(ecs, dt);
 	build_shadows_pass(ecs, dt);
 	camera_pass(ecs, dt);
+
+	memory_report_ = frame_memory_report_;
+	frame_memory_report_ = {};
+	transient_pool_.end_frame();
 }
 
 void deferred_rendering::build_reflections_pass(SpatialSystem& ecs, std::chrono::duration<float> dt)
 {
 	auto dirty_models = gather_visible_models(ecs, nullptr, true, true, true);
+
+	// World bounds of the dirty models, shared by all probes.
+	math::cull_batch dirty_bounds;
+	dirty_bounds.reserve(dirty_models.size());
+	for(auto e : dirty_models)
+	{
+		const auto mesh = ecs.get<model_component>(e).get_model().get_lod(0);
+		dirty_bounds.add_obb(mesh->get_bounds(), ecs.get<transform_component>(e).get_transform());
+	}
+
 	ecs.view<transform_component, reflection_probe_component>().each(
-		[this, &ecs, dt, &dirty_models](EntityType ce, auto& transform_comp,
+		[this, &ecs, dt, &dirty_bounds](EntityType ce, auto& transform_comp,
 										auto& reflection_probe_comp) {
 			const auto& world_tranform = transform_comp.get_transform();
 			const auto& probe = reflection_probe_comp.get_probe();
@@ -251,7 +379,7 @@ void deferred_rendering::build_reflections_pass(SpatialSystem& ecs, std::chrono:
 			if(!transform_comp.is_touched() && !reflection_probe_comp.is_touched())
 			{
 				// If reflections shouldn't be rebuilt - continue.
-				should_rebuild = should_rebuild_reflections(dirty_models, probe);
+				should_rebuild = should_rebuild_reflections(dirty_bounds, probe, world_tranform);
 			}
 
 			if(!should_rebuild)
@@ -270,16 +398,26 @@ void deferred_rendering::build_reflections_pass(SpatialSystem& ecs, std::chrono:
 				if(probe.method != reflect_method::environment)
 					visibility_set = gather_visible_models(ecs, &camera, !should_rebuild, true, true);
 
-				std::shared_ptr<gfx::frame_buffer> output = nullptr;
-				output = g_buffer_pass(output, camera, render_view, visibility_set, camera_lods, dt);
-				output = lighting_pass(output, camera, render_view, ecs, dt);
-				output = atmospherics_pass(output, camera, render_view, ecs, dt);
-				output = tonemapping_pass(output, camera, render_view);
-
-				gfx::render_pass pass("cubemap_fill");
-				pass.touch();
-				gfx::blit(pass.id, cubemap_fbo->get_texture()->native_handle(), 0, 0, 0, std::uint16_t(i),
-						  output->get_texture()->native_handle());
+				// the face is copied into the cubemap right away, so all of its
+				// targets can come from the pool
+				gfx::frame_graph graph(transient_pool_);
+				deferred_resources res;
+				add_deferred_passes(graph, res, camera, render_view, ecs, visibility_set, camera_lods, dt,
+									false, true);
+
+				const auto cubemap = graph.import_texture("CUBEMAP", cubemap_fbo->get_texture());
+				graph.add_pass("cubemap_fill",
+							   [&](gfx::frame_graph::builder& builder) {
+								   builder.read(res.output);
+								   builder.write(cubemap);
+							   },
+							   [&](const gfx::frame_graph::resources& r) {
+								   gfx::render_pass pass("cubemap_fill");
+								   pass.touch();
+								   gfx::blit(pass.id, r.get_texture(cubemap)->native_handle(), 0, 0, 0,
+											 std::uint16_t(i), r.get_texture(res.output)->native_handle());
+							   });
+				execute_graph(graph);
 			}
 
 			gfx::render_pass pass("cubemap_generate_mips");
@@ -326,38 +464,197 @@ std::shared_ptr<gfx::frame_buffer> deferred_rendering::deferred_render_full(
 	camera& camera, gfx::render_view& render_view, SpatialSystem& ecs,
 	std::unordered_map<EntityType, lod_data>& camera_lods, std::chrono::duration<float> dt)
 {
-	std::shared_ptr<gfx::frame_buffer> output = nullptr;
-
 	auto visibility_set = gather_visible_models(ecs, &camera, false, false, false);
 
-	output = g_buffer_pass(output, camera, render_view, visibility_set, camera_lods, dt);
+	gfx::frame_graph graph(transient_pool_);
+	deferred_resources res;
+	add_deferred_passes(graph, res, camera, render_view, ecs, visibility_set, camera_lods, dt, true, false);
+	execute_graph(graph);
 
-	output = reflection_probe_pass(output, camera, render_view, ecs, dt);
+	return render_view.get_output_fbo(camera.get_viewport_size());
+}
 
-	output = lighting_pass(output, camera, render_view, ecs, dt);
+void deferred_rendering::add_deferred_passes(gfx::frame_graph& graph, deferred_resources& res, camera& camera,
+											 gfx::render_view& render_view, SpatialSystem& ecs,
+											 visibility_set_models_t& visibility_set,
+											 std::unordered_map<EntityType, lod_data>& camera_lods,
+											 std::chrono::duration<float> dt, bool reflection_probes,
+											 bool transient_targets)
+{
+	static auto format =
+		gfx::get_best_format(BGFX_CAPS_FORMAT_TEXTURE_FRAMEBUFFER,
+							 gfx::format_search_flags::four_channels | gfx::format_search_flags::requires_alpha);
+	static auto hdr_format = gfx::get_best_format(BGFX_CAPS_FORMAT_TEXTURE_FRAMEBUFFER,
+												  gfx::format_search_flags::four_channels |
+													  gfx::format_search_flags::requires_alpha |
+													  gfx::format_search_flags::half_precision_float);
+	static auto depth_format =
+		gfx::get_best_format(BGFX_CAPS_FORMAT_TEXTURE_FRAMEBUFFER, gfx::format_search_flags::requires_depth);
 
-	output = atmospherics_pass(output, camera, render_view, ecs, dt);
+	const auto& viewport_size = camera.get_viewport_size();
+	const auto make_desc = [&viewport_size](gfx::texture_format format) {
+		gfx::transient_texture_desc desc;
+		desc.width = std::uint16_t(viewport_size.width);
+		desc.height = std::uint16_t(viewport_size.height);
+		desc.format = format;
+		return desc;
+	};
+
+	// setup runs right away, execute only from execute_graph, after this
+	// function returned, so those capture what outlives it
+	graph.add_pass("g_buffer_fill",
+				   [&](gfx::frame_graph::builder& builder) {
+					   if(transient_targets)
+					   {
+						   res.depth = builder.create("DEPTH", make_desc(depth_format));
+					   }
+					   else
+					   {
+						   res.depth = builder.write(
+							   graph.import_texture("DEPTH", render_view.get_depth_buffer(viewport_size)));
+					   }
+
+					   // the editor shows the g-buffer after the frame, it can't be shared then
+					   if(render_view.get_retain_g_buffer())
+					   {
+						   const auto fbo = render_view.get_g_buffer_fbo(viewport_size);
+						   for(std::uint32_t i = 0; i < 4; ++i)
+						   {
+							   res.g_buffer[i] = builder.write(
+								   graph.import_texture("GBUFFER" + std::to_string(i), fbo->get_texture(i)));
+						   }
+					   }
+					   else
+					   {
+						   res.g_buffer[0] = builder.create("GBUFFER0", make_desc(format));
+						   res.g_buffer[1] = builder.create("GBUFFER1", make_desc(hdr_format));
+						   res.g_buffer[2] = builder.create("GBUFFER2", make_desc(format));
+						   res.g_buffer[3] = builder.create("GBUFFER3", make_desc(format));
+					   }
+				   },
+				   [this, &res, &camera, &visibility_set, &camera_lods, dt](const gfx::frame_graph::resources& r) {
+					   const auto fbo = r.get_fbo(
+						   {res.g_buffer[0], res.g_buffer[1], res.g_buffer[2], res.g_buffer[3], res.depth});
+					   g_buffer_pass(fbo.get(), camera, visibility_set, camera_lods, dt);
+				   });
+
+	graph.add_pass("refl_buffer_fill",
+				   [&](gfx::frame_graph::builder& builder) {
+					   res.refl_buffer = builder.create("RBUFFER", make_desc(hdr_format));
+					   if(reflection_probes)
+					   {
+						   for(auto id : res.g_buffer)
+						   {
+							   builder.read(id);
+						   }
+						   builder.read(res.depth);
+					   }
+				   },
+				   [this, &res, &camera, &ecs, reflection_probes](const gfx::frame_graph::resources& r) {
+					   const auto r_buffer_fbo = r.get_fbo({res.refl_buffer});
+					   if(reflection_probes)
+					   {
+						   const auto g_buffer_fbo = r.get_fbo(
+							   {res.g_buffer[0], res.g_buffer[1], res.g_buffer[2], res.g_buffer[3], res.depth});
+						   reflection_probe_pass(g_buffer_fbo.get(), r_buffer_fbo.get(), camera, ecs);
+					   }
+					   else
+					   {
+						   // probe faces don't see other probes
+						   gfx::render_pass pass("refl_buffer_clear");
+						   pass.bind(r_buffer_fbo.get());
+						   pass.clear(BGFX_CLEAR_COLOR, 0, 0.0f, 0);
+					   }
+				   });
+
+	graph.add_pass("light_buffer_fill",
+				   [&](gfx::frame_graph::builder& builder) {
+					   for(auto id : res.g_buffer)
+					   {
+						   builder.read(id);
+					   }
+					   builder.read(res.depth);
+					   builder.read(res.refl_buffer);
+					   res.light_buffer = builder.create("LBUFFER", make_desc(hdr_format));
+				   },
+				   [this, &res, &camera, &ecs](const gfx::frame_graph::resources& r) {
+					   const auto g_buffer_fbo = r.get_fbo(
+						   {res.g_buffer[0], res.g_buffer[1], res.g_buffer[2], res.g_buffer[3], res.depth});
+					   const auto l_buffer_fbo = r.get_fbo({res.light_buffer});
+					   lighting_pass(g_buffer_fbo.get(), r.get_texture(res.refl_buffer).get(), l_buffer_fbo.get(),
+									 camera, ecs);
+				   });
+
+	graph.add_pass("atmospherics_fill",
+				   [&](gfx::frame_graph::builder& builder) {
+					   builder.read(res.depth);
+					   builder.write(res.light_buffer);
+				   },
+				   [this, &res, &camera, &ecs](const gfx::frame_graph::resources& r) {
+					   const auto fbo = r.get_fbo({res.light_buffer, res.depth});
+					   atmospherics_pass(fbo.get(), camera, ecs);
+				   });
+
+	graph.add_pass("output_buffer_fill",
+				   [&](gfx::frame_graph::builder& builder) {
+					   builder.read(res.light_buffer);
+					   builder.read(res.depth);
+					   if(transient_targets)
+					   {
+						   res.output = builder.create("OUTPUT", make_desc(format));
+					   }
+					   else
+					   {
+						   res.output = builder.write(
+							   graph.import_texture("OUTPUT", render_view.get_output_buffer(viewport_size)));
+					   }
+				   },
+				   [this, &res, &camera](const gfx::frame_graph::resources& r) {
+					   const auto fbo = r.get_fbo({res.output, res.depth});
+					   tonemapping_pass(r.get_texture(res.light_buffer).get(), fbo.get(), camera);
+				   });
+}
+
+void deferred_rendering::execute_graph(gfx::frame_graph& graph)
+{
+	graph.compile();
+	graph.execute();
+
+	const auto& report = graph.get_memory_report();
+	frame_memory_report_.pass_count += report.pass_count;
+	frame_memory_report_.culled_pass_count += report.culled_pass_count;
+	frame_memory_report_.transient_count += report.transient_count;
+	frame_memory_report_.physical_count += report.physical_count;
+	frame_memory_report_.requested_bytes += report.requested_bytes;
+	frame_memory_report_.allocated_bytes += report.allocated_bytes;
+}
 
-	output = tonemapping_pass(output, camera, render_view);
+const gfx::frame_graph::memory_report& deferred_rendering::get_memory_report() const
+{
+	return memory_report_;
+}
 
-	return output;
+gfx::transient_texture_pool::stats deferred_rendering::get_transient_pool_stats() const
+{
+	return transient_pool_.get_stats();
 }
 
-std::shared_ptr<gfx::frame_buffer>
-deferred_rendering::g_buffer_pass(std::shared_ptr<gfx::frame_buffer> input, camera& camera,
-								  gfx::render_view& render_view, visibility_set_models_t& visibility_set,
-								  std::unordered_map<EntityType, lod_data>& camera_lods,
-								  std::chrono::duration<float> dt)
+void deferred_rendering::g_buffer_pass(gfx::frame_buffer* g_buffer_fbo, camera& camera,
+									   visibility_set_models_t& visibility_set,
+									   std::unordered_map<EntityType, lod_data>& camera_lods,
+									   std::chrono::duration<float> dt)
 {
 	auto& ecs = core::get_subsystem<SpatialSystem>();
 	const auto& view = camera.get_view();
 	const auto& proj = camera.get_projection();
-	const auto& viewport_size = camera.get_viewport_size();
-	auto g_buffer_fbo = render_view.get_g_buffer_fbo(viewport_size);
 	gfx::render_pass pass("g_buffer_fill");
 	pass.clear();
 	pass.set_view_proj(view, proj);
-	pass.bind(g_buffer_fbo.get());
+	pass.bind(g_buffer_fbo);
+
+	const auto camera_pos = camera.get_position();
+	const auto clip_planes = math::vec2(camera.get_near_clip(), camera.get_far_clip());
+	g_buffer_queue_.clear();
 
 	for(auto e : visibility_set)
 	{
@@ -379,7 +676,6 @@ deferred_rendering::g_buffer_pass(std::shared_ptr<gfx::frame_buffer> input, came
 			continue;
 
 		const auto& world_transform = transform_comp_ref.get_transform();
-		const auto clip_planes = math::vec2(camera.get_near_clip(), camera.get_far_clip());
 
 		auto& lod_data = camera_lods[e];
 		const auto transition_time = model.get_lod_transition_time();
@@ -402,55 +698,35 @@ deferred_rendering::g_buffer_pass(std::shared_ptr<gfx::frame_buffer> input, came
 
 		const auto& bone_transforms = model_comp_ref.get_bone_transforms();
 
-		model.render(pass.id, world_transform, bone_transforms, true, true, true, 0, current_lod_index,
-					 nullptr, [&camera, &clip_planes, &params](auto& p) {
-						 auto camera_pos = camera.get_position();
-						 p.set_uniform("u_camera_wpos", camera_pos);
-						 p.set_uniform("u_camera_clip_planes", clip_planes);
-						 p.set_uniform("u_lod_params", params);
-					 });
+		// front to back inside a batch, the key only keeps 16 bits of it
+		const auto depth = math::distance(camera_pos, world_transform.get_position()) / camera.get_far_clip();
+
+		g_buffer_queue_.push(model, current_lod_index, world_transform, bone_transforms, depth, params);
 
 		if(current_time != 0.0f)
 		{
-			model.render(
-				pass.id, world_transform, bone_transforms, true, true, true, 0, target_lod_index, nullptr,
-				[&params_inv](auto& p) { p.set_uniform("u_lod_params", params_inv); });
+			g_buffer_queue_.push(model, target_lod_index, world_transform, bone_transforms, depth, params_inv);
 		}
 	}
 
-	return g_buffer_fbo;
+	g_buffer_queue_.submit(pass.id, [&camera_pos, &clip_planes](gpu_program& p, const math::vec3& params) {
+		p.set_uniform(uniforms::u_camera_wpos, camera_pos);
+		p.set_uniform(uniforms::u_camera_clip_planes, clip_planes);
+		p.set_uniform(uniforms::u_lod_params, params);
+	});
 }
 
-std::shared_ptr<gfx::frame_buffer> deferred_rendering::lighting_pass(std::shared_ptr<gfx::frame_buffer> input,
-																	 camera& camera,
-																	 gfx::render_view& render_view,
-																	 SpatialSystem& ecs,
-																	 std::chrono::duration<float> dt)
+void deferred_rendering::lighting_pass(gfx::frame_buffer* g_buffer_fbo, gfx::texture* refl_buffer,
+									   gfx::frame_buffer* l_buffer_fbo, camera& camera, SpatialSystem& ecs)
 {
 	const auto& view = camera.get_view();
 	const auto& proj = camera.get_projection();
-
-	const auto& viewport_size = camera.get_viewport_size();
-	auto g_buffer_fbo = render_view.get_g_buffer_fbo(viewport_size).get();
-
-	static auto light_buffer_format = gfx::get_best_format(
-		BGFX_CAPS_FORMAT_TEXTURE_FRAMEBUFFER, gfx::format_search_flags::four_channels |
-												  gfx::format_search_flags::requires_alpha |
-												  gfx::format_search_flags::half_precision_float);
-
-	auto light_buffer = render_view.get_texture("LBUFFER", viewport_size.width, viewport_size.height, false,
-												1, light_buffer_format);
-	auto l_buffer_fbo = render_view.get_fbo("LBUFFER", {light_buffer});
 	const auto buffer_size = l_buffer_fbo->get_size();
 
 	gfx::render_pass pass("light_buffer_fill");
-	pass.bind(l_buffer_fbo.get());
+	pass.bind(l_buffer_fbo);
 	pass.set_view_proj(view, proj);
 	pass.clear(BGFX_CLEAR_COLOR, 0, 0.0f, 0);
-	auto refl_buffer =
-		render_view
-			.get_texture("RBUFFER", viewport_size.width, viewport_size.height, false, 1, light_buffer_format)
-			.get();
 
 	ecs.view<transform_component, light_component>().each(
 		[
@@ -474,7 +750,7 @@ std::shared_ptr<gfx::frame_buffer> deferred_rendering::lighting_pass(std::shared
 				// Draw light.
 				program = directional_light_program_.get();
 				program->begin();
-				program->set_uniform("u_light_direction", light_direction);
+				program->set_uniform(uniforms::u_light_direction, light_direction);
 			}
 			if(light.type == light_type::point && point_light_program_)
 			{
@@ -483,8 +759,8 @@ std::shared_ptr<gfx::frame_buffer> deferred_rendering::lighting_pass(std::shared
 				// Draw light.
 				program = point_light_program_.get();
 				program->begin();
-				program->set_uniform("u_light_position", light_position);
-				program->set_uniform("u_light_data", light_data);
+				program->set_uniform(uniforms::u_light_position, light_position);
+				program->set_uniform(uniforms::u_light_data, light_data);
 			}
 
 			if(light.type == light_type::spot && spot_light_program_)
@@ -497,9 +773,9 @@ std::shared_ptr<gfx::frame_buffer> deferred_rendering::lighting_pass(std::shared
 				// Draw light.
 				program = spot_light_program_.get();
 				program->begin();
-				program->set_uniform("u_light_position", light_position);
-				program->set_uniform("u_light_direction", light_direction);
-				program->set_uniform("u_light_data", light_data);
+				program->set_uniform(uniforms::u_light_position, light_position);
+				program->set_uniform(uniforms::u_light_direction, light_direction);
+				program->set_uniform(uniforms::u_light_data, light_data);
 			}
 
 			if(program)
@@ -507,15 +783,15 @@ std::shared_ptr<gfx::frame_buffer> deferred_rendering::lighting_pass(std::shared
 				float light_color_intensity[4] = {light.color.value.r, light.color.value.g,
 												  light.color.value.b, light.intensity};
 				auto camera_pos = camera.get_position();
-				program->set_uniform("u_light_color_intensity", light_color_intensity);
-				program->set_uniform("u_camera_position", camera_pos);
-				program->set_texture(0, "s_tex0", g_buffer_fbo->get_texture(0).get());
-				program->set_texture(1, "s_tex1", g_buffer_fbo->get_texture(1).get());
-				program->set_texture(2, "s_tex2", g_buffer_fbo->get_texture(2).get());
-				program->set_texture(3, "s_tex3", g_buffer_fbo->get_texture(3).get());
-				program->set_texture(4, "s_tex4", g_buffer_fbo->get_texture(4).get());
-				program->set_texture(5, "s_tex5", refl_buffer);
-				program->set_texture(6, "s_tex6", ibl_brdf_lut_.get());
+				program->set_uniform(uniforms::u_light_color_intensity, light_color_intensity);
+				program->set_uniform(uniforms::u_camera_position, camera_pos);
+				program->set_texture(0, uniforms::s_tex0, g_buffer_fbo->get_texture(0).get());
+				program->set_texture(1, uniforms::s_tex1, g_buffer_fbo->get_texture(1).get());
+				program->set_texture(2, uniforms::s_tex2, g_buffer_fbo->get_texture(2).get());
+				program->set_texture(3, uniforms::s_tex3, g_buffer_fbo->get_texture(3).get());
+				program->set_texture(4, uniforms::s_tex4, g_buffer_fbo->get_texture(4).get());
+				program->set_texture(5, uniforms::s_tex5, refl_buffer);
+				program->set_texture(6, uniforms::s_tex6, ibl_brdf_lut_.get());
 
 				gfx::set_scissor(rect.left, rect.top, rect.width(), rect.height());
 				auto topology = gfx::clip_quad(1.0f);
@@ -526,33 +802,17 @@ std::shared_ptr<gfx::frame_buffer> deferred_rendering::lighting_pass(std::shared
 				program->end();
 			}
 		});
-
-	return l_buffer_fbo;
 }
 
-std::shared_ptr<gfx::frame_buffer>
-deferred_rendering::reflection_probe_pass(std::shared_ptr<gfx::frame_buffer> input, camera& camera,
-										  gfx::render_view& render_view, SpatialSystem& ecs,
-										  std::chrono::duration<float> dt)
+void deferred_rendering::reflection_probe_pass(gfx::frame_buffer* g_buffer_fbo, gfx::frame_buffer* r_buffer_fbo,
+											   camera& camera, SpatialSystem& ecs)
 {
 	const auto& view = camera.get_view();
 	const auto& proj = camera.get_projection();
-
-	const auto& viewport_size = camera.get_viewport_size();
-	auto g_buffer_fbo = render_view.get_g_buffer_fbo(viewport_size).get();
-
-	static auto refl_buffer_format = gfx::get_best_format(BGFX_CAPS_FORMAT_TEXTURE_FRAMEBUFFER,
-														  gfx::format_search_flags::four_channels |
-															  gfx::format_search_flags::requires_alpha |
-															  gfx::format_search_flags::half_precision_float);
-
-	auto refl_buffer = render_view.get_texture("RBUFFER", viewport_size.width, viewport_size.height, false, 1,
-											   refl_buffer_format);
-	auto r_buffer_fbo = render_view.get_fbo("RBUFFER", {refl_buffer});
-	const auto buffer_size = refl_buffer->get_size();
+	const auto buffer_size = r_buffer_fbo->get_size();
 
 	gfx::render_pass pass("refl_buffer_fill");
-	pass.bind(r_buffer_fbo.get());
+	pass.bind(r_buffer_fbo);
 	pass.set_view_proj(view, proj);
 	pass.clear(BGFX_CLEAR_COLOR, 0, 0.0f, 0);
 	ecs.view<transform_component, reflection_probe_component>().each(
@@ -589,8 +849,8 @@ deferred_rendering::reflection_probe_pass(std::shared_ptr<gfx::frame_buffer> inp
 
 				program = box_ref_probe_program_.get();
 				program->begin();
-				program->set_uniform("u_inv_world", math::value_ptr(u_inv_world));
-				program->set_uniform("u_data2", data2);
+				program->set_uniform(uniforms::u_inv_world, math::value_ptr(u_inv_world));
+				program->set_uniform(uniforms::u_data2, data2);
 
 				influence_radius = math::length(t.get_scale() + probe.box_data.transition_distance);
 			}
@@ -607,15 +867,15 @@ deferred_rendering::reflection_probe_pass(std::shared_ptr<gfx::frame_buffer> inp
 
 				float data1[4] = {mips, 0.0f, 0.0f, 0.0f};
 
-				program->set_uniform("u_data0", data0);
-				program->set_uniform("u_data1", data1);
+				program->set_uniform(uniforms::u_data0, data0);
+				program->set_uniform(uniforms::u_data1, data1);
 
-				program->set_texture(0, "s_tex0", g_buffer_fbo->get_texture(0).get());
-				program->set_texture(1, "s_tex1", g_buffer_fbo->get_texture(1).get());
-				program->set_texture(2, "s_tex2", g_buffer_fbo->get_texture(2).get());
-				program->set_texture(3, "s_tex3", g_buffer_fbo->get_texture(3).get());
-				program->set_texture(4, "s_tex4", g_buffer_fbo->get_texture(4).get());
-				program->set_texture(5, "s_tex_cube", cubemap.get());
+				program->set_texture(0, uniforms::s_tex0, g_buffer_fbo->get_texture(0).get());
+				program->set_texture(1, uniforms::s_tex1, g_buffer_fbo->get_texture(1).get());
+				program->set_texture(2, uniforms::s_tex2, g_buffer_fbo->get_texture(2).get());
+				program->set_texture(3, uniforms::s_tex3, g_buffer_fbo->get_texture(3).get());
+				program->set_texture(4, uniforms::s_tex4, g_buffer_fbo->get_texture(4).get());
+				program->set_texture(5, uniforms::s_tex_cube, cubemap.get());
 				gfx::set_scissor(rect.left, rect.top, rect.width(), rect.height());
 				auto topology = gfx::clip_quad(1.0f);
 				gfx::set_state(topology | BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A | BGFX_STATE_BLEND_ALPHA);
@@ -624,32 +884,17 @@ deferred_rendering::reflection_probe_pass(std::shared_ptr<gfx::frame_buffer> inp
 				program->end();
 			}
 		});
-
-	return r_buffer_fbo;
 }
 
-std::shared_ptr<gfx::frame_buffer>
-deferred_rendering::atmospherics_pass(std::shared_ptr<gfx::frame_buffer> input, camera& camera,
-									  gfx::render_view& render_view, SpatialSystem& ecs,
-									  std::chrono::duration<float> dt)
+void deferred_rendering::atmospherics_pass(gfx::frame_buffer* l_buffer_fbo, camera& camera, SpatialSystem& ecs)
 {
 	auto far_clip_cache = camera.get_far_clip();
 	camera.set_far_clip(10000.0f);
 	const auto& view = camera.get_view();
 	const auto& proj = camera.get_projection();
 	camera.set_far_clip(far_clip_cache);
-	const auto& viewport_size = camera.get_viewport_size();
-
-	static auto light_buffer_format = gfx::get_best_format(
-		BGFX_CAPS_FORMAT_TEXTURE_FRAMEBUFFER, gfx::format_search_flags::four_channels |
-												  gfx::format_search_flags::requires_alpha |
-												  gfx::format_search_flags::half_precision_float);
-
-	auto light_buffer = render_view.get_texture("LBUFFER", viewport_size.width, viewport_size.height, false,
-												1, light_buffer_format, gfx::get_default_rt_sampler_flags());
-	input = render_view.get_fbo("LBUFFER", {light_buffer, render_view.get_depth_buffer(viewport_size)});
 
-	const auto surface = input.get();
+	const auto surface = l_buffer_fbo;
 	const auto output_size = surface->get_size();
 	gfx::render_pass pass("atmospherics_fill");
 	pass.set_view_proj(view, proj);
@@ -678,7 +923,7 @@ deferred_rendering::atmospherics_pass(std::shared_ptr<gfx::frame_buffer> input,
 			});
 
 		atmospherics_program_->begin();
-		atmospherics_program_->set_uniform("u_light_direction", light_direction);
+		atmospherics_program_->set_uniform(uniforms::u_light_direction, light_direction);
 
 		irect32_t rect(0, 0, irect32_t::value_type(output_size.width),
 					   irect32_t::value_type(output_size.height));
@@ -690,30 +935,25 @@ deferred_rendering::atmospherics_pass(std::shared_ptr<gfx::frame_buffer> input,
 		gfx::set_state(BGFX_STATE_DEFAULT);
 		atmospherics_program_->end();
 	}
-
-	return input;
 }
 
-std::shared_ptr<gfx::frame_buffer>
-deferred_rendering::tonemapping_pass(std::shared_ptr<gfx::frame_buffer> input, camera& camera,
-									 gfx::render_view& render_view)
+void deferred_rendering::tonemapping_pass(gfx::texture* input, gfx::frame_buffer* output_fbo, camera& camera)
 {
-	if(!input)
-		return nullptr;
+	if(input == nullptr)
+		return;
 
-	const auto& viewport_size = camera.get_viewport_size();
-	const auto surface = render_view.get_output_fbo(viewport_size);
+	const auto surface = output_fbo;
 	const auto output_size = surface->get_size();
 	const auto& view = camera.get_view();
 	const auto& proj = camera.get_projection();
 	gfx::render_pass pass("output_buffer_fill");
 	pass.set_view_proj(view, proj);
-	pass.bind(surface.get());
+	pass.bind(surface);
 
 	if(surface && gamma_correction_program_)
 	{
 		gamma_correction_program_->begin();
-		gamma_correction_program_->set_texture(0, "s_input", input->get_texture().get());
+		gamma_correction_program_->set_texture(0, uniforms::s_input, input);
 		irect32_t rect(0, 0, irect32_t::value_type(output_size.width),
 					   irect32_t::value_type(output_size.height));
 		gfx::set_scissor(rect.left, rect.top, rect.width(), rect.height());
@@ -723,12 +963,12 @@ deferred_rendering::tonemapping_pass(std::shared_ptr<gfx::frame_buffer> input, c
 		gfx::set_state(BGFX_STATE_DEFAULT);
 		gamma_correction_program_->end();
 	}
-
-	return surface;
 }
 
 void deferred_rendering::receive(Registry& reg, EntityType e)
 {
+	remove_model_proxy(e);
+
 	lod_data_.erase(e);
 	for(auto& pair : lod_data_)
 	{
@@ -739,6 +979,11 @@ deferred_rendering::deferred_rendering()
 {
 	auto& ecs = core::get_subsystem<SpatialSystem>();
 	ecs.destruction<model_component>().connect<&deferred_rendering::receive>(this);
+	ecs.construction<model_component>().connect<&deferred_rendering::on_model_constructed>(this);
+	ecs.construction<transform_component>().connect<&deferred_rendering::on_model_constructed>(this);
+	ecs.destruction<transform_component>().connect<&deferred_rendering::on_transform_destroyed>(this);
+	ecs.view<transform_component, model_component>().each(
+		[this](EntityType e, auto&, auto&) { pending_models_.emplace_back(e); });
 	on_frame_render.connect(this, &deferred_rendering::frame_render);
 
 	auto& ts = core::get_subsystem<core::task_system>();
@@ -817,6 +1062,9 @@ deferred_rendering::~deferred_rendering()
 {
 	auto& ecs = core::get_subsystem<SpatialSystem>();
 	ecs.destruction<model_component>().disconnect<&deferred_rendering::receive>(this);
+	ecs.construction<model_component>().disconnect<&deferred_rendering::on_model_constructed>(this);
+	ecs.construction<transform_component>().disconnect<&deferred_rendering::on_model_constructed>(this);
+	ecs.destruction<transform_component>().disconnect<&deferred_rendering::on_transform_destroyed>(this);
 	on_frame_render.disconnect(this, &deferred_rendering::frame_render);
 }
 }
@@ -1,11 +1,15 @@
 #pragma once
 
 #include "../../rendering/gpu_program.h"
+#include "../../rendering/render_queue.h"
 #include "../components/model_component.h"
 #include "../components/transform_component.h"
 #include "runtime/ecs/ent.h"
 
 #include <core/common/basetypes.hpp>
+#include <core/graphics/frame_graph.h>
+#include <core/math/bvh.h>
+#include <core/math/frustum_cull.h>
 
 #include <chrono>
 #include <memory>
@@ -13,6 +17,7 @@
 #include <vector>
 
 class camera;
+class mesh;
 
 namespace gfx
 {
@@ -41,9 +46,9 @@ public:
 	//-----------------------------------------------------------------------------
 	//  Name : gather_visible_models ()
 	/// <summary>
-	///
-	///
-	///
+	/// Collects the models passing the filters. With a camera only the models
+	/// found in the bounds tree are considered, subtrees fully inside the
+	/// frustum skip the per model test.
 	/// </summary>
 	//-----------------------------------------------------------------------------
 	visibility_set_models_t gather_visible_models(SpatialSystem& ecs, camera* camera,
@@ -69,6 +74,15 @@ public:
 	//-----------------------------------------------------------------------------
 	void receive(Registry& reg, EntityType e);
 
+	//-----------------------------------------------------------------------------
+	//  Name : update_model_tree ()
+	/// <summary>
+	/// Refits the world bounds of the models whose transform or mesh changed
+	/// this frame and indexes the ones waiting for their mesh.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void update_model_tree(SpatialSystem& ecs);
+
 	//-----------------------------------------------------------------------------
 	//  Name : build_reflections ()
 	/// <summary>
@@ -102,9 +116,9 @@ public:
 	//-----------------------------------------------------------------------------
 	//  Name : scene_pass ()
 	/// <summary>
-	///
-	///
-	///
+	/// Renders the view through a frame graph of the deferred passes. The
+	/// depth and output buffers are owned by the render view, everything
+	/// else is borrowed from the transient pool.
 	/// </summary>
 	//-----------------------------------------------------------------------------
 	std::shared_ptr<gfx::frame_buffer> deferred_render_full(camera& camera, gfx::render_view& render_view,
@@ -120,11 +134,8 @@ public:
 	///
 	/// </summary>
 	//-----------------------------------------------------------------------------
-	std::shared_ptr<gfx::frame_buffer> g_buffer_pass(std::shared_ptr<gfx::frame_buffer> input, camera& camera,
-													 gfx::render_view& render_view,
-													 visibility_set_models_t& visibility_set,
-													 std::unordered_map<EntityType, lod_data>& camera_lods,
-													 delta_t dt);
+	void g_buffer_pass(gfx::frame_buffer* g_buffer_fbo, camera& camera, visibility_set_models_t& visibility_set,
+					   std::unordered_map<EntityType, lod_data>& camera_lods, delta_t dt);
 
 	//-----------------------------------------------------------------------------
 	//  Name : lighting_pass ()
@@ -134,9 +145,8 @@ public:
 	///
 	/// </summary>
 	//-----------------------------------------------------------------------------
-	std::shared_ptr<gfx::frame_buffer> lighting_pass(std::shared_ptr<gfx::frame_buffer> input, camera& camera,
-													 gfx::render_view& render_view,
-													 SpatialSystem& ecs, delta_t dt);
+	void lighting_pass(gfx::frame_buffer* g_buffer_fbo, gfx::texture* refl_buffer, gfx::frame_buffer* l_buffer_fbo,
+					   camera& camera, SpatialSystem& ecs);
 
 	//-----------------------------------------------------------------------------
 	//  Name : reflection_probe ()
@@ -146,9 +156,8 @@ public:
 	///
 	/// </summary>
 	//-----------------------------------------------------------------------------
-	std::shared_ptr<gfx::frame_buffer> reflection_probe_pass(std::shared_ptr<gfx::frame_buffer> input,
-															 camera& camera, gfx::render_view& render_view,
-															 SpatialSystem& ecs, delta_t dt);
+	void reflection_probe_pass(gfx::frame_buffer* g_buffer_fbo, gfx::frame_buffer* r_buffer_fbo, camera& camera,
+							   SpatialSystem& ecs);
 
 	//-----------------------------------------------------------------------------
 	//  Name : atmospherics_pass ()
@@ -158,9 +167,7 @@ public:
 	///
 	/// </summary>
 	//-----------------------------------------------------------------------------
-	std::shared_ptr<gfx::frame_buffer> atmospherics_pass(std::shared_ptr<gfx::frame_buffer> input,
-														 camera& camera, gfx::render_view& render_view,
-														 SpatialSystem& ecs, delta_t dt);
+	void atmospherics_pass(gfx::frame_buffer* l_buffer_fbo, camera& camera, SpatialSystem& ecs);
 
 	//-----------------------------------------------------------------------------
 	//  Name : tonemapping_pass ()
@@ -170,11 +177,88 @@ public:
 	///
 	/// </summary>
 	//-----------------------------------------------------------------------------
-	std::shared_ptr<gfx::frame_buffer> tonemapping_pass(std::shared_ptr<gfx::frame_buffer> input,
-														camera& camera, gfx::render_view& render_view);
+	void tonemapping_pass(gfx::texture* input, gfx::frame_buffer* output_fbo, camera& camera);
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_memory_report ()
+	/// <summary>
+	/// Transient render target use of the frame graphs of the last frame,
+	/// summed over all views and probe faces.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	const gfx::frame_graph::memory_report& get_memory_report() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_transient_pool_stats ()
+	/// <summary>
+	/// Render targets currently owned by the transient pool.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	gfx::transient_texture_pool::stats get_transient_pool_stats() const;
 
 private:
+	struct model_proxy
+	{
+		math::bvh::proxy_t proxy = math::bvh::null_node;
+		/// Mesh the bounds were taken from, a different one means the model changed.
+		const mesh* source = nullptr;
+	};
+
+	void on_model_constructed(Registry& reg, EntityType e);
+	void on_transform_destroyed(Registry& reg, EntityType e);
+	void remove_model_proxy(EntityType e);
+	void refit_model(SpatialSystem& ecs, EntityType e);
+
+	/// Resources of the deferred passes in a frame graph.
+	struct deferred_resources
+	{
+		gfx::frame_graph::resource_id depth = 0;
+		gfx::frame_graph::resource_id g_buffer[4] = {};
+		gfx::frame_graph::resource_id refl_buffer = 0;
+		gfx::frame_graph::resource_id light_buffer = 0;
+		gfx::frame_graph::resource_id output = 0;
+	};
+
+	//-----------------------------------------------------------------------------
+	//  Name : add_deferred_passes ()
+	/// <summary>
+	/// Declares the deferred passes in the graph. With transient targets the
+	/// depth and output buffers come from the pool too, which is what the
+	/// probe faces use since their output is copied into the cubemap.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void add_deferred_passes(gfx::frame_graph& graph, deferred_resources& res, camera& camera,
+							 gfx::render_view& render_view, SpatialSystem& ecs,
+							 visibility_set_models_t& visibility_set,
+							 std::unordered_map<EntityType, lod_data>& camera_lods, delta_t dt,
+							 bool reflection_probes, bool transient_targets);
+
+	//-----------------------------------------------------------------------------
+	//  Name : execute_graph ()
+	/// <summary>
+	/// Compiles and runs the graph and adds it to the memory report.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void execute_graph(gfx::frame_graph& graph);
+
 	std::unordered_map<EntityType, std::unordered_map<EntityType, lod_data>> lod_data_;
+	/// World bounds of the indexed models.
+	math::bvh model_tree_;
+	/// Tree proxy of every indexed model.
+	std::unordered_map<EntityType, model_proxy> model_proxies_;
+	/// Models to index or refit next frame, their mesh may still be loading.
+	std::vector<EntityType> pending_models_;
+	/// Scratch space for batch culling the models the tree can't decide on.
+	math::cull_batch cull_batch_;
+	std::vector<EntityType> cull_entities_;
+	std::vector<std::uint32_t> cull_visibility_;
+	/// Draws of the g-buffer pass, reused every frame.
+	render_queue g_buffer_queue_;
+	/// Render targets shared by the frame graphs of all views.
+	gfx::transient_texture_pool transient_pool_;
+	/// Memory report being summed up this frame and the one of the last frame.
+	gfx::frame_graph::memory_report frame_memory_report_;
+	gfx::frame_graph::memory_report memory_report_;
 	/// Program that is responsible for rendering.
 	std::unique_ptr<gpu_program> directional_light_program_;
 	/// Program that is responsible for rendering.
@@ -1,5 +1,5 @@
 #include "reflection_probe_system.h"
-#include "../../system/events.h"
+#include "../../system/system_scheduler.h"
 #include "../components/reflection_probe_component.h"
 
 #include <core/system/subsystem.h>
@@ -16,11 +16,15 @@ void reflection_probe_system::frame_update(delta_t dt)
 
 reflection_probe_system::reflection_probe_system()
 {
-	on_frame_update.connect(this, &reflection_probe_system::frame_update);
+	auto& scheduler = core::get_subsystem<system_scheduler>();
+	scheduler.add_system("reflection_probe_system", this, &reflection_probe_system::frame_update)
+		.writes<reflection_probe_component>()
+		.on_owner_thread();
 }
 
 reflection_probe_system::~reflection_probe_system()
 {
-	on_frame_update.disconnect(this, &reflection_probe_system::frame_update);
+	auto& scheduler = core::get_subsystem<system_scheduler>();
+	scheduler.remove_system("reflection_probe_system");
 }
 }
@@ -1,36 +1,253 @@
 #include "scene_graph.h"
-#include "../../system/events.h"
 #include "../components/transform_component.h"
 #include "../components/relation.h"
 
+#include <core/common/assert.hpp>
 #include <core/system/subsystem.h>
 
 namespace runtime
 {
+namespace
+{
+std::size_t index_of(EntityType e)
+{
+	return static_cast<std::size_t>(e & entt::entt_traits<EntityType>::entity_mask);
+}
+}
 
-void scene_graph::frame_update(delta_t dt)
+bool scene_graph::set_parent(EntityType e, EntityType parent)
 {
 	auto& ecs = core::get_subsystem<SpatialSystem>();
-	roots_.clear();
+	expects(ecs.has<Relation>(e));
+	expects(parent == entt::null || ecs.valid(parent));
+
+	if(parent == e || (parent != entt::null && is_ancestor(e, parent)))
+	{
+		return false;
+	}
+
+	ecs.get<Relation>(e).parent = parent;
+	if(get_parent(e) == parent)
+	{
+		return true;
+	}
+
+	unlink(e);
+	link(e, parent);
+	version_++;
+	return true;
+}
+
+EntityType scene_graph::get_parent(EntityType e) const
+{
+	const auto n = find(e);
+	return n ? n->parent : entt::null;
+}
+
+EntityType scene_graph::get_first_child(EntityType e) const
+{
+	const auto n = find(e);
+	return n ? n->first_child : entt::null;
+}
+
+EntityType scene_graph::get_next_sibling(EntityType e) const
+{
+	const auto n = find(e);
+	return n ? n->next_sibling : entt::null;
+}
+
+std::vector<EntityType> scene_graph::get_roots() const
+{
+	std::vector<EntityType> roots;
+	roots.reserve(root_count_);
+	for_each_root([&roots](EntityType root) { roots.push_back(root); });
+	return roots;
+}
+
+void scene_graph::on_relation_constructed(Registry& reg, EntityType e)
+{
+	acquire(e).tracked = true;
+
+	// loaded data may point to a dead entity or close a loop
+	auto& relation = reg.get<Relation>(e);
+	if(relation.parent != entt::null &&
+	   (!reg.valid(relation.parent) || relation.parent == e || is_ancestor(e, relation.parent)))
+	{
+		relation.parent = entt::null;
+	}
+
+	link(e, relation.parent);
+	version_++;
+}
+
+void scene_graph::on_relation_destroyed(Registry&, EntityType e)
+{
+	auto n = find(e);
+	if(n == nullptr)
+	{
+		return;
+	}
+
+	if(n->tracked)
+	{
+		unlink(e);
+	}
+	orphan_children(*n);
+	*n = node{};
+	version_++;
+}
+
+scene_graph::node* scene_graph::find(EntityType e)
+{
+	const auto idx = index_of(e);
+	if(e == entt::null || idx >= nodes_.size() || nodes_[idx].entity != e)
+	{
+		return nullptr;
+	}
+	return &nodes_[idx];
+}
+
+const scene_graph::node* scene_graph::find(EntityType e) const
+{
+	const auto idx = index_of(e);
+	if(e == entt::null || idx >= nodes_.size() || nodes_[idx].entity != e)
+	{
+		return nullptr;
+	}
+	return &nodes_[idx];
+}
+
+scene_graph::node& scene_graph::acquire(EntityType e)
+{
+	const auto idx = index_of(e);
+	if(idx >= nodes_.size())
+	{
+		nodes_.resize(idx + 1);
+	}
 
-	auto view = ecs.view<Relation>();
-	for (auto ent : view) {
-		const auto& relation = view.get(ent);
-		if (relation.parent == entt::null) {
-			roots_.push_back(ent);
+	auto& n = nodes_[idx];
+	if(n.entity != e)
+	{
+		if(n.entity != entt::null)
+		{
+			// the previous owner of the index died without a Relation
+			if(n.tracked)
+			{
+				unlink(n.entity);
+			}
+			orphan_children(n);
+			version_++;
+		}
+		n = node{};
+		n.entity = e;
+	}
+	return n;
+}
+
+bool scene_graph::is_ancestor(EntityType ancestor, EntityType e) const
+{
+	for(auto parent = get_parent(e); parent != entt::null; parent = get_parent(parent))
+	{
+		if(parent == ancestor)
+		{
+			return true;
 		}
 	}
+	return false;
+}
+
+void scene_graph::link(EntityType e, EntityType parent)
+{
+	// acquiring the parent may grow the storage, look the child up after it
+	auto& head = (parent == entt::null) ? first_root_ : acquire(parent).first_child;
+	auto& tail = (parent == entt::null) ? last_root_ : find(parent)->last_child;
+	auto& n = *find(e);
+
+	n.parent = parent;
+	n.prev_sibling = tail;
+	n.next_sibling = entt::null;
+	if(tail != entt::null)
+	{
+		find(tail)->next_sibling = e;
+	}
+	else
+	{
+		head = e;
+	}
+	tail = e;
+
+	if(parent == entt::null)
+	{
+		root_count_++;
+	}
+}
+
+void scene_graph::unlink(EntityType e)
+{
+	auto& n = *find(e);
+
+	// the parent node outlives its children, see acquire
+	auto& head = (n.parent == entt::null) ? first_root_ : find(n.parent)->first_child;
+	auto& tail = (n.parent == entt::null) ? last_root_ : find(n.parent)->last_child;
+
+	if(n.prev_sibling != entt::null)
+	{
+		find(n.prev_sibling)->next_sibling = n.next_sibling;
+	}
+	else
+	{
+		head = n.next_sibling;
+	}
+
+	if(n.next_sibling != entt::null)
+	{
+		find(n.next_sibling)->prev_sibling = n.prev_sibling;
+	}
+	else
+	{
+		tail = n.prev_sibling;
+	}
+
+	if(n.parent == entt::null)
+	{
+		root_count_--;
+	}
+
+	n.parent = entt::null;
+	n.prev_sibling = entt::null;
+	n.next_sibling = entt::null;
+}
+
+void scene_graph::orphan_children(node& n)
+{
+	auto& ecs = core::get_subsystem<SpatialSystem>();
+
+	// linking to the roots never grows the storage so n stays valid
+	while(n.first_child != entt::null)
+	{
+		const auto child = n.first_child;
+		unlink(child);
+		ecs.get<Relation>(child).parent = entt::null;
+		link(child, entt::null);
+	}
 }
 
 scene_graph::scene_graph()
 {
-	runtime::on_frame_update.connect(this, &scene_graph::frame_update);
+	auto& ecs = core::get_subsystem<SpatialSystem>();
+	ecs.construction<Relation>().connect<&scene_graph::on_relation_constructed>(this);
+	ecs.destruction<Relation>().connect<&scene_graph::on_relation_destroyed>(this);
+
+	ecs.view<Relation>().each(
+		[this, &ecs](EntityType e, const Relation&) { on_relation_constructed(ecs, e); });
 
 	transform_component::static_id();
 }
 
 scene_graph::~scene_graph()
 {
-	runtime::on_frame_update.disconnect(this, &scene_graph::frame_update);
+	auto& ecs = core::get_subsystem<SpatialSystem>();
+	ecs.construction<Relation>().disconnect<&scene_graph::on_relation_constructed>(this);
+	ecs.destruction<Relation>().disconnect<&scene_graph::on_relation_destroyed>(this);
 }
 }
@@ -4,40 +4,218 @@
 
 #include <core/common/basetypes.hpp>
 
+#include <cstdint>
 #include <vector>
 
 namespace runtime
 {
+//-----------------------------------------------------------------------------
+// Main Class Declarations
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//  Name : scene_graph (Class)
+/// <summary>
+/// Incremental index of the entity hierarchy. Every Relation is linked into
+/// its parent's child list (first child / next sibling), entities without a
+/// parent are linked into the root list. The index follows the Relation
+/// construction and destruction signals, parent changes have to go through
+/// set_parent since Relation::parent is a plain field.
+/// </summary>
+//-----------------------------------------------------------------------------
 class scene_graph
 {
 public:
 	scene_graph();
 	~scene_graph();
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_parent ()
+	/// <summary>
+	/// Moves the entity under a new parent, entt::null makes it a root. The
+	/// entity is appended as the last child. Returns false and leaves the
+	/// hierarchy untouched if the parent is the entity itself or one of its
+	/// descendants.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool set_parent(EntityType e, EntityType parent);
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_parent ()
+	/// <summary>
+	/// Parent of the entity, entt::null for roots and untracked entities.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	EntityType get_parent(EntityType e) const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_first_child ()
+	/// <summary>
+	/// First child of the entity, entt::null if it has none.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	EntityType get_first_child(EntityType e) const;
+
 	//-----------------------------------------------------------------------------
-	//  Name : frame_update (virtual )
+	//  Name : get_next_sibling ()
 	/// <summary>
-	///
-	///
-	///
+	/// Next entity with the same parent, entt::null after the last one. For
+	/// roots this walks the root list.
 	/// </summary>
 	//-----------------------------------------------------------------------------
-	void frame_update(delta_t dt);
+	EntityType get_next_sibling(EntityType e) const;
 
 	//-----------------------------------------------------------------------------
-	//  Name : getRoots ()
+	//  Name : get_first_root ()
 	/// <summary>
-	///
-	///
-	///
+	/// First entity of the root list, entt::null for an empty scene.
 	/// </summary>
 	//-----------------------------------------------------------------------------
-	const std::vector<EntityType>& get_roots() const
+	EntityType get_first_root() const
 	{
-		return roots_;
+		return first_root_;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_root_count ()
+	/// <summary>
+	/// Number of entities in the root list.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::size_t get_root_count() const
+	{
+		return root_count_;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_roots ()
+	/// <summary>
+	/// Copies the root list in order.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::vector<EntityType> get_roots() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : has_children ()
+	/// <summary>
+	/// Does the entity have at least one child.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool has_children(EntityType e) const
+	{
+		return get_first_child(e) != entt::null;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : for_each_child ()
+	/// <summary>
+	/// Calls f(child) for the direct children of the entity in order.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	template <typename F>
+	void for_each_child(EntityType e, F&& f) const
+	{
+		for(auto child = get_first_child(e); child != entt::null;)
+		{
+			// allow the callback to unlink the current child
+			const auto next = get_next_sibling(child);
+			f(child);
+			child = next;
+		}
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : for_each_root ()
+	/// <summary>
+	/// Calls f(root) for every entity in the root list in order.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	template <typename F>
+	void for_each_root(F&& f) const
+	{
+		for(auto root = first_root_; root != entt::null;)
+		{
+			const auto next = get_next_sibling(root);
+			f(root);
+			root = next;
+		}
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : for_each_descendant ()
+	/// <summary>
+	/// Calls f(descendant) depth first, parents before their children. The
+	/// entity itself is not visited.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	template <typename F>
+	void for_each_descendant(EntityType e, F&& f) const
+	{
+		for_each_child(e, [this, &f](EntityType child) {
+			f(child);
+			for_each_descendant(child, f);
+		});
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_version ()
+	/// <summary>
+	/// Incremented on every structural change. Systems caching a layout of
+	/// the hierarchy compare it instead of scanning the registry.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::uint64_t get_version() const
+	{
+		return version_;
 	}
 
 private:
-	/// scene roots
-	std::vector<EntityType> roots_;
+	struct node
+	{
+		/// entity owning the slot, the index alone is reused by the registry
+		EntityType entity = entt::null;
+		EntityType parent = entt::null;
+		EntityType first_child = entt::null;
+		EntityType last_child = entt::null;
+		EntityType prev_sibling = entt::null;
+		EntityType next_sibling = entt::null;
+		/// the entity has a Relation, otherwise the node only holds children
+		bool tracked = false;
+	};
+
+	void on_relation_constructed(Registry& reg, EntityType e);
+	void on_relation_destroyed(Registry& reg, EntityType e);
+
+	//-----------------------------------------------------------------------------
+	//  Name : find ()
+	/// <summary>
+	/// Node of the entity or nullptr if the slot belongs to nobody or to a
+	/// different version of the index.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	node* find(EntityType e);
+	const node* find(EntityType e) const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : acquire ()
+	/// <summary>
+	/// Node of the entity, creating it if needed. A stale node left behind by
+	/// a destroyed parent without a Relation has its children moved to the
+	/// roots first.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	node& acquire(EntityType e);
+
+	bool is_ancestor(EntityType ancestor, EntityType e) const;
+	void link(EntityType e, EntityType parent);
+	void unlink(EntityType e);
+	void orphan_children(node& n);
+
+	/// nodes indexed by the entity part of the identifier
+	std::vector<node> nodes_;
+	/// head and tail of the root list
+	EntityType first_root_ = entt::null;
+	EntityType last_root_ = entt::null;
+	std::size_t root_count_ = 0;
+	std::uint64_t version_ = 0;
 };
 }
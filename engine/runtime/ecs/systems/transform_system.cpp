@@ -1,31 +1,189 @@
 #include "transform_system.h"
-#include "../../system/events.h"
+#include "scene_graph.h"
+#include "../../system/system_scheduler.h"
 #include "../components/relation.h"
 #include "../components/transform_component.h"
 
 #include <core/system/subsystem.h>
+#include <core/tasks/parallel_for.hpp>
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
 
 namespace runtime
 {
+namespace
+{
+/// Below this many transforms a level is processed inline.
+constexpr std::size_t propagate_grain = 256;
+}
+
 void transform_system::frame_update(delta_t) {
   auto& ecs = core::get_subsystem<SpatialSystem>();
+  auto& sg = core::get_subsystem<scene_graph>();
+  auto& ts = core::get_subsystem<core::task_system>();
+
+  if (layout_dirty_ || hierarchy_version_ != sg.get_version()) {
+    rebuild(ecs);
+  }
+
+  for (std::size_t level = 0; level + 1 < level_offsets_.size(); ++level) {
+    // parents live in the previous levels so they are final by now
+    core::parallel_for_range(ts, level_offsets_[level], level_offsets_[level + 1],
+      [this](std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i) {
+          auto& transform = *transforms_[i];
+          const auto parent = parent_slots_[i];
+          const bool parent_changed = parent != invalid_slot && changed_[parent];
+
+          if (!transform.is_dirty() && !parent_changed) {
+            changed_[i] = false;
+            continue;
+          }
+
+          if (parent == invalid_slot) {
+            transform.set_parent_transform(math::transform::identity());
+            transform.set_world_transform(transform.get_local_transform());
+            // resolve the lazily built matrix here, the children read it concurrently
+            transform.get_transform().get_matrix();
+          } else {
+            const auto& parent_world = transforms_[parent]->get_transform();
+            transform.set_parent_transform(parent_world);
+            transform.set_world_transform(parent_world * transform.get_local_transform());
+          }
 
-  ecs.view<transform_component>().each(
-    [&ecs](EntityType e, auto& transform)->void {
+          transform.set_dirty(false);
+          transform.touch();
+          changed_[i] = true;
+        }
+      }, propagate_grain);
+  }
+
+  changed_entities_.clear();
+  for (std::size_t i = 0; i < entities_.size(); ++i) {
+    if (changed_[i]) {
+      changed_entities_.push_back(entities_[i]);
+    }
+  }
+}
+
+std::size_t transform_system::get_depth_count() const {
+  return level_offsets_.empty() ? 0 : level_offsets_.size() - 1;
+}
+
+const std::vector<EntityType>& transform_system::get_changed() const {
+  return changed_entities_;
+}
+
+void transform_system::on_transforms_changed(Registry&, EntityType) {
+  layout_dirty_ = true;
+}
 
-      if (ecs.has<Relation>(e)) {
-        // handle parent transform...
+void transform_system::rebuild(Registry& reg) {
+  auto& sg = core::get_subsystem<scene_graph>();
+
+  constexpr std::size_t no_parent = std::numeric_limits<std::size_t>::max();
+  std::vector<EntityType> entities;
+  std::vector<std::size_t> parent_index;
+  std::vector<std::size_t> depth;
+  std::unordered_map<EntityType, std::size_t> index_of;
+  std::size_t max_depth = 0;
+
+  // the scene graph is acyclic so a walk from the top visits parents first
+  std::vector<std::pair<EntityType, std::size_t>> stack;
+  const auto visit = [&](EntityType top) {
+    stack.emplace_back(top, no_parent);
+    while (!stack.empty()) {
+      const auto e = stack.back().first;
+      const auto parent = stack.back().second;
+      stack.pop_back();
+
+      // a parent without a transform makes a root
+      auto current = no_parent;
+      if (reg.has<transform_component>(e) && index_of.count(e) == 0) {
+        current = entities.size();
+        index_of.emplace(e, current);
+        entities.push_back(e);
+        parent_index.push_back(parent);
+        depth.push_back(parent == no_parent ? 0 : depth[parent] + 1);
+        max_depth = std::max(max_depth, depth.back());
       }
-      // transform.world_transform_ = transform.local_transform_;
-      transform.set_world_transform(transform.get_local_transform());
-    });
+
+      sg.for_each_child(e, [&stack, current](EntityType child) {
+        stack.emplace_back(child, current);
+      });
+    }
+  };
+
+  sg.for_each_root(visit);
+
+  // transforms outside of the root subtrees, their topmost ancestor has no Relation
+  auto view = reg.view<transform_component>();
+  for (auto e : view) {
+    if (index_of.count(e) != 0) {
+      continue;
+    }
+    auto top = e;
+    for (auto parent = sg.get_parent(top); parent != entt::null; parent = sg.get_parent(parent)) {
+      top = parent;
+    }
+    visit(top);
+  }
+
+  const auto count = entities.size();
+
+  // counting sort by depth keeps the walk order inside a level
+  level_offsets_.assign(count > 0 ? max_depth + 2 : 1, 0);
+  for (std::size_t i = 0; i < count; ++i) {
+    level_offsets_[depth[i] + 1]++;
+  }
+  for (std::size_t level = 1; level < level_offsets_.size(); ++level) {
+    level_offsets_[level] += level_offsets_[level - 1];
+  }
+
+  std::vector<std::size_t> slot_of(count);
+  auto next = level_offsets_;
+  for (std::size_t i = 0; i < count; ++i) {
+    slot_of[i] = next[depth[i]]++;
+  }
+
+  entities_.assign(count, entt::null);
+  parent_slots_.assign(count, invalid_slot);
+  transforms_.assign(count, nullptr);
+  changed_.assign(count, false);
+  for (std::size_t i = 0; i < count; ++i) {
+    const auto slot = slot_of[i];
+    entities_[slot] = entities[i];
+    if (parent_index[i] != no_parent) {
+      parent_slots_[slot] = static_cast<std::uint32_t>(slot_of[parent_index[i]]);
+    }
+    transforms_[slot] = &reg.get<transform_component>(entities[i]);
+    // the hierarchy changed, everything has to be recomputed once
+    transforms_[slot]->set_dirty(true);
+  }
+
+  hierarchy_version_ = sg.get_version();
+  layout_dirty_ = false;
 }
 
 transform_system::transform_system() {
-  on_frame_update.connect(this, &transform_system::frame_update);
+  auto& ecs = core::get_subsystem<SpatialSystem>();
+  ecs.construction<transform_component>().connect<&transform_system::on_transforms_changed>(this);
+  ecs.destruction<transform_component>().connect<&transform_system::on_transforms_changed>(this);
+
+  auto& scheduler = core::get_subsystem<system_scheduler>();
+  scheduler.add_system("transform_system", this, &transform_system::frame_update)
+    .reads<Relation>()
+    .writes<transform_component>();
 }
 
 transform_system::~transform_system() {
-  on_frame_update.disconnect(this, &transform_system::frame_update);
+  auto& scheduler = core::get_subsystem<system_scheduler>();
+  scheduler.remove_system("transform_system");
+
+  auto& ecs = core::get_subsystem<SpatialSystem>();
+  ecs.construction<transform_component>().disconnect<&transform_system::on_transforms_changed>(this);
+  ecs.destruction<transform_component>().disconnect<&transform_system::on_transforms_changed>(this);
 }
 }  // namespace runtime
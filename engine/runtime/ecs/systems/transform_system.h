@@ -1,7 +1,15 @@
 #pragma once
 
+#include "runtime/ecs/ent.h"
+
 #include <core/common/basetypes.hpp>
 
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+class transform_component;
+
 namespace runtime
 {
 class transform_system
@@ -12,11 +20,61 @@ public:
   //-----------------------------------------------------------------------------
   //  Name : frame_update (virtual )
   /// <summary>
-  ///
-  ///
-  ///
+  /// Propagates the world transforms down the hierarchy. Only subtrees
+  /// under a dirty transform are recomputed. Each depth level is one
+  /// contiguous batch processed in parallel, parents are always done
+  /// before their children.
   /// </summary>
   //-----------------------------------------------------------------------------
   void frame_update(delta_t dt);
+
+  //-----------------------------------------------------------------------------
+  //  Name : get_depth_count ()
+  /// <summary>
+  /// Number of hierarchy levels in the current layout.
+  /// </summary>
+  //-----------------------------------------------------------------------------
+  std::size_t get_depth_count() const;
+
+  //-----------------------------------------------------------------------------
+  //  Name : get_changed ()
+  /// <summary>
+  /// Entities whose world transform was recomputed by the last frame_update,
+  /// in layout order. Systems caching world space data refit only these.
+  /// </summary>
+  //-----------------------------------------------------------------------------
+  const std::vector<EntityType>& get_changed() const;
+
+private:
+  static constexpr std::uint32_t invalid_slot = std::numeric_limits<std::uint32_t>::max();
+
+  void on_transforms_changed(Registry& reg, EntityType e);
+
+  //-----------------------------------------------------------------------------
+  //  Name : rebuild ()
+  /// <summary>
+  /// Lays out all transforms sorted by depth and marks them dirty. The
+  /// hierarchy is walked through the scene graph links.
+  /// </summary>
+  //-----------------------------------------------------------------------------
+  void rebuild(Registry& reg);
+
+  /// Entities sorted by depth, one slot each.
+  std::vector<EntityType> entities_;
+  /// Slot of the parent, invalid_slot for roots.
+  std::vector<std::uint32_t> parent_slots_;
+  /// Transform of each slot. Only valid until the next component
+  /// construction or destruction, both of which trigger a rebuild.
+  std::vector<transform_component*> transforms_;
+  /// Was the world transform of the slot recomputed this frame.
+  std::vector<std::uint8_t> changed_;
+  /// First slot of every depth level, plus one past the end.
+  std::vector<std::size_t> level_offsets_;
+  /// Entities of the changed slots, collected after propagation.
+  std::vector<EntityType> changed_entities_;
+  /// Transforms were added or removed.
+  bool layout_dirty_ = true;
+  /// Scene graph version the layout was built from.
+  std::uint64_t hierarchy_version_ = 0;
 };
 }
@@ -1,9 +1,11 @@
 #include "animation.hpp"
 #include "../core/math/quaternion.hpp"
 #include "../core/math/transform.hpp"
+#include "../core/math/vector.hpp"
 
 #include <core/serialization/associative_archive.h>
 #include <core/serialization/binary_archive.h>
+#include <core/serialization/types/vector.hpp>
 
 namespace runtime
 {
@@ -27,6 +29,9 @@ SAVE(node_animation)
 	try_save(ar, cereal::make_nvp("position_keys", obj.position_keys));
 	try_save(ar, cereal::make_nvp("rotation_keys", obj.rotation_keys));
 	try_save(ar, cereal::make_nvp("scaling_keys", obj.scaling_keys));
+	try_save(ar, cereal::make_nvp("quantized_position_keys", obj.quantized_position_keys));
+	try_save(ar, cereal::make_nvp("quantized_rotation_keys", obj.quantized_rotation_keys));
+	try_save(ar, cereal::make_nvp("quantized_scaling_keys", obj.quantized_scaling_keys));
 }
 SAVE_INSTANTIATE(node_animation, cereal::oarchive_associative_t);
 SAVE_INSTANTIATE(node_animation, cereal::oarchive_binary_t);
@@ -37,6 +42,9 @@ LOAD(node_animation)
 	try_load(ar, cereal::make_nvp("position_keys", obj.position_keys));
 	try_load(ar, cereal::make_nvp("rotation_keys", obj.rotation_keys));
 	try_load(ar, cereal::make_nvp("scaling_keys", obj.scaling_keys));
+	try_load(ar, cereal::make_nvp("quantized_position_keys", obj.quantized_position_keys));
+	try_load(ar, cereal::make_nvp("quantized_rotation_keys", obj.quantized_rotation_keys));
+	try_load(ar, cereal::make_nvp("quantized_scaling_keys", obj.quantized_scaling_keys));
 }
 LOAD_INSTANTIATE(node_animation, cereal::iarchive_associative_t);
 LOAD_INSTANTIATE(node_animation, cereal::iarchive_binary_t);
@@ -21,6 +21,16 @@ inline void SERIALIZE_FUNCTION_NAME(Archive& ar, node_animation::key<T>& obj)
 	try_serialize(ar, cereal::make_nvp("value", obj.value));
 }
 
+template <typename Archive>
+inline void SERIALIZE_FUNCTION_NAME(Archive& ar, quantized_keys& obj)
+{
+	try_serialize(ar, cereal::make_nvp("time_scale", obj.time_scale));
+	try_serialize(ar, cereal::make_nvp("min", obj.min));
+	try_serialize(ar, cereal::make_nvp("scale", obj.scale));
+	try_serialize(ar, cereal::make_nvp("times", obj.times));
+	try_serialize(ar, cereal::make_nvp("values", obj.values));
+}
+
 REFLECT_EXTERN(node_animation);
 REFLECT_EXTERN(animation);
 }
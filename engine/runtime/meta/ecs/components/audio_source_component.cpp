@@ -4,8 +4,11 @@
 #include "../../assets/asset_handle.hpp"
 #include "../../core/common/basetypes.hpp"
 
+#include "../../../ecs/constructs/snapshots.h"
 #include <core/serialization/types/vector.hpp>
 
+#include <type_traits>
+
 REFLECT(audio_source_component)
 {
 	rttr::registration::class_<audio_source_component>("audio_source_component")(
@@ -27,6 +30,11 @@ REFLECT(audio_source_component)
 			rttr::metadata("max", 10.0f))
 		.property("range", &audio_source_component::get_range,
 				  &audio_source_component::set_range)(rttr::metadata("pretty_name", "Range"))
+		.property("priority", &audio_source_component::get_priority,
+				  &audio_source_component::set_priority)(
+			rttr::metadata("pretty_name", "Priority"),
+			rttr::metadata("tooltip", "Sources with a higher priority keep playing when there are "
+									  "too many to hear at once, regardless of how loud they are."))
 		.property("sound", &audio_source_component::get_sound,
 				  &audio_source_component::set_sound)(rttr::metadata("pretty_name", "Sound"));
 	;
@@ -41,6 +49,7 @@ SAVE(audio_source_component)
 	try_save(ar, cereal::make_nvp("pitch", obj.pitch_));
 	try_save(ar, cereal::make_nvp("volume_rolloff", obj.volume_rolloff_));
 	try_save(ar, cereal::make_nvp("range", obj.range_));
+	try_save(ar, cereal::make_nvp("priority", obj.priority_));
 	try_save(ar, cereal::make_nvp("sound", obj.sound_));
 }
 SAVE_INSTANTIATE(audio_source_component, cereal::oarchive_associative_t);
@@ -55,6 +64,11 @@ LOAD(audio_source_component)
 	try_load(ar, cereal::make_nvp("pitch", obj.pitch_));
 	try_load(ar, cereal::make_nvp("volume_rolloff", obj.volume_rolloff_));
 	try_load(ar, cereal::make_nvp("range", obj.range_));
+	// binary snapshots before version 2 have no priority and keep the default
+	if(!std::is_same<Archive, cereal::iarchive_binary_t>::value || ecs::get_loading_snapshot_version() >= 2)
+	{
+		try_load(ar, cereal::make_nvp("priority", obj.priority_));
+	}
 	try_load(ar, cereal::make_nvp("sound", obj.sound_));
 
 	obj.apply_all();
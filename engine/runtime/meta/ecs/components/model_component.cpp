@@ -18,6 +18,8 @@ REFLECT(model_component)
 				  &model_component::set_casts_shadow)(rttr::metadata("pretty_name", "Casts Shadow"))
 		.property("casts_reflection", &model_component::casts_reflection,
 				  &model_component::set_casts_reflection)(rttr::metadata("pretty_name", "Casts Reflection"))
+		.property("bone_entities_enabled", &model_component::get_bone_entities_enabled,
+				  &model_component::set_bone_entities_enabled)(rttr::metadata("pretty_name", "Bone Entities"))
 		.property("model", &model_component::get_model,
 				  &model_component::set_model)(rttr::metadata("pretty_name", "Model"));
 }
@@ -29,6 +31,7 @@ SAVE(model_component)
 	try_save(ar, cereal::make_nvp("casts_shadow", obj.casts_shadow_));
 	try_save(ar, cereal::make_nvp("casts_reflection", obj.casts_reflection_));
 	try_save(ar, cereal::make_nvp("model", obj.model_));
+	try_save(ar, cereal::make_nvp("bone_entities_enabled", obj.bone_entities_enabled_));
 	try_save(ar, cereal::make_nvp("bone_entities", obj.bone_entities_));
 }
 SAVE_INSTANTIATE(model_component, cereal::oarchive_associative_t);
@@ -41,6 +44,7 @@ LOAD(model_component)
 	try_load(ar, cereal::make_nvp("casts_shadow", obj.casts_shadow_));
 	try_load(ar, cereal::make_nvp("casts_reflection", obj.casts_reflection_));
 	try_load(ar, cereal::make_nvp("model", obj.model_));
+	try_load(ar, cereal::make_nvp("bone_entities_enabled", obj.bone_entities_enabled_));
 	try_load(ar, cereal::make_nvp("bone_entities", obj.bone_entities_));
 }
 LOAD_INSTANTIATE(model_component, cereal::iarchive_associative_t);
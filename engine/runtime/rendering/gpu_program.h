@@ -81,6 +81,30 @@ public:
 	void set_uniform(const std::string& _name, const math::vec3& _value, std::uint16_t _num = 1);
 	void set_uniform(const std::string& _name, const math::vec2& _value, std::uint16_t _num = 1);
 
+	//-----------------------------------------------------------------------------
+	//  Name : set_texture ()
+	/// <summary>
+	/// Overloads taking an interned name, they skip the string lookup and
+	/// are meant for code that sets the same uniforms every frame.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_texture(std::uint8_t _stage, const gfx::uniform_id& _sampler, gfx::frame_buffer* _handle,
+					 uint8_t _attachment = 0,
+					 std::uint32_t _flags = std::numeric_limits<std::uint32_t>::max());
+	void set_texture(std::uint8_t _stage, const gfx::uniform_id& _sampler, gfx::texture* _texture,
+					 std::uint32_t _flags = std::numeric_limits<std::uint32_t>::max());
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_uniform ()
+	/// <summary>
+	/// Overloads taking an interned name, see set_texture.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_uniform(const gfx::uniform_id& _id, const void* _value, std::uint16_t _num = 1);
+	void set_uniform(const gfx::uniform_id& _id, const math::vec4& _value, std::uint16_t _num = 1);
+	void set_uniform(const gfx::uniform_id& _id, const math::vec3& _value, std::uint16_t _num = 1);
+	void set_uniform(const gfx::uniform_id& _id, const math::vec2& _value, std::uint16_t _num = 1);
+
 	//-----------------------------------------------------------------------------
 	//  Name : get_uniform ()
 	/// <summary>
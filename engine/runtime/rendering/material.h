@@ -3,6 +3,7 @@
 #include "../assets/asset_handle.h"
 
 #include <core/graphics/graphics.h>
+#include <core/graphics/uniform_id.h>
 #include <core/math/math_includes.h>
 #include <core/reflection/registration.h>
 #include <core/serialization/serialization.h>
@@ -96,6 +97,16 @@ public:
 	//-----------------------------------------------------------------------------
 	void set_uniform(const std::string& _name, const void* _value, std::uint16_t _num = 1);
 
+	//-----------------------------------------------------------------------------
+	//  Name : set_texture ()
+	/// <summary>
+	/// Overloads taking an interned name, they skip the string lookup.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_texture(std::uint8_t _stage, const gfx::uniform_id& _sampler, gfx::texture* _texture,
+					 std::uint32_t _flags = std::numeric_limits<std::uint32_t>::max());
+	void set_uniform(const gfx::uniform_id& _id, const void* _value, std::uint16_t _num = 1);
+
 	//-----------------------------------------------------------------------------
 	//  Name : get_program ()
 	/// <summary>
@@ -155,13 +166,29 @@ public:
 	std::uint64_t get_render_states(bool apply_cull = true, bool depth_write = true,
 									bool depth_test = true) const;
 
+	//-----------------------------------------------------------------------------
+	//  Name : has_instanced_program ()
+	/// <summary>
+	/// Can the material draw instances with the world matrix in the instance
+	/// data buffer.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline bool has_instanced_program() const
+	{
+		return program_instanced_ != nullptr;
+	}
+
 	bool skinned = false;
+	/// Select the instanced program, ignored for skinned draws.
+	bool instanced = false;
 
 protected:
 	/// Program that is responsible for rendering.
 	std::unique_ptr<gpu_program> program_;
 	/// Program that is responsible for rendering.
 	std::unique_ptr<gpu_program> program_skinned_;
+	/// Program that is responsible for instanced rendering.
+	std::unique_ptr<gpu_program> program_instanced_;
 	/// Cull type for this material.
 	cull_type cull_type_ = cull_type::counter_clockwise;
 	/// Default color texture
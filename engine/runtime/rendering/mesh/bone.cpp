@@ -74,6 +74,31 @@ bone_palette::get_skinning_matrices(const std::vector<math::transform>& node_tra
   return transforms;
 }
 
+void bone_palette::get_skinning_matrices(const std::vector<math::transform>& node_transforms,
+                                         const skin_bind_data& bind_data, bool compute_inverse_transpose,
+                                         std::vector<math::transform::mat4_t>& matrices) const
+{
+  const auto& bind_list = bind_data.get_bones();
+  if(node_transforms.empty())
+  {
+    matrices.clear();
+    return;
+  }
+
+  // Only the palette bones are written, the capacity stays for the next call.
+  matrices.resize(bones_.size());
+  for(size_t i = 0; i < bones_.size(); ++i)
+  {
+    auto bone = bones_[i];
+    auto& matrix = matrices[i];
+    matrix = node_transforms[bone].get_matrix() * bind_list[bone].bind_pose_transform.get_matrix();
+    if(compute_inverse_transpose)
+    {
+      matrix = math::transpose(math::inverse(matrix));
+    }
+  }
+}
+
 void bone_palette::assign_bones(bone_index_map_t& bones, std::vector<std::uint32_t>& faces)
 {
   bone_index_map_t::iterator it_bone, it_bone2;
@@ -47,6 +47,18 @@ public:
                              const skin_bind_data& bind_data,
                              bool compute_inverse_transpose) const;
 
+  //-----------------------------------------------------------------------------
+  //  Name : get_skinning_matrices()
+  /// <summary>
+  /// Same as above but writes the matrices of the palette bones into a
+  /// buffer owned by the caller, so it can be reused from frame to frame.
+  /// Works on the matrices directly, the transforms are never decomposed.
+  /// </summary>
+  //-----------------------------------------------------------------------------
+  void get_skinning_matrices(const std::vector<math::transform>& node_transforms,
+                             const skin_bind_data& bind_data, bool compute_inverse_transpose,
+                             std::vector<math::transform::mat4_t>& matrices) const;
+
   //-----------------------------------------------------------------------------
   //  Name : compute_palette_fit()
   /// <summary>
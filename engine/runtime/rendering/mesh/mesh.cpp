@@ -3,13 +3,17 @@
 #include "runtime/rendering/generator/generator.hpp"
 
 #include <core/graphics/index_buffer.h>
+#include <core/common/hash.hpp>
 #include <core/graphics/vertex_buffer.h>
 #include <core/logging/logging.h>
 #include <core/memory/checked_delete.h>
+#include <core/system/subsystem.h>
+#include <core/tasks/parallel_for.hpp>
 
 #include <algorithm>
 #include <cmath>
 #include <cstring>
+#include <unordered_map>
 //-----------------------------------------------------------------------------
 // Local Module Level Namespaces.
 //-----------------------------------------------------------------------------
@@ -23,6 +27,275 @@ const float ValenceBoostPower = 0.5f;
 const std::int32_t MaxVertexCacheSize = 32;
 };
 
+namespace
+{
+/// Faces or vertices processed by one task at least.
+constexpr std::size_t face_grain = 1024;
+constexpr std::size_t vertex_grain = 1024;
+
+//-----------------------------------------------------------------------------
+//  Name : parallel_chunks ()
+/// <summary>
+/// Calls f(begin, end) for chunks of [0, count) on the task system. Meshes
+/// are also prepared by tools and tests running without one, in which case
+/// the whole range is processed on the calling thread.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <typename F>
+void parallel_chunks(std::size_t count, std::size_t grain, F&& f)
+{
+	if(core::has_subsystems<core::task_system>())
+		core::parallel_for_range(core::get_subsystem<core::task_system>(), 0, count, f, grain);
+	else if(count > 0)
+		f(std::size_t(0), count);
+}
+
+//-----------------------------------------------------------------------------
+//  Name : sum_vertex_normal ()
+/// <summary>
+/// Sums the normals of the faces around the vertex at a corner of a face by
+/// walking the face adjacency, and returns the normalized result.
+/// </summary>
+//-----------------------------------------------------------------------------
+math::vec3 sum_vertex_normal(const std::uint32_t* adjacency_ptr, const math::vec3* face_normals,
+							 std::uint32_t face, std::uint32_t corner)
+{
+	std::uint32_t start_tri, previous_tri, current_tri, k;
+	math::vec3 vec_normal = face_normals[face];
+
+	// To generate vertex normals using the adjacency information we first
+	// need to walk backwards
+	// through the list to find the first triangle that references this vertex
+	// (using entrance/exit
+	// edge strategy).
+	// Once we have the first triangle, step forwards and sum the normals of
+	// each of the faces
+	// for each triangle we touch. This is essentially a flood fill through
+	// all of the triangles
+	// that touch this vertex, without ever having to test the entire set for
+	// shared vertices.
+	// The initial backwards traversal prevents us from having to store (and
+	// test) a 'visited' flag
+	// for
+	// every triangle in the buffer.
+
+	// First walk backwards...
+	start_tri = face;
+	previous_tri = face;
+	current_tri = adjacency_ptr[(face * 3) + ((corner + 2) % 3)];
+	for(;;)
+	{
+		// Stop walking if we reach the starting triangle again, or if there
+		// is no connectivity out of this edge
+		if(current_tri == start_tri || current_tri == 0xFFFFFFFF)
+			break;
+
+		// Find the edge in the adjacency list that we came in through
+		for(k = 0; k < 3; ++k)
+		{
+			if(adjacency_ptr[(current_tri * 3) + k] == previous_tri)
+				break;
+
+		} // Next item in adjacency list
+
+		// If we found the edge we entered through, the exit edge will
+		// be the edge counter-clockwise from this one when walking backwards
+		if(k < 3)
+		{
+			previous_tri = current_tri;
+			current_tri = adjacency_ptr[(current_tri * 3) + ((k + 2) % 3)];
+
+		} // End if found entrance edge
+		else
+		{
+			break;
+
+		} // End if failed to find entrance edge
+
+	} // Next Test
+
+	// We should now be at the starting triangle, we can start to walk
+	// forwards
+	// collecting the face normals. First find the exit edge so we can start
+	// walking.
+	if(current_tri != 0xFFFFFFFF)
+	{
+		for(k = 0; k < 3; ++k)
+		{
+			if(adjacency_ptr[(current_tri * 3) + k] == previous_tri)
+				break;
+
+		} // Next item in adjacency list
+	}
+	else
+	{
+		// Couldn't step back, so first triangle is the current triangle
+		current_tri = face;
+		k = corner;
+	}
+
+	if(k < 3)
+	{
+		start_tri = current_tri;
+		previous_tri = current_tri;
+		current_tri = adjacency_ptr[(current_tri * 3) + k];
+		vec_normal = face_normals[start_tri];
+		for(;;)
+		{
+			// Stop walking if we reach the starting triangle again, or if there
+			// is no connectivity out of this edge
+			if(current_tri == start_tri || current_tri == 0xFFFFFFFF)
+				break;
+
+			// Add this normal.
+			vec_normal += face_normals[current_tri];
+
+			// Find the edge in the adjacency list that we came in through
+			for(k = 0; k < 3; ++k)
+			{
+				if(adjacency_ptr[(current_tri * 3) + k] == previous_tri)
+					break;
+
+			} // Next item in adjacency list
+
+			// If we found the edge we came entered through, the exit edge will
+			// be the edge clockwise from this one when walking forwards
+			if(k < 3)
+			{
+				previous_tri = current_tri;
+				current_tri = adjacency_ptr[(current_tri * 3) + ((k + 1) % 3)];
+
+			} // End if found entrance edge
+			else
+			{
+				break;
+
+			} // End if failed to find entrance edge
+
+		} // Next Test
+
+	} // End if found entrance edge
+
+	// Normalize the new vertex normal
+	return math::normalize(vec_normal);
+}
+
+//-----------------------------------------------------------------------------
+//  Name : position_grid (Class)
+/// <summary>
+/// Spatial hash used to find an earlier point lying within a tolerance of a
+/// new one. Cells are as large as the tolerance, so a match can only be in
+/// the cell of the point or one of its neighbours. Points of a cell are
+/// chained through their index, so no per cell storage is allocated.
+/// </summary>
+//-----------------------------------------------------------------------------
+class position_grid
+{
+public:
+	static constexpr std::uint32_t invalid_index = 0xFFFFFFFF;
+
+	position_grid(float tolerance, std::uint32_t expected_count)
+		: cell_scale_(1.0 / double(std::max(tolerance, math::epsilon<float>())))
+	{
+		cells_.reserve(expected_count);
+		next_.reserve(expected_count);
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : find ()
+	/// <summary>
+	/// Returns the lowest index around the position accepted by the predicate,
+	/// or invalid_index.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	template <typename Predicate>
+	std::uint32_t find(const math::vec3& position, Predicate&& matches) const
+	{
+		const cell_key cell = get_cell(position);
+		std::uint32_t result = invalid_index;
+		for(std::int64_t x = cell.x - 1; x <= cell.x + 1; ++x)
+		{
+			for(std::int64_t y = cell.y - 1; y <= cell.y + 1; ++y)
+			{
+				for(std::int64_t z = cell.z - 1; z <= cell.z + 1; ++z)
+				{
+					auto it = cells_.find(cell_key{x, y, z});
+					if(it == cells_.end())
+						continue;
+
+					for(std::uint32_t index = it->second; index != invalid_index; index = next_[index])
+					{
+						if(index < result && matches(index))
+							result = index;
+					}
+				}
+			}
+		}
+		return result;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : insert ()
+	/// <summary>
+	/// Adds a point. Indices have to be inserted in sequence starting at 0.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void insert(const math::vec3& position, std::uint32_t index)
+	{
+		auto it = cells_.emplace(get_cell(position), invalid_index).first;
+		next_.push_back(it->second);
+		it->second = index;
+	}
+
+private:
+	struct cell_key
+	{
+		std::int64_t x, y, z;
+
+		bool operator==(const cell_key& other) const
+		{
+			return x == other.x && y == other.y && z == other.z;
+		}
+	};
+
+	struct cell_hash
+	{
+		std::size_t operator()(const cell_key& key) const
+		{
+			std::size_t seed = 0;
+			utils::hash_combine(seed, key.x);
+			utils::hash_combine(seed, key.y);
+			utils::hash_combine(seed, key.z);
+			return seed;
+		}
+	};
+
+	std::int64_t get_coordinate(float value) const
+	{
+		// Keep huge (or invalid) coordinates representable.
+		const double limit = 1e18;
+		const double scaled = std::floor(double(value) * cell_scale_);
+		if(!(scaled > -limit))
+			return -std::int64_t(limit);
+		if(!(scaled < limit))
+			return std::int64_t(limit);
+		return std::int64_t(scaled);
+	}
+
+	cell_key get_cell(const math::vec3& position) const
+	{
+		return {get_coordinate(position.x), get_coordinate(position.y), get_coordinate(position.z)};
+	}
+
+	/// Inverse of the cell size.
+	double cell_scale_ = 1.0;
+	/// First point of every occupied cell.
+	std::unordered_map<cell_key, std::uint32_t, cell_hash> cells_;
+	/// Next point in the same cell, per point.
+	std::vector<std::uint32_t> next_;
+};
+}
+
 mesh::mesh()
 	: hardware_vb_(std::make_shared<gfx::vertex_buffer>())
 	, hardware_ib_(std::make_shared<gfx::index_buffer>())
@@ -474,9 +747,25 @@ bool mesh::bind_skin(const skin_bind_data& bind_data)
 	return true;
 }
 
+static void flatten_armature(const mesh::armature_node& node, std::int32_t parent, skeleton& skel)
+{
+	const auto index = skel.add_node(node.name, parent, node.local_transform);
+	for(const auto& child : node.children)
+	{
+		flatten_armature(*child, index, skel);
+	}
+}
+
 bool mesh::bind_armature(std::unique_ptr<armature_node>& root)
 {
 	root_ = std::move(root);
+
+	skeleton_.clear();
+	if(root_)
+	{
+		flatten_armature(*root_, skeleton::invalid_index, skeleton_);
+	}
+	skeleton_.bind(skin_bind_data_);
 	return true;
 }
 
@@ -927,30 +1216,30 @@ bool mesh::end_prepare(bool hardware_copy /* = true */, bool weld /* = true */,
 	} // End if previously preparing
 
 	// Scan the preparation data for degenerate triangles.
-	std::uint16_t position_offset = vertex_format_.getOffset(gfx::attribute::Position);
-	// std::uint16_t vertex_stride = _vertex_format.getStride();
-	std::uint8_t* src_vertices_ptr = &preparation_data_.vertex_data[0] + position_offset;
-	for(std::uint32_t i = 0; i < preparation_data_.triangle_count; ++i)
-	{
-		triangle& tri = preparation_data_.triangle_data[i];
-		math::vec3 v1;
-		float vf1[4];
-		gfx::vertex_unpack(vf1, gfx::attribute::Position, vertex_format_, src_vertices_ptr, tri.indices[0]);
-		math::vec3 v2;
-		float vf2[4];
-		gfx::vertex_unpack(vf2, gfx::attribute::Position, vertex_format_, src_vertices_ptr, tri.indices[1]);
-		math::vec3 v3;
-		float vf3[4];
-		gfx::vertex_unpack(vf3, gfx::attribute::Position, vertex_format_, src_vertices_ptr, tri.indices[2]);
-		memcpy(&v1[0], vf1, 3 * sizeof(float));
-		memcpy(&v2[0], vf2, 3 * sizeof(float));
-		memcpy(&v3[0], vf3, 3 * sizeof(float));
-
-		math::vec3 c = math::cross(v2 - v1, v3 - v1);
-		if(math::length2(c) < (4.0f * 0.000001f * 0.000001f))
-			tri.flags |= triangle_flags::degenerate;
+	const std::uint8_t* src_vertices_ptr = &preparation_data_.vertex_data[0];
+	parallel_chunks(preparation_data_.triangle_count, face_grain, [&](std::size_t begin, std::size_t end) {
+		for(std::size_t i = begin; i < end; ++i)
+		{
+			triangle& tri = preparation_data_.triangle_data[i];
+			math::vec3 v1;
+			float vf1[4];
+			gfx::vertex_unpack(vf1, gfx::attribute::Position, vertex_format_, src_vertices_ptr, tri.indices[0]);
+			math::vec3 v2;
+			float vf2[4];
+			gfx::vertex_unpack(vf2, gfx::attribute::Position, vertex_format_, src_vertices_ptr, tri.indices[1]);
+			math::vec3 v3;
+			float vf3[4];
+			gfx::vertex_unpack(vf3, gfx::attribute::Position, vertex_format_, src_vertices_ptr, tri.indices[2]);
+			memcpy(&v1[0], vf1, 3 * sizeof(float));
+			memcpy(&v2[0], vf2, 3 * sizeof(float));
+			memcpy(&v3[0], vf3, 3 * sizeof(float));
 
-	} // Next triangle
+			math::vec3 c = math::cross(v2 - v1, v3 - v1);
+			if(math::length2(c) < (4.0f * 0.000001f * 0.000001f))
+				tri.flags |= triangle_flags::degenerate;
+
+		} // Next triangle
+	});
 
 	// Process the vertex data in order to generate any additional components that
 	// may be necessary
@@ -1017,14 +1306,7 @@ void mesh::build_vb(bool hardware_copy)
 {
 	// A video memory copy of the mesh was requested?
 	if(hardware_copy)
-	{
-		// Calculate the required size of the vertex buffer
-		std::uint32_t buffer_size = vertex_count_ * vertex_format_.getStride();
-
-		const gfx::memory_view* mem = gfx::copy(system_vb_, static_cast<std::uint32_t>(buffer_size));
-		hardware_vb_ = std::make_shared<gfx::vertex_buffer>(mem, vertex_format_);
-
-	} // End if video memory vertex buffer required
+		build_vb(copy_vb());
 }
 
 void mesh::build_ib(bool hardware_copy)
@@ -1032,28 +1314,38 @@ void mesh::build_ib(bool hardware_copy)
 	// Hardware versions of the final buffer were required?
 	if(hardware_copy)
 	{
-		// Calculate the required size of the index buffer
-		std::uint32_t buffer_size = face_count_ * 3 * sizeof(std::uint32_t);
-
 		// Allocate hardware buffer if required (i.e. it does not already exist).
-		if(!hardware_ib_)
-		{
-			const gfx::memory_view* mem = gfx::copy(system_ib_, static_cast<std::uint32_t>(buffer_size));
-			hardware_ib_ = std::make_shared<gfx::index_buffer>(mem, BGFX_BUFFER_INDEX32);
-		} // End if not allocated
-		else
-		{
-			auto ib = std::static_pointer_cast<gfx::index_buffer>(hardware_ib_);
-			if(!ib->is_valid())
-			{
-				const gfx::memory_view* mem = gfx::copy(system_ib_, static_cast<std::uint32_t>(buffer_size));
-				hardware_ib_ = std::make_shared<gfx::index_buffer>(mem, BGFX_BUFFER_INDEX32);
-			}
-		}
+		auto ib = std::static_pointer_cast<gfx::index_buffer>(hardware_ib_);
+		if(!ib || !ib->is_valid())
+			build_ib(copy_ib());
 
 	} // End if hardware buffer required
 }
 
+const gfx::memory_view* mesh::copy_vb() const
+{
+	// Calculate the required size of the vertex buffer
+	std::uint32_t buffer_size = vertex_count_ * vertex_format_.getStride();
+	return gfx::copy(system_vb_, static_cast<std::uint32_t>(buffer_size));
+}
+
+const gfx::memory_view* mesh::copy_ib() const
+{
+	// Calculate the required size of the index buffer
+	std::uint32_t buffer_size = face_count_ * 3 * sizeof(std::uint32_t);
+	return gfx::copy(system_ib_, static_cast<std::uint32_t>(buffer_size));
+}
+
+void mesh::build_vb(const gfx::memory_view* mem)
+{
+	hardware_vb_ = std::make_shared<gfx::vertex_buffer>(mem, vertex_format_);
+}
+
+void mesh::build_ib(const gfx::memory_view* mem)
+{
+	hardware_ib_ = std::make_shared<gfx::index_buffer>(mem, BGFX_BUFFER_INDEX32);
+}
+
 bool mesh::sort_mesh_data(bool optimize, bool hardware_copy, bool build_buffer)
 {
 	std::map<mesh_subset_key, std::uint32_t> subset_sizes;
@@ -1200,32 +1492,44 @@ bool mesh::sort_mesh_data(bool optimize, bool hardware_copy, bool build_buffer)
 		std::sort(it_data_group->second.begin(), it_data_group->second.end(), sort_predicate);
 
 	// Optimize the faces as we transfer to the final destination index buffer
-	// if requested. Otherwise, just copy them over directly.
+	// if requested. Otherwise, just copy them over directly. Every subset is
+	// written to its own range of the destination, so they are processed in
+	// parallel.
 	src_indices_ptr = dst_indices_ptr;
 	dst_indices_ptr = system_ib_;
+	std::vector<std::uint32_t> subset_face_starts(new_subsets.size());
 	counter = 0;
-	for(auto subset : new_subsets)
+	for(std::size_t i = 0; i < new_subsets.size(); ++i)
 	{
-		// Note: Remember that at this stage, the subset's 'vertex_count' member
-		// still describes
-		// a 'max' vertex (not a count)... We're correcting this later.
-		if(optimize)
-			build_optimized_index_buffer(subset, src_indices_ptr + (subset->face_start * 3), dst_indices_ptr,
-										 static_cast<std::uint32_t>(subset->vertex_start),
-										 static_cast<std::uint32_t>(subset->vertex_count));
-		else
-			memcpy(dst_indices_ptr, src_indices_ptr + (subset->face_start * 3),
-				   static_cast<std::size_t>(subset->face_count) * 3 * sizeof(std::uint32_t));
+		subset_face_starts[i] = static_cast<std::uint32_t>(counter);
+		counter += new_subsets[i]->face_count;
 
-		// This subset's starting face now refers to its location
-		// in the final destination buffer rather than the temporary one.
-		subset->face_start = counter;
-		counter += subset->face_count;
+	} // Next subset
 
-		// Move on to output next sorted subset.
-		dst_indices_ptr += subset->face_count * 3;
+	parallel_chunks(new_subsets.size(), 1, [&](std::size_t begin, std::size_t end) {
+		for(std::size_t i = begin; i < end; ++i)
+		{
+			const subset* sub = new_subsets[i];
+			std::uint32_t* subset_dst_ptr = dst_indices_ptr + (subset_face_starts[i] * 3);
+
+			// Note: Remember that at this stage, the subset's 'vertex_count' member
+			// still describes
+			// a 'max' vertex (not a count)... We're correcting this later.
+			if(optimize)
+				build_optimized_index_buffer(sub, src_indices_ptr + (sub->face_start * 3), subset_dst_ptr,
+											 static_cast<std::uint32_t>(sub->vertex_start),
+											 static_cast<std::uint32_t>(sub->vertex_count));
+			else
+				memcpy(subset_dst_ptr, src_indices_ptr + (sub->face_start * 3),
+					   static_cast<std::size_t>(sub->face_count) * 3 * sizeof(std::uint32_t));
 
-	} // Next subset
+		} // Next subset
+	});
+
+	// Each subset's starting face now refers to its location
+	// in the final destination buffer rather than the temporary one.
+	for(std::size_t i = 0; i < new_subsets.size(); ++i)
+		new_subsets[i]->face_start = static_cast<std::int32_t>(subset_face_starts[i]);
 
 	// Clean up.
 	checked_array_delete(src_indices_ptr);
@@ -1715,9 +2019,7 @@ bool mesh::generate_vertex_components(bool weld)
 bool mesh::generate_vertex_normals(std::uint32_t* adjacency_ptr,
 								   std::vector<std::uint32_t>* remap_array_ptr /* = nullptr */)
 {
-	std::uint32_t start_tri, previous_tri, current_tri;
-	math::vec3 vec_edge1, vec_edge2, vec_normal;
-	std::uint32_t i, j, k, index;
+	std::uint32_t i, j, index;
 
 	// Get access to useful data offset information.
 	std::uint16_t position_offset = vertex_format_.getOffset(gfx::attribute::Position);
@@ -1738,34 +2040,66 @@ bool mesh::generate_vertex_normals(std::uint32_t* adjacency_ptr,
 
 	} // End if supplied
 
+	// Returns true when the vertex referenced by a face corner needs a normal.
+	const auto needs_normal = [this](const triangle& tri, std::uint32_t corner) {
+		// Skip this vertex if normal information was already provided.
+		return force_normal_generation_ ||
+			   !(preparation_data_.vertex_flags[tri.indices[corner]] & preparation_data::source_contains_normal);
+	};
+
 	// Pre-compute surface normals for each triangle
-	std::uint8_t* src_vertices_ptr = &preparation_data_.vertex_data[0];
-	auto* normals_ptr = new math::vec3[preparation_data_.triangle_count];
-	memset(normals_ptr, 0, preparation_data_.triangle_count * sizeof(math::vec3));
-	for(i = 0; i < preparation_data_.triangle_count; ++i)
-	{
-		// Retrieve positions of each referenced vertex.
-		const triangle& tri = preparation_data_.triangle_data[i];
-		const auto* v1 = reinterpret_cast<const math::vec3*>(
-			src_vertices_ptr + (tri.indices[0] * vertex_stride) + position_offset);
-		const auto* v2 = reinterpret_cast<const math::vec3*>(
-			src_vertices_ptr + (tri.indices[1] * vertex_stride) + position_offset);
-		const auto* v3 = reinterpret_cast<const math::vec3*>(
-			src_vertices_ptr + (tri.indices[2] * vertex_stride) + position_offset);
-
-		// Compute the two edge vectors required for generating our normal
-		// We normalize here to prevent problems when the triangles are very small.
-		vec_edge1 = math::normalize(*v2 - *v1);
-		vec_edge2 = math::normalize(*v3 - *v1);
-
-		// Generate the normal
-		vec_normal = math::cross(vec_edge1, vec_edge2);
-		normals_ptr[i] = math::normalize(vec_normal);
+	const std::uint32_t triangle_count = preparation_data_.triangle_count;
+	const std::uint8_t* src_vertices_ptr = &preparation_data_.vertex_data[0];
+	std::vector<math::vec3> face_normals(triangle_count);
+	parallel_chunks(triangle_count, face_grain, [&](std::size_t begin, std::size_t end) {
+		for(std::size_t face = begin; face < end; ++face)
+		{
+			// Retrieve positions of each referenced vertex.
+			const triangle& tri = preparation_data_.triangle_data[face];
+			const auto* v1 = reinterpret_cast<const math::vec3*>(
+				src_vertices_ptr + (tri.indices[0] * vertex_stride) + position_offset);
+			const auto* v2 = reinterpret_cast<const math::vec3*>(
+				src_vertices_ptr + (tri.indices[1] * vertex_stride) + position_offset);
+			const auto* v3 = reinterpret_cast<const math::vec3*>(
+				src_vertices_ptr + (tri.indices[2] * vertex_stride) + position_offset);
+
+			// Compute the two edge vectors required for generating our normal
+			// We normalize here to prevent problems when the triangles are very small.
+			math::vec3 vec_edge1 = math::normalize(*v2 - *v1);
+			math::vec3 vec_edge2 = math::normalize(*v3 - *v1);
+
+			// Generate the normal
+			face_normals[face] = math::normalize(math::cross(vec_edge1, vec_edge2));
 
-	} // Next Face
+		} // Next Face
+	});
+
+	// Now compute the actual VERTEX normals using face adjacency information.
+	// The walk only reads the adjacency and the face normals, so the normal
+	// of every face corner is computed up front and in parallel.
+	std::vector<math::vec3> corner_normals(triangle_count * 3);
+	parallel_chunks(triangle_count, face_grain, [&](std::size_t begin, std::size_t end) {
+		for(std::size_t face = begin; face < end; ++face)
+		{
+			const triangle& tri = preparation_data_.triangle_data[face];
+			if(tri.flags & triangle_flags::degenerate)
+				continue;
+
+			for(std::uint32_t corner = 0; corner < 3; ++corner)
+			{
+				if(needs_normal(tri, corner))
+					corner_normals[(face * 3) + corner] = sum_vertex_normal(
+						adjacency_ptr, face_normals.data(), std::uint32_t(face), corner);
+
+			} // Next Vertex
 
-	// Now compute the actual VERTEX normals using face adjacency information
-	for(i = 0; i < preparation_data_.triangle_count; ++i)
+		} // Next Face
+	});
+
+	// Store the normals, splitting vertices shared by faces that disagree.
+	// This grows the vertex buffer and so happens in face order.
+	std::uint8_t* dst_vertices_ptr = &preparation_data_.vertex_data[0];
+	for(i = 0; i < triangle_count; ++i)
 	{
 		triangle& tri = preparation_data_.triangle_data[i];
 		if(tri.flags & triangle_flags::degenerate)
@@ -1774,129 +2108,13 @@ bool mesh::generate_vertex_normals(std::uint32_t* adjacency_ptr,
 		// Process each vertex in the face
 		for(j = 0; j < 3; ++j)
 		{
-			// Retrieve the index for this vertex.
-			index = tri.indices[j];
-
-			// Skip this vertex if normal information was already provided.
-			if(!force_normal_generation_ &&
-			   (preparation_data_.vertex_flags[index] & preparation_data::source_contains_normal))
+			if(!needs_normal(tri, j))
 				continue;
 
-			// To generate vertex normals using the adjacency information we first
-			// need to walk backwards
-			// through the list to find the first triangle that references this vertex
-			// (using entrance/exit
-			// edge strategy).
-			// Once we have the first triangle, step forwards and sum the normals of
-			// each of the faces
-			// for each triangle we touch. This is essentially a flood fill through
-			// all of the triangles
-			// that touch this vertex, without ever having to test the entire set for
-			// shared vertices.
-			// The initial backwards traversal prevents us from having to store (and
-			// test) a 'visited' flag
-			// for
-			// every triangle in the buffer.
-
-			// First walk backwards...
-			start_tri = i;
-			previous_tri = i;
-			current_tri = adjacency_ptr[(i * 3) + ((j + 2) % 3)];
-			for(;;)
-			{
-				// Stop walking if we reach the starting triangle again, or if there
-				// is no connectivity out of this edge
-				if(current_tri == start_tri || current_tri == 0xFFFFFFFF)
-					break;
-
-				// Find the edge in the adjacency list that we came in through
-				for(k = 0; k < 3; ++k)
-				{
-					if(adjacency_ptr[(current_tri * 3) + k] == previous_tri)
-						break;
-
-				} // Next item in adjacency list
-
-				// If we found the edge we entered through, the exit edge will
-				// be the edge counter-clockwise from this one when walking backwards
-				if(k < 3)
-				{
-					previous_tri = current_tri;
-					current_tri = adjacency_ptr[(current_tri * 3) + ((k + 2) % 3)];
-
-				} // End if found entrance edge
-				else
-				{
-					break;
-
-				} // End if failed to find entrance edge
-
-			} // Next Test
-
-			// We should now be at the starting triangle, we can start to walk
-			// forwards
-			// collecting the face normals. First find the exit edge so we can start
-			// walking.
-			if(current_tri != 0xFFFFFFFF)
-			{
-				for(k = 0; k < 3; ++k)
-				{
-					if(adjacency_ptr[(current_tri * 3) + k] == previous_tri)
-						break;
-
-				} // Next item in adjacency list
-			}
-			else
-			{
-				// Couldn't step back, so first triangle is the current triangle
-				current_tri = i;
-				k = j;
-			}
-
-			if(k < 3)
-			{
-				start_tri = current_tri;
-				previous_tri = current_tri;
-				current_tri = adjacency_ptr[(current_tri * 3) + k];
-				vec_normal = normals_ptr[start_tri];
-				for(;;)
-				{
-					// Stop walking if we reach the starting triangle again, or if there
-					// is no connectivity out of this edge
-					if(current_tri == start_tri || current_tri == 0xFFFFFFFF)
-						break;
-
-					// Add this normal.
-					vec_normal += normals_ptr[current_tri];
-
-					// Find the edge in the adjacency list that we came in through
-					for(k = 0; k < 3; ++k)
-					{
-						if(adjacency_ptr[(current_tri * 3) + k] == previous_tri)
-							break;
-
-					} // Next item in adjacency list
-
-					// If we found the edge we came entered through, the exit edge will
-					// be the edge clockwise from this one when walking forwards
-					if(k < 3)
-					{
-						previous_tri = current_tri;
-						current_tri = adjacency_ptr[(current_tri * 3) + ((k + 1) % 3)];
-
-					} // End if found entrance edge
-					else
-					{
-						break;
-
-					} // End if failed to find entrance edge
-
-				} // Next Test
-
-			} // End if found entrance edge
-
-			// Normalize the new vertex normal
-			vec_normal = math::normalize(vec_normal);
+			// Retrieve the index for this vertex.
+			index = tri.indices[j];
+			const math::vec3& vec_normal = corner_normals[(i * 3) + j];
+			math::vec4 norm(vec_normal, 0.0f);
 
 			// If the normal we are about to store is significantly different from any
 			// normal
@@ -1904,14 +2122,15 @@ bool mesh::generate_vertex_normals(std::uint32_t* adjacency_ptr,
 			// we need
 			// to split the vertex into two.
 			float fn[4];
-			gfx::vertex_unpack(fn, gfx::attribute::Normal, vertex_format_, src_vertices_ptr, index);
+			gfx::vertex_unpack(fn, gfx::attribute::Normal, vertex_format_, dst_vertices_ptr, index);
 			math::vec3 ref_normal;
 			ref_normal[0] = fn[0];
 			ref_normal[1] = fn[1];
 			ref_normal[2] = fn[2];
 			if(ref_normal.x == 0.0f && ref_normal.y == 0.0f && ref_normal.z == 0.0f)
 			{
-				gfx::vertex_pack(fn, true, gfx::attribute::Normal, vertex_format_, src_vertices_ptr, index);
+				gfx::vertex_pack(math::value_ptr(norm), true, gfx::attribute::Normal, vertex_format_,
+								 dst_vertices_ptr, index);
 			} // End if no normal stored here yet
 			else
 			{
@@ -1924,16 +2143,16 @@ bool mesh::generate_vertex_normals(std::uint32_t* adjacency_ptr,
 					preparation_data_.vertex_data.resize(preparation_data_.vertex_data.size() +
 														 vertex_stride);
 
-					// Ensure that we update the 'src_vertices_ptr' pointer (used
+					// Ensure that we update the 'dst_vertices_ptr' pointer (used
 					// throughout the
 					// loop). The internal buffer wrapped by the resized vertex data
 					// vector
 					// may have been re-allocated.
-					src_vertices_ptr = &preparation_data_.vertex_data[0];
+					dst_vertices_ptr = &preparation_data_.vertex_data[0];
 
 					// Duplicate the vertex at the end of the buffer
-					memcpy(src_vertices_ptr + (preparation_data_.vertex_count * vertex_stride),
-						   src_vertices_ptr + (index * vertex_stride), vertex_stride);
+					memcpy(dst_vertices_ptr + (preparation_data_.vertex_count * vertex_stride),
+						   dst_vertices_ptr + (index * vertex_stride), vertex_stride);
 
 					// Duplicate any other remaining information.
 					preparation_data_.vertex_flags.push_back(preparation_data_.vertex_flags[index]);
@@ -1945,9 +2164,8 @@ bool mesh::generate_vertex_normals(std::uint32_t* adjacency_ptr,
 					// Store the new normal and finally record the fact that we have
 					// added a new vertex.
 					index = preparation_data_.vertex_count++;
-					math::vec4 norm(vec_normal, 0.0f);
 					gfx::vertex_pack(math::value_ptr(norm), true, gfx::attribute::Normal, vertex_format_,
-									 src_vertices_ptr, index);
+									 dst_vertices_ptr, index);
 
 					// Update the index
 					tri.indices[j] = index;
@@ -1960,9 +2178,6 @@ bool mesh::generate_vertex_normals(std::uint32_t* adjacency_ptr,
 
 	} // Next Face
 
-	// We're done with the surface normals
-	checked_array_delete(normals_ptr);
-
 	// If no new vertices were introduced, then it is not necessary
 	// for the caller to remap anything.
 	if(remap_array_ptr && original_vertex_count == preparation_data_.vertex_count)
@@ -1980,9 +2195,7 @@ bool mesh::generate_vertex_barycentrics(std::uint32_t* adjacency)
 
 bool mesh::generate_vertex_tangents()
 {
-	math::vec3 *tangents = nullptr, *bitangents = nullptr;
-	std::uint32_t i, i1, i2, i3, num_faces, num_verts;
-	math::vec3 P, Q, T, B, cross_vec, normal_vec;
+	std::uint32_t num_faces, num_verts;
 
 	// Get access to useful data offset information.
 	std::uint16_t vertex_stride = vertex_format_.getStride();
@@ -1998,159 +2211,172 @@ bool mesh::generate_vertex_tangents()
 	if(!force_tangent_generation_ && !requires_bitangents && !requires_tangents)
 		return true;
 
-	// Allocate storage space for the tangent and bitangent vectors
-	// that we will effectively need to average for shared vertices.
+	// Allocate storage space for the tangent and bitangent vectors of every
+	// face, and for those we will effectively need to average for shared
+	// vertices.
 	num_faces = preparation_data_.triangle_count;
 	num_verts = preparation_data_.vertex_count;
-	tangents = new math::vec3[num_verts];
-	bitangents = new math::vec3[num_verts];
-	memset(tangents, 0, sizeof(math::vec3) * num_verts);
-	memset(bitangents, 0, sizeof(math::vec3) * num_verts);
+	std::vector<math::vec3> face_tangents(num_faces), face_bitangents(num_faces);
+	std::vector<std::uint8_t> face_valid(num_faces, 0);
+	std::vector<math::vec3> tangents(num_verts), bitangents(num_verts);
 
-	// Iterate through each triangle in the mesh
+	// Compute the tangent space of each triangle in the mesh
 	std::uint8_t* src_vertices_ptr = &preparation_data_.vertex_data[0];
-	for(i = 0; i < num_faces; ++i)
-	{
-		triangle& tri = preparation_data_.triangle_data[i];
+	parallel_chunks(num_faces, face_grain, [&](std::size_t begin, std::size_t end) {
+		for(std::size_t i = begin; i < end; ++i)
+		{
+			const triangle& tri = preparation_data_.triangle_data[i];
+
+			// Compute the three indices for the triangle
+			std::uint32_t i1 = tri.indices[0];
+			std::uint32_t i2 = tri.indices[1];
+			std::uint32_t i3 = tri.indices[2];
+
+			// Retrieve references to the positions of the three vertices in the
+			// triangle.
+			math::vec3 E;
+			float fE[4];
+			gfx::vertex_unpack(fE, gfx::attribute::Position, vertex_format_, src_vertices_ptr, i1);
+			math::vec3 F;
+			float fF[4];
+			gfx::vertex_unpack(fF, gfx::attribute::Position, vertex_format_, src_vertices_ptr, i2);
+			math::vec3 G;
+			float fG[4];
+			gfx::vertex_unpack(fG, gfx::attribute::Position, vertex_format_, src_vertices_ptr, i3);
+			memcpy(&E[0], fE, 3 * sizeof(float));
+			memcpy(&F[0], fF, 3 * sizeof(float));
+			memcpy(&G[0], fG, 3 * sizeof(float));
+
+			// Retrieve references to the base texture coordinates of the three vertices
+			// in the triangle.
+			// TODO: Allow customization of which tex coordinates to generate from.
+			math::vec2 Et;
+			float fEt[4];
+			gfx::vertex_unpack(&fEt[0], gfx::attribute::TexCoord0, vertex_format_, src_vertices_ptr, i1);
+			math::vec2 Ft;
+			float fFt[4];
+			gfx::vertex_unpack(&fFt[0], gfx::attribute::TexCoord0, vertex_format_, src_vertices_ptr, i2);
+			math::vec2 Gt;
+			float fGt[4];
+			gfx::vertex_unpack(&fGt[0], gfx::attribute::TexCoord0, vertex_format_, src_vertices_ptr, i3);
+			memcpy(&Et[0], fEt, 2 * sizeof(float));
+			memcpy(&Ft[0], fFt, 2 * sizeof(float));
+			memcpy(&Gt[0], fGt, 2 * sizeof(float));
+
+			// Compute the known variables P & Q, where "P = F-E" and "Q = G-E"
+			// based on our original discussion of the tangent vector
+			// calculation.
+			math::vec3 P = F - E;
+			math::vec3 Q = G - E;
+
+			// Also compute the know variables <s1,t1> and <s2,t2>. Recall that
+			// these are the texture coordinate deltas similarly for "F-E"
+			// and "G-E".
+			float s1 = Ft.x - Et.x;
+			float t1 = Ft.y - Et.y;
+			float s2 = Gt.x - Et.x;
+			float t2 = Gt.y - Et.y;
+
+			// Next we can pre-compute part of the equation we developed
+			// earlier: "1/(s1 * t2 - s2 * t1)". We do this in two separate
+			// stages here in order to ensure that the texture coordinates
+			// are not invalid.
+			float r = (s1 * t2 - s2 * t1);
+			if(math::abs(r) < math::epsilon<float>())
+				continue;
+			r = 1.0f / r;
+
+			// All that's left for us to do now is to run the matrix
+			// multiplication and multiply the result by the scalar portion
+			// we precomputed earlier.
+			math::vec3& T = face_tangents[i];
+			math::vec3& B = face_bitangents[i];
+			T.x = r * (t2 * P.x - t1 * Q.x);
+			T.y = r * (t2 * P.y - t1 * Q.y);
+			T.z = r * (t2 * P.z - t1 * Q.z);
+			B.x = r * (s1 * Q.x - s2 * P.x);
+			B.y = r * (s1 * Q.y - s2 * P.y);
+			B.z = r * (s1 * Q.z - s2 * P.z);
+			face_valid[i] = 1;
+
+		} // Next triangle
+	});
 
-		// Compute the three indices for the triangle
-		i1 = tri.indices[0];
-		i2 = tri.indices[1];
-		i3 = tri.indices[2];
-
-		// Retrieve references to the positions of the three vertices in the
-		// triangle.
-		math::vec3 E;
-		float fE[4];
-		gfx::vertex_unpack(fE, gfx::attribute::Position, vertex_format_, src_vertices_ptr, i1);
-		math::vec3 F;
-		float fF[4];
-		gfx::vertex_unpack(fF, gfx::attribute::Position, vertex_format_, src_vertices_ptr, i2);
-		math::vec3 G;
-		float fG[4];
-		gfx::vertex_unpack(fG, gfx::attribute::Position, vertex_format_, src_vertices_ptr, i3);
-		memcpy(&E[0], fE, 3 * sizeof(float));
-		memcpy(&F[0], fF, 3 * sizeof(float));
-		memcpy(&G[0], fG, 3 * sizeof(float));
-
-		// Retrieve references to the base texture coordinates of the three vertices
-		// in the triangle.
-		// TODO: Allow customization of which tex coordinates to generate from.
-		math::vec2 Et;
-		float fEt[4];
-		gfx::vertex_unpack(&fEt[0], gfx::attribute::TexCoord0, vertex_format_, src_vertices_ptr, i1);
-		math::vec2 Ft;
-		float fFt[4];
-		gfx::vertex_unpack(&fFt[0], gfx::attribute::TexCoord0, vertex_format_, src_vertices_ptr, i2);
-		math::vec2 Gt;
-		float fGt[4];
-		gfx::vertex_unpack(&fGt[0], gfx::attribute::TexCoord0, vertex_format_, src_vertices_ptr, i3);
-		memcpy(&Et[0], fEt, 2 * sizeof(float));
-		memcpy(&Ft[0], fFt, 2 * sizeof(float));
-		memcpy(&Gt[0], fGt, 2 * sizeof(float));
-
-		// Compute the known variables P & Q, where "P = F-E" and "Q = G-E"
-		// based on our original discussion of the tangent vector
-		// calculation.
-		P = F - E;
-		Q = G - E;
-
-		// Also compute the know variables <s1,t1> and <s2,t2>. Recall that
-		// these are the texture coordinate deltas similarly for "F-E"
-		// and "G-E".
-		float s1 = Ft.x - Et.x;
-		float t1 = Ft.y - Et.y;
-		float s2 = Gt.x - Et.x;
-		float t2 = Gt.y - Et.y;
-
-		// Next we can pre-compute part of the equation we developed
-		// earlier: "1/(s1 * t2 - s2 * t1)". We do this in two separate
-		// stages here in order to ensure that the texture coordinates
-		// are not invalid.
-		float r = (s1 * t2 - s2 * t1);
-		if(math::abs(r) < math::epsilon<float>())
+	// Add the tangent and bitangent vectors (summed average) to
+	// any previous values computed for each vertex. Done in face order
+	// so the sums do not depend on the scheduling.
+	for(std::uint32_t i = 0; i < num_faces; ++i)
+	{
+		if(!face_valid[i])
 			continue;
-		r = 1.0f / r;
-
-		// All that's left for us to do now is to run the matrix
-		// multiplication and multiply the result by the scalar portion
-		// we precomputed earlier.
-		T.x = r * (t2 * P.x - t1 * Q.x);
-		T.y = r * (t2 * P.y - t1 * Q.y);
-		T.z = r * (t2 * P.z - t1 * Q.z);
-		B.x = r * (s1 * Q.x - s2 * P.x);
-		B.y = r * (s1 * Q.y - s2 * P.y);
-		B.z = r * (s1 * Q.z - s2 * P.z);
-
-		// Add the tangent and bitangent vectors (summed average) to
-		// any previous values computed for each vertex.
-		tangents[i1] += T;
-		tangents[i2] += T;
-		tangents[i3] += T;
-		bitangents[i1] += B;
-		bitangents[i2] += B;
-		bitangents[i3] += B;
+
+		for(auto index : preparation_data_.triangle_data[i].indices)
+		{
+			tangents[index] += face_tangents[i];
+			bitangents[index] += face_bitangents[i];
+		}
 
 	} // Next triangle
 
 	// Generate final tangent vectors
-	for(i = 0; i < num_verts; i++, src_vertices_ptr += vertex_stride)
-	{
-		// Skip if the original imported data already provided a bitangent /
-		// tangent.
-		bool has_bitangent =
-			((preparation_data_.vertex_flags[i] & preparation_data::source_contains_binormal) != 0);
-		bool has_tangent =
-			((preparation_data_.vertex_flags[i] & preparation_data::source_contains_tangent) != 0);
-		if(!force_tangent_generation_ && has_bitangent && has_tangent)
-			continue;
+	parallel_chunks(num_verts, vertex_grain, [&](std::size_t begin, std::size_t end) {
+		for(std::size_t i = begin; i < end; ++i)
+		{
+			std::uint8_t* vertex_ptr = src_vertices_ptr + (i * vertex_stride);
+
+			// Skip if the original imported data already provided a bitangent /
+			// tangent.
+			bool has_bitangent =
+				((preparation_data_.vertex_flags[i] & preparation_data::source_contains_binormal) != 0);
+			bool has_tangent =
+				((preparation_data_.vertex_flags[i] & preparation_data::source_contains_tangent) != 0);
+			if(!force_tangent_generation_ && has_bitangent && has_tangent)
+				continue;
 
-		// Retrieve the normal vector from the vertex and the computed
-		// tangent vector.
-		float normal[4];
-		gfx::vertex_unpack(normal, gfx::attribute::Normal, vertex_format_, src_vertices_ptr);
-		memcpy(&normal_vec[0], normal, 3 * sizeof(float));
+			// Retrieve the normal vector from the vertex and the computed
+			// tangent vector.
+			math::vec3 normal_vec;
+			float normal[4];
+			gfx::vertex_unpack(normal, gfx::attribute::Normal, vertex_format_, vertex_ptr);
+			memcpy(&normal_vec[0], normal, 3 * sizeof(float));
 
-		T = tangents[i];
+			math::vec3 T = tangents[i];
 
-		// GramSchmidt orthogonalize
-		T = T - (normal_vec * math::dot(normal_vec, T));
-		T = math::normalize(T);
+			// GramSchmidt orthogonalize
+			T = T - (normal_vec * math::dot(normal_vec, T));
+			T = math::normalize(T);
 
-		// Store tangent if required
-		if(force_tangent_generation_ || (!has_tangent && requires_tangents))
-			gfx::vertex_pack(&math::vec4(T, 1.0f)[0], true, gfx::attribute::Tangent, vertex_format_,
-							 src_vertices_ptr);
+			// Store tangent if required
+			if(force_tangent_generation_ || (!has_tangent && requires_tangents))
+				gfx::vertex_pack(&math::vec4(T, 1.0f)[0], true, gfx::attribute::Tangent, vertex_format_,
+								 vertex_ptr);
 
-		// Compute and store bitangent if required
-		if(force_tangent_generation_ || (!has_bitangent && requires_bitangents))
-		{
-			// Calculate the new orthogonal bitangent
-			B = math::cross(normal_vec, T);
-			B = math::normalize(B);
-
-			// Compute the "handedness" of the tangent and bitangent. This
-			// ensures the inverted / mirrored texture coordinates still have
-			// an accurate matrix.
-			cross_vec = math::cross(normal_vec, T);
-			if(math::dot(cross_vec, bitangents[i]) < 0.0f)
+			// Compute and store bitangent if required
+			if(force_tangent_generation_ || (!has_bitangent && requires_bitangents))
 			{
-				// Flip the bitangent
-				B = -B;
-
-			} // End if coordinates inverted
+				// Calculate the new orthogonal bitangent
+				math::vec3 B = math::cross(normal_vec, T);
+				B = math::normalize(B);
+
+				// Compute the "handedness" of the tangent and bitangent. This
+				// ensures the inverted / mirrored texture coordinates still have
+				// an accurate matrix.
+				math::vec3 cross_vec = math::cross(normal_vec, T);
+				if(math::dot(cross_vec, bitangents[i]) < 0.0f)
+				{
+					// Flip the bitangent
+					B = -B;
 
-			// Store.
-			gfx::vertex_pack(&math::vec4(B, 1.0f)[0], true, gfx::attribute::Bitangent, vertex_format_,
-							 src_vertices_ptr);
+				} // End if coordinates inverted
 
-		} // End if requires bitangent
+				// Store.
+				gfx::vertex_pack(&math::vec4(B, 1.0f)[0], true, gfx::attribute::Bitangent, vertex_format_,
+								 vertex_ptr);
 
-	} // Next vertex
+			} // End if requires bitangent
 
-	// Cleanup
-	checked_array_delete(tangents);
-	checked_array_delete(bitangents);
+		} // Next vertex
+	});
 
 	// Return success
 	return true;
@@ -2158,206 +2384,111 @@ bool mesh::generate_vertex_tangents()
 
 bool mesh::generate_adjacency(std::vector<std::uint32_t>& adjacency)
 {
-	std::map<adjacent_edge_key, std::uint32_t> edge_tree;
-	std::map<adjacent_edge_key, std::uint32_t>::iterator it_edge;
-
 	// What is the status of the mesh?
-	if(prepare_status_ != mesh_status::prepared)
-	{
-		// Validate requirements
-		if(preparation_data_.triangle_count == 0)
-			return false;
-
-		// Retrieve useful data offset information.
-		std::uint16_t position_offset = vertex_format_.getOffset(gfx::attribute::Position);
-		std::uint16_t vertex_stride = vertex_format_.getStride();
-
-		// Insert all edges into the edge tree
-		std::uint8_t* src_vertices_ptr = &preparation_data_.vertex_data[0] + position_offset;
-		for(std::uint32_t i = 0; i < preparation_data_.triangle_count; ++i)
-		{
-			adjacent_edge_key edge;
+	const bool prepared = (prepare_status_ == mesh_status::prepared);
+	const std::uint32_t face_count = prepared ? face_count_ : preparation_data_.triangle_count;
+	const std::uint32_t vertex_count = prepared ? vertex_count_ : preparation_data_.vertex_count;
 
-			// Degenerate triangles cannot participate.
-			const triangle& tri = preparation_data_.triangle_data[i];
-			if(tri.flags & triangle_flags::degenerate)
-				continue;
+	// Validate requirements
+	if(face_count == 0)
+		return false;
 
-			// Retrieve positions of each referenced vertex.
-			const math::vec3* v1 =
-				reinterpret_cast<const math::vec3*>(src_vertices_ptr + (tri.indices[0] * vertex_stride));
-			const math::vec3* v2 =
-				reinterpret_cast<const math::vec3*>(src_vertices_ptr + (tri.indices[1] * vertex_stride));
-			const math::vec3* v3 =
-				reinterpret_cast<const math::vec3*>(src_vertices_ptr + (tri.indices[2] * vertex_stride));
-
-			// edge 1
-			edge.vertex1 = v1;
-			edge.vertex2 = v2;
-			edge_tree[edge] = i;
-
-			// edge 2
-			edge.vertex1 = v2;
-			edge.vertex2 = v3;
-			edge_tree[edge] = i;
-
-			// edge 3
-			edge.vertex1 = v3;
-			edge.vertex2 = v1;
-			edge_tree[edge] = i;
+	// Retrieve useful data offset information.
+	std::uint16_t position_offset = vertex_format_.getOffset(gfx::attribute::Position);
+	std::uint16_t vertex_stride = vertex_format_.getStride();
+	const std::uint8_t* src_vertices_ptr =
+		(prepared ? system_vb_ : &preparation_data_.vertex_data[0]) + position_offset;
 
-		} // Next Face
+	// Returns the indices of a face, or nullptr for degenerate triangles which
+	// cannot participate.
+	const auto get_face_indices = [&](std::uint32_t face) -> const std::uint32_t* {
+		if(prepared)
+			return &system_ib_[face * 3];
 
-		// Size the output array.
-		adjacency.resize(preparation_data_.triangle_count * 3, 0xFFFFFFFF);
+		const triangle& tri = preparation_data_.triangle_data[face];
+		if(tri.flags & triangle_flags::degenerate)
+			return nullptr;
+		return tri.indices;
+	};
 
-		// Now, find any adjacent edges for each triangle edge
-		for(std::uint32_t i = 0; i < preparation_data_.triangle_count; ++i)
+	// Vertices sharing a position (within epsilon) share an edge, so map each
+	// one to the first vertex found at its location.
+	std::vector<std::uint32_t> position_ids(vertex_count);
+	std::uint32_t position_count = 0;
+	{
+		std::vector<const math::vec3*> unique_positions;
+		unique_positions.reserve(vertex_count);
+		position_grid grid(math::epsilon<float>(), vertex_count);
+		for(std::uint32_t i = 0; i < vertex_count; ++i)
 		{
-			adjacent_edge_key edge;
+			const auto* v = reinterpret_cast<const math::vec3*>(src_vertices_ptr + (i * vertex_stride));
+			std::uint32_t id = grid.find(*v, [&](std::uint32_t candidate) {
+				const math::vec3& p = *unique_positions[candidate];
+				return math::all(math::epsilonEqual(p, *v, math::epsilon<float>()));
+			});
 
-			// Degenerate triangles cannot participate.
-			const triangle& tri = preparation_data_.triangle_data[i];
-			if(tri.flags & triangle_flags::degenerate)
-				continue;
+			if(id == position_grid::invalid_index)
+			{
+				id = position_count++;
+				unique_positions.push_back(v);
+				grid.insert(*v, id);
+			}
+			position_ids[i] = id;
 
-			// Retrieve positions of each referenced vertex.
-			const math::vec3* v1 =
-				reinterpret_cast<const math::vec3*>(src_vertices_ptr + (tri.indices[0] * vertex_stride));
-			const math::vec3* v2 =
-				reinterpret_cast<const math::vec3*>(src_vertices_ptr + (tri.indices[1] * vertex_stride));
-			const math::vec3* v3 =
-				reinterpret_cast<const math::vec3*>(src_vertices_ptr + (tri.indices[2] * vertex_stride));
-
-			// Note: Notice below that the order of the edge vertices
-			//       is swapped. This is because we want to find the
-			//       matching ADJACENT edge, rather than simply finding
-			//       the same edge that we're currently processing.
-
-			// edge 1
-			edge.vertex2 = v1;
-			edge.vertex1 = v2;
-
-			// Find the matching adjacent edge
-			it_edge = edge_tree.find(edge);
-			if(it_edge != edge_tree.end())
-				adjacency[(i * 3)] = it_edge->second;
-
-			// edge 2
-			edge.vertex2 = v2;
-			edge.vertex1 = v3;
-
-			// Find the matching adjacent edge
-			it_edge = edge_tree.find(edge);
-			if(it_edge != edge_tree.end())
-				adjacency[(i * 3) + 1] = it_edge->second;
-
-			// edge 3
-			edge.vertex2 = v3;
-			edge.vertex1 = v1;
-
-			// Find the matching adjacent edge
-			it_edge = edge_tree.find(edge);
-			if(it_edge != edge_tree.end())
-				adjacency[(i * 3) + 2] = it_edge->second;
+		} // Next Vertex
+	}
 
-		} // Next Face
+	// Directed edges are keyed by the ids of their start and end position.
+	const auto edge_key = [](std::uint32_t from, std::uint32_t to) {
+		return (std::uint64_t(from) << 32) | std::uint64_t(to);
+	};
 
-	} // End if not prepared
-	else
+	// Insert all edges into the edge table
+	std::unordered_map<std::uint64_t, std::uint32_t> edge_table;
+	edge_table.reserve(face_count * 3);
+	for(std::uint32_t i = 0; i < face_count; ++i)
 	{
-		// Validate requirements
-		if(face_count_ == 0)
-			return false;
+		const std::uint32_t* indices = get_face_indices(i);
+		if(indices == nullptr)
+			continue;
 
-		// Retrieve useful data offset information.
-		std::uint16_t position_offset = vertex_format_.getOffset(gfx::attribute::Position);
-		std::uint16_t vertex_stride = vertex_format_.getStride();
+		const std::uint32_t v1 = position_ids[indices[0]];
+		const std::uint32_t v2 = position_ids[indices[1]];
+		const std::uint32_t v3 = position_ids[indices[2]];
+		edge_table[edge_key(v1, v2)] = i;
+		edge_table[edge_key(v2, v3)] = i;
+		edge_table[edge_key(v3, v1)] = i;
 
-		// Insert all edges into the edge tree
-		std::uint8_t* src_vertices_ptr = system_vb_ + position_offset;
-		std::uint32_t* src_indices_ptr = system_ib_;
-		for(std::uint32_t i = 0; i < face_count_; ++i, src_indices_ptr += 3)
-		{
-			adjacent_edge_key edge;
+	} // Next Face
 
-			// Retrieve positions of each referenced vertex.
-			const auto* v1 =
-				reinterpret_cast<const math::vec3*>(src_vertices_ptr + (src_indices_ptr[0] * vertex_stride));
-			const auto* v2 =
-				reinterpret_cast<const math::vec3*>(src_vertices_ptr + (src_indices_ptr[1] * vertex_stride));
-			const auto* v3 =
-				reinterpret_cast<const math::vec3*>(src_vertices_ptr + (src_indices_ptr[2] * vertex_stride));
-
-			// edge 1
-			edge.vertex1 = v1;
-			edge.vertex2 = v2;
-			edge_tree[edge] = i;
-
-			// edge 2
-			edge.vertex1 = v2;
-			edge.vertex2 = v3;
-			edge_tree[edge] = i;
-
-			// edge 3
-			edge.vertex1 = v3;
-			edge.vertex2 = v1;
-			edge_tree[edge] = i;
+	// Size the output array.
+	adjacency.assign(face_count * 3, 0xFFFFFFFF);
 
-		} // Next Face
+	// Now, find any adjacent edges for each triangle edge
+	for(std::uint32_t i = 0; i < face_count; ++i)
+	{
+		const std::uint32_t* indices = get_face_indices(i);
+		if(indices == nullptr)
+			continue;
 
-		// Size the output array.
-		adjacency.resize(face_count_ * 3, 0xFFFFFFFF);
+		const std::uint32_t v1 = position_ids[indices[0]];
+		const std::uint32_t v2 = position_ids[indices[1]];
+		const std::uint32_t v3 = position_ids[indices[2]];
 
-		// Now, find any adjacent edges for each triangle edge
-		src_indices_ptr = system_ib_;
-		for(std::uint32_t i = 0; i < face_count_; ++i, src_indices_ptr += 3)
+		// Note: Notice below that the order of the edge vertices
+		//       is swapped. This is because we want to find the
+		//       matching ADJACENT edge, rather than simply finding
+		//       the same edge that we're currently processing.
+		const std::uint64_t edges[3] = {edge_key(v2, v1), edge_key(v3, v2), edge_key(v1, v3)};
+		for(std::uint32_t j = 0; j < 3; ++j)
 		{
-			adjacent_edge_key edge;
+			auto it_edge = edge_table.find(edges[j]);
+			if(it_edge != edge_table.end())
+				adjacency[(i * 3) + j] = it_edge->second;
 
-			// Retrieve positions of each referenced vertex.
-			const math::vec3* v1 =
-				reinterpret_cast<const math::vec3*>(src_vertices_ptr + (src_indices_ptr[0] * vertex_stride));
-			const math::vec3* v2 =
-				reinterpret_cast<const math::vec3*>(src_vertices_ptr + (src_indices_ptr[1] * vertex_stride));
-			const math::vec3* v3 =
-				reinterpret_cast<const math::vec3*>(src_vertices_ptr + (src_indices_ptr[2] * vertex_stride));
-
-			// Note: Notice below that the order of the edge vertices
-			//       is swapped. This is because we want to find the
-			//       matching ADJACENT edge, rather than simply finding
-			//       the same edge that we're currently processing.
-
-			// edge 1
-			edge.vertex2 = v1;
-			edge.vertex1 = v2;
-
-			// Find the matching adjacent edge
-			it_edge = edge_tree.find(edge);
-			if(it_edge != edge_tree.end())
-				adjacency[(i * 3)] = it_edge->second;
-
-			// edge 2
-			edge.vertex2 = v2;
-			edge.vertex1 = v3;
-
-			// Find the matching adjacent edge
-			it_edge = edge_tree.find(edge);
-			if(it_edge != edge_tree.end())
-				adjacency[(i * 3) + 1] = it_edge->second;
-
-			// edge 3
-			edge.vertex2 = v3;
-			edge.vertex1 = v1;
-
-			// Find the matching adjacent edge
-			it_edge = edge_tree.find(edge);
-			if(it_edge != edge_tree.end())
-				adjacency[(i * 3) + 2] = it_edge->second;
-
-		} // Next Face
+		} // Next Edge
 
-	} // End if prepared
+	} // Next Face
 
 	// Success!
 	return true;
@@ -2365,62 +2496,76 @@ bool mesh::generate_adjacency(std::vector<std::uint32_t>& adjacency)
 
 bool mesh::weld_vertices(float tolerance, std::vector<std::uint32_t>* vertex_remap_ptr /* = nullptr */)
 {
-	weld_key key;
-	std::map<weld_key, std::uint32_t> vertex_tree;
-	std::map<weld_key, std::uint32_t>::const_iterator it_key;
-	byte_array_t new_vertex_data, new_vertex_flags;
-	std::uint32_t new_vertex_count = 0;
+	const std::uint32_t vertex_count = preparation_data_.vertex_count;
+	if(vertex_count == 0)
+	{
+		if(vertex_remap_ptr)
+			vertex_remap_ptr->clear();
+		return true;
+	}
 
 	// Allocate enough space to build the remap array for the existing vertices
 	if(vertex_remap_ptr)
-		vertex_remap_ptr->resize(preparation_data_.vertex_count);
-	auto collapse_map = new std::uint32_t[preparation_data_.vertex_count];
+		vertex_remap_ptr->resize(vertex_count);
+	std::vector<std::uint32_t> collapse_map(vertex_count);
 
-	// Retrieve useful data offset information.
+	// Retrieve useful data offset information. Everything but the position
+	// has to match exactly for two vertices to be welded.
 	std::uint16_t vertex_stride = vertex_format_.getStride();
+	std::uint16_t position_offset = vertex_format_.getOffset(gfx::attribute::Position);
+	auto position_end = static_cast<std::uint16_t>(position_offset + sizeof(math::vec3));
+	const float tolerance_sq = tolerance * tolerance;
+
+	byte_array_t new_vertex_data, new_vertex_flags;
+	new_vertex_data.reserve(preparation_data_.vertex_data.size());
+	new_vertex_flags.reserve(vertex_count);
+	std::uint32_t new_vertex_count = 0;
 
 	// For each vertex to be welded.
-	for(std::uint32_t i = 0; i < preparation_data_.vertex_count; ++i)
+	position_grid grid(tolerance, vertex_count);
+	const std::uint8_t* src_vertex_ptr = &preparation_data_.vertex_data[0];
+	for(std::uint32_t i = 0; i < vertex_count; ++i, src_vertex_ptr += vertex_stride)
 	{
-		// Build a new key structure for inserting
-		key.vertex = (&preparation_data_.vertex_data[0]) + (i * vertex_stride);
-		key.format = vertex_format_;
-		key.tolerance = tolerance;
-
-		// Does a vertex with matching details already exist in the tree.
-		it_key = vertex_tree.find(key);
-		if(it_key == vertex_tree.end())
+		const auto& position = *reinterpret_cast<const math::vec3*>(src_vertex_ptr + position_offset);
+
+		// Does a vertex with matching details already exist nearby.
+		std::uint32_t index = grid.find(position, [&](std::uint32_t candidate) {
+			const std::uint8_t* vertex_ptr = &new_vertex_data[candidate * vertex_stride];
+			const auto& p = *reinterpret_cast<const math::vec3*>(vertex_ptr + position_offset);
+			return math::distance2(p, position) <= tolerance_sq &&
+				   memcmp(vertex_ptr, src_vertex_ptr, position_offset) == 0 &&
+				   memcmp(vertex_ptr + position_end, src_vertex_ptr + position_end,
+						  vertex_stride - position_end) == 0;
+		});
+
+		if(index == position_grid::invalid_index)
 		{
-			// No matching vertex. Insert into the tree (value = NEW index of vertex).
-			vertex_tree[key] = new_vertex_count;
-			collapse_map[i] = new_vertex_count;
-			if(vertex_remap_ptr)
-				(*vertex_remap_ptr)[i] = new_vertex_count;
-
-			// Store the vertex in the new buffer
-			new_vertex_data.resize((new_vertex_count + 1) * vertex_stride);
-			memcpy(&new_vertex_data[new_vertex_count * vertex_stride], key.vertex, vertex_stride);
+			// No matching vertex. Store the vertex in the new buffer.
+			index = new_vertex_count++;
+			new_vertex_data.insert(new_vertex_data.end(), src_vertex_ptr, src_vertex_ptr + vertex_stride);
 			new_vertex_flags.push_back(preparation_data_.vertex_flags[i]);
-			new_vertex_count++;
+			grid.insert(position, index);
+
+			if(vertex_remap_ptr)
+				(*vertex_remap_ptr)[i] = index;
 
 		} // End if no matching vertex
 		else
 		{
 			// A vertex already existed at this location.
 			// Just mark the 'collapsed' index for this vertex in the remap array.
-			collapse_map[i] = it_key->second;
 			if(vertex_remap_ptr)
 				(*vertex_remap_ptr)[i] = 0xFFFFFFFF;
 
 		} // End if vertex already existed
 
+		collapse_map[i] = index;
+
 	} // Next Vertex
 
 	// If nothing was welded, just bail
-	if(preparation_data_.vertex_count == new_vertex_count)
+	if(vertex_count == new_vertex_count)
 	{
-		checked_array_delete(collapse_map);
-
 		if(vertex_remap_ptr)
 			vertex_remap_ptr->clear();
 		return true;
@@ -2428,12 +2573,8 @@ bool mesh::weld_vertices(float tolerance, std::vector<std::uint32_t>* vertex_rem
 	} // End if nothing to do
 
 	// Otherwise, replace the old preparation vertices and remap
-	preparation_data_.vertex_data.clear();
-	preparation_data_.vertex_data.resize(new_vertex_data.size());
-	memcpy(&preparation_data_.vertex_data[0], &new_vertex_data[0], new_vertex_data.size());
-	preparation_data_.vertex_flags.clear();
-	preparation_data_.vertex_flags.resize(new_vertex_flags.size());
-	memcpy(&preparation_data_.vertex_flags[0], &new_vertex_flags[0], new_vertex_flags.size());
+	preparation_data_.vertex_data = std::move(new_vertex_data);
+	preparation_data_.vertex_flags = std::move(new_vertex_flags);
 	preparation_data_.vertex_count = new_vertex_count;
 
 	// Now remap all the triangle indices
@@ -2446,9 +2587,6 @@ bool mesh::weld_vertices(float tolerance, std::vector<std::uint32_t>* vertex_rem
 
 	} // Next triangle
 
-	// Clean up
-	checked_array_delete(collapse_map);
-
 	// Success!
 	return true;
 }
@@ -2511,6 +2649,11 @@ const std::unique_ptr<mesh::armature_node>& mesh::get_armature() const
 	return root_;
 }
 
+const skeleton& mesh::get_skeleton() const
+{
+	return skeleton_;
+}
+
 irect32_t mesh::calculate_screen_rect(const math::transform& world, const camera& cam) const
 {
 
@@ -2543,46 +2686,11 @@ irect32_t mesh::calculate_screen_rect(const math::transform& world, const camera
 ///////////////////////////////////////////////////////////////////////////////
 // Global Operator Definitions
 ///////////////////////////////////////////////////////////////////////////////
-bool operator<(const mesh::adjacent_edge_key& key1, const mesh::adjacent_edge_key& key2)
-{
-	// Test vertex positions.
-	if(math::epsilonNotEqual(key1.vertex1->x, key2.vertex1->x, math::epsilon<float>()))
-		return (key2.vertex1->x < key1.vertex1->x);
-	if(math::epsilonNotEqual(key1.vertex1->y, key2.vertex1->y, math::epsilon<float>()))
-		return (key2.vertex1->y < key1.vertex1->y);
-	if(math::epsilonNotEqual(key1.vertex1->z, key2.vertex1->z, math::epsilon<float>()))
-		return (key2.vertex1->z < key1.vertex1->z);
-
-	if(math::epsilonNotEqual(key1.vertex2->x, key2.vertex2->x, math::epsilon<float>()))
-		return (key2.vertex2->x < key1.vertex2->x);
-	if(math::epsilonNotEqual(key1.vertex2->y, key2.vertex2->y, math::epsilon<float>()))
-		return (key2.vertex2->y < key1.vertex2->y);
-	if(math::epsilonNotEqual(key1.vertex2->z, key2.vertex2->z, math::epsilon<float>()))
-		return (key2.vertex2->z < key1.vertex2->z);
-
-	// Exactly equal
-	return false;
-}
-
 bool operator<(const mesh::mesh_subset_key& key1, const mesh::mesh_subset_key& key2)
 {
 	return key1.data_group_id < key2.data_group_id;
 }
 
-bool operator<(const mesh::weld_key& key1, const mesh::weld_key& key2)
-{
-	float pos1[4];
-	gfx::vertex_unpack(pos1, gfx::attribute::Position, key1.format, key1.vertex);
-	math::vec3 v1(pos1[0], pos1[1], pos1[2]);
-
-	float pos2[4] = {0};
-	gfx::vertex_unpack(pos1, gfx::attribute::Position, key2.format, key2.vertex);
-	math::vec3 v2(pos2[0], pos2[1], pos2[2]);
-	float tolerance = key1.tolerance * key2.tolerance;
-
-	return math::distance2(v1, v2) > tolerance;
-}
-
 bool operator<(const mesh::bone_combination_key& key1, const mesh::bone_combination_key& key2)
 {
 	// Data group id must match.
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "./bone.h"
+#include "./skeleton.h"
 #include "./skin.h"
 
 #include <core/common/basetypes.hpp>
@@ -199,7 +200,8 @@ public:
 	//-----------------------------------------------------------------------------
 	//  Name : bind_armature ()
 	/// <summary>
-	/// Bind the armature tree.
+	/// Bind the armature tree and flatten it into the skeleton. Call after
+	/// bind_skin so the bones can be mapped to their nodes.
 	/// </summary>
 	//-----------------------------------------------------------------------------
 	bool bind_armature(std::unique_ptr<armature_node>& root);
@@ -340,6 +342,41 @@ public:
 	//-----------------------------------------------------------------------------
 	void build_ib(bool hardware_copy = true);
 
+	//-----------------------------------------------------------------------------
+	//  Name : copy_vb ()
+	/// <summary>
+	/// Copies the prepared vertex data into a graphics memory block to build
+	/// the vertex buffer from. Unlike building the buffer this can be done on
+	/// any thread, so loaders copy large meshes off the owner thread.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	const gfx::memory_view* copy_vb() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : copy_ib ()
+	/// <summary>
+	/// Copies the prepared index data into a graphics memory block to build
+	/// the index buffer from. Can be done on any thread.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	const gfx::memory_view* copy_ib() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : build_vb ()
+	/// <summary>
+	/// Builds internal vertex buffer from a block made by copy_vb.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void build_vb(const gfx::memory_view* mem);
+
+	//-----------------------------------------------------------------------------
+	//  Name : build_ib ()
+	/// <summary>
+	/// Builds internal index buffer from a block made by copy_ib.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void build_ib(const gfx::memory_view* mem);
+
 	// Utility functions
 	//-----------------------------------------------------------------------------
 	//  Name : generate_adjacency ()
@@ -420,6 +457,15 @@ public:
 	const bone_palette_array_t& get_bone_palettes() const;
 
 	const std::unique_ptr<armature_node>& get_armature() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_skeleton ()
+	/// <summary>
+	/// Flattened armature used to pose the skin at runtime.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	const skeleton& get_skeleton() const;
+
 	irect32_t calculate_screen_rect(const math::transform& world, const camera& cam) const;
 	//-----------------------------------------------------------------------------
 	//  Name : get_subset ()
@@ -542,15 +588,6 @@ protected:
 
 	}; // End Struct optimizer_triangle_info
 
-	struct adjacent_edge_key
-	{
-		/// Pointer to the first vertex in the edge
-		const math::vec3* vertex1 = nullptr;
-		/// Pointer to the second vertex in the edge
-		const math::vec3* vertex2 = nullptr;
-
-	}; // End Struct adjacent_edge_key
-
 	struct mesh_subset_key
 	{
 		/// The data group identifier for this subset.
@@ -569,20 +606,6 @@ protected:
 	using subset_key_map_t = std::map<mesh_subset_key, subset*>;
 	using subset_key_array_t = std::vector<mesh_subset_key>;
 
-	// Simple structure to allow us to leverage the hierarchical properties of a
-	// map
-	// to accelerate the weld operation.
-	struct weld_key
-	{
-		// Pointer to the vertex for easy access.
-		std::uint8_t* vertex;
-		// Format of the above vertex for easy access.
-		gfx::vertex_layout format;
-		// The tolerance we're using to weld (transport only, these should be the
-		// same for every key).
-		float tolerance;
-	};
-
 	struct face_influences
 	{
 		bone_palette::bone_index_map_t bones; // List of unique bones that influence a given number of faces.
@@ -607,9 +630,7 @@ protected:
 	//-------------------------------------------------------------------------
 	// Friend List
 	//-------------------------------------------------------------------------
-	friend bool operator<(const adjacent_edge_key& key1, const adjacent_edge_key& key2);
 	friend bool operator<(const mesh_subset_key& key1, const mesh_subset_key& key2);
-	friend bool operator<(const weld_key& key1, const weld_key& key2);
 	friend bool operator<(const bone_combination_key& key1, const bone_combination_key& key2);
 	//-------------------------------------------------------------------------
 	// Protected Methods
@@ -778,4 +799,6 @@ protected:
 	bone_palette_array_t bone_palettes_;
 	/// List of each of armature nodes
 	std::unique_ptr<armature_node> root_ = nullptr;
+	/// The armature flattened parent before child.
+	skeleton skeleton_;
 };
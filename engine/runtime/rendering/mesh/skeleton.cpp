@@ -0,0 +1,140 @@
+#include "skeleton.h"
+
+#include <cassert>
+
+std::int32_t skeleton::add_node(const std::string& name, std::int32_t parent,
+                                const math::transform& local_transform)
+{
+  assert(parent < std::int32_t(parents_.size()));
+
+  parents_.push_back(parent);
+  names_.push_back(name);
+  bind_pose_.push_back(local_transform);
+  return std::int32_t(parents_.size() - 1);
+}
+
+void skeleton::bind(const skin_bind_data& bind_data)
+{
+  const auto& bones = bind_data.get_bones();
+  bone_nodes_.clear();
+  bone_nodes_.reserve(bones.size());
+  for(const auto& bone : bones)
+  {
+    bone_nodes_.push_back(find_node(bone.bone_id));
+  }
+}
+
+void skeleton::clear()
+{
+  parents_.clear();
+  names_.clear();
+  bind_pose_.clear();
+  bone_nodes_.clear();
+}
+
+std::int32_t skeleton::find_node(const std::string& name) const
+{
+  for(std::size_t i = 0; i < names_.size(); ++i)
+  {
+    if(names_[i] == name)
+      return std::int32_t(i);
+  }
+
+  return invalid_index;
+}
+
+bool skeleton::empty() const
+{
+  return parents_.empty();
+}
+
+std::size_t skeleton::get_node_count() const
+{
+  return parents_.size();
+}
+
+const std::vector<std::int32_t>& skeleton::get_parents() const
+{
+  return parents_;
+}
+
+const std::vector<std::string>& skeleton::get_names() const
+{
+  return names_;
+}
+
+const std::vector<math::transform>& skeleton::get_bind_pose() const
+{
+  return bind_pose_;
+}
+
+const std::vector<std::int32_t>& skeleton::get_bone_nodes() const
+{
+  return bone_nodes_;
+}
+
+void skeleton_pose::reset(const skeleton& skel)
+{
+  skeleton_ = &skel;
+  local_ = skel.get_bind_pose();
+  model_.resize(skel.get_node_count());
+  bones_.resize(skel.get_bone_nodes().size());
+}
+
+bool skeleton_pose::is_bound_to(const skeleton& skel) const
+{
+  // a reloaded mesh may reuse the address, the sizes catch most of that
+  return skeleton_ == &skel && local_.size() == skel.get_node_count() &&
+         bones_.size() == skel.get_bone_nodes().size();
+}
+
+void skeleton_pose::compute_model_space(const skeleton& skel)
+{
+  const auto& parents = skel.get_parents();
+  assert(parents.size() == local_.size());
+
+  for(std::size_t i = 0; i < local_.size(); ++i)
+  {
+    const auto parent = parents[i];
+    if(parent == skeleton::invalid_index)
+      model_[i] = local_[i].get_matrix();
+    else
+      model_[i] = model_[std::size_t(parent)] * local_[i].get_matrix();
+  }
+}
+
+void skeleton_pose::compute_bone_transforms(const skeleton& skel, const math::transform& world_transform)
+{
+  const auto& bone_nodes = skel.get_bone_nodes();
+  assert(bone_nodes.size() == bones_.size());
+
+  const auto& world = world_transform.get_matrix();
+  for(std::size_t i = 0; i < bone_nodes.size(); ++i)
+  {
+    const auto node = bone_nodes[i];
+    if(node == skeleton::invalid_index)
+      bones_[i] = world_transform;
+    else
+      bones_[i] = math::transform(world * model_[std::size_t(node)]);
+  }
+}
+
+std::vector<math::transform>& skeleton_pose::get_local_transforms()
+{
+  return local_;
+}
+
+const std::vector<math::transform>& skeleton_pose::get_local_transforms() const
+{
+  return local_;
+}
+
+const std::vector<math::transform::mat4_t>& skeleton_pose::get_model_transforms() const
+{
+  return model_;
+}
+
+const std::vector<math::transform>& skeleton_pose::get_bone_transforms() const
+{
+  return bones_;
+}
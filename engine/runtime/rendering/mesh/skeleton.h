@@ -0,0 +1,209 @@
+#pragma once
+
+#include <core/math/math_includes.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "./skin.h"
+
+//-----------------------------------------------------------------------------
+// Main Class Declarations
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//  Name : skeleton (Class)
+/// <summary>
+/// Flattened armature of a mesh. Nodes are stored parent before child so a
+/// pose can be resolved with one pass over contiguous arrays, and every bone
+/// of the skin bind data is mapped to the node driving it.
+/// </summary>
+//-----------------------------------------------------------------------------
+class skeleton
+{
+public:
+  /// Parent index of the root nodes.
+  static constexpr std::int32_t invalid_index = -1;
+
+  //-----------------------------------------------------------------------------
+  //  Name : add_node ()
+  /// <summary>
+  /// Appends a node and returns its index. The parent must have been added
+  /// before, or be invalid_index for a root.
+  /// </summary>
+  //-----------------------------------------------------------------------------
+  std::int32_t add_node(const std::string& name, std::int32_t parent, const math::transform& local_transform);
+
+  //-----------------------------------------------------------------------------
+  //  Name : bind ()
+  /// <summary>
+  /// Maps the bones of the skin to the nodes of the same name. Bones without
+  /// a node map to invalid_index and keep the identity transform.
+  /// </summary>
+  //-----------------------------------------------------------------------------
+  void bind(const skin_bind_data& bind_data);
+
+  //-----------------------------------------------------------------------------
+  //  Name : clear ()
+  /// <summary>
+  /// Removes all nodes and bones.
+  /// </summary>
+  //-----------------------------------------------------------------------------
+  void clear();
+
+  //-----------------------------------------------------------------------------
+  //  Name : find_node ()
+  /// <summary>
+  /// Index of the node with the name or invalid_index.
+  /// </summary>
+  //-----------------------------------------------------------------------------
+  std::int32_t find_node(const std::string& name) const;
+
+  //-----------------------------------------------------------------------------
+  //  Name : empty ()
+  /// <summary>
+  /// Does the skeleton have no nodes.
+  /// </summary>
+  //-----------------------------------------------------------------------------
+  bool empty() const;
+
+  //-----------------------------------------------------------------------------
+  //  Name : get_node_count ()
+  /// <summary>
+  /// Number of nodes.
+  /// </summary>
+  //-----------------------------------------------------------------------------
+  std::size_t get_node_count() const;
+
+  //-----------------------------------------------------------------------------
+  //  Name : get_parents ()
+  /// <summary>
+  /// Parent index of every node, always lower than the index of the node.
+  /// </summary>
+  //-----------------------------------------------------------------------------
+  const std::vector<std::int32_t>& get_parents() const;
+
+  //-----------------------------------------------------------------------------
+  //  Name : get_names ()
+  /// <summary>
+  /// Name of every node.
+  /// </summary>
+  //-----------------------------------------------------------------------------
+  const std::vector<std::string>& get_names() const;
+
+  //-----------------------------------------------------------------------------
+  //  Name : get_bind_pose ()
+  /// <summary>
+  /// Local transform of every node as imported.
+  /// </summary>
+  //-----------------------------------------------------------------------------
+  const std::vector<math::transform>& get_bind_pose() const;
+
+  //-----------------------------------------------------------------------------
+  //  Name : get_bone_nodes ()
+  /// <summary>
+  /// Node index of every bone of the skin bind data.
+  /// </summary>
+  //-----------------------------------------------------------------------------
+  const std::vector<std::int32_t>& get_bone_nodes() const;
+
+private:
+  //-------------------------------------------------------------------------
+  // Private Member Variables.
+  //-------------------------------------------------------------------------
+  /// Parent index of every node.
+  std::vector<std::int32_t> parents_;
+  /// Name of every node.
+  std::vector<std::string> names_;
+  /// Imported local transform of every node.
+  std::vector<math::transform> bind_pose_;
+  /// Node index of every bone.
+  std::vector<std::int32_t> bone_nodes_;
+};
+
+//-----------------------------------------------------------------------------
+//  Name : skeleton_pose (Class)
+/// <summary>
+/// Pose of one skeleton instance. The local transforms are written by
+/// whoever drives the skeleton, the model space and bone transforms are
+/// resolved from them. The buffers are kept between frames and only
+/// reallocated when the skeleton changes.
+/// </summary>
+//-----------------------------------------------------------------------------
+class skeleton_pose
+{
+public:
+  //-----------------------------------------------------------------------------
+  //  Name : reset ()
+  /// <summary>
+  /// Sizes the buffers for the skeleton and sets the local transforms to
+  /// its bind pose.
+  /// </summary>
+  //-----------------------------------------------------------------------------
+  void reset(const skeleton& skel);
+
+  //-----------------------------------------------------------------------------
+  //  Name : is_bound_to ()
+  /// <summary>
+  /// Was the pose last reset for this skeleton.
+  /// </summary>
+  //-----------------------------------------------------------------------------
+  bool is_bound_to(const skeleton& skel) const;
+
+  //-----------------------------------------------------------------------------
+  //  Name : compute_model_space ()
+  /// <summary>
+  /// Resolves the hierarchy in a single pass, parents are always resolved
+  /// before their children.
+  /// </summary>
+  //-----------------------------------------------------------------------------
+  void compute_model_space(const skeleton& skel);
+
+  //-----------------------------------------------------------------------------
+  //  Name : compute_bone_transforms ()
+  /// <summary>
+  /// World transform of every bone of the skin, in skin bone order, as
+  /// expected by bone_palette::get_skinning_matrices.
+  /// </summary>
+  //-----------------------------------------------------------------------------
+  void compute_bone_transforms(const skeleton& skel, const math::transform& world_transform);
+
+  //-----------------------------------------------------------------------------
+  //  Name : get_local_transforms ()
+  /// <summary>
+  /// Local transform of every node.
+  /// </summary>
+  //-----------------------------------------------------------------------------
+  std::vector<math::transform>& get_local_transforms();
+  const std::vector<math::transform>& get_local_transforms() const;
+
+  //-----------------------------------------------------------------------------
+  //  Name : get_model_transforms ()
+  /// <summary>
+  /// Model space matrix of every node.
+  /// </summary>
+  //-----------------------------------------------------------------------------
+  const std::vector<math::transform::mat4_t>& get_model_transforms() const;
+
+  //-----------------------------------------------------------------------------
+  //  Name : get_bone_transforms ()
+  /// <summary>
+  /// World transform of every bone of the skin.
+  /// </summary>
+  //-----------------------------------------------------------------------------
+  const std::vector<math::transform>& get_bone_transforms() const;
+
+private:
+  //-------------------------------------------------------------------------
+  // Private Member Variables.
+  //-------------------------------------------------------------------------
+  /// Skeleton of the last reset, only compared against.
+  const skeleton* skeleton_ = nullptr;
+  /// Local transform of every node.
+  std::vector<math::transform> local_;
+  /// Model space matrix of every node. Kept as plain matrices, composing
+  /// math::transform decomposes the product every time.
+  std::vector<math::transform::mat4_t> model_;
+  /// World transform of every bone.
+  std::vector<math::transform> bones_;
+};
@@ -133,7 +133,7 @@ void model::set_lod_limits(const std::vector<urange32_t>& limits)
 void model::render(gfx::view_id id, const math::transform& world_transform,
 				   const std::vector<math::transform>& bone_transforms, bool apply_cull, bool depth_write,
 				   bool depth_test, std::uint64_t extra_states, unsigned int lod, gpu_program* user_program,
-				   std::function<void(gpu_program&)> setup_params) const
+				   const std::function<void(gpu_program&)>& setup_params) const
 {
 	const auto mesh = get_lod(lod);
 	if(!mesh)
@@ -141,11 +141,10 @@ void model::render(gfx::view_id id, const math::transform& world_transform,
 		return;
 	}
 
-	auto render_subset = [this, &mesh](gfx::view_id id, bool skinned, std::uint32_t group_id,
-									   const std::vector<math::transform>& matrices, bool apply_cull,
-									   bool depth_write, bool depth_test, std::uint64_t extra_states,
-									   gpu_program* user_program,
-									   std::function<void(gpu_program&)> setup_params) {
+	auto render_subset = [this, &mesh, &setup_params](gfx::view_id id, bool skinned, std::uint32_t group_id,
+													  const math::transform::mat4_t* matrices, std::size_t count,
+													  bool apply_cull, bool depth_write, bool depth_test,
+													  std::uint64_t extra_states, gpu_program* user_program) {
 
 		bool valid_program = false;
 		gpu_program* program = user_program;
@@ -154,6 +153,7 @@ void model::render(gfx::view_id id, const math::transform& world_transform,
 		if(mat)
 		{
 			mat->skinned = skinned;
+			mat->instanced = false;
 			if(user_program == nullptr)
 			{
 				program = mat->get_program();
@@ -181,16 +181,9 @@ void model::render(gfx::view_id id, const math::transform& world_transform,
 				extra_states |= mat->get_render_states(apply_cull, depth_write, depth_test);
 			}
 
-			if(!matrices.empty())
+			if(count > 0)
 			{
-				using mat_type = math::transform::mat4_t;
-				std::vector<mat_type> mats;
-				mats.reserve(matrices.size());
-				for(const auto& m : matrices)
-				{
-					mats.emplace_back(m.get_matrix());
-				}
-				gfx::set_transform(mats.data(), static_cast<std::uint16_t>(mats.size()));
+				gfx::set_transform(matrices, static_cast<std::uint16_t>(count));
 			}
 
 			gfx::set_state(extra_states);
@@ -214,15 +207,16 @@ void model::render(gfx::view_id id, const math::transform& world_transform,
 	{
 		// Process each palette in the skin with a matching attribute.
 		const auto& palettes = mesh->get_bone_palettes();
+		std::vector<math::transform::mat4_t> skinning_matrices;
 		for(const auto& palette : palettes)
 		{
 			// Apply the bone palette.
-			auto skinning_matrices = palette.get_skinning_matrices(bone_transforms, skin_data, false);
+			palette.get_skinning_matrices(bone_transforms, skin_data, false, skinning_matrices);
 			// auto max_blend_index = palette.get_maximum_blend_index();
 
 			auto data_group = palette.get_data_group();
-			render_subset(id, true, data_group, skinning_matrices, apply_cull, depth_write, depth_test,
-						  extra_states, user_program, setup_params);
+			render_subset(id, true, data_group, skinning_matrices.data(), skinning_matrices.size(), apply_cull,
+						  depth_write, depth_test, extra_states, user_program);
 
 		} // Next Palette
 	}
@@ -230,8 +224,8 @@ void model::render(gfx::view_id id, const math::transform& world_transform,
 	{
 		for(std::size_t i = 0; i < mesh->get_subset_count(); ++i)
 		{
-			render_subset(id, false, std::uint32_t(i), {world_transform}, apply_cull, depth_write, depth_test,
-						  extra_states, user_program, setup_params);
+			render_subset(id, false, std::uint32_t(i), &world_transform.get_matrix(), 1, apply_cull, depth_write,
+						  depth_test, extra_states, user_program);
 		}
 	}
 }
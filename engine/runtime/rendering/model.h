@@ -186,7 +186,7 @@ public:
 	void render(gfx::view_id id, const math::transform& world_transform,
 				const std::vector<math::transform>& bone_transforms, bool apply_cull, bool depth_write,
 				bool depth_test, std::uint64_t extra_states, unsigned int lod, gpu_program* user_program,
-				std::function<void(gpu_program&)> setup_params) const;
+				const std::function<void(gpu_program&)>& setup_params) const;
 
 private:
 	void recalulate_lod_limits();
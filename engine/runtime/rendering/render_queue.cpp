@@ -0,0 +1,282 @@
+#include "render_queue.h"
+#include "gpu_program.h"
+#include "material.h"
+#include "mesh/mesh.h"
+#include "model.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+/// Size of one instance, the world matrix.
+constexpr std::uint16_t instance_stride = sizeof(math::transform::mat4_t);
+}
+
+void render_queue::clear()
+{
+	items_.clear();
+	keys_.clear();
+	transforms_.clear();
+	program_ids_.clear();
+	material_ids_.clear();
+	mesh_ids_.clear();
+}
+
+void render_queue::push(const model& mdl, std::uint32_t lod, const math::transform& world_transform,
+						const std::vector<math::transform>& bone_transforms, float depth,
+						const math::vec3& params, bool apply_cull, bool depth_write, bool depth_test,
+						std::uint64_t extra_states)
+{
+	const auto lod_mesh = mdl.get_lod(lod);
+	if(!lod_mesh)
+	{
+		return;
+	}
+
+	auto mesh_ptr = lod_mesh.get();
+	const auto& skin_data = mesh_ptr->get_skin_bind_data();
+
+	// Has skinning data?
+	if(skin_data.has_bones() && !bone_transforms.empty())
+	{
+		// Process each palette in the skin with a matching attribute.
+		for(const auto& palette : mesh_ptr->get_bone_palettes())
+		{
+			palette.get_skinning_matrices(bone_transforms, skin_data, false, palette_matrices_);
+			const auto group = palette.get_data_group();
+			auto mat = mdl.get_material_for_group(group);
+
+			emit(mesh_ptr, mat.get(), group, true, palette_matrices_.data(), palette_matrices_.size(), depth,
+				 params, apply_cull, depth_write, depth_test, extra_states);
+		}
+	}
+	else
+	{
+		const auto& world = world_transform.get_matrix();
+		for(std::size_t i = 0; i < mesh_ptr->get_subset_count(); ++i)
+		{
+			const auto group = std::uint32_t(i);
+			auto mat = mdl.get_material_for_group(group);
+			emit(mesh_ptr, mat.get(), group, false, &world, 1, depth, params, apply_cull, depth_write,
+				 depth_test, extra_states);
+		}
+	}
+}
+
+void render_queue::emit(mesh* mesh_ptr, material* mat, std::uint32_t group, bool skinned,
+						const math::transform::mat4_t* matrices, std::size_t count, float depth,
+						const math::vec3& params, bool apply_cull, bool depth_write, bool depth_test,
+						std::uint64_t extra_states)
+{
+	if(mat == nullptr || count == 0)
+	{
+		return;
+	}
+
+	mat->skinned = skinned;
+	mat->instanced = false;
+	const auto program = mat->get_program();
+	if(program == nullptr)
+	{
+		return;
+	}
+
+	item it;
+	it.mesh_ptr = mesh_ptr;
+	it.mat = mat;
+	it.group = group;
+	it.states = extra_states | mat->get_render_states(apply_cull, depth_write, depth_test);
+	it.first_transform = std::uint32_t(transforms_.size());
+	it.transform_count = std::uint16_t(count);
+	it.skinned = skinned;
+	it.params = params;
+	transforms_.insert(transforms_.end(), matrices, matrices + count);
+	items_.emplace_back(it);
+	keys_.emplace_back(make_key(program, mat, mesh_ptr, group, depth));
+}
+
+std::uint32_t render_queue::get_id(std::unordered_map<const void*, std::uint32_t>& ids, const void* ptr)
+{
+	return ids.emplace(ptr, std::uint32_t(ids.size())).first->second;
+}
+
+std::uint64_t render_queue::make_key(const gpu_program* program, const material* mat, const mesh* mesh_ptr,
+									 std::uint32_t group, float depth)
+{
+	return pack_key(get_id(program_ids_, program), get_id(material_ids_, mat), get_id(mesh_ids_, mesh_ptr),
+					group, depth);
+}
+
+std::uint64_t render_queue::pack_key(std::uint32_t program_id, std::uint32_t material_id,
+									 std::uint32_t mesh_id, std::uint32_t group, float depth)
+{
+	const auto depth_bits = std::uint64_t(math::clamp(depth, 0.0f, 1.0f) * 65535.0f);
+
+	return (std::uint64_t(program_id & 0xfff) << 52) | (std::uint64_t(material_id & 0xfff) << 40) |
+		   (std::uint64_t(mesh_id & 0xffff) << 24) | (std::uint64_t(group & 0xff) << 16) | depth_bits;
+}
+
+void render_queue::sort_keys(const std::vector<std::uint64_t>& keys, std::vector<std::uint32_t>& order,
+							 std::vector<std::uint32_t>& scratch)
+{
+	const auto count = keys.size();
+	order.resize(count);
+	scratch.resize(count);
+	for(std::size_t i = 0; i < count; ++i)
+	{
+		order[i] = std::uint32_t(i);
+	}
+
+	for(std::uint32_t shift = 0; shift < 64; shift += 8)
+	{
+		std::size_t histogram[256] = {};
+		for(const auto key : keys)
+		{
+			histogram[(key >> shift) & 0xff]++;
+		}
+
+		// all keys share this byte, the order stays as it is
+		if(count == 0 || histogram[(keys[0] >> shift) & 0xff] == count)
+		{
+			continue;
+		}
+
+		std::size_t offset = 0;
+		for(auto& bucket : histogram)
+		{
+			const auto size = bucket;
+			bucket = offset;
+			offset += size;
+		}
+
+		for(auto index : order)
+		{
+			scratch[histogram[(keys[index] >> shift) & 0xff]++] = index;
+		}
+		std::swap(order, scratch);
+	}
+}
+
+bool render_queue::can_batch(const item& a, const item& b) const
+{
+	return !a.skinned && !b.skinned && a.mesh_ptr == b.mesh_ptr && a.mat == b.mat && a.group == b.group &&
+		   a.states == b.states && a.params == b.params;
+}
+
+void render_queue::submit(gfx::view_id id, const setup_params_t& setup_params)
+{
+	submit_count_ = 0;
+	sort_keys(keys_, order_, scratch_);
+
+	const gpu_program* last_program = nullptr;
+	const math::vec3* last_params = nullptr;
+	for_each_run(order_,
+				 [this](std::uint32_t a, std::uint32_t b) { return can_batch(items_[a], items_[b]); },
+				 [&](std::size_t begin, std::size_t end) {
+					 submit_run(id, begin, end, setup_params, last_program, last_params);
+				 });
+}
+
+void render_queue::submit_run(gfx::view_id id, std::size_t begin, std::size_t end,
+							  const setup_params_t& setup_params, const gpu_program*& last_program,
+							  const math::vec3*& last_params)
+{
+	const auto& first = items_[order_[begin]];
+	auto mat = first.mat;
+	const auto count = end - begin;
+
+	const auto caps = gfx::get_caps();
+	const bool instancing = count > 1 && mat->has_instanced_program() && caps != nullptr &&
+							(caps->supported & BGFX_CAPS_INSTANCING) != 0;
+
+	mat->skinned = first.skinned;
+	mat->instanced = instancing;
+	auto program = mat->get_program();
+	if(program == nullptr || !program->begin())
+	{
+		if(program != nullptr)
+		{
+			program->end();
+		}
+		return;
+	}
+
+	// uniforms stay set between submits, bindings are preserved explicitly
+	if(program != last_program || last_params == nullptr || *last_params != first.params)
+	{
+		setup_params(*program, first.params);
+		last_program = program;
+		last_params = &first.params;
+	}
+
+	const auto bind = [&]() {
+		mat->submit();
+		gfx::set_state(first.states);
+		first.mesh_ptr->bind_render_buffers_for_subset(first.group);
+	};
+
+	std::size_t done = 0;
+	if(instancing)
+	{
+		while(done < count)
+		{
+			const auto left = std::uint32_t(count - done);
+			const auto avail = gfx::get_avail_instance_data_buffer(left, instance_stride);
+			if(avail == 0)
+			{
+				break;
+			}
+
+			gfx::instance_data_buffer idb;
+			gfx::alloc_instance_data_buffer(&idb, avail, instance_stride);
+			auto data = idb.data;
+			for(std::uint32_t i = 0; i < avail; ++i)
+			{
+				const auto& it = items_[order_[begin + done + i]];
+				std::memcpy(data, &transforms_[it.first_transform], instance_stride);
+				data += instance_stride;
+			}
+
+			// the instance buffer must not leak into a following draw, so
+			// every chunk binds its own state
+			bind();
+			gfx::set_instance_data_buffer(&idb, 0, avail);
+			gfx::submit(id, program->native_handle());
+			submit_count_++;
+			done += avail;
+		}
+
+		if(done == count)
+		{
+			program->end();
+			return;
+		}
+
+		// out of transient memory, draw the rest one by one
+		program->end();
+		mat->instanced = false;
+		program = mat->get_program();
+		if(program == nullptr || !program->begin())
+		{
+			if(program != nullptr)
+			{
+				program->end();
+			}
+			return;
+		}
+		setup_params(*program, first.params);
+		last_program = program;
+	}
+
+	bind();
+	for(auto i = done; i < count; ++i)
+	{
+		const auto& it = items_[order_[begin + i]];
+		gfx::set_transform(&transforms_[it.first_transform], it.transform_count);
+		gfx::submit(id, program->native_handle(), 0, i + 1 < count);
+		submit_count_++;
+	}
+
+	program->end();
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <core/graphics/graphics.h>
+#include <core/math/math_includes.h>
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+class gpu_program;
+class material;
+class mesh;
+class model;
+
+//-----------------------------------------------------------------------------
+// Main Class Declarations
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//  Name : render_queue (Class)
+/// <summary>
+/// Collects the draws of a pass as compact items, sorts them by a 64 bit key
+/// (program, material, mesh, subset, depth) and submits them with as few
+/// state changes as possible. Consecutive items sharing mesh subset,
+/// material, states and parameters are drawn with one instanced submit when
+/// the material has an instanced program, otherwise their bindings are kept
+/// between the submits and only the transform changes.
+/// </summary>
+//-----------------------------------------------------------------------------
+class render_queue
+{
+public:
+	using setup_params_t = std::function<void(gpu_program&, const math::vec3&)>;
+
+	//-----------------------------------------------------------------------------
+	//  Name : clear ()
+	/// <summary>
+	/// Removes all items, the storage is kept for the next frame.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void clear();
+
+	//-----------------------------------------------------------------------------
+	//  Name : push ()
+	/// <summary>
+	/// Emits one item per subset of the model lod, or one per bone palette for
+	/// skinned meshes. Depth is the normalized view distance used to sort
+	/// front to back, params are handed to the setup callback on submit.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void push(const model& mdl, std::uint32_t lod, const math::transform& world_transform,
+			  const std::vector<math::transform>& bone_transforms, float depth, const math::vec3& params,
+			  bool apply_cull = true, bool depth_write = true, bool depth_test = true,
+			  std::uint64_t extra_states = 0);
+
+	//-----------------------------------------------------------------------------
+	//  Name : submit ()
+	/// <summary>
+	/// Sorts the items and submits them to the view. The callback is invoked
+	/// for every program switch and every change of params.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void submit(gfx::view_id id, const setup_params_t& setup_params);
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_item_count ()
+	/// <summary>
+	/// Number of items pushed since the last clear.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::size_t get_item_count() const
+	{
+		return items_.size();
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_submit_count ()
+	/// <summary>
+	/// Number of draw calls issued by the last submit.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::size_t get_submit_count() const
+	{
+		return submit_count_;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : pack_key ()
+	/// <summary>
+	/// Program 12 bits, material 12, mesh 16, subset 8, depth 16. Ids wider
+	/// than their field wrap around, which only costs batching.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	static std::uint64_t pack_key(std::uint32_t program_id, std::uint32_t material_id, std::uint32_t mesh_id,
+								  std::uint32_t group, float depth);
+
+	//-----------------------------------------------------------------------------
+	//  Name : sort_keys ()
+	/// <summary>
+	/// LSD radix sort of the indices of keys, 8 bits per pass. Passes where
+	/// every key has the same byte are skipped. Equal keys keep their order.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	static void sort_keys(const std::vector<std::uint64_t>& keys, std::vector<std::uint32_t>& order,
+						  std::vector<std::uint32_t>& scratch);
+
+	//-----------------------------------------------------------------------------
+	//  Name : for_each_run ()
+	/// <summary>
+	/// Splits order into runs of consecutive entries that can_batch accepts
+	/// together with the first entry of the run and calls f(begin, end) for
+	/// each of them.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	template <typename Pred, typename F>
+	static void for_each_run(const std::vector<std::uint32_t>& order, const Pred& can_batch, const F& f)
+	{
+		for(std::size_t begin = 0; begin < order.size();)
+		{
+			auto end = begin + 1;
+			while(end < order.size() && can_batch(order[begin], order[end]))
+			{
+				++end;
+			}
+
+			f(begin, end);
+			begin = end;
+		}
+	}
+
+private:
+	struct item
+	{
+		mesh* mesh_ptr = nullptr;
+		material* mat = nullptr;
+		std::uint32_t group = 0;
+		std::uint64_t states = 0;
+		/// Range in transforms_, the world matrix or the skinning palette.
+		std::uint32_t first_transform = 0;
+		std::uint16_t transform_count = 0;
+		bool skinned = false;
+		math::vec3 params;
+	};
+
+	//-----------------------------------------------------------------------------
+	//  Name : make_key ()
+	/// <summary>
+	/// Packs the key of an item from ids that are dense per frame.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::uint64_t make_key(const gpu_program* program, const material* mat, const mesh* mesh_ptr,
+						   std::uint32_t group, float depth);
+	std::uint32_t get_id(std::unordered_map<const void*, std::uint32_t>& ids, const void* ptr);
+	void emit(mesh* mesh_ptr, material* mat, std::uint32_t group, bool skinned,
+			  const math::transform::mat4_t* matrices, std::size_t count, float depth,
+			  const math::vec3& params, bool apply_cull, bool depth_write, bool depth_test,
+			  std::uint64_t extra_states);
+
+	bool can_batch(const item& a, const item& b) const;
+	void submit_run(gfx::view_id id, std::size_t begin, std::size_t end, const setup_params_t& setup_params,
+					const gpu_program*& last_program, const math::vec3*& last_params);
+
+	std::vector<item> items_;
+	/// Sort keys of items_, kept apart so the sort passes read them densely.
+	std::vector<std::uint64_t> keys_;
+	/// Sorted order of items_.
+	std::vector<std::uint32_t> order_;
+	std::vector<std::uint32_t> scratch_;
+	/// World matrices and skinning palettes of all items.
+	std::vector<math::transform::mat4_t> transforms_;
+	/// Scratch buffer for the skinning palettes, reused between pushes.
+	std::vector<math::transform::mat4_t> palette_matrices_;
+	std::unordered_map<const void*, std::uint32_t> program_ids_;
+	std::unordered_map<const void*, std::uint32_t> material_ids_;
+	std::unordered_map<const void*, std::uint32_t> mesh_ids_;
+	std::size_t submit_count_ = 0;
+};
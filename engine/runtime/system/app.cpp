@@ -1,10 +1,12 @@
 #include "app.h"
 #include "app_setup.h"
 #include "events.h"
+#include "system_scheduler.h"
 
 #include "../assets/asset_manager.h"
 #include "../ecs/ent.h"
 #include <runtime/ecs/components/relation.h>
+#include "../ecs/systems/animation_system.h"
 #include "../ecs/systems/audio_system.h"
 #include "../ecs/systems/bone_system.h"
 #include "../ecs/systems/transform_system.h"
@@ -19,6 +21,7 @@
 
 #include <core/audio/library.h>
 #include <core/logging/logging.h>
+#include <core/profiling/profiler.h>
 #include <core/serialization/serialization.h>
 #include <core/simulation/simulation.h>
 #include <core/tasks/task_system.h>
@@ -27,6 +30,40 @@
 
 namespace runtime
 {
+namespace
+{
+const profiling::source_location frame_begin_location = {"on_frame_begin", __FILE__, __LINE__};
+const profiling::source_location frame_update_location = {"on_frame_update", __FILE__, __LINE__};
+const profiling::source_location frame_render_location = {"on_frame_render", __FILE__, __LINE__};
+const profiling::source_location frame_ui_render_location = {"on_frame_ui_render", __FILE__, __LINE__};
+const profiling::source_location frame_end_location = {"on_frame_end", __FILE__, __LINE__};
+
+// every slot gets a zone of its own, told apart by its position
+void emit_profiled(const event<void(delta_t)>& e, const profiling::source_location& location, delta_t dt)
+{
+	e.emit_with(
+		[&location](std::size_t index, const auto& slot, auto... args) {
+			profiling::scoped_zone zone(location, std::int32_t(index));
+			slot(args...);
+		},
+		dt);
+}
+
+void save_profile()
+{
+	const auto frame = core::get_subsystem<core::simulation>().get_frame();
+	const auto path = "profile_" + std::to_string(frame) + ".json";
+	std::string err;
+	if(profiling::save_chrome_trace(path, err))
+	{
+		APPLOG_INFO("Saved the last {0} frames to {1}", profiling::get_frames().size(), path);
+	}
+	else
+	{
+		APPLOG_ERROR("Could not save the profile : {0}", err);
+	}
+}
+}
 
 void app::setup(cmd_line::parser& parser)
 {
@@ -34,7 +71,8 @@ void app::setup(cmd_line::parser& parser)
 	logging_container->add_sink(std::make_shared<logging::sinks::platform_sink_mt>());
 	logging_container->add_sink(std::make_shared<logging::sinks::simple_file_sink_mt>("Log.txt", true));
 
-	logging::create(APPLOG, logging_container);
+	logging::create_app_logger(logging_container);
+	logging::flush_on_crash();
 
 	serialization::set_warning_logger([](const std::string& msg) { APPLOG_WARNING(msg); });
 
@@ -49,13 +87,22 @@ void app::setup(cmd_line::parser& parser)
 
 	parser.set_optional<std::string>("r", "renderer", "auto", "Select preferred renderer.");
 	parser.set_optional<bool>("n", "novsync", false, "Disable vsync.");
+	parser.set_optional<bool>("np", "noprofile", false,
+							  "Disable the frame profiler. Ctrl+F12 saves the last frames it recorded.");
+
+	profiling::set_thread_name("main");
 }
 
 void app::start(cmd_line::parser& parser)
 {
+	bool noprofile = false;
+	parser.try_get("noprofile", noprofile);
+	profiling::set_enabled(!noprofile);
 
 	// this order is important
 	core::add_subsystem<SpatialSystem>();
+	core::add_subsystem<system_scheduler>();
+	core::add_subsystem<scene_graph>();
 	core::add_subsystem<transform_system>();
 	core::add_subsystem<core::simulation>();
 	core::add_subsystem<renderer>(parser);
@@ -64,7 +111,7 @@ void app::start(cmd_line::parser& parser)
 	core::add_subsystem<asset_manager>();
 	core::add_subsystem<core::task_system>(false);
 	setup_asset_manager();
-	core::add_subsystem<scene_graph>();
+	core::add_subsystem<animation_system>();
 	core::add_subsystem<bone_system>();
 	core::add_subsystem<camera_system>();
 	core::add_subsystem<reflection_probe_system>();
@@ -132,14 +179,27 @@ void app::run_one_frame()
 
 	auto& sim = core::get_subsystem<core::simulation>();
 	auto& tasks = core::get_subsystem<core::task_system>();
+	auto& scheduler = core::get_subsystem<system_scheduler>();
 	auto& renderer = core::get_subsystem<runtime::renderer>();
 	const bool is_active = renderer.get_focused_window() != nullptr;
 	sim.run_one_frame(is_active);
-	tasks.run_on_owner_thread(5ms);
+	{
+		PROFILE_SCOPE("owner_thread_tasks");
+		tasks.run_on_owner_thread(5ms);
+	}
 
 	auto dt = sim.get_delta_time();
 
-	poll_events();
+	{
+		PROFILE_SCOPE("poll_events");
+		poll_events();
+	}
+
+	auto& input = core::get_subsystem<runtime::input>();
+	if(input.is_key_pressed(mml::keyboard::F12, mml::keyboard::LControl))
+	{
+		save_profile();
+	}
 
 	renderer.process_pending_windows();
 
@@ -152,17 +212,28 @@ void app::run_one_frame()
 		return;
 	}
 
-	on_frame_begin(dt);
+	emit_profiled(on_frame_begin, frame_begin_location, dt);
 
-	on_frame_update(dt);
+	{
+		// ecs systems, in parallel where their declared component access allows
+		PROFILE_SCOPE("system_scheduler");
+		scheduler.run(dt);
+	}
+
+	emit_profiled(on_frame_update, frame_update_location, dt);
 
-	on_frame_render(dt);
+	emit_profiled(on_frame_render, frame_render_location, dt);
 
-	on_frame_ui_render(dt);
+	emit_profiled(on_frame_ui_render, frame_ui_render_location, dt);
 
-	on_frame_end(dt);
+	emit_profiled(on_frame_end, frame_end_location, dt);
+
+	{
+		PROFILE_SCOPE("delete_marked_ents");
+		delete_marked_ents();
+	}
 
-	delete_marked_ents();
+	profiling::end_frame();
 }
 
 void app::setup_testing() {
@@ -186,6 +257,7 @@ int app::run(int argc, char* argv[])
 	setup(parser);
 	if(exitcode_ != 0)
 	{
+		logging::shutdown();
 		core::details::dispose();
 		return exitcode_;
 	}
@@ -210,6 +282,7 @@ int app::run(int argc, char* argv[])
 	start(parser);
 	if(exitcode_ != 0)
 	{
+		logging::shutdown();
 		core::details::dispose();
 		return exitcode_;
 	}
@@ -224,6 +297,8 @@ int app::run(int argc, char* argv[])
 
 	APPLOG_INFO("Exiting...");
 
+	// whatever the subsystems log while disposed is written right away
+	logging::shutdown();
 	core::details::dispose();
 	return exitcode_;
 }
@@ -0,0 +1,284 @@
+#include "system_scheduler.h"
+
+#include <core/common/assert.hpp>
+#include <core/profiling/profiler.h>
+#include <core/system/subsystem.h>
+#include <core/tasks/task_system.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace runtime
+{
+namespace
+{
+template <typename T>
+bool intersects(const std::vector<T>& lhs, const std::vector<T>& rhs)
+{
+	return std::any_of(std::begin(lhs), std::end(lhs), [&rhs](const T& item) {
+		return std::find(std::begin(rhs), std::end(rhs), item) != std::end(rhs);
+	});
+}
+
+double to_ms(system_scheduler::clock_t::duration d)
+{
+	return std::chrono::duration<double, std::milli>(d).count();
+}
+} // namespace
+
+system_scheduler::system_desc& system_scheduler::system_desc::after(const std::string& name)
+{
+	after_.emplace_back(name);
+	return *this;
+}
+
+system_scheduler::system_desc& system_scheduler::system_desc::before(const std::string& name)
+{
+	before_.emplace_back(name);
+	return *this;
+}
+
+system_scheduler::system_desc& system_scheduler::system_desc::on_owner_thread()
+{
+	owner_thread_ = true;
+	return *this;
+}
+
+system_scheduler::system_desc& system_scheduler::system_desc::exclusive()
+{
+	exclusive_ = true;
+	return *this;
+}
+
+bool system_scheduler::system_desc::conflicts_with(const system_desc& other) const
+{
+	if(exclusive_ || other.exclusive_)
+	{
+		return true;
+	}
+
+	return intersects(writes_, other.writes_) || intersects(writes_, other.reads_) ||
+		   intersects(reads_, other.writes_);
+}
+
+system_scheduler::system_desc& system_scheduler::add_system(const std::string& name, update_t update)
+{
+	expects(!running_);
+	expects(std::none_of(std::begin(systems_), std::end(systems_),
+						 [&name](const system_desc& desc) { return desc.name_ == name; }) &&
+			"duplicated system");
+
+	system_desc desc;
+	desc.name_ = name;
+	desc.update_ = std::move(update);
+	systems_.emplace_back(std::move(desc));
+	dirty_ = true;
+
+	return systems_.back();
+}
+
+void system_scheduler::remove_system(const std::string& name)
+{
+	expects(!running_);
+
+	systems_.erase(std::remove_if(std::begin(systems_), std::end(systems_),
+								  [&name](const system_desc& desc) { return desc.name_ == name; }),
+				   std::end(systems_));
+	dirty_ = true;
+}
+
+void system_scheduler::build_graph()
+{
+	const auto count = systems_.size();
+
+	const auto find = [this](const std::string& name) {
+		auto it = std::find_if(std::begin(systems_), std::end(systems_),
+							   [&name](const system_desc& desc) { return desc.name_ == name; });
+		return static_cast<std::size_t>(std::distance(std::begin(systems_), it));
+	};
+
+	// explicit constraints first
+	std::vector<std::vector<std::size_t>> successors(count);
+	const auto add_edge = [&](std::size_t before, std::size_t after) {
+		if(before == count || after == count || before == after)
+		{
+			return;
+		}
+		auto& next = successors[before];
+		if(std::find(std::begin(next), std::end(next), after) == std::end(next))
+		{
+			next.push_back(after);
+		}
+	};
+
+	for(std::size_t i = 0; i < count; ++i)
+	{
+		for(const auto& name : systems_[i].after_)
+		{
+			add_edge(find(name), i);
+		}
+		for(const auto& name : systems_[i].before_)
+		{
+			add_edge(i, find(name));
+		}
+	}
+
+	const auto reaches = [&](std::size_t from, std::size_t to) {
+		std::vector<bool> visited(count, false);
+		std::vector<std::size_t> stack{from};
+		while(!stack.empty())
+		{
+			const auto current = stack.back();
+			stack.pop_back();
+			if(current == to)
+			{
+				return true;
+			}
+			if(visited[current])
+			{
+				continue;
+			}
+			visited[current] = true;
+			stack.insert(std::end(stack), std::begin(successors[current]), std::end(successors[current]));
+		}
+		return false;
+	};
+
+	// conflicting systems keep their registration order unless the explicit
+	// constraints already order them the other way around
+	for(std::size_t i = 0; i < count; ++i)
+	{
+		for(std::size_t j = i + 1; j < count; ++j)
+		{
+			if(systems_[i].conflicts_with(systems_[j]) && !reaches(j, i) && !reaches(i, j))
+			{
+				add_edge(i, j);
+			}
+		}
+	}
+
+	graph_.clear();
+	for(std::size_t i = 0; i < count; ++i)
+	{
+		const auto affinity = systems_[i].owner_thread_ ? core::task_graph::thread_affinity::owner
+														: core::task_graph::thread_affinity::worker;
+		const auto location = &profiling::get_location(systems_[i].name_);
+		graph_.add_node(systems_[i].name_,
+						[this, i, location]() {
+							profiling::scoped_zone zone(*location);
+							const auto start = clock_t::now();
+							systems_[i].update_(dt_);
+
+							auto& timing = timings_[i];
+							timing.start = start - run_start_;
+							timing.duration = clock_t::now() - start;
+						},
+						affinity);
+	}
+
+	for(std::size_t i = 0; i < count; ++i)
+	{
+		for(auto next : successors[i])
+		{
+			graph_.precede(i, next);
+		}
+	}
+
+	// asserts on cycles in the explicit constraints
+	graph_.get_topological_order();
+
+	timings_.clear();
+	timings_.resize(count);
+	for(std::size_t i = 0; i < count; ++i)
+	{
+		timings_[i].name = systems_[i].name_;
+		timings_[i].on_owner_thread = systems_[i].owner_thread_;
+	}
+
+	dirty_ = false;
+}
+
+void system_scheduler::run(delta_t dt)
+{
+	if(dirty_)
+	{
+		build_graph();
+	}
+
+	auto& ts = core::get_subsystem<core::task_system>();
+
+	// creating a pool resizes the registry, it must not happen inside a system
+	if(core::has_subsystems<SpatialSystem>())
+	{
+		auto& ecs = core::get_subsystem<SpatialSystem>();
+		for(const auto& system : systems_)
+		{
+			for(const auto assure : system.pools_)
+			{
+				assure(ecs);
+			}
+		}
+	}
+
+	dt_ = dt;
+	run_start_ = clock_t::now();
+	running_ = true;
+	try
+	{
+		graph_.run(ts);
+	}
+	catch(...)
+	{
+		running_ = false;
+		throw;
+	}
+	running_ = false;
+}
+
+const std::vector<system_scheduler::system_timing>& system_scheduler::get_timings() const
+{
+	return timings_;
+}
+
+std::string system_scheduler::get_schedule_dump() const
+{
+	std::ostringstream out;
+	out << std::fixed << std::setprecision(3);
+
+	if(dirty_)
+	{
+		out << "system schedule: not built yet (" << systems_.size() << " systems)\n";
+		return out.str();
+	}
+
+	clock_t::duration total{};
+	for(const auto& timing : timings_)
+	{
+		total = std::max(total, timing.start + timing.duration);
+	}
+	out << "system schedule: " << timings_.size() << " systems, " << to_ms(total) << " ms\n";
+
+	for(auto id : graph_.get_topological_order())
+	{
+		const auto& timing = timings_[id];
+		out << "  " << timing.name << (timing.on_owner_thread ? " [owner]" : " [worker]") << " start "
+			<< to_ms(timing.start) << " ms, took " << to_ms(timing.duration) << " ms";
+
+		bool first = true;
+		for(std::size_t other = 0; other < graph_.size(); ++other)
+		{
+			const auto& next = graph_.get_successors(other);
+			if(std::find(std::begin(next), std::end(next), id) == std::end(next))
+			{
+				continue;
+			}
+			out << (first ? ", after: " : ", ") << graph_.get_name(other);
+			first = false;
+		}
+		out << "\n";
+	}
+
+	return out.str();
+}
+} // namespace runtime
@@ -0,0 +1,192 @@
+#pragma once
+
+#include "../ecs/ent.h"
+
+#include <core/common/basetypes.hpp>
+#include <core/common/nonstd/type_index.hpp>
+#include <core/tasks/task_graph.h>
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace runtime
+{
+
+//-----------------------------------------------------------------------------
+// Main Class Declarations
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//  Name : system_scheduler (Class)
+/// <summary>
+/// Runs the per frame update of the ecs systems. Each system declares the
+/// component types it reads and writes and optionally explicit ordering
+/// constraints. Systems that conflict (one writes what the other reads or
+/// writes) keep their registration order, everything else may run
+/// concurrently on the task_system workers.
+/// </summary>
+//-----------------------------------------------------------------------------
+class system_scheduler
+{
+public:
+	using update_t = std::function<void(delta_t)>;
+	using clock_t = std::chrono::steady_clock;
+
+	//-----------------------------------------------------------------------------
+	//  Name : system_desc (Class)
+	/// <summary>
+	/// Declaration of a system. Returned by add_system to be filled in with a
+	/// fluent interface.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	class system_desc
+	{
+	public:
+		template <typename T>
+		system_desc& reads()
+		{
+			reads_.emplace_back(rtti::type_id<T>());
+			pools_.emplace_back(&assure_pool<T>);
+			return *this;
+		}
+
+		template <typename T>
+		system_desc& writes()
+		{
+			writes_.emplace_back(rtti::type_id<T>());
+			pools_.emplace_back(&assure_pool<T>);
+			return *this;
+		}
+
+		//-----------------------------------------------------------------------------
+		//  Name : after ()
+		/// <summary>
+		/// The system must run after the named one, if it is registered.
+		/// </summary>
+		//-----------------------------------------------------------------------------
+		system_desc& after(const std::string& name);
+
+		//-----------------------------------------------------------------------------
+		//  Name : before ()
+		/// <summary>
+		/// The system must run before the named one, if it is registered.
+		/// </summary>
+		//-----------------------------------------------------------------------------
+		system_desc& before(const std::string& name);
+
+		//-----------------------------------------------------------------------------
+		//  Name : on_owner_thread ()
+		/// <summary>
+		/// The system has to run on the owner thread, for example because it
+		/// talks to the graphics or audio device.
+		/// </summary>
+		//-----------------------------------------------------------------------------
+		system_desc& on_owner_thread();
+
+		//-----------------------------------------------------------------------------
+		//  Name : exclusive ()
+		/// <summary>
+		/// The system changes the registry itself (creates or destroys entities,
+		/// adds or removes components) and can't overlap with any other system.
+		/// </summary>
+		//-----------------------------------------------------------------------------
+		system_desc& exclusive();
+
+	private:
+		friend class system_scheduler;
+
+		bool conflicts_with(const system_desc& other) const;
+
+		// reserving creates a missing pool without touching the components
+		template <typename T>
+		static void assure_pool(Registry& reg)
+		{
+			reg.reserve<T>(reg.size<T>());
+		}
+
+		std::string name_;
+		update_t update_;
+		std::vector<rtti::type_index_t> reads_;
+		std::vector<rtti::type_index_t> writes_;
+		/// Creates the registry pools of the read and written components.
+		std::vector<void (*)(Registry&)> pools_;
+		std::vector<std::string> after_;
+		std::vector<std::string> before_;
+		bool owner_thread_ = false;
+		bool exclusive_ = false;
+	};
+
+	struct system_timing
+	{
+		std::string name;
+		/// Offset from the start of the update.
+		clock_t::duration start{};
+		clock_t::duration duration{};
+		bool on_owner_thread = false;
+	};
+
+	//-----------------------------------------------------------------------------
+	//  Name : add_system ()
+	/// <summary>
+	/// Registers a system under a unique name.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	system_desc& add_system(const std::string& name, update_t update);
+
+	template <typename C>
+	system_desc& add_system(const std::string& name, C* const object_ptr,
+							void (C::*const method_ptr)(delta_t))
+	{
+		return add_system(name, [object_ptr, method_ptr](delta_t dt) { (object_ptr->*method_ptr)(dt); });
+	}
+
+	void remove_system(const std::string& name);
+
+	//-----------------------------------------------------------------------------
+	//  Name : run ()
+	/// <summary>
+	/// Runs every system once. Must be called from the owner thread of the
+	/// task_system. The registry pools of the declared components are created
+	/// up front, so that concurrent systems only ever look them up.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void run(delta_t dt);
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_timings ()
+	/// <summary>
+	/// Timings of the last run, in registration order.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	const std::vector<system_timing>& get_timings() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_schedule_dump ()
+	/// <summary>
+	/// Human readable description of the schedule: the order, the
+	/// dependencies of each system, where it runs and how long it took last
+	/// frame.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::string get_schedule_dump() const;
+
+private:
+	void build_graph();
+
+	/// Declared systems in registration order.
+	std::vector<system_desc> systems_;
+	/// Graph built from the declarations, rebuilt when they change.
+	core::task_graph graph_;
+	/// Is the graph out of date.
+	bool dirty_ = true;
+	/// Are we inside run.
+	bool running_ = false;
+	/// Delta time of the current run.
+	delta_t dt_{};
+	/// Start of the current run.
+	clock_t::time_point run_start_;
+	/// Timings of the last run.
+	std::vector<system_timing> timings_;
+};
+} // namespace runtime
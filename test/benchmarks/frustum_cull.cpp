@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+#include <core/math/frustum_cull.h>
+
+#include <random>
+#include <vector>
+
+namespace
+{
+struct scene
+{
+	std::vector<math::transform> transforms;
+	math::bbox bounds{math::vec3(-0.5f), math::vec3(0.5f)};
+	// roughly a quarter of the objects end up inside
+	math::frustum frustum{math::bbox(math::vec3(-50.0f), math::vec3(0.0f, 50.0f, 50.0f))};
+};
+
+scene make_scene(std::size_t count)
+{
+	std::mt19937 rng(42);
+	std::uniform_real_distribution<float> pos(-100.0f, 100.0f);
+	std::uniform_real_distribution<float> scale(0.5f, 4.0f);
+
+	scene s;
+	s.transforms.resize(count);
+	for(auto& t : s.transforms)
+	{
+		t.set_position({pos(rng), pos(rng), pos(rng)});
+		t.set_scale({scale(rng), scale(rng), scale(rng)});
+		t.rotate_axis(pos(rng), math::vec3(0.0f, 1.0f, 0.0f));
+	}
+	return s;
+}
+
+void FrustumCull_TestObb(benchmark::State& st)
+{
+	const auto s = make_scene(static_cast<std::size_t>(st.range(0)));
+	std::vector<std::uint8_t> visible(s.transforms.size());
+	while(st.KeepRunning())
+	{
+		for(std::size_t i = 0; i < s.transforms.size(); ++i)
+		{
+			visible[i] = math::frustum::test_obb(s.frustum, s.bounds, s.transforms[i]);
+		}
+		benchmark::DoNotOptimize(visible.data());
+	}
+	st.SetItemsProcessed(st.iterations() * st.range(0));
+}
+
+void FrustumCull_Batch(benchmark::State& st)
+{
+	const auto s = make_scene(static_cast<std::size_t>(st.range(0)));
+	math::cull_batch batch;
+	std::vector<std::uint32_t> visibility;
+	while(st.KeepRunning())
+	{
+		// filling the batch is part of the cost, it is rebuilt every frame
+		batch.clear();
+		for(const auto& t : s.transforms)
+		{
+			batch.add_obb(s.bounds, t);
+		}
+		batch.test(s.frustum, visibility);
+		benchmark::DoNotOptimize(visibility.data());
+	}
+	st.SetItemsProcessed(st.iterations() * st.range(0));
+}
+
+void FrustumCull_BatchTestOnly(benchmark::State& st)
+{
+	const auto s = make_scene(static_cast<std::size_t>(st.range(0)));
+	math::cull_batch batch;
+	for(const auto& t : s.transforms)
+	{
+		batch.add_obb(s.bounds, t);
+	}
+
+	std::vector<std::uint32_t> visibility;
+	while(st.KeepRunning())
+	{
+		batch.test(s.frustum, visibility);
+		benchmark::DoNotOptimize(visibility.data());
+	}
+	st.SetItemsProcessed(st.iterations() * st.range(0));
+}
+} // namespace
+
+BENCHMARK(FrustumCull_TestObb)->Arg(10000);
+BENCHMARK(FrustumCull_Batch)->Arg(10000);
+BENCHMARK(FrustumCull_BatchTestOnly)->Arg(10000);
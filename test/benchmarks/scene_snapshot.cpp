@@ -0,0 +1,69 @@
+#include <benchmark/benchmark.h>
+#include <runtime/ecs/components/relation.h>
+#include <runtime/ecs/components/transform_component.h>
+#include <runtime/ecs/constructs/snapshots.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+// Flat roots with a few children each, roughly what a level looks like.
+std::string make_scene(std::size_t count, ecs::snapshot_format format)
+{
+	Registry reg;
+	EntityType parent = entt::null;
+	for(std::size_t i = 0; i < count; ++i)
+	{
+		auto e = reg.create();
+		reg.assign<Name>(e).name = "entity_" + std::to_string(i);
+		reg.assign<Relation>(e).parent = (i % 8 == 0) ? entt::null : parent;
+		reg.assign<transform_component>(e).set_local_position(
+			{static_cast<float>(i), 0.0f, static_cast<float>(i % 8)});
+		if(i % 8 == 0)
+		{
+			parent = e;
+		}
+	}
+
+	std::stringstream stream;
+	ecs::serialize(stream, reg, {}, format);
+	return stream.str();
+}
+
+void load_scene(benchmark::State& st, ecs::snapshot_format format)
+{
+	const auto count = static_cast<std::size_t>(st.range(0));
+	const auto data = make_scene(count, format);
+
+	Registry reg;
+	std::vector<EntityType> loaded;
+	while(st.KeepRunning())
+	{
+		std::istringstream stream(data);
+		ecs::deserialize(stream, reg, loaded);
+		benchmark::DoNotOptimize(loaded.data());
+
+		st.PauseTiming();
+		reg.reset();
+		loaded.clear();
+		st.ResumeTiming();
+	}
+	st.SetItemsProcessed(st.iterations() * st.range(0));
+	st.SetBytesProcessed(st.iterations() * static_cast<int64_t>(data.size()));
+}
+
+void SceneSnapshot_LoadJson(benchmark::State& st)
+{
+	load_scene(st, ecs::snapshot_format::json);
+}
+
+void SceneSnapshot_LoadBinary(benchmark::State& st)
+{
+	load_scene(st, ecs::snapshot_format::binary);
+}
+} // namespace
+
+BENCHMARK(SceneSnapshot_LoadJson)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(SceneSnapshot_LoadBinary)->Arg(100000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,157 @@
+#include <benchmark/benchmark.h>
+#include <core/tasks/parallel_for.hpp>
+#include <core/tasks/task_system.h>
+
+#include <cmath>
+
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace
+{
+// The representation used before tasks were pooled: a heap allocated model
+// holding a std::packaged_task, shared through a std::shared_future.
+struct legacy_task_concept
+{
+	virtual ~legacy_task_concept() = default;
+	virtual void invoke() = 0;
+};
+
+template <typename R>
+struct legacy_task_model : legacy_task_concept
+{
+	template <typename F>
+	explicit legacy_task_model(F&& f)
+		: f_(std::forward<F>(f))
+	{
+	}
+
+	void invoke() override
+	{
+		f_();
+	}
+
+	std::packaged_task<R()> f_;
+};
+
+void LegacyTask_MakeExecuteGet(benchmark::State& st)
+{
+	int sum = 0;
+	while(st.KeepRunning())
+	{
+		auto model = std::make_unique<legacy_task_model<int>>([]() { return 1; });
+		auto fut = model->f_.get_future().share();
+		std::unique_ptr<legacy_task_concept> t = std::move(model);
+		t->invoke();
+		sum += fut.get();
+	}
+	benchmark::DoNotOptimize(sum);
+	st.SetItemsProcessed(st.iterations());
+}
+
+void Task_MakeExecuteGet(benchmark::State& st)
+{
+	int sum = 0;
+	while(st.KeepRunning())
+	{
+		auto t = core::task::make_ready_task([]() { return 1; });
+		t.first();
+		sum += t.second.get();
+	}
+	benchmark::DoNotOptimize(sum);
+	st.SetItemsProcessed(st.iterations());
+}
+
+void TaskSystem_PushExecuteGet(benchmark::State& st)
+{
+	core::task_system ts(false);
+	const auto batch = static_cast<std::size_t>(st.range(0));
+	std::vector<core::task_future<int>> futures;
+	futures.reserve(batch);
+
+	int sum = 0;
+	while(st.KeepRunning())
+	{
+		futures.clear();
+		for(std::size_t i = 0; i < batch; ++i)
+		{
+			futures.emplace_back(ts.push_on_worker_thread([]() { return 1; }));
+		}
+		for(const auto& f : futures)
+		{
+			sum += f.get();
+		}
+	}
+	benchmark::DoNotOptimize(sum);
+	st.SetItemsProcessed(st.iterations() * st.range(0));
+}
+
+void TaskSystem_Continuations(benchmark::State& st)
+{
+	core::task_system ts(false);
+	const auto batch = static_cast<std::size_t>(st.range(0));
+	std::vector<core::task_future<int>> futures;
+	futures.reserve(batch);
+
+	int sum = 0;
+	while(st.KeepRunning())
+	{
+		futures.clear();
+		for(std::size_t i = 0; i < batch; ++i)
+		{
+			auto first = ts.push_on_worker_thread([]() { return 1; });
+			futures.emplace_back(ts.push_on_worker_thread([](int v) { return v + 1; }, first));
+		}
+		for(const auto& f : futures)
+		{
+			sum += f.get();
+		}
+	}
+	benchmark::DoNotOptimize(sum);
+	st.SetItemsProcessed(st.iterations() * st.range(0) * 2);
+}
+// Per entity work of roughly the size of a transform update.
+float simulate_entity(std::size_t i)
+{
+	auto v = static_cast<float>(i);
+	for(int k = 0; k < 32; ++k)
+	{
+		v = std::sqrt(v * 1.0001f + 1.0f);
+	}
+	return v;
+}
+
+void Serial_For(benchmark::State& st)
+{
+	std::vector<float> out(static_cast<std::size_t>(st.range(0)));
+	while(st.KeepRunning())
+	{
+		for(std::size_t i = 0; i < out.size(); ++i)
+		{
+			out[i] = simulate_entity(i);
+		}
+		benchmark::DoNotOptimize(out.data());
+	}
+	st.SetItemsProcessed(st.iterations() * st.range(0));
+}
+
+void TaskSystem_ParallelFor(benchmark::State& st)
+{
+	core::task_system ts(false);
+	std::vector<float> out(static_cast<std::size_t>(st.range(0)));
+	while(st.KeepRunning())
+	{
+		core::parallel_for(ts, 0, out.size(), [&out](std::size_t i) { out[i] = simulate_entity(i); }, 256);
+		benchmark::DoNotOptimize(out.data());
+	}
+	st.SetItemsProcessed(st.iterations() * st.range(0));
+}
+} // namespace
+
+BENCHMARK(LegacyTask_MakeExecuteGet);
+BENCHMARK(Task_MakeExecuteGet);
+BENCHMARK(TaskSystem_PushExecuteGet)->Arg(64)->Arg(1024);
+BENCHMARK(TaskSystem_Continuations)->Arg(64)->Arg(1024);
+BENCHMARK(Serial_For)->Arg(50000);
+BENCHMARK(TaskSystem_ParallelFor)->Arg(50000);
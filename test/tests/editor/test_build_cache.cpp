@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include "../temp_dir_test.h"
+
+#include "editor_runtime/assets/build_cache.h"
+#include <core/logging/logging.h>
+
+#include <chrono>
+#include <fstream>
+
+namespace {
+class BuildCacheTest : public TempDirTest {
+protected:
+  BuildCacheTest() : TempDirTest("build_cache_test") {}
+
+  void SetUp() override {
+    logging::create_app_logger(logging::get_mutable_logging_container(), false);
+    TempDirTest::SetUp();
+  }
+};
+}
+
+TEST_F(BuildCacheTest, SkipsUnchangedInputs) {
+  asset_compiler::build_cache cache;
+  cache.load(dir_ / "build_cache.db");
+
+  const auto source = write("a.png", "pixels");
+  const auto meta = write("a.png.meta", "metadata");
+  const auto output = write("a.png.asset", "compiled");
+
+  const auto e = cache.make_entry(output, source, meta, {"-m"});
+  EXPECT_FALSE(cache.is_up_to_date(output, e, false));
+  cache.record(output, e);
+  EXPECT_TRUE(cache.is_up_to_date(output, e, false));
+
+  // rewriting the same content keeps the key
+  write("a.png", "pixels");
+  EXPECT_EQ(cache.make_entry(output, source, meta, {"-m"}).key, e.key);
+
+  // changed content or tool arguments do not
+  write("a.png", "other pixels");
+  EXPECT_FALSE(cache.is_up_to_date(output, cache.make_entry(output, source, meta, {"-m"}), false));
+  write("a.png", "pixels");
+  EXPECT_FALSE(cache.is_up_to_date(output, cache.make_entry(output, source, meta, {"-t"}), false));
+
+  // a missing output is never up to date
+  fs::error_code err;
+  fs::remove(output, err);
+  EXPECT_FALSE(cache.is_up_to_date(output, e, false));
+}
+
+TEST_F(BuildCacheTest, PersistsAndRenames) {
+  const auto source = write("b.wav", "samples");
+  const auto meta = write("b.wav.meta", "metadata");
+  const auto output = write("b.wav.asset", "compiled");
+  const auto renamed = dir_ / "c.wav.asset";
+
+  asset_compiler::build_cache::entry e;
+  {
+    asset_compiler::build_cache cache;
+    cache.load(dir_ / "build_cache.db");
+    e = cache.make_entry(output, source, meta, {});
+    cache.record(output, e);
+    cache.save();
+  }
+
+  asset_compiler::build_cache cache;
+  cache.load(dir_ / "build_cache.db");
+  ASSERT_EQ(cache.get_entries().size(), 1u);
+  EXPECT_TRUE(cache.is_up_to_date(output, e, false));
+
+  fs::error_code err;
+  fs::rename(output, renamed, err);
+  cache.rename(output, renamed);
+  EXPECT_TRUE(cache.is_up_to_date(renamed, e, false));
+
+  cache.remove(renamed);
+  EXPECT_TRUE(cache.get_entries().empty());
+}
+
+TEST_F(BuildCacheTest, ReusesOutputsWithTheSameKey) {
+  asset_compiler::build_cache cache;
+  cache.load(dir_ / "build_cache.db");
+
+  const auto source = write("d.mat", "material");
+  const auto meta = write("d.mat.meta", "metadata");
+  const auto output = write("d.mat.asset", "compiled");
+  const auto e = cache.make_entry(output, source, meta, {});
+  cache.record(output, e);
+
+  // a copy of the source under another name builds to the same key
+  const auto copy_source = write("e.mat", "material");
+  const auto copy_meta = write("e.mat.meta", "metadata");
+  const auto copy_output = dir_ / "e.mat.asset";
+  const auto copy = cache.make_entry(copy_output, copy_source, copy_meta, {});
+  ASSERT_EQ(copy.key, e.key);
+  EXPECT_FALSE(cache.is_up_to_date(copy_output, copy, false));
+  ASSERT_TRUE(cache.reuse(copy_output, copy));
+  EXPECT_TRUE(cache.is_up_to_date(copy_output, copy, false));
+
+  std::ifstream stream(copy_output.string(), std::ios::binary);
+  std::string content;
+  stream >> content;
+  EXPECT_EQ(content, "compiled");
+}
+
+TEST_F(BuildCacheTest, AdoptsOnlyNewerUnknownOutputs) {
+  asset_compiler::build_cache cache;
+  cache.load(dir_ / "build_cache.db");
+
+  const auto source = write("f.pfb", "prefab");
+  const auto meta = write("f.pfb.meta", "metadata");
+  const auto output = write("f.pfb.asset", "compiled");
+
+  fs::error_code err;
+  const auto source_time = fs::last_write_time(source, err);
+  fs::last_write_time(output, source_time - std::chrono::hours(1), err);
+  const auto e = cache.make_entry(output, source, meta, {});
+  EXPECT_FALSE(cache.is_up_to_date(output, e, true));
+
+  fs::last_write_time(output, source_time + std::chrono::hours(1), err);
+  EXPECT_TRUE(cache.is_up_to_date(output, e, true));
+  EXPECT_EQ(cache.get_entries().size(), 1u);
+}
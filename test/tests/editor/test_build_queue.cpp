@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include "editor_runtime/assets/build_queue.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+// holds the single build slot until released
+struct gate {
+  void wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [this]() { return open; });
+  }
+  void release() {
+    std::lock_guard<std::mutex> lock(mutex);
+    open = true;
+    cv.notify_all();
+  }
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool open = false;
+};
+
+struct build_log {
+  void add(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    keys.push_back(key);
+  }
+  std::mutex mutex;
+  std::vector<std::string> keys;
+};
+}
+
+TEST(BuildQueue, PrioritizesRequestedSources) {
+  core::task_system ts(true, 3);
+  asset_compiler::build_queue queue(ts);
+  queue.set_max_running(1);
+
+  gate g;
+  build_log log;
+  queue.push("app:/data/blocker.png", [&]() { g.wait(); });
+  for (const auto& key : {"app:/data/a.png", "app:/data/b.png", "app:/data/c.png"}) {
+    queue.push(key, [&log, key]() { log.add(key); });
+  }
+  queue.prioritize("app:/data/c.png");
+
+  const auto info = queue.get_info();
+  EXPECT_EQ(info.running, 1u);
+  EXPECT_EQ(info.pending, 3u);
+
+  g.release();
+  queue.wait();
+  const std::vector<std::string> expected = {"app:/data/c.png", "app:/data/a.png", "app:/data/b.png"};
+  EXPECT_EQ(log.keys, expected);
+  EXPECT_EQ(queue.get_info().pending + queue.get_info().running, 0u);
+}
+
+TEST(BuildQueue, DeduplicatesWaitingBuilds) {
+  core::task_system ts(true, 3);
+  asset_compiler::build_queue queue(ts);
+  queue.set_max_running(1);
+
+  gate g;
+  std::atomic<int> first{0};
+  std::atomic<int> second{0};
+  queue.push("app:/data/blocker.png", [&]() { g.wait(); });
+  queue.push("app:/data/a.png", [&]() { ++first; });
+  queue.push("app:/data/a.png", [&]() { ++second; });
+  EXPECT_EQ(queue.get_info().pending, 1u);
+
+  g.release();
+  queue.wait();
+  EXPECT_EQ(first, 0);
+  EXPECT_EQ(second, 1);
+}
+
+TEST(BuildQueue, NeverRunsASourceTwiceAtOnce) {
+  core::task_system ts(true, 4);
+  asset_compiler::build_queue queue(ts);
+  queue.set_max_running(3);
+
+  gate g;
+  std::atomic<int> active{0};
+  std::atomic<int> max_active{0};
+  std::atomic<int> runs{0};
+  const auto job = [&]() {
+    const auto now = ++active;
+    int expected = max_active;
+    while (now > expected && !max_active.compare_exchange_weak(expected, now)) {
+    }
+    g.wait();
+    ++runs;
+    --active;
+  };
+
+  // the second push waits for the first instead of running beside it
+  queue.push("app:/data/a.png", job);
+  queue.push("app:/data/a.png", job);
+  EXPECT_EQ(queue.get_info().running, 1u);
+  EXPECT_EQ(queue.get_info().pending, 1u);
+
+  g.release();
+  queue.wait();
+  EXPECT_EQ(runs, 2);
+  EXPECT_EQ(max_active, 1);
+}
+
+TEST(BuildQueue, ClearsAGroup) {
+  core::task_system ts(true, 3);
+  asset_compiler::build_queue queue(ts);
+  queue.set_max_running(1);
+
+  gate g;
+  build_log log;
+  queue.push("engine:/data/blocker.png", [&]() { g.wait(); });
+  queue.push("app:/data/a.png", [&]() { log.add("app"); });
+  queue.push("engine:/data/b.png", [&]() { log.add("engine"); });
+  queue.clear("app:/");
+  EXPECT_EQ(queue.get_info().pending, 1u);
+
+  g.release();
+  queue.wait();
+  EXPECT_EQ(log.keys, std::vector<std::string>{"engine"});
+}
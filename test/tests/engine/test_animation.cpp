@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include <runtime/animation/animation_compression.h>
+#include <runtime/animation/animation_player.h>
+#include <runtime/animation/animation_sampler.h>
+#include <runtime/rendering/mesh/skeleton.h>
+
+#include <cmath>
+#include <random>
+
+namespace {
+using seconds_t = runtime::animation::seconds_t;
+
+runtime::animation make_clip(float duration, std::size_t key_count, float amplitude) {
+  runtime::animation anim;
+  anim.duration = seconds_t(duration);
+  anim.channels.resize(1);
+  auto& channel = anim.channels.front();
+  channel.node_name = "arm";
+  for (std::size_t i = 0; i < key_count; ++i) {
+    const auto t = duration * float(i) / float(key_count - 1);
+    const auto angle = amplitude * std::sin(t * 3.0f);
+    channel.position_keys.push_back({seconds_t(t), math::vec3(t, amplitude * std::cos(t), 0.0f)});
+    channel.rotation_keys.push_back({seconds_t(t), math::angleAxis(angle, math::vec3(0.0f, 1.0f, 0.0f))});
+    channel.scaling_keys.push_back({seconds_t(t), math::vec3(1.0f)});
+  }
+  return anim;
+}
+
+// reference: search every key from the start
+math::vec3 reference_position(const runtime::node_animation& channel, float time) {
+  const auto& keys = channel.position_keys;
+  if (time <= keys.front().time.count()) {
+    return keys.front().value;
+  }
+  for (std::size_t i = 0; i + 1 < keys.size(); ++i) {
+    const auto t0 = keys[i].time.count();
+    const auto t1 = keys[i + 1].time.count();
+    if (time < t1) {
+      return math::mix(keys[i].value, keys[i + 1].value, (time - t0) / (t1 - t0));
+    }
+  }
+  return keys.back().value;
+}
+
+skeleton make_skeleton() {
+  skeleton skel;
+  const auto root = skel.add_node("root", skeleton::invalid_index, math::transform());
+  skel.add_node("arm", root, math::transform());
+  return skel;
+}
+}  // namespace
+
+TEST(Animation, CursorSamplingMatchesSearch) {
+  const auto anim = make_clip(4.0f, 97, 1.0f);
+  const auto& channel = anim.channels.front();
+
+  std::mt19937 rng(3);
+  std::uniform_real_distribution<float> jump(-5.0f, 5.0f);
+
+  runtime::channel_cursor cursor;
+  float time = 0.0f;
+  for (int i = 0; i < 500; ++i) {
+    // mostly small steps forward, sometimes a jump anywhere
+    time = (i % 17 == 0) ? jump(rng) : time + 0.011f;
+    math::vec3 position(0.0f);
+    math::quat rotation;
+    math::vec3 scaling(0.0f);
+    runtime::sample_channel(channel, time, cursor, position, rotation, scaling);
+
+    const auto expected = reference_position(channel, time);
+    EXPECT_NEAR(position.x, expected.x, 0.0001f) << time;
+    EXPECT_NEAR(position.y, expected.y, 0.0001f) << time;
+    EXPECT_NEAR(scaling.x, 1.0f, 0.0001f);
+  }
+}
+
+TEST(Animation, CompressedTracksStayClose) {
+  const auto source = make_clip(2.0f, 241, 0.5f);
+  auto compressed = source;
+  runtime::compress(compressed, runtime::animation_compression_settings{});
+
+  EXPECT_LT(runtime::get_key_count(compressed), runtime::get_key_count(source));
+  EXPECT_LT(runtime::get_key_memory(compressed) * 3, runtime::get_key_memory(source));
+
+  const auto& a = source.channels.front();
+  const auto& b = compressed.channels.front();
+  EXPECT_TRUE(b.position_keys.empty());
+  EXPECT_EQ(b.quantized_scaling_keys.size(), 1u);
+
+  runtime::channel_cursor cursor_a;
+  runtime::channel_cursor cursor_b;
+  for (float time = 0.0f; time <= 2.0f; time += 0.004f) {
+    math::vec3 pa(0.0f), pb(0.0f), sa(0.0f), sb(0.0f);
+    math::quat ra, rb;
+    runtime::sample_channel(a, time, cursor_a, pa, ra, sa);
+    runtime::sample_channel(b, time, cursor_b, pb, rb, sb);
+
+    EXPECT_LT(math::length(pa - pb), 0.005f) << time;
+    EXPECT_GT(std::abs(math::dot(ra, rb)), 0.9999f) << time;
+    EXPECT_LT(math::length(sa - sb), 0.001f) << time;
+  }
+}
+
+TEST(Animation, PlayerBlendsLayersIntoThePose) {
+  const auto skel = make_skeleton();
+  skeleton_pose pose;
+  pose.reset(skel);
+
+  auto walk = std::make_shared<runtime::animation>();
+  walk->duration = seconds_t(1.0f);
+  walk->channels.resize(1);
+  walk->channels[0].node_name = "arm";
+  walk->channels[0].position_keys = {{seconds_t(0.0f), math::vec3(0.0f)}, {seconds_t(1.0f), math::vec3(4.0f, 0.0f, 0.0f)}};
+
+  auto lift = std::make_shared<runtime::animation>(*walk);
+  lift->channels[0].position_keys = {{seconds_t(0.0f), math::vec3(0.0f, 2.0f, 0.0f)}};
+
+  asset_handle<runtime::animation> walk_handle;
+  walk_handle = walk;
+  asset_handle<runtime::animation> lift_handle;
+  lift_handle = lift;
+
+  runtime::animation_player player;
+  player.add_layer(walk_handle);
+  player.add_layer(lift_handle);
+  player.update(seconds_t(0.25f));
+  player.evaluate(skel, pose);
+
+  // equal weights average the layers
+  const auto& arm = pose.get_local_transforms()[1];
+  EXPECT_NEAR(arm.get_position().x, 0.5f, 0.0001f);
+  EXPECT_NEAR(arm.get_position().y, 1.0f, 0.0001f);
+
+  // looping wraps around, a half weight layer mixes with the rest pose
+  player.remove_layer(1);
+  player.get_layer(0).weight = 0.5f;
+  player.update(seconds_t(1.5f));
+  EXPECT_NEAR(player.get_layer(0).time.count(), 0.75f, 0.0001f);
+  player.evaluate(skel, pose);
+  EXPECT_NEAR(pose.get_local_transforms()[1].get_position().x, 1.5f, 0.0001f);
+}
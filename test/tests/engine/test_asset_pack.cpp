@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "../temp_dir_test.h"
+#include <runtime/assets/asset_pack.h>
+
+#include <istream>
+#include <string>
+
+namespace {
+class AssetPackTest : public TempDirTest {
+protected:
+  AssetPackTest() : TempDirTest("asset_pack_test") {}
+
+  std::string read(const runtime::asset_pack& pack, const std::string& key) {
+    fs::byte_span data;
+    if (!pack.find(key, data)) {
+      return {};
+    }
+    return std::string(reinterpret_cast<const char*>(data.data), data.size);
+  }
+};
+}
+
+TEST_F(AssetPackTest, FindsTheDataOfEveryKey) {
+  const runtime::asset_pack::sources_t sources = {
+      {"app:/cache/a.png.asset", write("a", "texture data")},
+      {"app:/cache/b.obj.asset", write("b", "")},
+      {"app:/cache/c.mat.asset", write("c", std::string(100000, 'm'))},
+  };
+  const auto pack_path = dir_ / "data.pak";
+  std::string err;
+  ASSERT_TRUE(runtime::asset_pack::write(pack_path, sources, err)) << err;
+
+  runtime::asset_pack pack;
+  ASSERT_TRUE(pack.open(pack_path, err)) << err;
+  EXPECT_EQ(pack.get_entries().size(), 3u);
+  EXPECT_EQ(read(pack, "app:/cache/a.png.asset"), "texture data");
+  EXPECT_EQ(read(pack, "app:/cache/b.obj.asset"), "");
+  EXPECT_EQ(read(pack, "app:/cache/c.mat.asset"), std::string(100000, 'm'));
+
+  fs::byte_span data;
+  EXPECT_FALSE(pack.find("app:/cache/missing.asset", data));
+
+  for (const auto& e : pack.get_entries()) {
+    EXPECT_EQ(e.second.offset % 16, 0u);
+    EXPECT_TRUE(pack.verify(e.first));
+  }
+}
+
+TEST_F(AssetPackTest, RejectsOtherFiles) {
+  std::string err;
+  runtime::asset_pack pack;
+  EXPECT_FALSE(pack.open(write("not.pak", "not a pack at all"), err));
+  EXPECT_FALSE(err.empty());
+
+  err.clear();
+  EXPECT_FALSE(pack.open(write("empty.pak", ""), err));
+  EXPECT_FALSE(err.empty());
+
+  err.clear();
+  EXPECT_FALSE(pack.open(dir_ / "missing.pak", err));
+  EXPECT_FALSE(err.empty());
+}
+
+TEST_F(AssetPackTest, RejectsTruncatedPacks) {
+  const runtime::asset_pack::sources_t sources = {{"app:/cache/a.png.asset", write("a", "texture data")}};
+  const auto pack_path = dir_ / "data.pak";
+  std::string err;
+  ASSERT_TRUE(runtime::asset_pack::write(pack_path, sources, err)) << err;
+
+  fs::error_code ec;
+  fs::resize_file(pack_path, fs::file_size(pack_path, ec) - 10, ec);
+  ASSERT_FALSE(ec);
+
+  runtime::asset_pack pack;
+  EXPECT_FALSE(pack.open(pack_path, err));
+  EXPECT_TRUE(pack.get_entries().empty());
+}
+
+TEST_F(AssetPackTest, StreamsFromTheMapping) {
+  const std::string content = "0123456789";
+  fs::byte_span span;
+  span.data = reinterpret_cast<const std::uint8_t*>(content.data());
+  span.size = content.size();
+
+  fs::span_streambuf buffer(span);
+  std::istream stream(&buffer);
+  std::string first;
+  stream >> first;
+  EXPECT_EQ(first, content);
+
+  stream.clear();
+  stream.seekg(4);
+  EXPECT_EQ(stream.get(), '4');
+  stream.seekg(-2, std::ios::end);
+  EXPECT_EQ(stream.get(), '8');
+  stream.seekg(20);
+  EXPECT_TRUE(stream.fail());
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include <core/math/bvh.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+std::vector<std::uint32_t> query_sorted(const math::bvh& tree, const math::frustum& f) {
+  std::vector<std::uint32_t> found;
+  tree.query(f, [&found](std::uint32_t user_data, math::volume_query) { found.push_back(user_data); });
+  std::sort(found.begin(), found.end());
+  return found;
+}
+}
+
+TEST(Bvh, MatchesBruteForce) {
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> pos(-100.0f, 100.0f);
+  std::uniform_real_distribution<float> size(0.1f, 3.0f);
+  const auto random_box = [&]() {
+    const math::vec3 center(pos(rng), pos(rng), pos(rng));
+    const math::vec3 extents(size(rng), size(rng), size(rng));
+    return math::bbox(center - extents, center + extents);
+  };
+
+  math::bvh tree;
+  std::vector<math::bbox> boxes;
+  std::vector<math::bvh::proxy_t> proxies;
+  std::vector<bool> alive;
+  for (std::uint32_t i = 0; i < 2000; ++i) {
+    boxes.push_back(random_box());
+    proxies.push_back(tree.insert(boxes.back(), i));
+    alive.push_back(true);
+  }
+
+  // moves both inside and outside of the fat bounds, removals and reinserts
+  for (int step = 0; step < 5000; ++step) {
+    const auto i = rng() % boxes.size();
+    if (!alive[i]) {
+      boxes[i] = random_box();
+      proxies[i] = tree.insert(boxes[i], std::uint32_t(i));
+      alive[i] = true;
+    } else if (step % 7 == 0) {
+      tree.remove(proxies[i]);
+      alive[i] = false;
+    } else {
+      const auto shift = (step % 2 == 0) ? math::vec3(0.01f, 0.0f, 0.0f) : math::vec3(pos(rng) * 0.1f);
+      boxes[i].min += shift;
+      boxes[i].max += shift;
+      tree.update(proxies[i], boxes[i]);
+    }
+  }
+
+  EXPECT_EQ(tree.get_proxy_count(), std::size_t(std::count(alive.begin(), alive.end(), true)));
+  // balanced, a degenerate tree would be a few hundred levels deep
+  EXPECT_LT(tree.get_height(), 32);
+
+  for (int q = 0; q < 50; ++q) {
+    const math::vec3 center(pos(rng), pos(rng), pos(rng));
+    const math::frustum f(math::bbox(center - math::vec3(25.0f), center + math::vec3(25.0f)));
+
+    std::vector<std::uint32_t> expected;
+    for (std::uint32_t i = 0; i < boxes.size(); ++i) {
+      if (!alive[i]) {
+        continue;
+      }
+      EXPECT_TRUE(tree.get_fat_bounds(proxies[i]).contains_point(boxes[i].get_center()));
+      if (f.classify_aabb(tree.get_fat_bounds(proxies[i])) != math::volume_query::outside) {
+        expected.push_back(i);
+      }
+    }
+    EXPECT_EQ(query_sorted(tree, f), expected);
+  }
+}
+
+TEST(Bvh, InsideSubtreesSkipTests) {
+  math::bvh tree(0.0f);
+  for (std::uint32_t i = 0; i < 64; ++i) {
+    const math::vec3 p(float(i % 8), float(i / 8), 0.0f);
+    tree.insert(math::bbox(p, p + math::vec3(0.5f)), i);
+  }
+
+  const math::frustum all(math::bbox(math::vec3(-1.0f), math::vec3(10.0f)));
+  std::size_t inside = 0;
+  tree.query(all, [&inside](std::uint32_t, math::volume_query result) {
+    EXPECT_EQ(result, math::volume_query::inside);
+    inside++;
+  });
+  EXPECT_EQ(inside, 64u);
+
+  const math::frustum none(math::bbox(math::vec3(50.0f), math::vec3(60.0f)));
+  tree.query(none, [](std::uint32_t, math::volume_query) { ADD_FAILURE(); });
+
+  tree.clear();
+  EXPECT_EQ(tree.get_height(), -1);
+  EXPECT_EQ(tree.get_proxy_count(), 0u);
+}
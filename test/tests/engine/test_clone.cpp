@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include <core/system/subsystem.h>
+#include <runtime/ecs/components/relation.h>
+#include <runtime/ecs/components/transform_component.h>
+#include <runtime/ecs/constructs/snapshots.h>
+#include <runtime/ecs/systems/scene_graph.h>
+
+#include <vector>
+
+namespace {
+class CloneTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    core::details::initialize();
+    core::add_subsystem<SpatialSystem>();
+    core::add_subsystem<runtime::scene_graph>();
+  }
+
+  void TearDown() override {
+    core::get_subsystem<SpatialSystem>().reset();
+    core::details::dispose();
+  }
+
+  static EntityType create(Registry& reg, const char* name, EntityType parent, float x) {
+    auto e = reg.create();
+    reg.assign<Name>(e, name);
+    reg.assign<Relation>(e).parent = parent;
+    reg.assign<transform_component>(e).set_local_position({x, 0.0f, 0.0f});
+    return e;
+  }
+};
+}
+
+TEST_F(CloneTest, RemapsReferencesInsideTheSet) {
+  auto& ecs = core::get_subsystem<SpatialSystem>();
+  auto& sg = core::get_subsystem<runtime::scene_graph>();
+
+  auto outside = create(ecs, "outside", entt::null, 0.0f);
+  auto root = create(ecs, "root", entt::null, 1.0f);
+  sg.set_parent(root, outside);
+  auto child = create(ecs, "child", entt::null, 2.0f);
+  sg.set_parent(child, root);
+
+  auto copies = ecs::clone(ecs, {root, child}, ecs, 3);
+  ASSERT_EQ(copies.size(), 6);
+
+  for (std::size_t k = 0; k < 3; ++k) {
+    const auto root_copy = copies[k * 2];
+    const auto child_copy = copies[k * 2 + 1];
+    EXPECT_EQ(ecs.get<Name>(root_copy).name, "root");
+    EXPECT_EQ(ecs.get<Name>(child_copy).name, "child");
+    EXPECT_FLOAT_EQ(ecs.get<transform_component>(child_copy).get_local_position().x, 2.0f);
+
+    // inside the set the copies point to each other, outside references stay
+    EXPECT_EQ(ecs.get<Relation>(child_copy).parent, root_copy);
+    EXPECT_EQ(ecs.get<Relation>(root_copy).parent, outside);
+    EXPECT_EQ(sg.get_parent(child_copy), root_copy);
+    EXPECT_EQ(sg.get_first_child(root_copy), child_copy);
+  }
+
+  // the originals are untouched
+  EXPECT_EQ(sg.get_first_child(root), child);
+  EXPECT_EQ(ecs.get<Relation>(child).parent, root);
+}
+
+TEST_F(CloneTest, BetweenRegistries) {
+  auto& ecs = core::get_subsystem<SpatialSystem>();
+  auto& sg = core::get_subsystem<runtime::scene_graph>();
+
+  Registry source;
+  auto outside = create(source, "outside", entt::null, 0.0f);
+  auto root = create(source, "root", outside, 1.0f);
+  auto child = create(source, "child", root, 2.0f);
+
+  const auto roots_before = sg.get_root_count();
+  auto copies = ecs::clone(source, {root, child}, ecs, 2);
+  ASSERT_EQ(copies.size(), 4);
+
+  // references leaving the source registry are dropped
+  EXPECT_EQ(ecs.get<Relation>(copies[0]).parent, entt::null);
+  EXPECT_EQ(ecs.get<Relation>(copies[1]).parent, copies[0]);
+  EXPECT_EQ(sg.get_root_count(), roots_before + 2);
+
+  // unless the hook maps them
+  auto parent = create(ecs, "parent", entt::null, 5.0f);
+  auto mapped = ecs::clone(source, {root}, ecs, 1, [parent](EntityType) { return parent; });
+  ASSERT_EQ(mapped.size(), 1);
+  EXPECT_EQ(sg.get_parent(mapped[0]), parent);
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <core/graphics/frame_graph.h>
+
+namespace {
+gfx::transient_texture_desc make_desc(gfx::texture_format format) {
+  gfx::transient_texture_desc desc;
+  desc.width = 64;
+  desc.height = 64;
+  desc.format = format;
+  return desc;
+}
+}
+
+// compile() needs no renderer, execute() is left to the running engine
+TEST(FrameGraph, CullsUnreadPassesAndAliases) {
+  gfx::transient_texture_pool pool;
+  gfx::frame_graph graph(pool);
+  const auto desc = make_desc(gfx::texture_format::RGBA8);
+  const auto output = graph.import_texture("OUTPUT", nullptr);
+
+  gfx::frame_graph::resource_id a = 0, b = 0, c = 0;
+  const auto nop = [](const gfx::frame_graph::resources&) {};
+  graph.add_pass("a", [&](gfx::frame_graph::builder& builder) { a = builder.create("A", desc); }, nop);
+  graph.add_pass("b",
+                 [&](gfx::frame_graph::builder& builder) {
+                   builder.read(a);
+                   b = builder.create("B", desc);
+                 },
+                 nop);
+  graph.add_pass("unread",
+                 [&](gfx::frame_graph::builder& builder) {
+                   builder.read(b);
+                   builder.create("U", desc);
+                 },
+                 nop);
+  graph.add_pass("c",
+                 [&](gfx::frame_graph::builder& builder) {
+                   builder.read(b);
+                   c = builder.create("C", desc);
+                 },
+                 nop);
+  graph.add_pass("output",
+                 [&](gfx::frame_graph::builder& builder) {
+                   builder.read(c);
+                   builder.write(output);
+                 },
+                 nop);
+  graph.compile();
+
+  EXPECT_FALSE(graph.is_culled(0));
+  EXPECT_FALSE(graph.is_culled(1));
+  EXPECT_TRUE(graph.is_culled(2));
+  EXPECT_FALSE(graph.is_culled(3));
+  EXPECT_FALSE(graph.is_culled(4));
+
+  // a is dead once b is written, c can take its place
+  EXPECT_EQ(graph.get_physical_index(a), graph.get_physical_index(c));
+  EXPECT_NE(graph.get_physical_index(a), graph.get_physical_index(b));
+
+  const auto& report = graph.get_memory_report();
+  EXPECT_EQ(report.pass_count, 5u);
+  EXPECT_EQ(report.culled_pass_count, 1u);
+  EXPECT_EQ(report.transient_count, 3u);
+  EXPECT_EQ(report.physical_count, 2u);
+  EXPECT_EQ(report.requested_bytes, 3 * gfx::get_storage_size(desc));
+  EXPECT_EQ(report.allocated_bytes, 2 * gfx::get_storage_size(desc));
+}
+
+TEST(FrameGraph, DifferentFormatsDontAlias) {
+  gfx::transient_texture_pool pool;
+  gfx::frame_graph graph(pool);
+  const auto output = graph.import_texture("OUTPUT", nullptr);
+
+  gfx::frame_graph::resource_id a = 0, b = 0;
+  const auto nop = [](const gfx::frame_graph::resources&) {};
+  graph.add_pass("a",
+                 [&](gfx::frame_graph::builder& builder) {
+                   a = builder.create("A", make_desc(gfx::texture_format::RGBA8));
+                 },
+                 nop);
+  graph.add_pass("b",
+                 [&](gfx::frame_graph::builder& builder) {
+                   builder.read(a);
+                   b = builder.create("B", make_desc(gfx::texture_format::RGBA16F));
+                 },
+                 nop);
+  graph.add_pass("output",
+                 [&](gfx::frame_graph::builder& builder) {
+                   builder.read(b);
+                   builder.write(output);
+                 },
+                 nop);
+  graph.compile();
+
+  EXPECT_NE(graph.get_physical_index(a), graph.get_physical_index(b));
+  EXPECT_EQ(graph.get_memory_report().physical_count, 2u);
+}
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include <core/math/frustum_cull.h>
+
+#include <random>
+#include <vector>
+
+TEST(FrustumCull, MatchesTestObb) {
+  std::mt19937 rng(11);
+  std::uniform_real_distribution<float> pos(-60.0f, 60.0f);
+  std::uniform_real_distribution<float> scale(0.2f, 5.0f);
+
+  const math::frustum f(math::bbox(math::vec3(-20.0f, -10.0f, -30.0f), math::vec3(25.0f, 15.0f, 5.0f)));
+  const math::bbox bounds(math::vec3(-1.0f, -0.5f, -2.0f), math::vec3(1.5f, 0.5f, 1.0f));
+
+  math::cull_batch batch;
+  std::vector<math::transform> transforms(999);
+  for (auto& t : transforms) {
+    t.set_position({pos(rng), pos(rng), pos(rng)});
+    t.set_scale({scale(rng), scale(rng), scale(rng)});
+    t.rotate(pos(rng), pos(rng), pos(rng));
+    batch.add_obb(bounds, t);
+  }
+  ASSERT_EQ(batch.size(), transforms.size());
+
+  std::vector<std::uint32_t> visibility;
+  batch.test(f, visibility);
+  ASSERT_EQ(visibility.size(), (transforms.size() + 31) / 32);
+
+  std::size_t visible = 0;
+  for (std::size_t i = 0; i < transforms.size(); ++i) {
+    EXPECT_EQ(math::cull_batch::is_visible(visibility, i), math::frustum::test_obb(f, bounds, transforms[i]));
+    visible += math::cull_batch::is_visible(visibility, i);
+  }
+  EXPECT_GT(visible, 0);
+  EXPECT_LT(visible, transforms.size());
+
+  // bits past the end stay clear
+  EXPECT_EQ(visibility.back() >> (transforms.size() % 32), 0u);
+}
+
+TEST(FrustumCull, SpheresAndAnyOf) {
+  const math::frustum left(math::bbox(math::vec3(-10.0f), math::vec3(0.0f, 10.0f, 10.0f)));
+  const math::frustum right(math::bbox(math::vec3(0.0f, -10.0f, -10.0f), math::vec3(10.0f)));
+
+  math::cull_batch batch;
+  batch.add_sphere({-5.0f, 0.0f, 0.0f}, 1.0f);
+  batch.add_sphere({5.0f, 0.0f, 0.0f}, 1.0f);
+  batch.add_sphere({50.0f, 0.0f, 0.0f}, 1.0f);
+  batch.add_aabb(math::bbox(math::vec3(-1.0f), math::vec3(1.0f)));
+
+  std::vector<std::uint32_t> visibility;
+  batch.test(left, visibility);
+  EXPECT_TRUE(math::cull_batch::is_visible(visibility, 0));
+  EXPECT_FALSE(math::cull_batch::is_visible(visibility, 1));
+  EXPECT_FALSE(math::cull_batch::is_visible(visibility, 2));
+  EXPECT_TRUE(math::cull_batch::is_visible(visibility, 3));
+
+  batch.test_any(right, visibility);
+  EXPECT_TRUE(math::cull_batch::is_visible(visibility, 0));
+  EXPECT_TRUE(math::cull_batch::is_visible(visibility, 1));
+  EXPECT_FALSE(math::cull_batch::is_visible(visibility, 2));
+
+  batch.clear();
+  batch.test(left, visibility);
+  EXPECT_FALSE(math::cull_batch::any_visible(visibility));
+}
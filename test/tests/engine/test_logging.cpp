@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include <core/logging/logging.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+class counting_sink : public logging::sinks::sink {
+public:
+  void log(const logging::details::log_msg&) override { ++count; }
+  void flush() override {}
+
+  std::atomic<int> count{0};
+};
+
+class LoggingTest : public ::testing::Test {
+protected:
+  void TearDown() override {
+    // the other tests log through the shared container
+    logging::create_app_logger(logging::get_mutable_logging_container(), false);
+  }
+};
+}
+
+TEST_F(LoggingTest, MacrosUseTheAppLogger) {
+  auto sink = std::make_shared<counting_sink>();
+  auto log = logging::create_app_logger(sink, false);
+  EXPECT_EQ(logging::get_app_logger(), log.get());
+  EXPECT_EQ(spdlog::get(APPLOG), log);
+
+  APPLOG_WARNING("warning {0}", 1);
+  APPLOG_ERROR("error");
+  EXPECT_EQ(sink->count, 2);
+}
+
+TEST_F(LoggingTest, FlushWritesEveryQueuedRecord) {
+  auto sink = std::make_shared<counting_sink>();
+  logging::create_app_logger(sink, true);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([]() {
+      for (int i = 0; i < 1000; ++i) {
+        APPLOG_WARNING("record {0}", i);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  logging::flush();
+  EXPECT_EQ(sink->count, 4000);
+
+  // from now on records are written as they are logged
+  logging::shutdown();
+  APPLOG_WARNING("after shutdown");
+  EXPECT_EQ(sink->count, 4001);
+}
+
+TEST_F(LoggingTest, ErrorsAreWrittenBeforeReturning) {
+  auto sink = std::make_shared<counting_sink>();
+  logging::create_app_logger(sink, true);
+
+  for (int i = 0; i < 100; ++i) {
+    APPLOG_WARNING("record {0}", i);
+  }
+  APPLOG_ERROR("error");
+  EXPECT_EQ(sink->count, 101);
+}
@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+#include <runtime/rendering/mesh/mesh.h>
+#include <core/graphics/vertex_decl.h>
+
+#include <cstring>
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace {
+// exposes the preparation internals the weld and adjacency work on
+class weld_mesh : public mesh {
+public:
+  using mesh::preparation_data_;
+  using mesh::weld_vertices;
+};
+
+std::vector<std::function<bool(weld_mesh&)>> get_primitives() {
+  const auto layout = gfx::mesh_vertex::get_layout();
+  const auto origin = mesh_create_origin::center;
+  return {
+      [=](weld_mesh& m) { return m.create_plane(layout, 2.0f, 1.0f, 6, 4, origin, false); },
+      [=](weld_mesh& m) { return m.create_cube(layout, 1.0f, 2.0f, 3.0f, 3, 3, 3, origin, false); },
+      [=](weld_mesh& m) { return m.create_sphere(layout, 0.5f, 16, 24, origin, false); },
+      [=](weld_mesh& m) { return m.create_cylinder(layout, 0.5f, 2.0f, 4, 16, origin, false); },
+      [=](weld_mesh& m) { return m.create_capsule(layout, 0.5f, 2.0f, 8, 16, origin, false); },
+      [=](weld_mesh& m) { return m.create_cone(layout, 0.5f, 0.0f, 2.0f, 4, 16, origin, false); },
+      [=](weld_mesh& m) { return m.create_torus(layout, 1.0f, 0.25f, 24, 12, origin, false); },
+      [=](weld_mesh& m) { return m.create_icosahedron(layout, false); },
+      [=](weld_mesh& m) { return m.create_dodecahedron(layout, false); },
+      [=](weld_mesh& m) { return m.create_icosphere(layout, 2, false); },
+  };
+}
+
+// builds the primitive and rolls it back into the preparation state
+bool prepare_primitive(const std::function<bool(weld_mesh&)>& create, weld_mesh& m) {
+  if (!create(m)) {
+    return false;
+  }
+  m.prepare_mesh(gfx::mesh_vertex::get_layout());
+  return m.get_status() == mesh_status::preparing;
+}
+
+const math::vec3& get_position(const mesh::preparation_data& data, std::uint32_t vertex) {
+  const auto& layout = gfx::mesh_vertex::get_layout();
+  const auto* ptr = &data.vertex_data[vertex * layout.getStride()] + layout.getOffset(gfx::attribute::Position);
+  return *reinterpret_cast<const math::vec3*>(ptr);
+}
+
+// reference: the edge tree the adjacency used to be built with
+struct edge_key {
+  const math::vec3* vertex1 = nullptr;
+  const math::vec3* vertex2 = nullptr;
+};
+
+bool operator<(const edge_key& key1, const edge_key& key2) {
+  const auto eps = math::epsilon<float>();
+  for (int i = 0; i < 3; ++i) {
+    if (math::epsilonNotEqual((*key1.vertex1)[i], (*key2.vertex1)[i], eps)) {
+      return (*key2.vertex1)[i] < (*key1.vertex1)[i];
+    }
+  }
+  for (int i = 0; i < 3; ++i) {
+    if (math::epsilonNotEqual((*key1.vertex2)[i], (*key2.vertex2)[i], eps)) {
+      return (*key2.vertex2)[i] < (*key1.vertex2)[i];
+    }
+  }
+  return false;
+}
+
+std::vector<std::uint32_t> reference_adjacency(const mesh::preparation_data& data) {
+  std::map<edge_key, std::uint32_t> edge_tree;
+  for (std::uint32_t i = 0; i < data.triangle_count; ++i) {
+    const auto& tri = data.triangle_data[i];
+    if (tri.flags & triangle_flags::degenerate) {
+      continue;
+    }
+    for (std::uint32_t j = 0; j < 3; ++j) {
+      edge_tree[{&get_position(data, tri.indices[j]), &get_position(data, tri.indices[(j + 1) % 3])}] = i;
+    }
+  }
+
+  std::vector<std::uint32_t> adjacency(data.triangle_count * 3, 0xFFFFFFFF);
+  for (std::uint32_t i = 0; i < data.triangle_count; ++i) {
+    const auto& tri = data.triangle_data[i];
+    if (tri.flags & triangle_flags::degenerate) {
+      continue;
+    }
+    for (std::uint32_t j = 0; j < 3; ++j) {
+      auto it = edge_tree.find({&get_position(data, tri.indices[(j + 1) % 3]), &get_position(data, tri.indices[j])});
+      if (it != edge_tree.end()) {
+        adjacency[i * 3 + j] = it->second;
+      }
+    }
+  }
+  return adjacency;
+}
+
+// splits every triangle into its own three vertices
+void make_triangle_soup(mesh::preparation_data& data) {
+  const auto stride = gfx::mesh_vertex::get_layout().getStride();
+  mesh::byte_array_t vertices, flags;
+  for (std::uint32_t i = 0; i < data.triangle_count; ++i) {
+    auto& tri = data.triangle_data[i];
+    for (auto& index : tri.indices) {
+      const auto* src = &data.vertex_data[index * stride];
+      vertices.insert(vertices.end(), src, src + stride);
+      flags.push_back(data.vertex_flags[index]);
+      index = std::uint32_t(flags.size() - 1);
+    }
+  }
+  data.vertex_data = std::move(vertices);
+  data.vertex_flags = std::move(flags);
+  data.vertex_count = std::uint32_t(data.vertex_flags.size());
+}
+
+// reference: compare every vertex against all the vertices kept so far
+void reference_weld(mesh::preparation_data& data, float tolerance) {
+  const auto& layout = gfx::mesh_vertex::get_layout();
+  const auto stride = layout.getStride();
+  const auto position_offset = layout.getOffset(gfx::attribute::Position);
+  const auto position_end = position_offset + sizeof(math::vec3);
+
+  mesh::byte_array_t vertices;
+  std::vector<std::uint32_t> remap(data.vertex_count);
+  std::uint32_t count = 0;
+  for (std::uint32_t i = 0; i < data.vertex_count; ++i) {
+    const auto* v = &data.vertex_data[i * stride];
+    const auto& p = get_position(data, i);
+    std::uint32_t match = count;
+    for (std::uint32_t k = 0; k < count && match == count; ++k) {
+      const auto* w = &vertices[k * stride];
+      const auto& q = *reinterpret_cast<const math::vec3*>(w + position_offset);
+      if (math::distance2(p, q) <= tolerance * tolerance && std::memcmp(v, w, position_offset) == 0 &&
+          std::memcmp(v + position_end, w + position_end, stride - position_end) == 0) {
+        match = k;
+      }
+    }
+    if (match == count) {
+      vertices.insert(vertices.end(), v, v + stride);
+      ++count;
+    }
+    remap[i] = match;
+  }
+
+  for (auto& tri : data.triangle_data) {
+    for (auto& index : tri.indices) {
+      index = remap[index];
+    }
+  }
+  data.vertex_data = std::move(vertices);
+  data.vertex_count = count;
+}
+}
+
+TEST(MeshWeld, AdjacencyMatchesEdgeTree) {
+  for (const auto& create : get_primitives()) {
+    weld_mesh m;
+    ASSERT_TRUE(prepare_primitive(create, m));
+
+    std::vector<std::uint32_t> adjacency;
+    ASSERT_TRUE(m.generate_adjacency(adjacency));
+    EXPECT_EQ(adjacency, reference_adjacency(m.preparation_data_));
+  }
+}
+
+TEST(MeshWeld, WeldMatchesBruteForce) {
+  const float tolerance = 0.000001f;
+  for (const auto& create : get_primitives()) {
+    weld_mesh m;
+    ASSERT_TRUE(prepare_primitive(create, m));
+    const auto vertex_count = m.preparation_data_.vertex_count;
+    make_triangle_soup(m.preparation_data_);
+
+    auto expected = m.preparation_data_;
+    reference_weld(expected, tolerance);
+
+    ASSERT_TRUE(m.weld_vertices(tolerance));
+    const auto& data = m.preparation_data_;
+    ASSERT_EQ(data.vertex_count, expected.vertex_count);
+    EXPECT_LE(data.vertex_count, vertex_count);
+    EXPECT_EQ(data.vertex_flags.size(), data.vertex_count);
+    EXPECT_EQ(data.vertex_data, expected.vertex_data);
+    for (std::uint32_t i = 0; i < data.triangle_count; ++i) {
+      for (int j = 0; j < 3; ++j) {
+        EXPECT_EQ(data.triangle_data[i].indices[j], expected.triangle_data[i].indices[j]);
+      }
+    }
+  }
+}
+
+TEST(MeshWeld, WeldsJitteredCopies) {
+  const float tolerance = 0.001f;
+  for (const auto& create : get_primitives()) {
+    weld_mesh m;
+    ASSERT_TRUE(prepare_primitive(create, m));
+    make_triangle_soup(m.preparation_data_);
+
+    // nudge every copy by less than the tolerance, positions land in different cells
+    auto& data = m.preparation_data_;
+    const auto& layout = gfx::mesh_vertex::get_layout();
+    for (std::uint32_t i = 0; i < data.vertex_count; ++i) {
+      auto* p = reinterpret_cast<math::vec3*>(&data.vertex_data[i * layout.getStride()] +
+                                              layout.getOffset(gfx::attribute::Position));
+      *p += math::vec3(float(i % 3) - 1.0f, float(i % 5) - 2.0f, float(i % 7) - 3.0f) * (tolerance * 0.1f);
+    }
+
+    auto expected = data;
+    reference_weld(expected, tolerance);
+    ASSERT_TRUE(m.weld_vertices(tolerance));
+    EXPECT_EQ(data.vertex_count, expected.vertex_count);
+    EXPECT_LT(data.vertex_count, data.triangle_count * 3);
+  }
+}
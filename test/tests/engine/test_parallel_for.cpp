@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include <core/tasks/parallel_for.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+class ParallelForTest : public ::testing::Test {
+protected:
+  core::task_system ts_{false, 4};
+};
+}
+
+TEST_F(ParallelForTest, VisitsEveryIndexOnce) {
+  std::vector<std::atomic<int>> hits(1000);
+  core::parallel_for(ts_, 0, hits.size(), [&](std::size_t i) { hits[i]++; });
+
+  for (const auto& hit : hits) {
+    EXPECT_EQ(hit.load(), 1);
+  }
+}
+
+TEST_F(ParallelForTest, RangeChunksCoverTheRange) {
+  std::mutex mutex;
+  std::vector<std::pair<std::size_t, std::size_t>> chunks;
+  core::parallel_for_range(ts_, 10, 1010, [&](std::size_t b, std::size_t e) {
+    std::lock_guard<std::mutex> lock(mutex);
+    chunks.emplace_back(b, e);
+  }, 16);
+
+  std::sort(chunks.begin(), chunks.end());
+  ASSERT_FALSE(chunks.empty());
+  EXPECT_EQ(chunks.front().first, 10u);
+  EXPECT_EQ(chunks.back().second, 1010u);
+  for (std::size_t i = 0; i < chunks.size(); ++i) {
+    EXPECT_LT(chunks[i].first, chunks[i].second);
+    if (i + 1 < chunks.size()) {
+      EXPECT_EQ(chunks[i].second, chunks[i + 1].first);
+      // only the last chunk may be smaller than the grain
+      EXPECT_GE(chunks[i].second - chunks[i].first, 16u);
+    }
+  }
+}
+
+TEST_F(ParallelForTest, EmptyRangeDoesNothing) {
+  std::atomic<int> calls{0};
+  core::parallel_for(ts_, 0, 0, [&](std::size_t) { calls++; });
+  core::parallel_for(ts_, 5, 3, [&](std::size_t) { calls++; });
+  core::parallel_for_range(ts_, 7, 7, [&](std::size_t, std::size_t) { calls++; });
+
+  EXPECT_EQ(calls.load(), 0);
+}
+
+TEST_F(ParallelForTest, FewerItemsThanGrainRunAsOneChunk) {
+  std::atomic<int> calls{0};
+  std::atomic<std::size_t> items{0};
+  core::parallel_for_range(ts_, 0, 5, [&](std::size_t b, std::size_t e) {
+    calls++;
+    items += e - b;
+  }, 64);
+
+  EXPECT_EQ(calls.load(), 1);
+  EXPECT_EQ(items.load(), 5u);
+}
+
+TEST_F(ParallelForTest, RethrowsExceptions) {
+  EXPECT_THROW(core::parallel_for(ts_, 0, 100, [](std::size_t i) {
+    if (i == 42) {
+      throw std::runtime_error("failed");
+    }
+  }), std::runtime_error);
+}
+
+TEST_F(ParallelForTest, ForEachRandomAccess) {
+  std::vector<int> values(500);
+  std::iota(values.begin(), values.end(), 0);
+  std::atomic<long> sum{0};
+  core::parallel_for_each(ts_, values, [&](int v) { sum += v; }, 8);
+
+  EXPECT_EQ(sum.load(), 499L * 500L / 2L);
+}
+
+TEST_F(ParallelForTest, ForEachForwardIterators) {
+  std::list<int> values(500);
+  std::iota(values.begin(), values.end(), 0);
+  std::atomic<long> sum{0};
+  std::atomic<int> calls{0};
+  core::parallel_for_each(ts_, values.begin(), values.end(), [&](int v) {
+    sum += v;
+    calls++;
+  });
+
+  EXPECT_EQ(calls.load(), 500);
+  EXPECT_EQ(sum.load(), 499L * 500L / 2L);
+}
+
+TEST_F(ParallelForTest, ForEachEmptyRange) {
+  std::list<int> values;
+  std::atomic<int> calls{0};
+  core::parallel_for_each(ts_, values, [&](int) { calls++; });
+
+  EXPECT_EQ(calls.load(), 0);
+}
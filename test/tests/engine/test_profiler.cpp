@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include <core/profiling/profiler.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+class ProfilerTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    profiling::set_enabled(true);
+    // starts from an empty capture
+    profiling::set_frame_capacity(0);
+    profiling::end_frame();
+    profiling::set_frame_capacity(4);
+  }
+};
+
+std::size_t count_zones(const profiling::frame& f, const std::string& name) {
+  std::size_t count = 0;
+  for (const auto& z : f.zones) {
+    count += name == z.location->name ? 1 : 0;
+  }
+  return count;
+}
+}
+
+TEST_F(ProfilerTest, RecordsNestedZones) {
+  {
+    PROFILE_SCOPE("outer");
+    PROFILE_SCOPE("inner");
+  }
+  profiling::end_frame();
+
+  const auto frames = profiling::get_frames();
+  ASSERT_EQ(frames.size(), 1u);
+  const auto& zones = frames.back().zones;
+  ASSERT_EQ(zones.size(), 2u);
+  // zones are recorded as they end
+  EXPECT_STREQ(zones[0].location->name, "inner");
+  EXPECT_STREQ(zones[1].location->name, "outer");
+  EXPECT_LE(zones[1].start, zones[0].start);
+  EXPECT_GE(zones[1].end, zones[0].end);
+  EXPECT_EQ(zones[0].thread, zones[1].thread);
+  EXPECT_LE(frames.back().start, zones[1].start);
+  EXPECT_GE(frames.back().end, zones[1].end);
+}
+
+TEST_F(ProfilerTest, CollectsEveryThread) {
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([]() {
+      for (int i = 0; i < 100; ++i) {
+        PROFILE_SCOPE("work");
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  profiling::end_frame();
+
+  const auto frames = profiling::get_frames();
+  ASSERT_EQ(frames.size(), 1u);
+  EXPECT_EQ(count_zones(frames.back(), "work"), 400u);
+  EXPECT_EQ(frames.back().dropped, 0u);
+}
+
+TEST_F(ProfilerTest, KeepsTheLastFrames) {
+  for (int i = 0; i < 10; ++i) {
+    {
+      profiling::scoped_zone zone(std::string("frame work"), i);
+    }
+    profiling::end_frame();
+  }
+  const auto frames = profiling::get_frames();
+  ASSERT_EQ(frames.size(), 4u);
+  for (std::size_t i = 0; i < frames.size(); ++i) {
+    ASSERT_EQ(frames[i].zones.size(), 1u);
+    EXPECT_EQ(frames[i].zones[0].index, std::int32_t(6 + i));
+  }
+}
+
+TEST_F(ProfilerTest, RecordsNothingWhileDisabled) {
+  profiling::set_enabled(false);
+  {
+    PROFILE_SCOPE("ignored");
+  }
+  profiling::end_frame();
+  profiling::set_enabled(true);
+  EXPECT_TRUE(profiling::get_frames().empty());
+}
+
+TEST_F(ProfilerTest, WritesChromeTraces) {
+  const auto& location = profiling::get_location("pass \"gbuffer\"");
+  EXPECT_EQ(&location, &profiling::get_location("pass \"gbuffer\""));
+  {
+    profiling::scoped_zone zone(location, 3);
+  }
+  profiling::end_frame();
+
+  std::ostringstream stream;
+  profiling::write_chrome_trace(stream);
+  const auto trace = stream.str();
+  EXPECT_NE(trace.find("\"traceEvents\""), std::string::npos);
+  EXPECT_NE(trace.find(R"("name":"pass \"gbuffer\"")"), std::string::npos);
+  EXPECT_NE(trace.find(R"("index":3)"), std::string::npos);
+  EXPECT_NE(trace.find(R"("ph":"X")"), std::string::npos);
+  EXPECT_EQ(trace.find(R"("ph":"B")"), std::string::npos);
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <runtime/rendering/render_queue.h>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// sorting and batching are checked on the keys alone, submitting needs a renderer
+TEST(RenderQueue, KeyFieldsOrderByStateBeforeDepth) {
+  const auto near_key = render_queue::pack_key(1, 2, 3, 4, 0.1f);
+  const auto far_key = render_queue::pack_key(1, 2, 3, 4, 0.9f);
+  EXPECT_LT(near_key, far_key);
+
+  // every field outweighs all the ones after it
+  EXPECT_LT(render_queue::pack_key(0, 9, 9, 9, 1.0f), render_queue::pack_key(1, 0, 0, 0, 0.0f));
+  EXPECT_LT(render_queue::pack_key(1, 0, 9, 9, 1.0f), render_queue::pack_key(1, 1, 0, 0, 0.0f));
+  EXPECT_LT(render_queue::pack_key(1, 1, 0, 9, 1.0f), render_queue::pack_key(1, 1, 1, 0, 0.0f));
+  EXPECT_LT(render_queue::pack_key(1, 1, 1, 0, 1.0f), render_queue::pack_key(1, 1, 1, 1, 0.0f));
+
+  // depth is clamped, wide ids wrap into their field
+  EXPECT_EQ(render_queue::pack_key(0, 0, 0, 0, 2.0f), render_queue::pack_key(0, 0, 0, 0, 1.0f));
+  EXPECT_EQ(render_queue::pack_key(0, 0, 0, 0, -1.0f), 0u);
+  EXPECT_EQ(render_queue::pack_key(0x1001, 0, 0, 0, 0.0f), render_queue::pack_key(1, 0, 0, 0, 0.0f));
+}
+
+TEST(RenderQueue, SortsOutOfOrderKeys) {
+  const std::vector<std::uint64_t> keys = {
+    render_queue::pack_key(2, 0, 0, 0, 0.5f),
+    render_queue::pack_key(1, 1, 0, 0, 0.2f),
+    render_queue::pack_key(1, 0, 7, 0, 0.9f),
+    render_queue::pack_key(1, 0, 7, 0, 0.1f),
+    render_queue::pack_key(1, 1, 0, 0, 0.2f),
+    render_queue::pack_key(0, 3, 0, 1, 0.0f),
+  };
+
+  std::vector<std::uint32_t> order;
+  std::vector<std::uint32_t> scratch;
+  render_queue::sort_keys(keys, order, scratch);
+
+  // equal keys keep the order they were pushed in
+  EXPECT_EQ(order, (std::vector<std::uint32_t>{5, 3, 2, 1, 4, 0}));
+  for (std::size_t i = 1; i < order.size(); ++i) {
+    EXPECT_LE(keys[order[i - 1]], keys[order[i]]);
+  }
+}
+
+TEST(RenderQueue, SortsEmptyAndUniformKeys) {
+  std::vector<std::uint32_t> order = {3, 1};
+  std::vector<std::uint32_t> scratch;
+  render_queue::sort_keys({}, order, scratch);
+  EXPECT_TRUE(order.empty());
+
+  const std::vector<std::uint64_t> keys(4, render_queue::pack_key(1, 1, 1, 1, 0.5f));
+  render_queue::sort_keys(keys, order, scratch);
+  EXPECT_EQ(order, (std::vector<std::uint32_t>{0, 1, 2, 3}));
+}
+
+TEST(RenderQueue, SplitsSortedItemsIntoRuns) {
+  // the same mesh subset and material, only the depth differs
+  const std::vector<std::uint64_t> keys = {
+    render_queue::pack_key(1, 2, 5, 0, 0.7f),
+    render_queue::pack_key(1, 1, 5, 0, 0.3f),
+    render_queue::pack_key(1, 2, 5, 0, 0.1f),
+    render_queue::pack_key(1, 1, 5, 0, 0.6f),
+    render_queue::pack_key(1, 2, 5, 1, 0.2f),
+    render_queue::pack_key(1, 2, 5, 0, 0.4f),
+  };
+
+  std::vector<std::uint32_t> order;
+  std::vector<std::uint32_t> scratch;
+  render_queue::sort_keys(keys, order, scratch);
+
+  std::vector<std::pair<std::size_t, std::size_t>> runs;
+  const auto same_draw = [&keys](std::uint32_t a, std::uint32_t b) { return keys[a] >> 16 == keys[b] >> 16; };
+  render_queue::for_each_run(order, same_draw,
+                             [&runs](std::size_t begin, std::size_t end) { runs.emplace_back(begin, end); });
+
+  const std::vector<std::pair<std::size_t, std::size_t>> expected = {{0, 2}, {2, 5}, {5, 6}};
+  EXPECT_EQ(runs, expected);
+  EXPECT_EQ(order, (std::vector<std::uint32_t>{1, 3, 2, 5, 0, 4}));
+}
+
+TEST(RenderQueue, NoRunsWithoutItems) {
+  std::size_t calls = 0;
+  render_queue::for_each_run({}, [](std::uint32_t, std::uint32_t) { return true; },
+                             [&calls](std::size_t, std::size_t) { calls++; });
+  EXPECT_EQ(calls, 0u);
+}
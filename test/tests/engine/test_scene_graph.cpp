@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <core/system/subsystem.h>
+#include <runtime/ecs/components/relation.h>
+#include <runtime/ecs/systems/scene_graph.h>
+
+#include <vector>
+
+namespace {
+class SceneGraphTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    core::details::initialize();
+    core::add_subsystem<SpatialSystem>();
+    core::add_subsystem<runtime::scene_graph>();
+  }
+
+  void TearDown() override {
+    core::get_subsystem<SpatialSystem>().reset();
+    core::details::dispose();
+  }
+
+  EntityType create(EntityType parent) {
+    auto& ecs = core::get_subsystem<SpatialSystem>();
+    auto e = ecs.create();
+    ecs.assign<Relation>(e);
+    core::get_subsystem<runtime::scene_graph>().set_parent(e, parent);
+    return e;
+  }
+
+  std::vector<EntityType> children_of(EntityType e) {
+    std::vector<EntityType> children;
+    core::get_subsystem<runtime::scene_graph>().for_each_child(
+      e, [&children](EntityType child) { children.push_back(child); });
+    return children;
+  }
+};
+}
+
+TEST_F(SceneGraphTest, LinksChildrenAndRoots) {
+  auto& ecs = core::get_subsystem<SpatialSystem>();
+  auto& sg = core::get_subsystem<runtime::scene_graph>();
+
+  auto a = create(entt::null);
+  auto b = create(entt::null);
+  auto a1 = create(a);
+  auto a2 = create(a);
+  auto a3 = create(a);
+
+  EXPECT_EQ(sg.get_root_count(), 2);
+  EXPECT_EQ(sg.get_roots(), (std::vector<EntityType>{a, b}));
+  EXPECT_EQ(children_of(a), (std::vector<EntityType>{a1, a2, a3}));
+  EXPECT_EQ(sg.get_parent(a2), a);
+  EXPECT_FALSE(sg.has_children(b));
+
+  // reparenting keeps Relation in sync
+  const auto version = sg.get_version();
+  EXPECT_TRUE(sg.set_parent(a2, b));
+  EXPECT_NE(sg.get_version(), version);
+  EXPECT_EQ(ecs.get<Relation>(a2).parent, b);
+  EXPECT_EQ(children_of(a), (std::vector<EntityType>{a1, a3}));
+  EXPECT_EQ(children_of(b), (std::vector<EntityType>{a2}));
+
+  // loops are refused
+  EXPECT_FALSE(sg.set_parent(b, a2));
+  EXPECT_FALSE(sg.set_parent(b, b));
+  EXPECT_EQ(sg.get_parent(b), entt::null);
+
+  EXPECT_TRUE(sg.set_parent(a1, entt::null));
+  EXPECT_EQ(sg.get_roots(), (std::vector<EntityType>{a, b, a1}));
+}
+
+TEST_F(SceneGraphTest, FollowsConstructionAndDestruction) {
+  auto& ecs = core::get_subsystem<SpatialSystem>();
+  auto& sg = core::get_subsystem<runtime::scene_graph>();
+
+  auto root = create(entt::null);
+  auto child = create(root);
+  auto grandchild = create(child);
+
+  // removing the Relation unlinks the entity
+  auto removed = create(root);
+  ecs.remove<Relation>(removed);
+  EXPECT_EQ(children_of(root), (std::vector<EntityType>{child}));
+  EXPECT_EQ(sg.get_root_count(), 1);
+
+  // destroying a parent moves its children to the roots
+  ecs.destroy(child);
+  EXPECT_EQ(sg.get_roots(), (std::vector<EntityType>{root, grandchild}));
+  EXPECT_EQ(ecs.get<Relation>(grandchild).parent, entt::null);
+  EXPECT_FALSE(sg.has_children(root));
+
+  // the index of the destroyed entity is reused
+  auto reused = create(grandchild);
+  EXPECT_EQ(children_of(grandchild), (std::vector<EntityType>{reused}));
+  EXPECT_EQ(sg.get_parent(child), entt::null);
+
+  std::vector<EntityType> descendants;
+  sg.for_each_descendant(grandchild, [&descendants](EntityType e) { descendants.push_back(e); });
+  EXPECT_EQ(descendants, (std::vector<EntityType>{reused}));
+}
+
+TEST_F(SceneGraphTest, ParentWithoutRelation) {
+  auto& ecs = core::get_subsystem<SpatialSystem>();
+  auto& sg = core::get_subsystem<runtime::scene_graph>();
+
+  auto holder = ecs.create();
+  auto child = create(holder);
+  EXPECT_EQ(sg.get_parent(child), holder);
+  EXPECT_EQ(sg.get_root_count(), 0);
+
+  // nothing is signaled here, the next owner of the index cleans up
+  ecs.destroy(holder);
+  auto next = create(entt::null);
+  EXPECT_EQ(sg.get_parent(child), entt::null);
+  EXPECT_EQ(ecs.get<Relation>(child).parent, entt::null);
+  EXPECT_EQ(sg.get_root_count(), 2);
+  EXPECT_FALSE(sg.has_children(next));
+}
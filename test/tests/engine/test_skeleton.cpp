@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include <runtime/rendering/mesh/skeleton.h>
+
+#include <random>
+#include <vector>
+
+namespace {
+struct node {
+  std::string name;
+  math::transform local;
+  std::vector<node> children;
+};
+
+// reference: walk the tree and compose the transforms on the way down
+void resolve(const node& n, const math::transform& parent, std::vector<math::transform>& out) {
+  out.emplace_back(parent * n.local);
+  for (const auto& child : n.children) {
+    resolve(child, out.back(), out);
+  }
+}
+
+void flatten(const node& n, std::int32_t parent, skeleton& skel) {
+  const auto index = skel.add_node(n.name, parent, n.local);
+  for (const auto& child : n.children) {
+    flatten(child, index, skel);
+  }
+}
+
+node make_tree(std::mt19937& rng, int depth, int& counter) {
+  std::uniform_real_distribution<float> value(-2.0f, 2.0f);
+  node n;
+  n.name = "node" + std::to_string(counter++);
+  n.local.set_position({value(rng), value(rng), value(rng)});
+  n.local.rotate(value(rng), value(rng), value(rng));
+  if (depth > 0) {
+    const int children = 1 + int(rng() % 3);
+    for (int i = 0; i < children; ++i) {
+      n.children.emplace_back(make_tree(rng, depth - 1, counter));
+    }
+  }
+  return n;
+}
+}  // namespace
+
+TEST(Skeleton, SinglePassMatchesRecursive) {
+  std::mt19937 rng(7);
+  int counter = 0;
+  const auto root = make_tree(rng, 4, counter);
+
+  skeleton skel;
+  flatten(root, skeleton::invalid_index, skel);
+  ASSERT_EQ(skel.get_node_count(), std::size_t(counter));
+  for (std::size_t i = 0; i < skel.get_node_count(); ++i) {
+    EXPECT_LT(skel.get_parents()[i], std::int32_t(i));
+  }
+
+  std::vector<math::transform> expected;
+  resolve(root, math::transform(), expected);
+
+  skeleton_pose pose;
+  pose.reset(skel);
+  EXPECT_TRUE(pose.is_bound_to(skel));
+  pose.compute_model_space(skel);
+
+  const auto& model = pose.get_model_transforms();
+  ASSERT_EQ(model.size(), expected.size());
+  for (std::size_t i = 0; i < model.size(); ++i) {
+    EXPECT_TRUE(math::transform(model[i]).is_equal(expected[i], 0.0001f)) << skel.get_names()[i];
+  }
+}
+
+TEST(Skeleton, BonesFollowTheirNodes) {
+  skeleton skel;
+  math::transform offset;
+  offset.set_position({0.0f, 1.0f, 0.0f});
+  const auto root = skel.add_node("root", skeleton::invalid_index, math::transform());
+  const auto arm = skel.add_node("arm", root, offset);
+  skel.add_node("hand", arm, offset);
+
+  skin_bind_data bind_data;
+  auto& bones = bind_data.get_bones();
+  bones.resize(3);
+  bones[0].bone_id = "hand";
+  bones[1].bone_id = "missing";
+  bones[2].bone_id = "root";
+  skel.bind(bind_data);
+
+  ASSERT_EQ(skel.get_bone_nodes().size(), 3u);
+  EXPECT_EQ(skel.get_bone_nodes()[0], 2);
+  EXPECT_EQ(skel.get_bone_nodes()[1], skeleton::invalid_index);
+  EXPECT_EQ(skel.get_bone_nodes()[2], 0);
+
+  math::transform world;
+  world.set_position({10.0f, 0.0f, 0.0f});
+
+  skeleton_pose pose;
+  pose.reset(skel);
+  pose.compute_model_space(skel);
+  pose.compute_bone_transforms(skel, world);
+
+  const auto& result = pose.get_bone_transforms();
+  ASSERT_EQ(result.size(), 3u);
+  EXPECT_TRUE(result[0].is_equal(world * offset * offset, 0.0001f));
+  EXPECT_TRUE(result[1].is_equal(world, 0.0001f));
+  EXPECT_TRUE(result[2].is_equal(world, 0.0001f));
+
+  // poses written by an animation are picked up on the next resolve
+  pose.get_local_transforms()[1] = math::transform();
+  pose.compute_model_space(skel);
+  pose.compute_bone_transforms(skel, world);
+  EXPECT_TRUE(result[0].is_equal(world * offset, 0.0001f));
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include <core/audio/device.h>
+#include <core/audio/exception.h>
+#include <core/audio/loaders/loader.h>
+#include <core/audio/sound.h>
+#include <core/audio/source.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+
+namespace {
+// plays into OpenAL's null backend, nothing reaches the speakers
+std::unique_ptr<audio::device> open_null_device() {
+#ifdef _WIN32
+  _putenv_s("ALSOFT_DRIVERS", "null");
+#else
+  setenv("ALSOFT_DRIVERS", "null", 1);
+#endif
+  try {
+    return std::make_unique<audio::device>(-1);
+  } catch (const audio::exception&) {
+    return nullptr;
+  }
+}
+
+// a mono saw wave, long enough to need many chunks
+audio::sound_data make_pcm(std::uint32_t seconds) {
+  audio::sound_data data;
+  data.info.channels = 1;
+  data.info.bytes_per_sample = 2;
+  data.info.sample_rate = 8000;
+  data.info.duration = audio::sound_info::duration_t(seconds);
+  data.data.resize(std::size_t(seconds) * data.info.sample_rate * data.info.bytes_per_sample);
+  auto samples = reinterpret_cast<std::int16_t*>(data.data.data());
+  for (std::size_t i = 0; i < data.data.size() / 2; ++i) {
+    samples[i] = std::int16_t((i % 256) * 128);
+  }
+  return data;
+}
+}
+
+TEST(SoundStream, RejectsInvalidOgg) {
+  const std::uint8_t garbage[] = {'n', 'o', 't', ' ', 'o', 'g', 'g'};
+  audio::sound_data data;
+  std::string err;
+  EXPECT_FALSE(audio::load_ogg_stream_from_memory(garbage, sizeof(garbage), data, err));
+  EXPECT_FALSE(err.empty());
+  EXPECT_TRUE(data.data.empty());
+}
+
+TEST(SoundStream, StreamsThroughABufferRing) {
+  auto device = open_null_device();
+  if (!device || !device->is_valid()) {
+    GTEST_SKIP() << "No OpenAL null device";
+  }
+
+  audio::sound snd(make_pcm(30), true);
+  ASSERT_TRUE(snd.is_valid());
+  EXPECT_TRUE(snd.is_streamed());
+
+  audio::source src;
+  src.set_loop(true);
+  src.bind(snd);
+  EXPECT_TRUE(src.is_streaming());
+  EXPECT_TRUE(src.is_looping());
+  EXPECT_NEAR(src.get_playing_duration().count(), 30.0, 0.001);
+
+  // seeking restarts decoding at the offset instead of decoding up to it
+  src.set_playing_offset(audio::sound_info::duration_t(20.0));
+  EXPECT_NEAR(src.get_playing_offset().count(), 20.0, 0.01);
+
+  src.play();
+  for (int i = 0; i < 10; ++i) {
+    src.update_stream();
+  }
+  EXPECT_TRUE(src.is_playing());
+  EXPECT_GE(src.get_playing_offset().count(), 20.0 - 0.01);
+
+  src.stop();
+  EXPECT_TRUE(src.is_stopped());
+}
+
+TEST(SoundStream, ShortSoundsAreNotStreamed) {
+  auto device = open_null_device();
+  if (!device || !device->is_valid()) {
+    GTEST_SKIP() << "No OpenAL null device";
+  }
+
+  audio::sound snd(make_pcm(1));
+  ASSERT_TRUE(snd.is_valid());
+  EXPECT_FALSE(snd.is_streamed());
+
+  audio::source src;
+  src.bind(snd);
+  EXPECT_FALSE(src.is_streaming());
+  src.set_playing_offset(audio::sound_info::duration_t(0.5));
+  EXPECT_NEAR(src.get_playing_offset().count(), 0.5, 0.01);
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <core/system/subsystem.h>
+#include <core/tasks/task_system.h>
+#include <runtime/system/system_scheduler.h>
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+struct position {};
+struct velocity {};
+struct listener {};
+
+class SystemSchedulerTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    core::details::initialize();
+    core::add_subsystem<core::task_system>(false, 4);
+  }
+
+  void TearDown() override {
+    core::details::dispose();
+  }
+
+  runtime::system_scheduler::update_t record(const std::string& name) {
+    return [this, name](delta_t) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      order_.push_back(name);
+    };
+  }
+
+  std::size_t position_of(const std::string& name) const {
+    return static_cast<std::size_t>(
+      std::distance(order_.begin(), std::find(order_.begin(), order_.end(), name)));
+  }
+
+  std::mutex mutex_;
+  std::vector<std::string> order_;
+};
+}
+
+TEST_F(SystemSchedulerTest, ConflictsKeepRegistrationOrder) {
+  runtime::system_scheduler scheduler;
+  scheduler.add_system("physics", record("physics")).writes<position>().reads<velocity>();
+  scheduler.add_system("camera", record("camera")).reads<position>().on_owner_thread();
+  scheduler.add_system("audio", record("audio")).reads<position>().writes<listener>();
+  scheduler.add_system("input", record("input")).writes<velocity>();
+
+  for (int frame = 0; frame < 10; ++frame) {
+    order_.clear();
+    scheduler.run(delta_t(0.016f));
+
+    ASSERT_EQ(order_.size(), 4);
+    EXPECT_LT(position_of("physics"), position_of("camera"));
+    EXPECT_LT(position_of("physics"), position_of("audio"));
+    EXPECT_LT(position_of("physics"), position_of("input"));
+  }
+}
+
+TEST_F(SystemSchedulerTest, ExplicitOrderAndExclusive) {
+  runtime::system_scheduler scheduler;
+  scheduler.add_system("transform", record("transform")).writes<position>();
+  scheduler.add_system("spawner", record("spawner")).exclusive();
+  scheduler.add_system("early", record("early")).before("transform");
+  scheduler.add_system("late", record("late")).after("spawner");
+
+  scheduler.run(delta_t(0.016f));
+
+  ASSERT_EQ(order_.size(), 4);
+  EXPECT_LT(position_of("early"), position_of("transform"));
+  EXPECT_LT(position_of("transform"), position_of("spawner"));
+  EXPECT_LT(position_of("spawner"), position_of("late"));
+
+  const auto dump = scheduler.get_schedule_dump();
+  EXPECT_NE(dump.find("transform"), std::string::npos);
+  EXPECT_EQ(scheduler.get_timings().size(), 4);
+
+  scheduler.remove_system("spawner");
+  order_.clear();
+  scheduler.run(delta_t(0.016f));
+  EXPECT_EQ(order_.size(), 3);
+}
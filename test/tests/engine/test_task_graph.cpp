@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include <core/tasks/task_graph.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+class TaskGraphTest : public ::testing::Test {
+protected:
+  core::task_graph::job_t record(const std::string& name) {
+    return [this, name]() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      order_.push_back(name);
+    };
+  }
+
+  std::size_t position_of(const std::string& name) const {
+    return static_cast<std::size_t>(
+      std::distance(order_.begin(), std::find(order_.begin(), order_.end(), name)));
+  }
+
+  core::task_system ts_{false, 4};
+  std::mutex mutex_;
+  std::vector<std::string> order_;
+};
+}
+
+TEST_F(TaskGraphTest, RunsJobsAfterTheirPredecessors) {
+  core::task_graph graph;
+  const auto a = graph.add_node("a", record("a"));
+  const auto b = graph.add_node("b", record("b"));
+  const auto c = graph.add_node("c", record("c"));
+  const auto d = graph.add_node("d", record("d"));
+  graph.precede(a, b);
+  graph.precede(a, c);
+  graph.precede(b, d);
+  graph.precede(c, d);
+
+  for (int run = 0; run < 20; ++run) {
+    order_.clear();
+    graph.run(ts_);
+
+    ASSERT_EQ(order_.size(), 4u);
+    EXPECT_LT(position_of("a"), position_of("b"));
+    EXPECT_LT(position_of("a"), position_of("c"));
+    EXPECT_LT(position_of("b"), position_of("d"));
+    EXPECT_LT(position_of("c"), position_of("d"));
+  }
+}
+
+TEST_F(TaskGraphTest, RunsOwnerJobsOnTheCallingThread) {
+  core::task_graph graph;
+  std::thread::id owner_id;
+  const auto a = graph.add_node("a", record("a"));
+  const auto b = graph.add_node("b", [&]() { owner_id = std::this_thread::get_id(); },
+                                core::task_graph::thread_affinity::owner);
+  graph.precede(a, b);
+  graph.run(ts_);
+
+  EXPECT_EQ(owner_id, std::this_thread::get_id());
+}
+
+TEST_F(TaskGraphTest, TopologicalOrderRespectsEdges) {
+  core::task_graph graph;
+  const auto a = graph.add_node("a", record("a"));
+  const auto b = graph.add_node("b", record("b"));
+  const auto c = graph.add_node("c", record("c"));
+  graph.precede(c, b);
+  graph.precede(b, a);
+
+  const auto order = graph.get_topological_order();
+  ASSERT_EQ(order.size(), 3u);
+  EXPECT_EQ(order[0], c);
+  EXPECT_EQ(order[1], b);
+  EXPECT_EQ(order[2], a);
+}
+
+TEST_F(TaskGraphTest, RethrowsAndSkipsDependents) {
+  core::task_graph graph;
+  const auto a = graph.add_node("a", []() { throw std::runtime_error("failed"); });
+  const auto b = graph.add_node("b", record("b"));
+  graph.precede(a, b);
+
+  EXPECT_THROW(graph.run(ts_), std::runtime_error);
+  EXPECT_TRUE(order_.empty());
+}
+
+TEST_F(TaskGraphTest, EmptyGraphReturns) {
+  core::task_graph graph;
+  graph.run(ts_);
+
+  EXPECT_EQ(graph.size(), 0u);
+}
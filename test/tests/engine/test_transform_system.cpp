@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <core/system/subsystem.h>
+#include <core/tasks/task_system.h>
+#include <runtime/ecs/components/relation.h>
+#include <runtime/ecs/components/transform_component.h>
+#include <runtime/ecs/systems/scene_graph.h>
+#include <runtime/ecs/systems/transform_system.h>
+#include <runtime/system/system_scheduler.h>
+
+namespace {
+class TransformSystemTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    core::details::initialize();
+    core::add_subsystem<SpatialSystem>();
+    core::add_subsystem<runtime::system_scheduler>();
+    core::add_subsystem<runtime::scene_graph>();
+    core::add_subsystem<core::task_system>(false, 4);
+    core::add_subsystem<runtime::transform_system>();
+  }
+
+  void TearDown() override {
+    core::get_subsystem<SpatialSystem>().reset();
+    core::details::dispose();
+  }
+
+  EntityType create(EntityType parent, const math::vec3& position) {
+    auto& ecs = core::get_subsystem<SpatialSystem>();
+    auto e = ecs.create();
+    ecs.assign<transform_component>(e).set_local_position(position);
+    ecs.assign<Relation>(e);
+    core::get_subsystem<runtime::scene_graph>().set_parent(e, parent);
+    return e;
+  }
+
+  void update() {
+    core::get_subsystem<runtime::system_scheduler>().run(delta_t(0.016f));
+  }
+
+  void expect_position(EntityType e, const math::vec3& expected) {
+    const auto& position = core::get_subsystem<SpatialSystem>().get<transform_component>(e).get_position();
+    EXPECT_FLOAT_EQ(position.x, expected.x);
+    EXPECT_FLOAT_EQ(position.y, expected.y);
+    EXPECT_FLOAT_EQ(position.z, expected.z);
+  }
+};
+}
+
+TEST_F(TransformSystemTest, PropagatesDirtySubtrees) {
+  auto& ecs = core::get_subsystem<SpatialSystem>();
+  auto& system = core::get_subsystem<runtime::transform_system>();
+
+  auto root = create(entt::null, {1.0f, 0.0f, 0.0f});
+  auto child = create(root, {0.0f, 2.0f, 0.0f});
+  auto grandchild = create(child, {0.0f, 0.0f, 3.0f});
+  auto other = create(entt::null, {7.0f, 0.0f, 0.0f});
+
+  update();
+  EXPECT_EQ(system.get_depth_count(), 3);
+  expect_position(grandchild, {1.0f, 2.0f, 3.0f});
+  expect_position(other, {7.0f, 0.0f, 0.0f});
+
+  ecs.get<transform_component>(root).set_local_position({5.0f, 0.0f, 0.0f});
+  update();
+  expect_position(child, {5.0f, 2.0f, 0.0f});
+  expect_position(grandchild, {5.0f, 2.0f, 3.0f});
+  expect_position(other, {7.0f, 0.0f, 0.0f});
+
+  // world space edits of a child are brought to its parent's space
+  ecs.get<transform_component>(grandchild).set_position({0.0f, 0.0f, 0.0f});
+  update();
+  expect_position(grandchild, {0.0f, 0.0f, 0.0f});
+  const auto& local = ecs.get<transform_component>(grandchild).get_local_position();
+  EXPECT_FLOAT_EQ(local.x, -5.0f);
+  EXPECT_FLOAT_EQ(local.y, -2.0f);
+}
+
+TEST_F(TransformSystemTest, Reparenting) {
+  auto& ecs = core::get_subsystem<SpatialSystem>();
+  auto& sg = core::get_subsystem<runtime::scene_graph>();
+  auto& system = core::get_subsystem<runtime::transform_system>();
+
+  auto a = create(entt::null, {1.0f, 0.0f, 0.0f});
+  auto b = create(entt::null, {0.0f, 1.0f, 0.0f});
+  auto c = create(a, {0.0f, 0.0f, 1.0f});
+
+  update();
+  expect_position(c, {1.0f, 0.0f, 1.0f});
+
+  sg.set_parent(c, b);
+  update();
+  expect_position(c, {0.0f, 1.0f, 1.0f});
+
+  // a cycle is refused instead of hanging the update
+  EXPECT_TRUE(sg.set_parent(a, c));
+  EXPECT_FALSE(sg.set_parent(b, a));
+  update();
+  expect_position(a, {1.0f, 1.0f, 1.0f});
+  EXPECT_EQ(system.get_depth_count(), 3);
+
+  ecs.destroy(b);
+  update();
+  EXPECT_EQ(system.get_depth_count(), 2);
+}
@@ -0,0 +1,14 @@
+#include <gtest/gtest.h>
+#include <core/graphics/uniform_id.h>
+
+TEST(UniformId, InternsNamesOnce) {
+  const gfx::uniform_id a("u_test_interned_a");
+  const gfx::uniform_id b("u_test_interned_b");
+  const gfx::uniform_id a2(std::string("u_test_interned_a"));
+
+  EXPECT_EQ(a, a2);
+  EXPECT_NE(a, b);
+  EXPECT_EQ(a.get_name(), "u_test_interned_a");
+  EXPECT_EQ(gfx::uniform_id::get_name(b.get_index()), "u_test_interned_b");
+  EXPECT_EQ(gfx::uniform_id::intern("u_test_interned_b"), b.get_index());
+}
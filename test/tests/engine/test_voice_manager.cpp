@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <runtime/audio/voice_manager.h>
+
+#include <vector>
+
+namespace {
+using voice = runtime::voice_manager::voice;
+
+voice make_voice(float x, std::int32_t priority = 0) {
+  voice v;
+  v.position = {x, 0.0f, 0.0f};
+  v.priority = priority;
+  v.playing = true;
+  return v;
+}
+
+const math::vec3 listener{0.0f, 0.0f, 0.0f};
+}
+
+TEST(VoiceManager, AudibilityFollowsTheLinearDistanceModel) {
+  auto v = make_voice(0.5f);
+  v.volume = 0.5f;
+  EXPECT_FLOAT_EQ(runtime::voice_manager::get_audibility(v, listener), 0.5f);
+
+  v.position = {10.5f, 0.0f, 0.0f};
+  EXPECT_FLOAT_EQ(runtime::voice_manager::get_audibility(v, listener), 0.25f);
+
+  v.position = {0.0f, 0.0f, 100.0f};
+  EXPECT_FLOAT_EQ(runtime::voice_manager::get_audibility(v, listener), 0.0f);
+
+  // non positional sounds are heard the same everywhere
+  v.positional = false;
+  EXPECT_FLOAT_EQ(runtime::voice_manager::get_audibility(v, listener), 0.5f);
+}
+
+TEST(VoiceManager, OnlyTheLoudestVoicesAreReal) {
+  runtime::voice_manager manager;
+  manager.set_max_voices(2);
+
+  std::vector<voice> voices = {make_voice(15.0f), make_voice(2.0f), make_voice(100.0f), make_voice(5.0f),
+                               make_voice(1.0f)};
+  voices[4].playing = false;
+  manager.update(listener, voices);
+
+  EXPECT_FALSE(voices[0].real);
+  EXPECT_TRUE(voices[1].real);
+  EXPECT_FALSE(voices[2].real);
+  EXPECT_TRUE(voices[3].real);
+  EXPECT_FALSE(voices[4].real);
+
+  const auto& stats = manager.get_stats();
+  EXPECT_EQ(stats.voices, 5u);
+  EXPECT_EQ(stats.playing, 4u);
+  EXPECT_EQ(stats.real, 2u);
+  EXPECT_EQ(stats.virtual_voices, 2u);
+  EXPECT_EQ(stats.steals, 0u);
+}
+
+TEST(VoiceManager, PriorityWinsOverLoudness) {
+  runtime::voice_manager manager;
+  manager.set_max_voices(1);
+
+  std::vector<voice> voices = {make_voice(1.0f), make_voice(15.0f, 1)};
+  manager.update(listener, voices);
+  EXPECT_FALSE(voices[0].real);
+  EXPECT_TRUE(voices[1].real);
+}
+
+TEST(VoiceManager, CountsStolenVoices) {
+  runtime::voice_manager manager;
+  manager.set_max_voices(1);
+
+  std::vector<voice> voices = {make_voice(5.0f), make_voice(15.0f)};
+  manager.update(listener, voices);
+  ASSERT_TRUE(voices[0].real);
+
+  // a louder voice takes the source of a slightly quieter one
+  voices[1].position = {1.0f, 0.0f, 0.0f};
+  manager.update(listener, voices);
+  EXPECT_FALSE(voices[0].real);
+  EXPECT_TRUE(voices[1].real);
+  EXPECT_EQ(manager.get_stats().steals, 1u);
+  EXPECT_EQ(manager.get_stats().total_steals, 1u);
+
+  // a stopped voice gives its source up without being stolen from
+  voices[1].playing = false;
+  manager.update(listener, voices);
+  EXPECT_TRUE(voices[0].real);
+  EXPECT_EQ(manager.get_stats().steals, 0u);
+}
+
+TEST(VoiceManager, RealVoicesKeepTheirSourceAgainstSimilarOnes) {
+  runtime::voice_manager manager;
+  manager.set_max_voices(1);
+
+  std::vector<voice> voices = {make_voice(5.0f), make_voice(5.5f)};
+  manager.update(listener, voices);
+  ASSERT_TRUE(voices[0].real);
+
+  // barely louder is not enough to take over
+  voices[1].position = {4.9f, 0.0f, 0.0f};
+  manager.update(listener, voices);
+  EXPECT_TRUE(voices[0].real);
+  EXPECT_FALSE(voices[1].real);
+  EXPECT_EQ(manager.get_stats().steals, 0u);
+}
@@ -28,6 +28,8 @@ struct notused {
 using ecs::output_archive;
 using ecs::input_archive;
 using ecs::continuous_archive;
+using ecs::binary_output_archive;
+using ecs::binary_continuous_archive;
 
 template<typename Archive>
 void serialize(Archive &archive, position &position) {
@@ -157,3 +159,63 @@ TEST(Serialize, Continuous) {
         ASSERT_EQ(rel.global_id, globalEnt);
     }
 }
+
+TEST(Serialize, Binary) {
+
+    std::stringstream storage;
+
+    entt::registry source;
+    entt::registry destination;
+
+    auto e0 = source.create();
+    source.assign<position>(e0, position{1.0f, 2.0f});
+    auto e1 = source.create();
+    source.assign<position>(e1);
+
+    auto e3 = source.create();
+    source.assign<timer>(e3, timer{42});
+    auto e4 = source.create();
+    source.assign<relationship>(e4, relationship{e3, e3});
+
+    {
+        // blocks are only written out by finish
+        binary_output_archive output(storage, source);
+        output.set<position>("position");
+        output.set<relationship>("relationship");
+        output.set<timer>("timer");
+        output.set<notused>("notused");
+        ASSERT_TRUE(output.finish());
+    }
+
+    std::uint32_t magic{0};
+    storage.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    ASSERT_EQ(magic, ecs::binary_snapshot_magic);
+    storage.seekg(0);
+
+    {
+        // any order works and unread blocks are skipped
+        binary_continuous_archive input(storage, destination);
+        EXPECT_EQ(input.get_version(), ecs::binary_snapshot_version);
+        input.get<timer>("timer");
+        input.get<relationship>("relationship", &relationship::parent);
+        input.get<notused>("notused");
+    }
+    storage.seekg(0);
+    {
+        binary_continuous_archive input(storage, destination);
+        input.get<position>("position");
+    }
+
+    ASSERT_EQ(destination.view<timer>().size(), 1);
+    ASSERT_EQ(destination.view<position>().size(), 2);
+    ASSERT_EQ(destination.view<relationship>().size(), 1);
+
+    auto timers = destination.view<timer>();
+    auto relationships = destination.view<relationship>();
+    for (auto ent : relationships) {
+        auto rel = relationships.get(ent);
+        // remapped to the loaded copy of e3
+        ASSERT_TRUE(destination.has<timer>(rel.parent));
+        ASSERT_EQ(timers.get(rel.parent).duration, 42);
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <core/filesystem/filesystem.h>
+
+#include <fstream>
+#include <string>
+#include <utility>
+
+// gives every test an empty directory under the temp path, removed afterwards
+class TempDirTest : public ::testing::Test {
+protected:
+  explicit TempDirTest(std::string name) : name_(std::move(name)) {}
+
+  void SetUp() override {
+    fs::error_code err;
+    dir_ = fs::temp_directory_path(err) / name_;
+    fs::remove_all(dir_, err);
+    fs::create_directories(dir_, err);
+  }
+
+  void TearDown() override {
+    fs::error_code err;
+    fs::remove_all(dir_, err);
+  }
+
+  fs::path write(const std::string& name, const std::string& content) {
+    const auto file = dir_ / name;
+    std::ofstream stream(file.string(), std::ios::binary | std::ios::trunc);
+    stream << content;
+    return file;
+  }
+
+  fs::path dir_;
+
+private:
+  std::string name_;
+};